@@ -0,0 +1,1060 @@
+// Generated by cmd/wiregen from schema/wire.schema. DO NOT EDIT.
+//
+// Binary encoders and decoders for the wire messages shared with the C++
+// client and the Go hub. The schema describes the encoding and how to
+// evolve it.
+
+export const MsgId = {
+    Unknown: 0,
+    JoinGame: 1,
+    RoomStatus: 2,
+    WaitingForOpponent: 3,
+    GameStart: 4,
+    GameState: 5,
+    Attack: 6,
+    GameOver: 7,
+    Pause: 8,
+    Resume: 9,
+    PlayerLeft: 10,
+    MoveLR: 32,
+    Rotate: 33,
+    MoveDown: 34,
+    GameStartHost: 35,
+    SyncState: 36,
+    StateHash: 37,
+    HashHistoryReq: 38,
+    HashHistory: 39,
+    ResumeSession: 40,
+    ResumeOk: 41,
+    ResumeReject: 42,
+    Inputs: 43,
+    Ping: 44,
+} as const
+
+// Snake-case names; for hub messages also the JSON "type"
+export const MSG_NAMES: Record<number, string> = {
+    1: 'join_game',
+    2: 'room_status',
+    3: 'waiting_for_opponent',
+    4: 'game_start',
+    5: 'game_state',
+    6: 'attack',
+    7: 'game_over',
+    8: 'pause',
+    9: 'resume',
+    10: 'player_left',
+    32: 'move_lr',
+    33: 'rotate',
+    34: 'move_down',
+    35: 'game_start_host',
+    36: 'sync_state',
+    37: 'state_hash',
+    38: 'hash_history_req',
+    39: 'hash_history',
+    40: 'resume_session',
+    41: 'resume_ok',
+    42: 'resume_reject',
+    43: 'inputs',
+    44: 'ping',
+}
+
+export class WireError extends Error {}
+
+const textEncoder = new TextEncoder()
+const textDecoder = new TextDecoder()
+
+class Writer {
+    private buf = new Uint8Array(64)
+    private len = 0
+
+    // Non-negative, below 2^53
+    varint(value: number) {
+        while (value >= 0x80) {
+            this.byte((value % 0x80) | 0x80)
+            value = Math.floor(value / 0x80)
+        }
+        this.byte(value)
+    }
+
+    varintBig(value: bigint) {
+        value = BigInt.asUintN(64, value)
+        while (value >= 0x80n) {
+            this.byte(Number(value & 0x7fn) | 0x80)
+            value >>= 7n
+        }
+        this.byte(Number(value))
+    }
+
+    key(tag: number, wireType: number) {
+        this.varint(tag * 8 + wireType)
+    }
+
+    bool(tag: number, value: boolean) {
+        this.key(tag, 0)
+        this.byte(value ? 1 : 0)
+    }
+
+    // Zigzag: small negative numbers stay short
+    int(tag: number, value: number) {
+        this.key(tag, 0)
+        this.varint(value >= 0 ? value * 2 : -value * 2 - 1)
+    }
+
+    uint64(tag: number, value: bigint) {
+        this.key(tag, 0)
+        this.varintBig(value)
+    }
+
+    bytes(tag: number, value: Uint8Array) {
+        this.key(tag, 2)
+        this.varint(value.length)
+        this.reserve(value.length)
+        this.buf.set(value, this.len)
+        this.len += value.length
+    }
+
+    string(tag: number, value: string) {
+        this.bytes(tag, textEncoder.encode(value))
+    }
+
+    packed(tag: number, values: bigint[]) {
+        const inner = new Writer()
+        values.forEach(v => inner.varintBig(v))
+        this.bytes(tag, inner.finish())
+    }
+
+    nested(tag: number, encode: (w: Writer) => void) {
+        const inner = new Writer()
+        encode(inner)
+        this.bytes(tag, inner.finish())
+    }
+
+    finish(): Uint8Array {
+        return this.buf.subarray(0, this.len)
+    }
+
+    private byte(value: number) {
+        this.reserve(1)
+        this.buf[this.len++] = value
+    }
+
+    private reserve(size: number) {
+        if (this.len + size <= this.buf.length) return
+        const grown = new Uint8Array(Math.max(this.buf.length * 2, this.len + size))
+        grown.set(this.buf.subarray(0, this.len))
+        this.buf = grown
+    }
+}
+
+class Reader {
+    private buf: Uint8Array
+    private pos = 0
+
+    constructor(buf: Uint8Array) {
+        this.buf = buf
+    }
+
+    more(): boolean {
+        return this.pos < this.buf.length
+    }
+
+    varint(): number {
+        let value = 0
+        let scale = 1
+        for (let i = 0; i < 10; i++) {
+            if (this.pos >= this.buf.length) throw new WireError('truncated frame')
+            const b = this.buf[this.pos++]!
+            value += (b & 0x7f) * scale
+            if (b < 0x80) return value
+            scale *= 0x80
+        }
+        throw new WireError('varint too long')
+    }
+
+    varintBig(): bigint {
+        let value = 0n
+        let shift = 0n
+        for (let i = 0; i < 10; i++) {
+            if (this.pos >= this.buf.length) throw new WireError('truncated frame')
+            const b = this.buf[this.pos++]!
+            value |= BigInt(b & 0x7f) << shift
+            if (b < 0x80) return BigInt.asUintN(64, value)
+            shift += 7n
+        }
+        throw new WireError('varint too long')
+    }
+
+    key(): [number, number] {
+        const key = this.varint()
+        const tag = Math.floor(key / 8)
+        if (tag === 0) throw new WireError('field tag 0')
+        return [tag, key % 8]
+    }
+
+    bool(): boolean {
+        return this.varint() !== 0
+    }
+
+    int(): number {
+        const v = this.varint()
+        return v % 2 === 1 ? -(v + 1) / 2 : v / 2
+    }
+
+    uint64(): bigint {
+        return this.varintBig()
+    }
+
+    // The next length-delimited value, still pointing into the frame
+    view(): Uint8Array {
+        const len = this.varint()
+        if (len > this.buf.length - this.pos) throw new WireError('truncated frame')
+        const out = this.buf.subarray(this.pos, this.pos + len)
+        this.pos += len
+        return out
+    }
+
+    bytes(): Uint8Array {
+        return this.view().slice()
+    }
+
+    string(): string {
+        return textDecoder.decode(this.view())
+    }
+
+    packed(): bigint[] {
+        const inner = new Reader(this.view())
+        const values: bigint[] = []
+        while (inner.more()) values.push(inner.varintBig())
+        return values
+    }
+
+    sub(): Reader {
+        return new Reader(this.view())
+    }
+
+    // Fields this build does not know: a newer peer sent them
+    skip(wireType: number) {
+        if (wireType === 0) this.varint()
+        else if (wireType === 2) this.view()
+        else throw new WireError(`unknown wire type ${wireType}`)
+    }
+
+    expect(id: number) {
+        const got = this.varint()
+        if (got !== id) {
+            throw new WireError(`${MSG_NAMES[got] ?? got} frame, want ${MSG_NAMES[id]}`)
+        }
+    }
+}
+
+// Id of a frame, MsgId.Unknown if it cannot be read. Ids of messages newer
+// than this build are returned as they are.
+export function peekId(frame: Uint8Array): number {
+    try {
+        return new Reader(frame).varint()
+    } catch {
+        return MsgId.Unknown
+    }
+}
+
+export interface HostSettings {
+    attackMode: string
+    showGhostPiece: boolean
+    effectType: string
+    useCascadeGravity: boolean
+    allowHoldPiece: boolean
+    increaseGravity: boolean
+}
+
+export function newHostSettings(): HostSettings {
+    return {
+        attackMode: '',
+        showGhostPiece: false,
+        effectType: '',
+        useCascadeGravity: false,
+        allowHoldPiece: true,
+        increaseGravity: true,
+    }
+}
+
+function writeHostSettings(w: Writer, m: HostSettings) {
+    if (m.attackMode !== '') w.string(1, m.attackMode)
+    if (m.showGhostPiece) w.bool(2, m.showGhostPiece)
+    if (m.effectType !== '') w.string(3, m.effectType)
+    if (m.useCascadeGravity) w.bool(4, m.useCascadeGravity)
+    if (!m.allowHoldPiece) w.bool(5, m.allowHoldPiece)
+    if (!m.increaseGravity) w.bool(6, m.increaseGravity)
+}
+
+function readHostSettings(r: Reader): HostSettings {
+    const m = newHostSettings()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 2) m.attackMode = r.string()
+        else if (tag === 2 && wireType === 0) m.showGhostPiece = r.bool()
+        else if (tag === 3 && wireType === 2) m.effectType = r.string()
+        else if (tag === 4 && wireType === 0) m.useCascadeGravity = r.bool()
+        else if (tag === 5 && wireType === 0) m.allowHoldPiece = r.bool()
+        else if (tag === 6 && wireType === 0) m.increaseGravity = r.bool()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface JoinGame {
+    name: string
+    settings?: HostSettings
+}
+
+export function newJoinGame(): JoinGame {
+    return {
+        name: '',
+    }
+}
+
+export function encodeJoinGame(m: JoinGame): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.JoinGame)
+    if (m.name !== '') w.string(1, m.name)
+    const settings = m.settings
+    if (settings) w.nested(2, inner => writeHostSettings(inner, settings))
+    return w.finish()
+}
+
+export function decodeJoinGame(frame: Uint8Array): JoinGame {
+    const r = new Reader(frame)
+    r.expect(MsgId.JoinGame)
+    const m = newJoinGame()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 2) m.name = r.string()
+        else if (tag === 2 && wireType === 2) m.settings = readHostSettings(r.sub())
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface RoomStatus {
+    hasHost: boolean
+    hostSettings?: HostSettings
+}
+
+export function newRoomStatus(): RoomStatus {
+    return {
+        hasHost: false,
+    }
+}
+
+export function encodeRoomStatus(m: RoomStatus): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.RoomStatus)
+    if (m.hasHost) w.bool(1, m.hasHost)
+    const hostSettings = m.hostSettings
+    if (hostSettings) w.nested(2, inner => writeHostSettings(inner, hostSettings))
+    return w.finish()
+}
+
+export function decodeRoomStatus(frame: Uint8Array): RoomStatus {
+    const r = new Reader(frame)
+    r.expect(MsgId.RoomStatus)
+    const m = newRoomStatus()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.hasHost = r.bool()
+        else if (tag === 2 && wireType === 2) m.hostSettings = readHostSettings(r.sub())
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface WaitingForOpponent {
+}
+
+export function newWaitingForOpponent(): WaitingForOpponent {
+    return {}
+}
+
+export function encodeWaitingForOpponent(_m: WaitingForOpponent): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.WaitingForOpponent)
+    return w.finish()
+}
+
+export function decodeWaitingForOpponent(frame: Uint8Array): WaitingForOpponent {
+    const r = new Reader(frame)
+    r.expect(MsgId.WaitingForOpponent)
+    const m = newWaitingForOpponent()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
+
+export interface GameStart {
+    opponentId: string
+    opponentName: string
+    matchId: string
+    attackMode: string
+}
+
+export function newGameStart(): GameStart {
+    return {
+        opponentId: '',
+        opponentName: '',
+        matchId: '',
+        attackMode: '',
+    }
+}
+
+export function encodeGameStart(m: GameStart): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.GameStart)
+    if (m.opponentId !== '') w.string(1, m.opponentId)
+    if (m.opponentName !== '') w.string(2, m.opponentName)
+    if (m.matchId !== '') w.string(3, m.matchId)
+    if (m.attackMode !== '') w.string(4, m.attackMode)
+    return w.finish()
+}
+
+export function decodeGameStart(frame: Uint8Array): GameStart {
+    const r = new Reader(frame)
+    r.expect(MsgId.GameStart)
+    const m = newGameStart()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 2) m.opponentId = r.string()
+        else if (tag === 2 && wireType === 2) m.opponentName = r.string()
+        else if (tag === 3 && wireType === 2) m.matchId = r.string()
+        else if (tag === 4 && wireType === 2) m.attackMode = r.string()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+// cells: one byte per cell, row-major, 10 per row
+export interface GameState {
+    cells: Uint8Array
+    score: number
+    lines: number
+}
+
+export function newGameState(): GameState {
+    return {
+        cells: new Uint8Array(0),
+        score: 0,
+        lines: 0,
+    }
+}
+
+export function encodeGameState(m: GameState): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.GameState)
+    if (m.cells.length > 0) w.bytes(1, m.cells)
+    if (m.score !== 0) w.int(2, m.score)
+    if (m.lines !== 0) w.int(3, m.lines)
+    return w.finish()
+}
+
+export function decodeGameState(frame: Uint8Array): GameState {
+    const r = new Reader(frame)
+    r.expect(MsgId.GameState)
+    const m = newGameState()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 2) m.cells = r.bytes()
+        else if (tag === 2 && wireType === 0) m.score = r.int()
+        else if (tag === 3 && wireType === 0) m.lines = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface Attack {
+    lines: number
+}
+
+export function newAttack(): Attack {
+    return {
+        lines: 0,
+    }
+}
+
+export function encodeAttack(m: Attack): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.Attack)
+    if (m.lines !== 0) w.int(1, m.lines)
+    return w.finish()
+}
+
+export function decodeAttack(frame: Uint8Array): Attack {
+    const r = new Reader(frame)
+    r.expect(MsgId.Attack)
+    const m = newAttack()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.lines = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface GameOver {
+}
+
+export function newGameOver(): GameOver {
+    return {}
+}
+
+export function encodeGameOver(_m: GameOver): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.GameOver)
+    return w.finish()
+}
+
+export function decodeGameOver(frame: Uint8Array): GameOver {
+    const r = new Reader(frame)
+    r.expect(MsgId.GameOver)
+    const m = newGameOver()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
+
+export interface Pause {
+}
+
+export function newPause(): Pause {
+    return {}
+}
+
+export function encodePause(_m: Pause): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.Pause)
+    return w.finish()
+}
+
+export function decodePause(frame: Uint8Array): Pause {
+    const r = new Reader(frame)
+    r.expect(MsgId.Pause)
+    const m = newPause()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
+
+export interface Resume {
+}
+
+export function newResume(): Resume {
+    return {}
+}
+
+export function encodeResume(_m: Resume): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.Resume)
+    return w.finish()
+}
+
+export function decodeResume(frame: Uint8Array): Resume {
+    const r = new Reader(frame)
+    r.expect(MsgId.Resume)
+    const m = newResume()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
+
+export interface PlayerLeft {
+}
+
+export function newPlayerLeft(): PlayerLeft {
+    return {}
+}
+
+export function encodePlayerLeft(_m: PlayerLeft): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.PlayerLeft)
+    return w.finish()
+}
+
+export function decodePlayerLeft(frame: Uint8Array): PlayerLeft {
+    const r = new Reader(frame)
+    r.expect(MsgId.PlayerLeft)
+    const m = newPlayerLeft()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
+
+export interface PieceState {
+    type: number
+    x: number
+    y: number
+    rotation: number
+}
+
+export function newPieceState(): PieceState {
+    return {
+        type: 0,
+        x: 0,
+        y: 0,
+        rotation: 0,
+    }
+}
+
+function writePieceState(w: Writer, m: PieceState) {
+    if (m.type !== 0) w.int(1, m.type)
+    if (m.x !== 0) w.int(2, m.x)
+    if (m.y !== 0) w.int(3, m.y)
+    if (m.rotation !== 0) w.int(4, m.rotation)
+}
+
+function readPieceState(r: Reader): PieceState {
+    const m = newPieceState()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.type = r.int()
+        else if (tag === 2 && wireType === 0) m.x = r.int()
+        else if (tag === 3 && wireType === 0) m.y = r.int()
+        else if (tag === 4 && wireType === 0) m.rotation = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+// stampMs: sender's clock for the jitter buffer, -1 if unknown
+export interface MoveLR {
+    dir: number
+    stampMs: number
+}
+
+export function newMoveLR(): MoveLR {
+    return {
+        dir: 0,
+        stampMs: -1,
+    }
+}
+
+export function encodeMoveLR(m: MoveLR): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.MoveLR)
+    if (m.dir !== 0) w.int(1, m.dir)
+    if (m.stampMs !== -1) w.int(2, m.stampMs)
+    return w.finish()
+}
+
+export function decodeMoveLR(frame: Uint8Array): MoveLR {
+    const r = new Reader(frame)
+    r.expect(MsgId.MoveLR)
+    const m = newMoveLR()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.dir = r.int()
+        else if (tag === 2 && wireType === 0) m.stampMs = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface Rotate {
+    stampMs: number
+}
+
+export function newRotate(): Rotate {
+    return {
+        stampMs: -1,
+    }
+}
+
+export function encodeRotate(m: Rotate): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.Rotate)
+    if (m.stampMs !== -1) w.int(1, m.stampMs)
+    return w.finish()
+}
+
+export function decodeRotate(frame: Uint8Array): Rotate {
+    const r = new Reader(frame)
+    r.expect(MsgId.Rotate)
+    const m = newRotate()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.stampMs = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+// soft: Logic::Move(0, 1) rather than a gravity tick
+export interface MoveDown {
+    soft: boolean
+    stampMs: number
+}
+
+export function newMoveDown(): MoveDown {
+    return {
+        soft: false,
+        stampMs: -1,
+    }
+}
+
+export function encodeMoveDown(m: MoveDown): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.MoveDown)
+    if (m.soft) w.bool(1, m.soft)
+    if (m.stampMs !== -1) w.int(2, m.stampMs)
+    return w.finish()
+}
+
+export function decodeMoveDown(frame: Uint8Array): MoveDown {
+    const r = new Reader(frame)
+    r.expect(MsgId.MoveDown)
+    const m = newMoveDown()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.soft = r.bool()
+        else if (tag === 2 && wireType === 0) m.stampMs = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface GameStartHost {
+    seed: number
+    session: bigint
+    hostName: string
+}
+
+export function newGameStartHost(): GameStartHost {
+    return {
+        seed: 0,
+        session: 0n,
+        hostName: '',
+    }
+}
+
+export function encodeGameStartHost(m: GameStartHost): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.GameStartHost)
+    if (m.seed !== 0) w.int(1, m.seed)
+    if (m.session !== 0n) w.uint64(2, m.session)
+    if (m.hostName !== '') w.string(3, m.hostName)
+    return w.finish()
+}
+
+export function decodeGameStartHost(frame: Uint8Array): GameStartHost {
+    const r = new Reader(frame)
+    r.expect(MsgId.GameStartHost)
+    const m = newGameStartHost()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.seed = r.int()
+        else if (tag === 2 && wireType === 0) m.session = r.uint64()
+        else if (tag === 3 && wireType === 2) m.hostName = r.string()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+// step and current are only set by a full resync
+export interface SyncState {
+    score: number
+    nextType: number
+    board: Uint8Array
+    step: number
+    current?: PieceState
+}
+
+export function newSyncState(): SyncState {
+    return {
+        score: 0,
+        nextType: 0,
+        board: new Uint8Array(0),
+        step: -1,
+    }
+}
+
+export function encodeSyncState(m: SyncState): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.SyncState)
+    if (m.score !== 0) w.int(1, m.score)
+    if (m.nextType !== 0) w.int(2, m.nextType)
+    if (m.board.length > 0) w.bytes(3, m.board)
+    if (m.step !== -1) w.int(4, m.step)
+    const current = m.current
+    if (current) w.nested(5, inner => writePieceState(inner, current))
+    return w.finish()
+}
+
+export function decodeSyncState(frame: Uint8Array): SyncState {
+    const r = new Reader(frame)
+    r.expect(MsgId.SyncState)
+    const m = newSyncState()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.score = r.int()
+        else if (tag === 2 && wireType === 0) m.nextType = r.int()
+        else if (tag === 3 && wireType === 2) m.board = r.bytes()
+        else if (tag === 4 && wireType === 0) m.step = r.int()
+        else if (tag === 5 && wireType === 2) m.current = readPieceState(r.sub())
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface StateHash {
+    step: number
+    hash: bigint
+}
+
+export function newStateHash(): StateHash {
+    return {
+        step: 0,
+        hash: 0n,
+    }
+}
+
+export function encodeStateHash(m: StateHash): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.StateHash)
+    if (m.step !== 0) w.int(1, m.step)
+    if (m.hash !== 0n) w.uint64(2, m.hash)
+    return w.finish()
+}
+
+export function decodeStateHash(frame: Uint8Array): StateHash {
+    const r = new Reader(frame)
+    r.expect(MsgId.StateHash)
+    const m = newStateHash()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.step = r.int()
+        else if (tag === 2 && wireType === 0) m.hash = r.uint64()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface HashHistoryReq {
+    fromStep: number
+    toStep: number
+}
+
+export function newHashHistoryReq(): HashHistoryReq {
+    return {
+        fromStep: 0,
+        toStep: 0,
+    }
+}
+
+export function encodeHashHistoryReq(m: HashHistoryReq): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.HashHistoryReq)
+    if (m.fromStep !== 0) w.int(1, m.fromStep)
+    if (m.toStep !== 0) w.int(2, m.toStep)
+    return w.finish()
+}
+
+export function decodeHashHistoryReq(frame: Uint8Array): HashHistoryReq {
+    const r = new Reader(frame)
+    r.expect(MsgId.HashHistoryReq)
+    const m = newHashHistoryReq()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.fromStep = r.int()
+        else if (tag === 2 && wireType === 0) m.toStep = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+// hashes[i] and inputs[i] belong to step fromStep + i
+export interface HashHistory {
+    fromStep: number
+    hashes: bigint[]
+    inputs: string
+}
+
+export function newHashHistory(): HashHistory {
+    return {
+        fromStep: 0,
+        hashes: [],
+        inputs: '',
+    }
+}
+
+export function encodeHashHistory(m: HashHistory): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.HashHistory)
+    if (m.fromStep !== 0) w.int(1, m.fromStep)
+    if (m.hashes.length > 0) w.packed(2, m.hashes)
+    if (m.inputs !== '') w.string(3, m.inputs)
+    return w.finish()
+}
+
+export function decodeHashHistory(frame: Uint8Array): HashHistory {
+    const r = new Reader(frame)
+    r.expect(MsgId.HashHistory)
+    const m = newHashHistory()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.fromStep = r.int()
+        else if (tag === 2 && wireType === 2) m.hashes = r.packed()
+        else if (tag === 3 && wireType === 2) m.inputs = r.string()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface ResumeSession {
+    session: bigint
+    ackStep: number
+}
+
+export function newResumeSession(): ResumeSession {
+    return {
+        session: 0n,
+        ackStep: 0,
+    }
+}
+
+export function encodeResumeSession(m: ResumeSession): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.ResumeSession)
+    if (m.session !== 0n) w.uint64(1, m.session)
+    if (m.ackStep !== 0) w.int(2, m.ackStep)
+    return w.finish()
+}
+
+export function decodeResumeSession(frame: Uint8Array): ResumeSession {
+    const r = new Reader(frame)
+    r.expect(MsgId.ResumeSession)
+    const m = newResumeSession()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.session = r.uint64()
+        else if (tag === 2 && wireType === 0) m.ackStep = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface ResumeOk {
+    ackStep: number
+}
+
+export function newResumeOk(): ResumeOk {
+    return {
+        ackStep: 0,
+    }
+}
+
+export function encodeResumeOk(m: ResumeOk): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.ResumeOk)
+    if (m.ackStep !== 0) w.int(1, m.ackStep)
+    return w.finish()
+}
+
+export function decodeResumeOk(frame: Uint8Array): ResumeOk {
+    const r = new Reader(frame)
+    r.expect(MsgId.ResumeOk)
+    const m = newResumeOk()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.ackStep = r.int()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface ResumeReject {
+}
+
+export function newResumeReject(): ResumeReject {
+    return {}
+}
+
+export function encodeResumeReject(_m: ResumeReject): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.ResumeReject)
+    return w.finish()
+}
+
+export function decodeResumeReject(frame: Uint8Array): ResumeReject {
+    const r = new Reader(frame)
+    r.expect(MsgId.ResumeReject)
+    const m = newResumeReject()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
+
+// codes[i] is the Logic step code of step fromStep + i
+export interface Inputs {
+    fromStep: number
+    codes: string
+}
+
+export function newInputs(): Inputs {
+    return {
+        fromStep: 0,
+        codes: '',
+    }
+}
+
+export function encodeInputs(m: Inputs): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.Inputs)
+    if (m.fromStep !== 0) w.int(1, m.fromStep)
+    if (m.codes !== '') w.string(2, m.codes)
+    return w.finish()
+}
+
+export function decodeInputs(frame: Uint8Array): Inputs {
+    const r = new Reader(frame)
+    r.expect(MsgId.Inputs)
+    const m = newInputs()
+    while (r.more()) {
+        const [tag, wireType] = r.key()
+        if (tag === 1 && wireType === 0) m.fromStep = r.int()
+        else if (tag === 2 && wireType === 2) m.codes = r.string()
+        else r.skip(wireType)
+    }
+    return m
+}
+
+export interface Ping {
+}
+
+export function newPing(): Ping {
+    return {}
+}
+
+export function encodePing(_m: Ping): Uint8Array {
+    const w = new Writer()
+    w.varint(MsgId.Ping)
+    return w.finish()
+}
+
+export function decodePing(frame: Uint8Array): Ping {
+    const r = new Reader(frame)
+    r.expect(MsgId.Ping)
+    const m = newPing()
+    while (r.more()) {
+        const [, wireType] = r.key()
+        r.skip(wireType)
+    }
+    return m
+}
@@ -0,0 +1,104 @@
+/**
+ * wire.gen.ts: binary codecs generated from schema/wire.schema
+ */
+import { describe, it, expect } from 'vitest'
+import {
+    MsgId, WireError, peekId,
+    newJoinGame, newHostSettings, encodeJoinGame, decodeJoinGame,
+    newSyncState, encodeSyncState, decodeSyncState,
+    newStateHash, encodeStateHash, decodeStateHash,
+    newHashHistory, encodeHashHistory, decodeHashHistory,
+    newMoveLR, encodeMoveLR, decodeMoveLR,
+    encodePing, decodeAttack,
+} from './wire.gen'
+
+// The same frames are checked by client/tests/wire_test.cpp and
+// wire/wire_test.go
+const GOLDEN_JOIN_GAME = '010a03416e6e120b0a056c696e657310012800'
+const GOLDEN_SYNC_STATE = '2408e01210061a03000102209a012a0808041001180a2006'
+const GOLDEN_STATE_HASH = '2508d8041090e4d0b287d3aeeefe01'
+
+const toHex = (bytes: Uint8Array) =>
+    Array.from(bytes, b => b.toString(16).padStart(2, '0')).join('')
+
+const fromHex = (hex: string) =>
+    new Uint8Array((hex.match(/../g) ?? []).map(b => parseInt(b, 16)))
+
+const goldenJoin = () => {
+    const join = newJoinGame()
+    join.name = 'Ann'
+    join.settings = newHostSettings()
+    join.settings.attackMode = 'lines'
+    join.settings.showGhostPiece = true
+    join.settings.allowHoldPiece = false
+    return join
+}
+
+const goldenSync = () => {
+    const sync = newSyncState()
+    sync.score = 1200
+    sync.nextType = 3
+    sync.board = new Uint8Array([0, 1, 2])
+    sync.step = 77
+    sync.current = { type: 2, x: -1, y: 5, rotation: 3 }
+    return sync
+}
+
+describe('wire codecs', () => {
+    it('encodes the same bytes as the C++ and Go codecs', () => {
+        expect(toHex(encodeJoinGame(goldenJoin()))).toBe(GOLDEN_JOIN_GAME)
+        expect(toHex(encodeSyncState(goldenSync()))).toBe(GOLDEN_SYNC_STATE)
+        const hash = newStateHash()
+        hash.step = 300
+        hash.hash = 0xfedcba9876543210n
+        expect(toHex(encodeStateHash(hash))).toBe(GOLDEN_STATE_HASH)
+
+        expect(decodeSyncState(fromHex(GOLDEN_SYNC_STATE))).toEqual(goldenSync())
+        expect(decodeStateHash(fromHex(GOLDEN_STATE_HASH)).hash)
+            .toBe(0xfedcba9876543210n)
+    })
+
+    it('round-trips every field type', () => {
+        const history = newHashHistory()
+        history.fromStep = -5
+        history.hashes = [0n, 1n, 0x80n, 0xffffffffffffffffn]
+        history.inputs = 'LR\u0000G'
+        expect(decodeHashHistory(encodeHashHistory(history))).toEqual(history)
+        expect(toHex(encodePing({}))).toBe(MsgId.Ping.toString(16))
+    })
+
+    it('leaves defaults out and restores them', () => {
+        const move = newMoveLR()
+        move.dir = 1
+        expect(toHex(encodeMoveLR(move))).toBe('200802')
+        expect(decodeMoveLR(encodeMoveLR(move)).stampMs).toBe(-1)
+
+        const join = decodeJoinGame(encodeJoinGame({ name: '', settings: newHostSettings() }))
+        expect(join.settings).toEqual(newHostSettings())
+    })
+
+    it('skips fields from newer peers', () => {
+        const frame = fromHex(GOLDEN_JOIN_GAME + '7801' + '820103616263' + 'f8ffffff0fff01')
+        expect(decodeJoinGame(frame)).toEqual(goldenJoin())
+        expect(decodeAttack(fromHex('060a0178')).lines).toBe(0)
+    })
+
+    it('rejects malformed and foreign frames', () => {
+        // Cuts between fields leave a valid frame with fewer fields
+        const frame = fromHex(GOLDEN_SYNC_STATE)
+        const boundaries = [1, 4, 6, 11, 14]
+        for (let n = 0; n < frame.length; n++) {
+            const decode = () => decodeSyncState(frame.subarray(0, n))
+            if (boundaries.includes(n)) expect(decode).not.toThrow()
+            else expect(decode).toThrow(WireError)
+        }
+
+        expect(() => decodeStateHash(frame)).toThrow(WireError)
+        expect(() => decodeStateHash(fromHex('250b'))).toThrow(WireError)
+        expect(() => decodeStateHash(fromHex('2500'))).toThrow(WireError)
+
+        expect(peekId(frame)).toBe(MsgId.SyncState)
+        expect(peekId(new Uint8Array(0))).toBe(MsgId.Unknown)
+        expect(peekId(fromHex('7f'))).toBe(127)
+    })
+})
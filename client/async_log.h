@@ -0,0 +1,472 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef __EMSCRIPTEN__
+#include <condition_variable>
+#include <thread>
+#endif
+
+// Logging for threads that must never wait on stdout or a disk: the network
+// threads and the validation worker. Write() copies the format pointer and
+// the raw argument values into the calling thread's own ring (one producer,
+// one consumer, no locks) and returns. Formatting and I/O happen later on
+// the drain side: a background thread on desktop, or Pump() once per frame
+// on Emscripten, where there are no threads.
+//
+// A full ring drops the message instead of waiting, and each call site
+// (format string) is limited to ratePerSecond messages, so a retry loop
+// cannot flood the output. Both are counted and reported in the log.
+//
+// Formats must be string literals: only the pointer is kept. String
+// arguments (const char *, std::string) are copied, so temporaries are fine.
+// Levels use raylib's TraceLogLevel values; LOG_INFO etc. can be passed.
+class AsyncLog {
+public:
+  enum Level : int {
+    LEVEL_TRACE = 1,
+    LEVEL_DEBUG = 2,
+    LEVEL_INFO = 3,
+    LEVEL_WARNING = 4,
+    LEVEL_ERROR = 5,
+    LEVEL_FATAL = 6,
+  };
+
+  struct Config {
+    int minLevel = LEVEL_INFO;
+    bool toStdout = true;
+    std::string filePath;   // Also append to this file when set
+    int ratePerSecond = 50; // Per call site; 0: unlimited
+    bool drainThread = true; // Ignored on Emscripten: call Pump() instead
+    int drainIntervalMs = 10;
+  };
+
+  static constexpr size_t RING_SLOTS = 512; // Per writing thread
+  static constexpr size_t ARG_BYTES = 216;  // Encoded arguments per message
+
+  AsyncLog() : AsyncLog(Config()) {}
+  explicit AsyncLog(const Config &config) : id(NextId()) {
+    Configure(config);
+#ifndef __EMSCRIPTEN__
+    if (config.drainThread) {
+      drainIntervalMs = config.drainIntervalMs;
+      drainer = std::thread(&AsyncLog::DrainLoop, this);
+    }
+#endif
+  }
+
+  ~AsyncLog() {
+#ifndef __EMSCRIPTEN__
+    if (drainer.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+      }
+      stopWake.notify_all();
+      drainer.join();
+    }
+#endif
+    Drain();
+    if (file)
+      fclose(file);
+  }
+
+  AsyncLog(const AsyncLog &) = delete;
+  AsyncLog &operator=(const AsyncLog &) = delete;
+
+  // The process-wide log: stdout, INFO and up, drained in the background
+  static AsyncLog &Get() {
+    static AsyncLog instance;
+    return instance;
+  }
+
+  // Level, outputs and rate limit; the drain thread is fixed at creation
+  void Configure(const Config &config) {
+    std::lock_guard<std::mutex> lock(drainMutex);
+    minLevel.store(config.minLevel, std::memory_order_relaxed);
+    ratePerSecond.store(config.ratePerSecond, std::memory_order_relaxed);
+    toStdout = config.toStdout;
+    if (file)
+      fclose(file);
+    file = config.filePath.empty() ? nullptr
+                                   : fopen(config.filePath.c_str(), "a");
+  }
+
+  void SetLevel(int level) {
+    minLevel.store(level, std::memory_order_relaxed);
+  }
+
+  // Never blocks: the only lock is taken once per thread, on its first
+  // message, to register the thread's ring.
+  template <typename... Args>
+  void Write(int level, const char *format, const Args &...args) {
+    if (level < minLevel.load(std::memory_order_relaxed))
+      return;
+    int64_t now = NowUs();
+    if (!Admit(format, now)) {
+      suppressed.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    Ring &ring = LocalRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_SLOTS) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    Record &record = ring.slots[head % RING_SLOTS];
+    char *pos = record.args;
+    if (!EncodeAll<typename std::decay<Args>::type...>(
+            pos, record.args + ARG_BYTES, args...)) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    record.timeUs = now;
+    record.level = level;
+    record.format = format;
+    record.formatter =
+        &Formatter<typename std::decay<Args>::type...>::Format;
+    ring.head.store(head + 1, std::memory_order_release);
+  }
+
+  // Formats and writes everything queued so far, oldest first across all
+  // threads. Returns the number of messages written. Any thread may call
+  // it; the drain thread does every drainIntervalMs.
+  size_t Drain() {
+    std::lock_guard<std::mutex> lock(drainMutex);
+    std::vector<std::shared_ptr<Ring>> active;
+    {
+      std::lock_guard<std::mutex> registryLock(registryMutex);
+      // Rings of exited threads go once they are empty
+      for (size_t i = 0; i < rings.size();) {
+        Ring &ring = *rings[i];
+        if (ring.retired.load(std::memory_order_acquire) &&
+            ring.tail.load(std::memory_order_relaxed) ==
+                ring.head.load(std::memory_order_acquire)) {
+          rings.erase(rings.begin() + i);
+          continue;
+        }
+        active.push_back(rings[i]);
+        i++;
+      }
+    }
+
+    std::string out;
+    size_t written = 0;
+    while (true) {
+      // Oldest pending message of any ring
+      Ring *next = nullptr;
+      int64_t nextTime = 0;
+      for (const std::shared_ptr<Ring> &ring : active) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        if (tail == ring->head.load(std::memory_order_acquire))
+          continue;
+        int64_t time = ring->slots[tail % RING_SLOTS].timeUs;
+        if (!next || time < nextTime) {
+          next = ring.get();
+          nextTime = time;
+        }
+      }
+      if (!next)
+        break;
+      uint64_t tail = next->tail.load(std::memory_order_relaxed);
+      AppendLine(out, next->slots[tail % RING_SLOTS]);
+      next->tail.store(tail + 1, std::memory_order_release);
+      written++;
+    }
+    AppendLossReport(out);
+    if (!out.empty()) {
+      if (toStdout) {
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+      }
+      if (file) {
+        fwrite(out.data(), 1, out.size(), file);
+        fflush(file);
+      }
+    }
+    return written;
+  }
+
+  // Once per frame from the main loop. Drains only where there is no
+  // drain thread, so the desktop render thread never does log I/O.
+  void Pump() {
+#ifndef __EMSCRIPTEN__
+    if (drainer.joinable())
+      return;
+#endif
+    Drain();
+  }
+
+  uint64_t GetDropped() const { return dropped.load(); }
+  uint64_t GetSuppressed() const { return suppressed.load(); }
+
+  static int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+private:
+  typedef int (*FormatFn)(char *out, size_t size, const char *format,
+                          const char *args);
+
+  struct Record {
+    int64_t timeUs;
+    const char *format;
+    FormatFn formatter; // Knows the argument types
+    int level;
+    char args[ARG_BYTES];
+  };
+
+  struct Ring {
+    Ring() : slots(new Record[RING_SLOTS]) {}
+    std::unique_ptr<Record[]> slots;
+    std::atomic<uint64_t> head{0}; // Writing thread
+    std::atomic<uint64_t> tail{0}; // Drain side
+    std::atomic<bool> retired{false};
+  };
+
+  // Numbers, enums and pointers are stored as-is and handed back with
+  // their own type, so the format sees exactly what the caller passed.
+  template <typename T, typename Enable = void> struct Codec {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value ||
+                      std::is_pointer<T>::value,
+                  "AsyncLog: unsupported argument type");
+    typedef T Decoded;
+    static bool Encode(char *&pos, const char *end, const T &value) {
+      if ((size_t)(end - pos) < sizeof(T))
+        return false;
+      memcpy(pos, &value, sizeof(T));
+      pos += sizeof(T);
+      return true;
+    }
+    static T Decode(const char *&pos) {
+      T value;
+      memcpy(&value, pos, sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+  };
+
+  // Strings are copied (length, bytes, NUL), truncated to the space left
+  struct StringCodec {
+    typedef const char *Decoded;
+    static bool EncodeBytes(char *&pos, const char *end, const char *text,
+                            size_t len) {
+      size_t room = (size_t)(end - pos);
+      if (room < 3)
+        return false;
+      if (len > room - 3)
+        len = room - 3;
+      uint16_t stored = (uint16_t)len;
+      memcpy(pos, &stored, 2);
+      memcpy(pos + 2, text, len);
+      pos[2 + len] = '\0';
+      pos += 3 + len;
+      return true;
+    }
+    static const char *Decode(const char *&pos) {
+      uint16_t len;
+      memcpy(&len, pos, 2);
+      const char *text = pos + 2;
+      pos += 3 + len;
+      return text;
+    }
+  };
+
+  template <typename T>
+  struct Codec<T, typename std::enable_if<
+                      std::is_same<T, const char *>::value ||
+                      std::is_same<T, char *>::value>::type> : StringCodec {
+    static bool Encode(char *&pos, const char *end, const char *text) {
+      if (!text)
+        text = "(null)";
+      return EncodeBytes(pos, end, text, strlen(text));
+    }
+  };
+
+  template <typename T>
+  struct Codec<T, typename std::enable_if<
+                      std::is_same<T, std::string>::value>::type>
+      : StringCodec {
+    static bool Encode(char *&pos, const char *end, const std::string &text) {
+      return EncodeBytes(pos, end, text.data(), text.size());
+    }
+  };
+
+  template <typename... Stored, typename... Args>
+  static bool EncodeAll(char *&pos, const char *end, const Args &...args) {
+    (void)end; // Unused without arguments
+    return (Codec<Stored>::Encode(pos, end, args) && ...);
+  }
+
+  template <typename... Stored> struct Formatter {
+    static int Format(char *out, size_t size, const char *format,
+                      const char *args) {
+      const char *pos = args;
+      // Braced initialization decodes left to right
+      std::tuple<typename Codec<Stored>::Decoded...> values{
+          Codec<Stored>::Decode(pos)...};
+      (void)pos;
+      return std::apply(
+          [&](auto... value) { return snprintf(out, size, format, value...); },
+          values);
+    }
+  };
+
+  static const char *LevelName(int level) {
+    switch (level) {
+    case LEVEL_TRACE:
+      return "TRACE";
+    case LEVEL_DEBUG:
+      return "DEBUG";
+    case LEVEL_INFO:
+      return "INFO";
+    case LEVEL_WARNING:
+      return "WARNING";
+    case LEVEL_ERROR:
+      return "ERROR";
+    case LEVEL_FATAL:
+      return "FATAL";
+    default:
+      return "LOG";
+    }
+  }
+
+  void AppendLine(std::string &out, const Record &record) {
+    char text[512];
+    int len = record.formatter(text, sizeof(text), record.format, record.args);
+    if (len < 0)
+      snprintf(text, sizeof(text), "(bad format: %s)", record.format);
+    char prefix[48];
+    snprintf(prefix, sizeof(prefix), "[%10.3f] %s: ",
+             (record.timeUs - startUs) / 1000000.0, LevelName(record.level));
+    out += prefix;
+    out += text;
+    out += '\n';
+  }
+
+  void AppendLossReport(std::string &out) {
+    uint64_t nowDropped = dropped.load(std::memory_order_relaxed);
+    uint64_t nowSuppressed = suppressed.load(std::memory_order_relaxed);
+    if (nowDropped == reportedDropped && nowSuppressed == reportedSuppressed)
+      return;
+    char line[160];
+    snprintf(line, sizeof(line),
+             "[%10.3f] WARNING: LOG: %llu messages rate limited, %llu dropped "
+             "(ring full)\n",
+             (NowUs() - startUs) / 1000000.0,
+             (unsigned long long)(nowSuppressed - reportedSuppressed),
+             (unsigned long long)(nowDropped - reportedDropped));
+    out += line;
+    reportedDropped = nowDropped;
+    reportedSuppressed = nowSuppressed;
+  }
+
+  // Per call site: at most ratePerSecond messages in each clock second.
+  // Sites share one of SITES counters by format pointer; collisions only
+  // make the limit a little stricter.
+  bool Admit(const char *format, int64_t nowUs) {
+    int limit = ratePerSecond.load(std::memory_order_relaxed);
+    if (limit <= 0)
+      return true;
+    uint64_t window = (uint64_t)(nowUs / 1000000) & 0xffffffffu;
+    uint64_t hash = ((uintptr_t)format >> 3) * 0x9E3779B97F4A7C15ull;
+    std::atomic<uint64_t> &site = sites[hash >> (64 - SITE_BITS)];
+    uint64_t value = site.load(std::memory_order_relaxed);
+    if ((value >> 32) != window &&
+        site.compare_exchange_strong(value, (window << 32) | 1,
+                                     std::memory_order_relaxed))
+      return true;
+    return (site.fetch_add(1, std::memory_order_relaxed) & 0xffffffffu) <
+           (uint64_t)limit;
+  }
+
+  // This thread's ring for this log, registered on first use. Marked
+  // retired when the thread exits; the drain side frees it once empty.
+  Ring &LocalRing() {
+    struct Local {
+      std::vector<std::pair<uint64_t, std::shared_ptr<Ring>>> rings;
+      ~Local() {
+        for (auto &entry : rings)
+          entry.second->retired.store(true, std::memory_order_release);
+      }
+    };
+    thread_local Local local;
+    for (auto &entry : local.rings)
+      if (entry.first == id)
+        return *entry.second;
+    std::shared_ptr<Ring> ring = std::make_shared<Ring>();
+    {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      rings.push_back(ring);
+    }
+    local.rings.emplace_back(id, ring);
+    return *ring;
+  }
+
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1);
+  }
+
+#ifndef __EMSCRIPTEN__
+  void DrainLoop() {
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopping) {
+      stopWake.wait_for(lock, std::chrono::milliseconds(drainIntervalMs));
+      lock.unlock();
+      Drain();
+      lock.lock();
+    }
+  }
+
+  std::thread drainer;
+  std::mutex stopMutex;
+  std::condition_variable stopWake;
+  bool stopping = false;
+  int drainIntervalMs = 10;
+#endif
+
+  static const int SITE_BITS = 8;
+
+  const uint64_t id; // Tells this log's rings apart in thread_local storage
+  const int64_t startUs = NowUs();
+
+  // Writers
+  std::atomic<int> minLevel{LEVEL_INFO};
+  std::atomic<int> ratePerSecond{0};
+  std::atomic<uint64_t> sites[1 << SITE_BITS] = {};
+  std::atomic<uint64_t> dropped{0};
+  std::atomic<uint64_t> suppressed{0};
+
+  std::mutex registryMutex;
+  std::vector<std::shared_ptr<Ring>> rings;
+
+  // Drain side
+  std::mutex drainMutex;
+  bool toStdout = true;
+  FILE *file = nullptr;
+  uint64_t reportedDropped = 0;
+  uint64_t reportedSuppressed = 0;
+};
+
+// Shorthand for the process-wide log
+template <typename... Args>
+inline void LogAsync(int level, const char *format, const Args &...args) {
+  AsyncLog::Get().Write(level, format, args...);
+}
+
+#endif
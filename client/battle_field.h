@@ -0,0 +1,92 @@
+#ifndef BATTLE_FIELD_H
+#define BATTLE_FIELD_H
+
+#include "logic.h"
+#include <random>
+#include <vector>
+
+// The opponents of the battle royale practice mode: one Logic per bot. Bots
+// play like the load generator's (tools/loadgen.cpp): random shifts and
+// rotations on a timer while gravity drops the piece, so they top out one
+// after another at different times.
+class BattleField {
+public:
+  // count opponents; the same seed gives the same match
+  void Reset(int count, int seed) {
+    bots.clear();
+    bots.resize(count);
+    boards.resize(count);
+    std::mt19937 seeder((uint32_t)seed);
+    std::uniform_real_distribution<float> gravity(0.15f, 0.5f);
+    for (int i = 0; i < count; i++) {
+      Bot &bot = bots[i];
+      bot.logic.Reset((int)(seeder() & 0x7fffffff));
+      bot.rng.seed(seeder());
+      bot.gravityInterval = gravity(seeder);
+      bot.gravityTimer = bot.gravityInterval;
+      bot.actionTimer = ActionDelay(bot);
+      boards[i] = &bot.logic;
+    }
+  }
+
+  void Update(float frameTime) {
+    for (Bot &bot : bots) {
+      if (bot.logic.isGameOver)
+        continue;
+      bot.actionTimer -= frameTime;
+      while (bot.actionTimer <= 0) {
+        uint32_t r = bot.rng() % 20;
+        if (r < 7)
+          bot.logic.Move(-1, 0);
+        else if (r < 14)
+          bot.logic.Move(1, 0);
+        else
+          bot.logic.Rotate();
+        bot.actionTimer += ActionDelay(bot);
+      }
+      bot.gravityTimer -= frameTime;
+      while (bot.gravityTimer <= 0 && !bot.logic.isGameOver) {
+        bot.logic.Tick();
+        bot.gravityTimer += bot.gravityInterval;
+      }
+    }
+  }
+
+  int Size() const { return (int)bots.size(); }
+  const Logic &Get(int i) const { return bots[i].logic; }
+  const Logic *const *Boards() const { return boards.data(); }
+
+  int Alive() const {
+    int alive = 0;
+    for (const Bot &bot : bots)
+      alive += bot.logic.isGameOver ? 0 : 1;
+    return alive;
+  }
+
+  // Rows from the bottom up to the highest locked block
+  static int StackHeight(const Logic &logic) {
+    for (int r = 0; r < BOARD_HEIGHT; r++)
+      for (int c = 0; c < BOARD_WIDTH; c++)
+        if (logic.board.GetCell(r, c) != 0)
+          return BOARD_HEIGHT - r;
+    return 0;
+  }
+
+private:
+  struct Bot {
+    Logic logic;
+    std::mt19937 rng;
+    float actionTimer = 0;
+    float gravityTimer = 0;
+    float gravityInterval = 0.3f;
+  };
+
+  static float ActionDelay(Bot &bot) {
+    return 0.1f + (bot.rng() % 300) / 1000.0f;
+  }
+
+  std::vector<Bot> bots;
+  std::vector<const Logic *> boards;
+};
+
+#endif
@@ -1,5 +1,5 @@
-
 #include "board.h"
+#include "state_hash.h"
 
 Board::Board() { Reset(); }
 
@@ -9,10 +9,14 @@ void Board::Reset() {
       grid[i][j] = 0;
     }
   }
+  hash = 0; // Empty cells contribute no key (see StateHash::CellKey)
 }
 
 void Board::SetCell(int r, int c, int val) {
   if (r >= 0 && r < 20 && c >= 0 && c < 10) {
+    int index = r * 10 + c;
+    hash ^= StateHash::CellKey(index, grid[r][c]) ^
+            StateHash::CellKey(index, val);
     grid[r][c] = val;
   }
 }
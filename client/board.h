@@ -1,6 +1,7 @@
-
 #pragma once
 
+#include <cstdint>
+
 class Board {
 public:
   Board();
@@ -10,6 +11,10 @@ public:
   int GetWidth() const { return 10; }
   int GetHeight() const { return 20; }
 
+  // Zobrist hash of the grid, kept up to date incrementally by SetCell().
+  uint64_t GetHash() const { return hash; }
+
 private:
   int grid[20][10];
+  uint64_t hash = 0;
 };
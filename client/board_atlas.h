@@ -0,0 +1,162 @@
+#ifndef BOARD_ATLAS_H
+#define BOARD_ATLAS_H
+
+#include "board_cells.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// The cell codes of up to MAX_BOARDS boards in one packed buffer: a grid of
+// TILES_X x TILES_Y tiles, each a board's 10x20 BoardCells codes. The
+// renderer (multi_board_renderer.h) uploads it as a single texture, and
+// only the rows that changed, so every miniboard on screen comes from one
+// texture and one shader.
+//
+// Level of detail per board:
+//  - FULL: every cell, the active piece included, refreshed every frame.
+//  - HEIGHTMAP: each column filled from its highest block down in one
+//    color, refreshed every farInterval frames. Boards are staggered so an
+//    equal share of them is refreshed each frame.
+// Boards that topped out are shown in the GHOST layer (dimmed).
+class BoardAtlas {
+public:
+  enum class Lod { FULL, HEIGHTMAP };
+
+  static constexpr int MAX_BOARDS = 100;
+  static constexpr int TILES_X = 10;
+  static constexpr int TILES_Y = (MAX_BOARDS + TILES_X - 1) / TILES_X;
+  static constexpr int WIDTH = TILES_X * BOARD_WIDTH; // Cells
+  static constexpr int HEIGHT = TILES_Y * BOARD_HEIGHT;
+
+  BoardAtlas() : cells(WIDTH * HEIGHT, 0) {}
+
+  static int TileX(int board) { return board % TILES_X * BOARD_WIDTH; }
+  static int TileY(int board) { return board / TILES_X * BOARD_HEIGHT; }
+
+  void SetLod(int board, Lod lod) {
+    if (board < 0 || board >= MAX_BOARDS || tiles[board].lod == lod)
+      return;
+    tiles[board].lod = lod;
+    tiles[board].stale = true;
+  }
+  Lod GetLod(int board) const { return tiles[board].lod; }
+
+  void SetFarInterval(int frames) { farInterval = frames < 1 ? 1 : frames; }
+
+  // Once per frame. boards[i] is drawn from tile i; boards past count are
+  // cleared. Returns how many tiles were rebuilt.
+  int Update(const Logic *const *boards, int count) {
+    if (count > MAX_BOARDS)
+      count = MAX_BOARDS;
+    int rebuilt = 0;
+    for (int i = 0; i < MAX_BOARDS; i++) {
+      Tile &tile = tiles[i];
+      if (i >= count) {
+        if (tile.used) {
+          uint8_t empty[BoardCells::CELL_COUNT] = {};
+          Store(i, empty);
+          tile.used = false;
+        }
+        continue;
+      }
+      bool due = tile.lod == Lod::FULL || tile.stale || !tile.used ||
+                 (frame + i) % farInterval == 0;
+      if (!due)
+        continue;
+      uint8_t next[BoardCells::CELL_COUNT];
+      Build(*boards[i], tile.lod, next);
+      Store(i, next);
+      tile.used = true;
+      tile.stale = false;
+      rebuilt++;
+    }
+    frame++;
+    return rebuilt;
+  }
+
+  const uint8_t *Data() const { return cells.data(); }
+  uint8_t At(int board, int r, int c) const {
+    return cells[(TileY(board) + r) * WIDTH + TileX(board) + c];
+  }
+
+  // Atlas rows written since the last ClearDirty(): [first, last)
+  bool GetDirtyRows(int &first, int &last) const {
+    first = dirtyFirst;
+    last = dirtyLast;
+    return dirtyFirst < dirtyLast;
+  }
+  void ClearDirty() {
+    dirtyFirst = HEIGHT;
+    dirtyLast = 0;
+  }
+
+  // The largest cell size (pixels) at which count boards fit a width x
+  // height area with gap pixels between them; 0 if even 1 px does not fit
+  static int FitCellSize(int width, int height, int count, int gap,
+                         int &columns) {
+    for (int cell = height / BOARD_HEIGHT; cell >= 1; cell--) {
+      int cols = (width + gap) / (BOARD_WIDTH * cell + gap);
+      int rows = (height + gap) / (BOARD_HEIGHT * cell + gap);
+      if (cols > 0 && cols * rows >= count) {
+        columns = cols;
+        return cell;
+      }
+    }
+    columns = 0;
+    return 0;
+  }
+
+private:
+  struct Tile {
+    Lod lod = Lod::FULL;
+    bool used = false;
+    bool stale = false; // LOD changed: rebuild on the next Update
+  };
+
+  static void Build(const Logic &logic, Lod lod, uint8_t *next) {
+    if (lod == Lod::FULL) {
+      BoardCells::Build(logic, false, next);
+    } else {
+      uint8_t fill =
+          BoardCells::Code(BoardCells::LOCKED, BoardCells::OTHER);
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        bool filled = false;
+        for (int r = 0; r < BOARD_HEIGHT; r++) {
+          filled = filled || logic.board.GetCell(r, c) != 0;
+          next[r * BOARD_WIDTH + c] = filled ? fill : 0;
+        }
+      }
+    }
+    if (!logic.isGameOver)
+      return;
+    for (int i = 0; i < BoardCells::CELL_COUNT; i++)
+      if (next[i])
+        next[i] = BoardCells::Code(BoardCells::GHOST,
+                                   next[i] % BoardCells::LAYER_STRIDE);
+  }
+
+  // Copies a tile in row by row, widening the dirty range on changes
+  void Store(int board, const uint8_t *tile) {
+    int x = TileX(board), y = TileY(board);
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      uint8_t *row = &cells[(y + r) * WIDTH + x];
+      const uint8_t *src = tile + r * BOARD_WIDTH;
+      if (memcmp(row, src, BOARD_WIDTH) == 0)
+        continue;
+      memcpy(row, src, BOARD_WIDTH);
+      if (y + r < dirtyFirst)
+        dirtyFirst = y + r;
+      if (y + r + 1 > dirtyLast)
+        dirtyLast = y + r + 1;
+    }
+  }
+
+  std::vector<uint8_t> cells;
+  Tile tiles[MAX_BOARDS];
+  int farInterval = 4;
+  uint64_t frame = 0;
+  int dirtyFirst = 0; // Everything, for the first upload
+  int dirtyLast = HEIGHT;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef BOARD_CELLS_H
+#define BOARD_CELLS_H
+
+#include "logic.h"
+#include <cstdint>
+#include <cstring>
+
+// What one board looks like this frame, one byte per cell: the code the
+// board shader (board_renderer.h) looks up in its palette. The renderer
+// uploads the bytes as a 10x20 texture, and only when Update() reports a
+// change, so an idle board costs no texture traffic at all.
+class BoardCells {
+public:
+  // Palette slots: 0 empty, 1-7 PieceType, OTHER for anything else a peer
+  // sends (hub grids, garbage)
+  static constexpr int OTHER = 8;
+  static constexpr int PALETTE_SIZE = 9;
+
+  // Code = layer * LAYER_STRIDE + palette slot
+  enum Layer { LOCKED = 0, ACTIVE = 1, GHOST = 2 };
+  static constexpr int LAYER_STRIDE = 16;
+  static constexpr int CELL_COUNT = BOARD_WIDTH * BOARD_HEIGHT;
+
+  static uint8_t Code(Layer layer, int slot) {
+    return (uint8_t)(layer * LAYER_STRIDE + slot);
+  }
+  static int Slot(int cellValue) {
+    return cellValue >= 0 && cellValue < OTHER ? cellValue : OTHER;
+  }
+
+  BoardCells() { memset(cells, 0xff, sizeof(cells)); } // First Update differs
+
+  // Rebuilds the cells from the logic; false if nothing changed
+  bool Update(const Logic &logic, bool showGhost) {
+    uint8_t next[CELL_COUNT];
+    Build(logic, showGhost, next);
+    if (memcmp(next, cells, sizeof(cells)) == 0)
+      return false;
+    memcpy(cells, next, sizeof(cells));
+    return true;
+  }
+
+  // The codes of one board, row by row, into next[CELL_COUNT]
+  static void Build(const Logic &logic, bool showGhost, uint8_t *next) {
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        int value = logic.board.GetCell(r, c);
+        next[r * BOARD_WIDTH + c] = value ? Code(LOCKED, Slot(value)) : 0;
+      }
+    }
+
+    const Piece &piece = logic.currentPiece;
+    if (piece.type != PieceType::NONE) {
+      int slot = Slot((int)piece.type);
+      if (showGhost) {
+        Piece ghost = piece;
+        ghost.y++;
+        while (logic.IsValidPosition(ghost))
+          ghost.y++;
+        ghost.y--;
+        if (ghost.y != piece.y)
+          Stamp(next, ghost, Code(GHOST, slot));
+      }
+      Stamp(next, piece, Code(ACTIVE, slot));
+    }
+  }
+
+  const uint8_t *Data() const { return cells; }
+  uint8_t At(int r, int c) const { return cells[r * BOARD_WIDTH + c]; }
+
+private:
+  // Blocks above the board (spawning) are left out
+  static void Stamp(uint8_t *out, const Piece &piece, uint8_t code) {
+    for (int i = 0; i < 4; i++) {
+      int bx, by;
+      piece.GetBlock(piece.rotation, i, bx, by);
+      int r = piece.y + by, c = piece.x + bx;
+      if (r >= 0 && r < BOARD_HEIGHT && c >= 0 && c < BOARD_WIDTH)
+        out[r * BOARD_WIDTH + c] = code;
+    }
+  }
+
+  uint8_t cells[CELL_COUNT];
+};
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef BOARD_RENDERER_H
+#define BOARD_RENDERER_H
+
+#include "board_cells.h"
+#include "raylib.h"
+
+// Colors of a board skin; cells[] is indexed by BoardCells palette slot
+struct BoardPalette {
+  Color background;
+  Color grid;   // Lines around empty cells; alpha is the line strength
+  Color border; // One pixel around the whole board
+  Color cells[BoardCells::PALETTE_SIZE];
+  float ghostAlpha; // Ghost blocks: cell color over the background
+
+  static BoardPalette Classic() {
+    BoardPalette p;
+    p.background = DARKGRAY;
+    p.grid = Fade(LIGHTGRAY, 0.1f);
+    p.border = WHITE;
+    p.cells[0] = BLANK;
+    p.cells[(int)PieceType::I] = SKYBLUE;
+    p.cells[(int)PieceType::O] = YELLOW;
+    p.cells[(int)PieceType::T] = PURPLE;
+    p.cells[(int)PieceType::S] = GREEN;
+    p.cells[(int)PieceType::Z] = RED;
+    p.cells[(int)PieceType::J] = BLUE;
+    p.cells[(int)PieceType::L] = ORANGE;
+    p.cells[BoardCells::OTHER] = GRAY;
+    p.ghostAlpha = 0.3f;
+    return p;
+  }
+};
+
+// Draws a whole board (cells, grid, active piece, ghost, border) as one
+// textured quad. Each board's cell codes live in a 10x20 single-channel
+// texture that is re-uploaded only when they change; the fragment shader
+// turns codes into palette colors. Without shader support it falls back to
+// rectangles from the same cell codes.
+//
+// Owns GPU resources: create and destroy it while the window is open.
+class BoardRenderer {
+public:
+  static constexpr int MAX_BOARDS = 2;
+
+  BoardRenderer() : palette(BoardPalette::Classic()) {}
+  BoardRenderer(const BoardRenderer &) = delete;
+  BoardRenderer &operator=(const BoardRenderer &) = delete;
+  ~BoardRenderer() { Unload(); }
+
+  const BoardPalette &GetPalette() const { return palette; }
+  void SetPalette(const BoardPalette &skin) {
+    palette = skin;
+    uniformsDirty = true;
+  }
+
+  // board: 0..MAX_BOARDS-1, one texture per board on screen
+  void Draw(int board, const Logic &logic, int x, int y, int cellSize,
+            bool showGhost) {
+    if (board < 0 || board >= MAX_BOARDS)
+      return;
+    if (!loaded)
+      Load();
+    Slot &slot = slots[board];
+    bool changed = slot.cells.Update(logic, showGhost);
+
+    if (!useShader) {
+      DrawRectangles(slot.cells, x, y, cellSize);
+      return;
+    }
+    if (changed)
+      UpdateTexture(slot.texture, slot.cells.Data());
+    if (uniformsDirty || cellSize != uniformCellSize)
+      SetUniforms(cellSize);
+
+    Rectangle source = {0, 0, (float)BOARD_WIDTH, (float)BOARD_HEIGHT};
+    Rectangle dest = {(float)x, (float)y, (float)(BOARD_WIDTH * cellSize),
+                      (float)(BOARD_HEIGHT * cellSize)};
+    BeginShaderMode(shader);
+    DrawTexturePro(slot.texture, source, dest, {0, 0}, 0.0f, WHITE);
+    EndShaderMode();
+  }
+
+  void Unload() {
+    if (!loaded)
+      return;
+    for (Slot &slot : slots) {
+      if (slot.texture.id > 0)
+        UnloadTexture(slot.texture);
+      slot = Slot();
+    }
+    if (useShader)
+      UnloadShader(shader);
+    loaded = useShader = false;
+  }
+
+private:
+  struct Slot {
+    BoardCells cells;
+    Texture2D texture = {};
+  };
+
+  void Load() {
+    loaded = true;
+    shader = LoadShaderFromMemory(nullptr, FRAGMENT_SHADER);
+    // A failed compile hands back raylib's default shader, which has no
+    // palette uniform
+    paletteLoc = GetShaderLocation(shader, "palette");
+    useShader = paletteLoc >= 0;
+    if (!useShader) {
+      TraceLog(LOG_WARNING, "BOARD: shader unavailable, drawing rectangles");
+      return;
+    }
+    backgroundLoc = GetShaderLocation(shader, "background");
+    gridLoc = GetShaderLocation(shader, "grid");
+    borderLoc = GetShaderLocation(shader, "border");
+    boardSizeLoc = GetShaderLocation(shader, "boardSize");
+    ghostAlphaLoc = GetShaderLocation(shader, "ghostAlpha");
+
+    static uint8_t empty[BoardCells::CELL_COUNT] = {};
+    Image image = {empty, BOARD_WIDTH, BOARD_HEIGHT, 1,
+                   PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+    for (Slot &slot : slots) {
+      slot.texture = LoadTextureFromImage(image);
+      SetTextureFilter(slot.texture, TEXTURE_FILTER_POINT);
+      SetTextureWrap(slot.texture, TEXTURE_WRAP_CLAMP); // NPOT on GLES2
+      slot.cells = BoardCells(); // Uploads on the next Draw
+    }
+    uniformsDirty = true;
+  }
+
+  static void Normalize(Color c, float *out) {
+    out[0] = c.r / 255.0f;
+    out[1] = c.g / 255.0f;
+    out[2] = c.b / 255.0f;
+    out[3] = c.a / 255.0f;
+  }
+
+  void SetUniforms(int cellSize) {
+    float colors[BoardCells::PALETTE_SIZE * 4];
+    for (int i = 0; i < BoardCells::PALETTE_SIZE; i++)
+      Normalize(palette.cells[i], colors + i * 4);
+    SetShaderValueV(shader, paletteLoc, colors, SHADER_UNIFORM_VEC4,
+                    BoardCells::PALETTE_SIZE);
+    float color[4];
+    Normalize(palette.background, color);
+    SetShaderValue(shader, backgroundLoc, color, SHADER_UNIFORM_VEC4);
+    Normalize(palette.grid, color);
+    SetShaderValue(shader, gridLoc, color, SHADER_UNIFORM_VEC4);
+    Normalize(palette.border, color);
+    SetShaderValue(shader, borderLoc, color, SHADER_UNIFORM_VEC4);
+    float size[2] = {(float)(BOARD_WIDTH * cellSize),
+                     (float)(BOARD_HEIGHT * cellSize)};
+    SetShaderValue(shader, boardSizeLoc, size, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, ghostAlphaLoc, &palette.ghostAlpha,
+                   SHADER_UNIFORM_FLOAT);
+    uniformCellSize = cellSize;
+    uniformsDirty = false;
+  }
+
+  // Fallback: what the shader draws, as immediate-mode rectangles
+  void DrawRectangles(const BoardCells &cells, int x, int y, int cellSize) {
+    DrawRectangle(x, y, BOARD_WIDTH * cellSize, BOARD_HEIGHT * cellSize,
+                  palette.background);
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        int code = cells.At(r, c);
+        int cx = x + c * cellSize, cy = y + r * cellSize;
+        if (code == 0) {
+          DrawRectangleLines(cx, cy, cellSize, cellSize, palette.grid);
+          continue;
+        }
+        Color color = palette.cells[code % BoardCells::LAYER_STRIDE];
+        if (code / BoardCells::LAYER_STRIDE == BoardCells::GHOST)
+          color = ColorAlphaBlend(palette.background,
+                                  Fade(color, palette.ghostAlpha), WHITE);
+        DrawRectangle(cx + 1, cy + 1, cellSize - 2, cellSize - 2, color);
+      }
+    }
+    DrawRectangleLines(x, y, BOARD_WIDTH * cellSize, BOARD_HEIGHT * cellSize,
+                       palette.border);
+  }
+
+  // Over raylib's default vertex shader. Desktop GL 3.3, GLSL ES 1.00 on
+  // WebGL/GLES2 (no integers or dynamic array indexing there).
+  static constexpr const char *FRAGMENT_SHADER =
+#if defined(PLATFORM_WEB) || defined(PLATFORM_ANDROID)
+      "#version 100\n"
+      "precision mediump float;\n"
+      "varying vec2 fragTexCoord;\n"
+      "varying vec4 fragColor;\n"
+      "#define TEXTURE texture2D\n"
+      "#define OUT_COLOR gl_FragColor\n"
+#else
+      "#version 330\n"
+      "in vec2 fragTexCoord;\n"
+      "in vec4 fragColor;\n"
+      "out vec4 finalColor;\n"
+      "#define TEXTURE texture\n"
+      "#define OUT_COLOR finalColor\n"
+#endif
+      "uniform sampler2D texture0;\n" // Cell codes
+      "uniform vec4 palette[9];\n"
+      "uniform vec4 background;\n"
+      "uniform vec4 grid;\n"
+      "uniform vec4 border;\n"
+      "uniform vec2 boardSize;\n" // Pixels
+      "uniform float ghostAlpha;\n"
+      "void main() {\n"
+      "  vec2 px = fragTexCoord * boardSize;\n"
+      "  vec2 cellPx = boardSize / vec2(10.0, 20.0);\n"
+      "  vec2 inCell = mod(px, cellPx);\n"
+      "  bool inset = inCell.x >= 1.0 && inCell.y >= 1.0 &&\n"
+      "               inCell.x < cellPx.x - 1.0 && inCell.y < cellPx.y - 1.0;\n"
+      "  float code = floor(TEXTURE(texture0, fragTexCoord).r * 255.0 + 0.5);\n"
+      "  float layer = floor(code / 16.0);\n"
+      "  float slot = code - layer * 16.0;\n"
+      "  vec4 block = palette[0];\n"
+      "  for (int i = 1; i < 9; i++)\n"
+      "    if (float(i) == slot) block = palette[i];\n"
+      "  vec4 color = background;\n"
+      "  if (slot == 0.0) {\n"
+      "    if (!inset) color.rgb = mix(background.rgb, grid.rgb, grid.a);\n"
+      "  } else if (inset) {\n"
+      "    color = layer == 2.0\n"
+      "        ? vec4(mix(background.rgb, block.rgb, ghostAlpha), 1.0)\n"
+      "        : block;\n"
+      "  }\n"
+      "  if (px.x < 1.0 || px.y < 1.0 || px.x >= boardSize.x - 1.0 ||\n"
+      "      px.y >= boardSize.y - 1.0)\n"
+      "    color = border;\n"
+      "  OUT_COLOR = color * fragColor;\n"
+      "}\n";
+
+  BoardPalette palette;
+  Slot slots[MAX_BOARDS];
+  bool loaded = false;
+  bool useShader = false;
+  bool uniformsDirty = true;
+  int uniformCellSize = 0;
+
+  Shader shader = {};
+  int paletteLoc = -1;
+  int backgroundLoc = -1;
+  int gridLoc = -1;
+  int borderLoc = -1;
+  int boardSizeLoc = -1;
+  int ghostAlphaLoc = -1;
+};
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef CATCH_UP_H
+#define CATCH_UP_H
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+// Recovery after the client fell behind: a backgrounded browser tab (where
+// requestAnimationFrame is throttled to ~1 Hz or paused), a long GC or a
+// debugger stop. Two things go wrong without it:
+//  - timers see one huge GetFrameTime() (DAS repeats dozens of times),
+//  - hundreds of queued remote messages are replayed at live pace, or all
+//    at once in a single multi-hundred-millisecond frame.
+// Frame times are clamped, and a large backlog is drained within a fixed
+// time budget per frame until it is gone. Then live timing resumes.
+class CatchUp {
+public:
+  struct Config {
+    float maxFrameTime = 0.1f;    // Longest step fed to gameplay timers
+    float stallFrameTime = 0.25f; // A frame this long means we were suspended
+    size_t backlogThreshold = 64; // Or this many messages are waiting
+    double budgetMs = 4.0;        // Backlog work per frame (~1/4 of 60 Hz)
+  };
+
+  CatchUp() : CatchUp(Config()) {}
+  explicit CatchUp(const Config &config) : config(config) {}
+
+  // Once per frame, before anything reads the frame time. Returns the
+  // clamped frame time.
+  float BeginFrame(float rawFrameTime) {
+    stalled = rawFrameTime >= config.stallFrameTime;
+    return rawFrameTime > config.maxFrameTime ? config.maxFrameTime
+                                              : rawFrameTime;
+  }
+
+  // Enters catch-up when the backlog is large or the last frame stalled.
+  // Returns true while catching up.
+  bool Update(size_t backlog) {
+    if (!active && backlog > 0 &&
+        (stalled || backlog >= config.backlogThreshold)) {
+      active = true;
+      startBacklog = backlog;
+      startTime = Clock::now();
+      frames = 0;
+    }
+    return active;
+  }
+
+  // Hands queued items to apply(item), oldest first. Live: everything.
+  // Catching up: until the frame's budget is spent; catch-up ends when
+  // the queue is empty. Stops and returns false when apply() does.
+  template <typename Q, typename F> bool Drain(Q &queue, F &&apply) {
+    Clock::time_point start = Clock::now();
+    int sinceCheck = 0;
+    if (active)
+      frames++;
+    while (!queue.empty()) {
+      // Reading the clock costs about as much as applying an input
+      if (active && ++sinceCheck >= CHECK_INTERVAL) {
+        sinceCheck = 0;
+        if (ElapsedMs(start) >= config.budgetMs)
+          return true;
+      }
+      typename Q::value_type item = std::move(queue.front());
+      queue.pop_front();
+      if (!apply(item)) {
+        End();
+        return false;
+      }
+    }
+    End();
+    return true;
+  }
+
+  bool IsActive() const { return active; }
+  int GetFrames() const { return frames; } // Of the current/last catch-up
+  size_t GetStartBacklog() const { return startBacklog; }
+  double GetDurationMs() const { return durationMs; } // Of the last catch-up
+
+private:
+  typedef std::chrono::steady_clock Clock;
+  static const int CHECK_INTERVAL = 8;
+
+  static double ElapsedMs(Clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - since)
+        .count();
+  }
+
+  void End() {
+    if (!active)
+      return;
+    active = false;
+    durationMs = ElapsedMs(startTime);
+  }
+
+  Config config;
+  bool stalled = false;
+  bool active = false;
+  size_t startBacklog = 0;
+  int frames = 0;
+  Clock::time_point startTime;
+  double durationMs = 0.0;
+};
+
+#endif
@@ -0,0 +1,16 @@
+// Global operator new, counted for the metrics endpoint
+// (tetris_allocations_total). Linked into the desktop game and the load
+// generator; a translation unit of its own so no caller ever sees the
+// replacement inline next to a matching delete.
+#include "metrics.h"
+#include <cstdlib>
+#include <new>
+
+void *operator new(size_t size) {
+  Metrics::Get().CountAllocation();
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
@@ -0,0 +1,151 @@
+#ifndef DESYNC_DETECTOR_H
+#define DESYNC_DETECTOR_H
+
+#include "logic.h"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Compares the local mirror of the remote player (logicPlayer2) against the
+// state hashes the remote peer reports for its own board (logicPlayer1).
+//
+// Both sides count steps the same way (one step per Move/Rotate/Tick, see
+// Logic::stepCounter), so a reported (step, hash) pair can be checked against
+// Logic::GetStepHash(step) without re-simulating. Reports are sent every
+// `interval` steps; on a mismatch the per-step hashes of the unverified range
+// are requested so the first divergent step can be pinpointed.
+class DesyncDetector {
+public:
+  enum class Result {
+    MATCH,    // Mirror agrees with the remote peer at that step
+    MISMATCH, // Mirror has diverged somewhere after lastVerifiedStep
+    UNKNOWN   // Step not reached yet or already out of the history ring
+  };
+
+  explicit DesyncDetector(int interval = 30) : interval(interval) {}
+
+  void Reset() {
+    lastReportedStep = 0;
+    lastVerifiedStep = 0;
+    mismatchStep = -1;
+    divergenceStep = -1;
+    desyncCount = 0;
+  }
+
+  // Sender side: true when the local board advanced at least `interval`
+  // steps since the last report. Call once per frame.
+  bool ShouldReport(const Logic &local) {
+    if (local.stepCounter - lastReportedStep < interval)
+      return false;
+    lastReportedStep = local.stepCounter;
+    return true;
+  }
+
+  // Receiver side: check a remote report against the mirror's history.
+  Result CheckRemote(const Logic &mirror, int step, uint64_t remoteHash) {
+    uint64_t localHash = mirror.GetStepHash(step);
+    if (localHash == 0)
+      return Result::UNKNOWN;
+    if (localHash == remoteHash) {
+      if (step > lastVerifiedStep)
+        lastVerifiedStep = step;
+      return Result::MATCH;
+    }
+    if (mismatchStep < 0) {
+      mismatchStep = step;
+      desyncCount++;
+    }
+    return Result::MISMATCH;
+  }
+
+  // Given the remote's per-step hashes starting at fromStep, return the first
+  // step at which the mirror disagrees (-1 if none can be found).
+  int FindDivergence(const Logic &mirror, int fromStep,
+                     const std::vector<uint64_t> &remoteHashes) {
+    for (size_t i = 0; i < remoteHashes.size(); i++) {
+      int step = fromStep + (int)i;
+      uint64_t localHash = mirror.GetStepHash(step);
+      if (localHash != 0 && localHash != remoteHashes[i]) {
+        divergenceStep = step;
+        return step;
+      }
+    }
+    return -1;
+  }
+
+  // Mirror was overwritten by a full resync; start verifying from there.
+  void OnResynced(int step) {
+    lastVerifiedStep = step;
+    mismatchStep = -1;
+  }
+
+  bool IsResyncPending() const { return mismatchStep >= 0; }
+  int GetLastVerifiedStep() const { return lastVerifiedStep; }
+  int GetMismatchStep() const { return mismatchStep; }
+  int GetDivergenceStep() const { return divergenceStep; }
+  int GetDesyncCount() const { return desyncCount; }
+  int GetInterval() const { return interval; }
+
+  // Collect per-step hashes and input codes of `logic` for [fromStep, toStep]
+  // to answer a HASH_HISTORY_REQ. The range comes from the peer: a reversed
+  // one or one wider than the ring is refused (false, nothing collected),
+  // and fromStep is moved up to the oldest step the ring still holds.
+  static bool CollectHistory(const Logic &logic, int &fromStep, int toStep,
+                             std::vector<uint64_t> &outHashes,
+                             std::string &outInputs) {
+    outHashes.clear();
+    outInputs.clear();
+    if (fromStep > toStep ||
+        (int64_t)toStep - fromStep >= Logic::STEP_HISTORY)
+      return false;
+    int oldest = std::max(1, logic.stepCounter - Logic::STEP_HISTORY + 1);
+    if (fromStep < oldest)
+      fromStep = oldest;
+    if (toStep > logic.stepCounter)
+      toStep = logic.stepCounter;
+    for (int step = fromStep; step <= toStep; step++) {
+      outHashes.push_back(logic.GetStepHash(step));
+      char input = logic.GetStepInput(step);
+      outInputs += input ? input : '?';
+    }
+    return true;
+  }
+
+  // Human-readable dump of a Logic state plus its recent input history.
+  static std::string DumpState(const Logic &logic, int fromStep, int toStep) {
+    std::string out;
+    out += "step=" + std::to_string(logic.stepCounter) +
+           " score=" + std::to_string(logic.score) +
+           " cur=" + std::to_string((int)logic.currentPiece.type) + "@" +
+           std::to_string(logic.currentPiece.x) + "," +
+           std::to_string(logic.currentPiece.y) + "r" +
+           std::to_string(logic.currentPiece.rotation) +
+           " next=" + std::to_string((int)logic.nextPiece.type) + "\n";
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        int cell = logic.board.GetCell(r, c);
+        out += cell == 0 ? '.' : (char)('0' + cell);
+      }
+      out += "\n";
+    }
+    out += "inputs[" + std::to_string(fromStep) + ".." +
+           std::to_string(toStep) + "]=";
+    for (int step = fromStep; step <= toStep; step++) {
+      char input = logic.GetStepInput(step);
+      out += input ? input : '?';
+    }
+    out += "\n";
+    return out;
+  }
+
+private:
+  int interval;
+  int lastReportedStep = 0;
+  int lastVerifiedStep = 0;
+  int mismatchStep = -1;   // Step of the failing report, -1 when in sync
+  int divergenceStep = -1; // First divergent step once pinpointed
+  int desyncCount = 0;
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef EFFECTS_H
+#define EFFECTS_H
+
+#include "board_cells.h"
+#include "logic.h"
+#include "particle_pool.h"
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Line-clear and lock effects of the boards on screen. Observe() each
+// board once per frame: a lock the board made since the last call spawns
+// particles, in screen pixels, from the cells it placed or cleared. The
+// style is the hub's effectType ("explosion", "sparkle", "classic"); the
+// Nuxt client's EffectSystem.ts has the same ones, as DOM particles.
+// Drawing is effects_renderer.h.
+class Effects {
+public:
+  enum class Style { EXPLOSION, SPARKLE, CLASSIC };
+
+  static constexpr int MAX_BOARDS = 2;
+  static constexpr int MAX_FLASHES = 16;
+  static constexpr float FLASH_TIME = 0.3f;
+  // Particles per cleared cell and line: a Tetris bursts 4 x 10 x 64
+  static constexpr int PARTICLES_PER_CELL = 16;
+  static constexpr int LOCK_PARTICLES = 6; // Per placed block
+
+  // A cleared row lighting up, fading over FLASH_TIME
+  struct Flash {
+    float x, y, width, height;
+    float time;
+    uint32_t color;
+  };
+
+  static Style StyleFromName(std::string_view name) {
+    if (name == "sparkle")
+      return Style::SPARKLE;
+    if (name == "classic")
+      return Style::CLASSIC;
+    return Style::EXPLOSION; // Also the hub's default
+  }
+  static const char *StyleName(Style style) {
+    switch (style) {
+    case Style::SPARKLE:
+      return "sparkle";
+    case Style::CLASSIC:
+      return "classic";
+    default:
+      return "explosion";
+    }
+  }
+
+  explicit Effects(int capacity = ParticlePool::DEFAULT_CAPACITY)
+      : particles(capacity) {
+    for (int i = 0; i < BoardCells::PALETTE_SIZE; i++)
+      slotColors[i] = 0xffffffff;
+  }
+
+  void SetStyle(Style s) { style = s; }
+  Style GetStyle() const { return style; }
+  // Block colors by palette slot (BoardCells), 0xRRGGBBAA
+  void SetColors(const uint32_t *colors) {
+    memcpy(slotColors, colors, sizeof(slotColors));
+  }
+
+  // The board's top-left corner and cell size in pixels
+  void Observe(int board, const Logic &logic, float x, float y,
+               float cellSize) {
+    if (board < 0 || board >= MAX_BOARDS)
+      return;
+    int &seen = seenLocks[board];
+    if (logic.lockCounter == seen)
+      return;
+    bool fresh = logic.lockCounter > seen; // Else the logic was Reset()
+    seen = logic.lockCounter;
+    if (!fresh)
+      return;
+    if (style != Style::CLASSIC)
+      SpawnLock(logic.lastLock, x, y, cellSize);
+    SpawnClear(logic.lastLock, x, y, cellSize);
+  }
+
+  void Update(float dt) {
+    particles.Update(dt);
+    for (int i = 0; i < flashCount;) {
+      flashes[i].time -= dt;
+      if (flashes[i].time > 0)
+        i++;
+      else
+        flashes[i] = flashes[--flashCount];
+    }
+  }
+
+  // New game: drop everything, locks seen so far stay seen
+  void Clear() {
+    particles.Clear();
+    flashCount = 0;
+  }
+
+  bool Active() const { return particles.Count() > 0 || flashCount > 0; }
+  const ParticlePool &Particles() const { return particles; }
+  int FlashCount() const { return flashCount; }
+  const Flash &GetFlash(int i) const { return flashes[i]; }
+
+  // By lines cleared at once, as in EffectSystem.ts
+  static uint32_t LineColor(int lines) {
+    static const uint32_t colors[4] = {0x4dd0e1ff, 0x81c784ff, 0xffb74dff,
+                                       0xfff176ff};
+    return colors[(lines < 1 ? 1 : lines > 4 ? 4 : lines) - 1];
+  }
+
+private:
+  // A puff from the bottom of each placed block
+  void SpawnLock(const Logic::LockEvent &lock, float x, float y,
+                 float cell) {
+    uint32_t color = slotColors[BoardCells::Slot((int)lock.type)];
+    for (int b = 0; b < lock.blockCount; b++) {
+      float bx = x + lock.blockCols[b] * cell;
+      float by = y + (lock.blockRows[b] + 1) * cell;
+      for (int i = 0; i < LOCK_PARTICLES; i++)
+        particles.Spawn(bx + Random(0, cell), by, Random(-3, 3) * cell,
+                        Random(-2.5f, -0.5f) * cell, 8 * cell,
+                        Random(0.2f, 0.4f), Random(0.08f, 0.15f) * cell,
+                        color);
+    }
+  }
+
+  void SpawnClear(const Logic::LockEvent &lock, float x, float y,
+                  float cell) {
+    int lines = lock.linesCleared;
+    if (lines <= 0)
+      return;
+    uint32_t color = LineColor(lines);
+    int perCell = style == Style::CLASSIC ? 0 : PARTICLES_PER_CELL * lines;
+    for (int l = 0; l < lines && l < 4; l++) {
+      float rowY = y + lock.clearedRows[l] * cell;
+      AddFlash(x, rowY, BOARD_WIDTH * cell, cell, color);
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        float cx = x + c * cell;
+        for (int i = 0; i < perCell; i++) {
+          // Half the sparks white-hot, the rest in the line color
+          uint32_t spark = i & 1 ? color : 0xffffffff;
+          float px = cx + Random(0, cell), py = rowY + Random(0, cell);
+          if (style == Style::SPARKLE)
+            particles.Spawn(px, py, Random(-0.5f, 0.5f) * cell,
+                            Random(-4, -1) * cell, -1 * cell,
+                            Random(0.6f, 1.4f), Random(0.06f, 0.12f) * cell,
+                            spark);
+          else
+            particles.Spawn(px, py, Random(-10, 10) * cell,
+                            Random(-12, 4) * cell, 30 * cell,
+                            Random(0.5f, 1.1f), Random(0.08f, 0.2f) * cell,
+                            spark);
+        }
+      }
+    }
+  }
+
+  void AddFlash(float x, float y, float width, float height,
+                uint32_t color) {
+    if (flashCount == MAX_FLASHES)
+      return;
+    flashes[flashCount++] = {x, y, width, height, FLASH_TIME, color};
+  }
+
+  // xorshift32: cheap, and spawning thousands a frame must stay cheap
+  float Random(float lo, float hi) {
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return lo + (hi - lo) * (float)(rng >> 8) * (1.0f / 16777216.0f);
+  }
+
+  ParticlePool particles;
+  Flash flashes[MAX_FLASHES];
+  int flashCount = 0;
+  Style style = Style::EXPLOSION;
+  uint32_t slotColors[BoardCells::PALETTE_SIZE];
+  int seenLocks[MAX_BOARDS] = {};
+  uint32_t rng = 2463534242u;
+};
+
+#endif
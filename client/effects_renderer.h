@@ -0,0 +1,64 @@
+#ifndef EFFECTS_RENDERER_H
+#define EFFECTS_RENDERER_H
+
+#include "effects.h"
+#include "raylib.h"
+#include "rlgl.h"
+
+// Draws Effects: row flashes as rectangles, then every particle as a quad
+// appended straight to rlgl's batch with additive blending. All quads use
+// the default white texture, so thousands of particles are a few draw
+// calls, one per CHUNK quads that fit the batch.
+class EffectsRenderer {
+public:
+  static constexpr int CHUNK = 512; // Quads; well under the web batch
+
+  static void Draw(const Effects &effects) {
+    for (int i = 0; i < effects.FlashCount(); i++) {
+      const Effects::Flash &flash = effects.GetFlash(i);
+      DrawRectangleRec({flash.x, flash.y, flash.width, flash.height},
+                       Fade(ToColor(flash.color),
+                            0.8f * flash.time / Effects::FLASH_TIME));
+    }
+
+    const ParticlePool &pool = effects.Particles();
+    int count = pool.Count();
+    if (count == 0)
+      return;
+    const float *x = pool.X(), *y = pool.Y(), *size = pool.Size();
+    const uint32_t *color = pool.Color();
+    BeginBlendMode(BLEND_ADDITIVE);
+    rlSetTexture(rlGetTextureIdDefault());
+    for (int start = 0; start < count; start += CHUNK) {
+      int end = start + CHUNK < count ? start + CHUNK : count;
+      rlCheckRenderBatchLimit(4 * (end - start));
+      rlBegin(RL_QUADS);
+      rlNormal3f(0.0f, 0.0f, 1.0f);
+      rlTexCoord2f(0.5f, 0.5f);
+      for (int i = start; i < end; i++) {
+        uint32_t c = color[i];
+        float half = size[i] * 0.5f;
+        rlColor4ub(c >> 24, (c >> 16) & 0xff, (c >> 8) & 0xff,
+                   (unsigned char)((c & 0xff) * pool.Fraction(i)));
+        rlVertex2f(x[i] - half, y[i] - half);
+        rlVertex2f(x[i] - half, y[i] + half);
+        rlVertex2f(x[i] + half, y[i] + half);
+        rlVertex2f(x[i] + half, y[i] - half);
+      }
+      rlEnd();
+    }
+    rlSetTexture(0);
+    EndBlendMode();
+  }
+
+  static Color ToColor(uint32_t c) {
+    return {(unsigned char)(c >> 24), (unsigned char)((c >> 16) & 0xff),
+            (unsigned char)((c >> 8) & 0xff), (unsigned char)(c & 0xff)};
+  }
+  static uint32_t FromColor(Color c) {
+    return (uint32_t)c.r << 24 | (uint32_t)c.g << 16 | (uint32_t)c.b << 8 |
+           c.a;
+  }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Always-on record of the last CAPACITY network messages for post-mortems
+// ("it lagged", "the board jumped"). Each message costs one clock read, an
+// atomic increment and a 64-byte copy on the calling thread: no locks, no
+// allocation, no I/O. The ring is written to a file only when asked (on a
+// disconnect, a desync, or a key press) and read by tools/flightview.cpp,
+// which can line up the files of both peers.
+//
+// Any number of threads may record. A slot that is being overwritten while
+// the ring is dumped is skipped rather than written half-updated.
+class FlightRecorder {
+public:
+  enum Direction : uint8_t { IN = 0, OUT = 1, MARK = 2 };
+
+  static constexpr size_t CAPACITY = 4096;
+  static constexpr size_t PREVIEW = 48;
+
+  // Written to the file as-is (little-endian hosts)
+  struct Entry {
+    int64_t timeUs;     // Monotonic clock of the recording process
+    uint32_t size;      // Full message size (the preview may be shorter)
+    uint8_t direction;  // Direction
+    uint8_t type;       // NetworkMsgType; UNKNOWN for hub JSON and marks
+    uint8_t previewLen;
+    uint8_t reserved;
+    char preview[PREVIEW]; // Start of the message
+  };
+  static_assert(sizeof(Entry) == 64, "file format");
+
+  struct FileHeader {
+    char magic[4];   // "TBFR"
+    uint32_t version;
+    uint32_t entrySize;
+    uint32_t count;
+    int64_t monoUs;  // Monotonic clock when the file was written ...
+    int64_t wallUs;  // ... and the wall clock at that moment (Unix epoch)
+    char label[32];  // Who recorded: "host alice"
+    char reason[32]; // Why: "disconnect", "desync", "manual"
+  };
+  static_assert(sizeof(FileHeader) == 96, "file format");
+  static constexpr uint32_t VERSION = 1;
+
+  FlightRecorder() : slots(new Slot[CAPACITY]) {}
+  ~FlightRecorder() { delete[] slots; }
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  void Record(Direction direction, uint8_t type, const char *data,
+              size_t len) {
+    uint64_t ticket = next.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[ticket % CAPACITY];
+    // Odd sequence: being written. Readers skip it.
+    slot.seq.store(ticket * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Entry &e = slot.entry;
+    e.timeUs = NowUs();
+    e.size = (uint32_t)len;
+    e.direction = direction;
+    e.type = type;
+    e.previewLen = (uint8_t)(len < PREVIEW ? len : PREVIEW);
+    e.reserved = 0;
+    memcpy(e.preview, data, e.previewLen);
+    slot.seq.store(ticket * 2 + 2, std::memory_order_release);
+  }
+
+  // Annotation in the timeline ("desync step 120", "match start")
+  void Mark(const char *text) { Record(MARK, 0, text, strlen(text)); }
+
+  // Completed entries, oldest first
+  std::vector<Entry> Snapshot() const {
+    std::vector<Entry> out;
+    uint64_t end = next.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    out.reserve((size_t)(end - begin));
+    for (uint64_t ticket = begin; ticket < end; ticket++) {
+      const Slot &slot = slots[ticket % CAPACITY];
+      if (slot.seq.load(std::memory_order_acquire) != ticket * 2 + 2)
+        continue; // Still being written, or already reused
+      Entry copy = slot.entry;
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq.load(std::memory_order_relaxed) == ticket * 2 + 2)
+        out.push_back(copy);
+    }
+    return out;
+  }
+
+  uint64_t GetRecordedCount() const { return next.load(); }
+
+  bool WriteFile(const char *path, const char *label,
+                 const char *reason) const {
+    std::vector<Entry> entries = Snapshot();
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "TBFR", 4);
+    header.version = VERSION;
+    header.entrySize = sizeof(Entry);
+    header.count = (uint32_t)entries.size();
+    header.monoUs = NowUs();
+    header.wallUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::system_clock::now().time_since_epoch())
+                        .count();
+    strncpy(header.label, label, sizeof(header.label) - 1);
+    strncpy(header.reason, reason, sizeof(header.reason) - 1);
+
+    FILE *file = fopen(path, "wb");
+    if (!file)
+      return false;
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (entries.empty() ||
+               fwrite(entries.data(), sizeof(Entry), entries.size(), file) ==
+                   entries.size());
+    return fclose(file) == 0 && ok;
+  }
+
+  static bool ReadFile(const char *path, FileHeader &header,
+                       std::vector<Entry> &entries) {
+    FILE *file = fopen(path, "rb");
+    if (!file)
+      return false;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              memcmp(header.magic, "TBFR", 4) == 0 &&
+              header.version == VERSION && header.entrySize == sizeof(Entry);
+    if (ok) {
+      header.label[sizeof(header.label) - 1] = '\0';
+      header.reason[sizeof(header.reason) - 1] = '\0';
+      // A damaged count must not size the allocation: never more than
+      // the ring holds, nor than the rest of the file has room for
+      long start = ftell(file);
+      ok = start >= 0 && fseek(file, 0, SEEK_END) == 0;
+      long end = ok ? ftell(file) : -1;
+      ok = ok && end >= start && fseek(file, start, SEEK_SET) == 0 &&
+           header.count <= CAPACITY &&
+           header.count <= (unsigned long)(end - start) / sizeof(Entry);
+    }
+    if (ok) {
+      entries.resize(header.count);
+      ok = header.count == 0 ||
+           fread(entries.data(), sizeof(Entry), header.count, file) ==
+               header.count;
+    }
+    fclose(file);
+    return ok;
+  }
+
+  static int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> seq{0}; // 2 * ticket + 2 once complete
+    Entry entry;
+  };
+
+  Slot *slots; // 288 KiB: kept off the owner's footprint
+  std::atomic<uint64_t> next{0};
+};
+
+#endif
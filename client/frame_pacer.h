@@ -0,0 +1,123 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include "latency_histogram.h"
+#include "metrics.h"
+#include <algorithm>
+#include <cstdint>
+
+// Frame pacing for the desktop loop, which sleeps until WakeAt() (pumping
+// events, see input_capture.h) and then samples input, updates and draws.
+// Deadlines are one period apart, from the first frame submitted; a frame
+// that misses one re-anchors the cadence on its own submission.
+//  - By default frames start one period apart, like raylib's own timer:
+//    input is sampled right after the previous frame went out, and with
+//    vsync that is almost a full frame before this one shows.
+//  - Latency mode (TETRIS_LOW_LATENCY=1) starts it as late as possible: a
+//    little before its deadline, leaving room for the recent render cost
+//    (a high percentile of the last COST_WINDOW frames) plus a margin.
+//
+// Also measures input-to-photon latency, up to the frame's submission
+// (EndDrawing() returning): InputEvent() stamps each key or button change
+// when the loop sees it, and the first frame submitted after sampling it
+// records the delay in a histogram and the metrics.
+class FramePacer {
+public:
+  static constexpr int COST_WINDOW = 64;  // Frames
+  static constexpr double COST_QUANTILE = 0.9;
+  static constexpr int MAX_PENDING = 32; // Input events between frames
+
+  explicit FramePacer(double period = 1.0 / 60.0,
+                      Metrics &metrics = Metrics::Get())
+      : period(period), metrics(metrics) {}
+
+  void SetLateSampling(bool late) { lateSampling = late; }
+  void SetMargin(double seconds) { margin = seconds; }
+  double GetPeriod() const { return period; }
+
+  // When to sample input for the next frame; in the past when late
+  double WakeAt() const {
+    if (!lateSampling)
+      return nextStart;
+    return nextDeadline - RenderCost() - margin;
+  }
+
+  // Time from sampling input to the submitted frame, recent high quantile
+  double RenderCost() const {
+    if (costCount == 0)
+      return period / 2; // Unknown: leave half the frame
+    double sorted[COST_WINDOW];
+    std::copy(costs, costs + costCount, sorted);
+    int rank = (int)(COST_QUANTILE * (costCount - 1));
+    std::nth_element(sorted, sorted + rank, sorted + costCount);
+    return sorted[rank];
+  }
+
+  // A key or button changed state at time t (seconds, GetTime())
+  void InputEvent(double t) {
+    if (pendingCount == MAX_PENDING) { // Oldest ones go unmeasured
+      std::copy(pending + 1, pending + MAX_PENDING, pending);
+      pendingCount--;
+    }
+    pending[pendingCount++] = t;
+  }
+
+  // A frame was submitted at submitTime; its input was sampled at
+  // sampleTime. Events seen by then are shown by this frame.
+  void FrameSubmitted(double sampleTime, double submitTime) {
+    // Capped: a driver that forces vsync blocks in the swap, which would
+    // otherwise feed back into ever earlier wake-ups
+    costs[costNext] = std::min(submitTime - sampleTime, period);
+    costNext = (costNext + 1) % COST_WINDOW;
+    costCount = std::min(costCount + 1, COST_WINDOW);
+
+    int shown = 0;
+    while (shown < pendingCount && pending[shown] <= sampleTime) {
+      int64_t us = (int64_t)((submitTime - pending[shown]) * 1e6);
+      latency.Record(us);
+      metrics.Observe(Metrics::INPUT_LATENCY, us);
+      shown++;
+    }
+    std::copy(pending + shown, pending + pendingCount, pending);
+    pendingCount -= shown;
+
+    if (nextDeadline == 0 || submitTime > nextDeadline + period / 2) {
+      if (nextDeadline != 0 && !restarted)
+        missed++;
+      nextDeadline = submitTime + period;
+    } else {
+      nextDeadline += period;
+    }
+    if (nextStart == 0 || sampleTime > nextStart + period / 2)
+      nextStart = sampleTime + period;
+    else
+      nextStart += period;
+    restarted = false;
+  }
+
+  // An idle screen's pass: its frames are not paced, the next late one is
+  // not counted as missed
+  void Restart() { restarted = true; }
+
+  const LatencyHistogram &Latency() const { return latency; }
+  void ClearLatency() { latency.Clear(); }
+  uint64_t Missed() const { return missed; }
+
+private:
+  double period;
+  bool lateSampling = false;
+  double margin = 0.001;
+  Metrics &metrics;
+  double nextDeadline = 0; // 0 until the first frame
+  double nextStart = 0;    // Default mode: one period after the last one
+  bool restarted = false;
+  double costs[COST_WINDOW] = {};
+  int costNext = 0;
+  int costCount = 0;
+  double pending[MAX_PENDING] = {};
+  int pendingCount = 0;
+  LatencyHistogram latency;
+  uint64_t missed = 0;
+};
+
+#endif
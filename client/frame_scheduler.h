@@ -0,0 +1,116 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include "metrics.h"
+#include <cstdint>
+
+// Event-driven main loop for screens that do not animate (title, menus,
+// pause, game over). Each pass of the loop updates the game, then:
+//  - draws only if the screen animates or its frame key changed (text
+//    typed, a button hovered, a message arrived),
+//  - blocks for input or network events until the screen's next timer
+//    (the cursor blink), instead of spinning at the target frame rate.
+// While a screen animates (play, network sessions) every pass draws and
+// nothing blocks, so full rate resumes on the pass that starts play.
+//
+// Also charges wall and CPU time to the screen they were spent on, so the
+// idle screens' cost shows up in the metrics and the log.
+class FrameScheduler {
+public:
+  static constexpr double MAX_WAIT = 1.0; // Longest single block (s)
+
+  explicit FrameScheduler(Metrics &metrics = Metrics::Get())
+      : metrics(metrics) {}
+
+  // After the update: whether this pass must draw. frameKey covers what a
+  // non-animating screen's picture depends on.
+  bool ShouldDraw(bool animating, uint64_t frameKey) {
+    bool draw = animating || !hasKey || frameKey != lastKey;
+    lastKey = frameKey;
+    hasKey = true;
+    if (draw) {
+      // raylib measures frame time from one EndDrawing() to the next
+      staleFrameTime = idleSinceDraw;
+      idleSinceDraw = false;
+    } else {
+      idleSinceDraw = true;
+    }
+    drewThisPass = draw;
+    return draw;
+  }
+
+  // How long the loop may block for events: 0 while animating, otherwise
+  // until the next timer (seconds from now, negative for none)
+  double WaitTimeout(bool animating, double nextTimer) const {
+    if (animating)
+      return 0.0;
+    if (nextTimer < 0.0 || nextTimer > MAX_WAIT)
+      return MAX_WAIT;
+    return nextTimer;
+  }
+
+  // The loop blocked (or slept) after this pass
+  void Waited() { idleSinceDraw = true; }
+
+  // True when the last drawn frame's GetFrameTime() spans idle passes or
+  // waits; the game should step by its target frame time instead
+  bool FrameTimeStale() const { return staleFrameTime; }
+
+  struct Visit {
+    int screen = -1;
+    double seconds = 0;
+    double cpuSeconds = 0;
+    int drawn = 0;
+    int skipped = 0;
+  };
+
+  // Once per pass, at its end: the time since the previous call is charged
+  // to screen. Returns true when the screen changed; LastVisit() then
+  // holds the totals of the one left.
+  bool Account(int screen, double wallNow, double cpuNow) {
+    bool changed = false;
+    if (current.screen >= 0) {
+      double wall = wallNow - lastWall;
+      double cpu = cpuNow - lastCpu;
+      current.seconds += wall;
+      current.cpuSeconds += cpu;
+      metrics.Add(Metrics::SCREEN_WALL_US, (uint64_t)(wall * 1e6),
+                  current.screen);
+      metrics.Add(Metrics::SCREEN_CPU_US, (uint64_t)(cpu * 1e6),
+                  current.screen);
+    }
+    if (screen != current.screen) {
+      changed = current.screen >= 0;
+      last = current;
+      current = Visit();
+      current.screen = screen;
+    }
+    if (drewThisPass)
+      current.drawn++;
+    else
+      current.skipped++;
+    metrics.Add(drewThisPass ? Metrics::FRAMES_DRAWN : Metrics::FRAMES_IDLE,
+                1, screen);
+    lastWall = wallNow;
+    lastCpu = cpuNow;
+    return changed;
+  }
+
+  const Visit &LastVisit() const { return last; }
+  bool Drew() const { return drewThisPass; }
+
+private:
+  Metrics &metrics;
+  uint64_t lastKey = 0;
+  bool hasKey = false;
+  bool drewThisPass = true;
+  bool idleSinceDraw = false;
+  bool staleFrameTime = false;
+
+  Visit current;
+  Visit last;
+  double lastWall = 0;
+  double lastCpu = 0;
+};
+
+#endif
@@ -1,7 +1,12 @@
 #include "game.h"
+#include "hub_codec.h"        // Go hub JSON messages
 #include "network_protocol.h" // Include Protocol
 #include "raylib.h"           // For LoadFileText, SaveFileText
 #include <algorithm>          // Required for std::max
+#include <cmath>              // For std::fmod (cursor blink)
+#include <cstdio>             // For sscanf (resync parsing)
+#include <cstdlib>            // For getenv
+#include <ctime>              // For flight record file names
 #include <vector>             // Required for std::vector in max initialization
 
 // Placeholder for getting local IP address (implementation depends on
@@ -47,17 +52,164 @@ void Game::ConnectToHost(const std::string &ip) {
   TraceLog(LOG_INFO, "NETWORK: Attempting to connect to %s:%d", ip.c_str(),
            networkPort);
 
-  // NOTE: The current `networkManager.ConnectClient` is assumed to be a
-  // blocking call for simplicity. In a production application, especially
-  // for a UI-driven game, this should ideally be an asynchronous operation
-  // to prevent the UI from freezing during connection attempts.
-  if (networkManager.ConnectClient(ip, networkPort)) {
-    currentNetworkState = NetworkState::CONNECTED;
-    TraceLog(LOG_INFO, "NETWORK: Successfully connected to host.");
-  } else {
+  // Connecting runs in the background; ProcessNetworkEvents() moves us to
+  // CONNECTED or CONNECTION_FAILED once the attempts settle.
+  networkManager.SetConnectOptions();
+  if (!networkManager.ConnectClient(ip, networkPort)) {
     TraceLog(LOG_ERROR, "NETWORK: Failed to connect to host.");
     currentNetworkState = NetworkState::CONNECTION_FAILED;
-    networkErrorMessage = "Connection Failed: Check IP/Host";
+    networkErrorMessage = std::string("Connection Failed: ") +
+                          networkManager.GetConnectError();
+  }
+}
+
+// Join the Go hub's matchmaking pool (same pool as the Nuxt/TS clients)
+void Game::ConnectToHub(const std::string &ip) {
+  isHost = false;
+  currentIpAddress = ip;
+  TraceLog(LOG_INFO, "NETWORK: Connecting to matchmaking hub %s:%d",
+           ip.c_str(), hubPort);
+
+  currentNetworkState = NetworkState::CLIENT_CONNECTING;
+  networkManager.SetConnectOptions();
+  if (!networkManager.ConnectHub(ip, hubPort)) {
+    currentNetworkState = NetworkState::CONNECTION_FAILED;
+    networkErrorMessage = std::string("Hub Connection Failed: ") +
+                          networkManager.GetConnectError();
+  }
+}
+
+// Enter the hub's pool once the WebSocket is up
+void Game::SendHubJoin() {
+  char buffer[256];
+  HubJson::Writer writer(buffer, sizeof(buffer));
+  writer.BeginMessage("join_game")
+      .BeginObject()
+      .Key("name")
+      .String(playerName)
+      .Key("attackMode")
+      .String("garbage")
+      .Key("effectType")
+      .String(Effects::StyleName(effects.GetStyle()))
+      .EndObject()
+      .EndMessage();
+  if (writer.Ok()) {
+    networkManager.SendHubMessage(writer.Data(), writer.Size());
+  }
+}
+
+void Game::SendHubEvent(const char *type) {
+  char buffer[64];
+  HubJson::Writer writer(buffer, sizeof(buffer));
+  writer.BeginObject().Key("type").String(type).EndObject();
+  if (writer.Ok()) {
+    networkManager.SendHubMessage(writer.Data(), writer.Size());
+  }
+}
+
+// Same shape as the Nuxt client's broadcastState(): {grid, score}
+void Game::SendHubGameState() {
+  char buffer[1024];
+  HubJson::Writer writer(buffer, sizeof(buffer));
+  writer.BeginMessage("game_state").BeginObject().Key("grid").BeginArray();
+  for (int r = 0; r < BOARD_HEIGHT; r++) {
+    writer.BeginArray();
+    for (int c = 0; c < BOARD_WIDTH; c++) {
+      writer.Int(logicPlayer1.board.GetCell(r, c));
+    }
+    writer.EndArray();
+  }
+  writer.EndArray().Key("score").Int(logicPlayer1.score).EndObject();
+  writer.EndMessage();
+  if (writer.Ok()) {
+    networkManager.SendHubMessage(writer.Data(), writer.Size());
+  }
+}
+
+void Game::ProcessHubMessage(const std::string &json) {
+  HubJson::MessageView msg;
+  if (!HubJson::ParseMessage(json, msg)) {
+    TraceLog(LOG_WARNING, "NETWORK: Malformed hub message");
+    return;
+  }
+
+  switch (msg.type) {
+  case HubJson::MsgType::WAITING_FOR_OPPONENT:
+    TraceLog(LOG_INFO, "NETWORK: Waiting in matchmaking pool...");
+    break;
+
+  case HubJson::MsgType::GAME_START: {
+    std::string_view raw, value;
+    char text[64];
+    if (HubJson::FindMember(msg.payload, "opponentName", raw) &&
+        HubJson::AsString(raw, value)) {
+      HubJson::Unescape(value, text, sizeof(text));
+      remotePlayerName = text;
+    }
+    // Both natives in a room derive the same piece sequence from the matchId
+    uint32_t seed = 2166136261u; // FNV-1a
+    if (HubJson::FindMember(msg.payload, "matchId", raw) &&
+        HubJson::AsString(raw, value)) {
+      for (char ch : value) {
+        seed = (seed ^ (uint8_t)ch) * 16777619u;
+      }
+    }
+    TraceLog(LOG_INFO, "NETWORK: Hub match started vs %s",
+             remotePlayerName.c_str());
+    logicPlayer1.Reset((int)(seed & 0x7FFFFFFF));
+    logicPlayer2.Reset((int)(seed & 0x7FFFFFFF));
+    logicPlayer2.currentPiece = Piece(); // Remote board is state-only
+    gravityTimerP1 = 0.0f;
+    lastSpawnCounterP1 = logicPlayer1.spawnCounter;
+    waitForDownReleaseP1 = false;
+    player1IsDead = false;
+    player2IsDead = false;
+    winnerName = "";
+    currentMode = GameMode::TWO_PLAYER_NETWORK_CLIENT;
+    currentNetworkState = NetworkState::IN_GAME;
+    currentGameState = GameState::PLAYING;
+    break;
+  }
+
+  case HubJson::MsgType::GAME_STATE: {
+    std::string_view raw;
+    long long value;
+    if (HubJson::FindMember(msg.payload, "grid", raw)) {
+      HubJson::ArrayCursor rows(raw);
+      std::string_view row, cell;
+      for (int r = 0; r < BOARD_HEIGHT && rows.Next(row); r++) {
+        HubJson::ArrayCursor cells(row);
+        for (int c = 0; c < BOARD_WIDTH && cells.Next(cell); c++) {
+          if (HubJson::AsInt(cell, value)) {
+            logicPlayer2.board.SetCell(r, c, (int)value);
+          }
+        }
+      }
+    }
+    if (HubJson::FindMember(msg.payload, "score", raw) &&
+        HubJson::AsInt(raw, value)) {
+      logicPlayer2.score = (int)value;
+    }
+    logicPlayer2.RefreshStepHash();
+    break;
+  }
+
+  case HubJson::MsgType::GAME_OVER:
+    logicPlayer2.isGameOver = true;
+    break;
+
+  case HubJson::MsgType::PLAYER_LEFT:
+    TraceLog(LOG_INFO, "NETWORK: Opponent left the hub room.");
+    Disconnect();
+    currentNetworkState = NetworkState::CONNECTION_FAILED;
+    networkErrorMessage = "Opponent left the match.";
+    if (currentGameState == GameState::PLAYING) {
+      currentGameState = GameState::NETWORK_SETUP;
+    }
+    break;
+
+  default:
+    break; // room_status, attack, pause, resume: not supported natively yet
   }
 }
 
@@ -68,6 +220,14 @@ void Game::Disconnect() {
     networkManager.Stop();
   }
   isHost = false; // Reset host flag
+  hubMode = false;
+  session.End();
+  remoteInputBuffer.Reset();
+  pendingMessages.clear();
+  if (clientValidation) {
+    clientValidator.EndMatch(clientValidation);
+    clientValidation = 0;
+  }
   currentNetworkState = NetworkState::DISCONNECTED;
   currentIpAddress = "";
   remotePlayerName = "RemotePlayer"; // Reset to default
@@ -75,19 +235,62 @@ void Game::Disconnect() {
 
 // Send game events over the network
 void Game::SendGameEvent(const std::string &eventData) {
+  if (hubMode)
+    return; // Hub peers speak JSON (SendHubGameState), not our text protocol
   if (currentNetworkState == NetworkState::CONNECTED ||
       currentNetworkState == NetworkState::IN_GAME) {
     // TraceLog(LOG_INFO, "NETWORK: Sending event: %s", eventData.c_str());
-    networkManager.SendMessageStr(eventData);
+    if (NetworkProtocol::IsInput(eventData))
+      networkManager.SendMessageStr(
+          NetworkProtocol::WithStamp(eventData, NowMs()));
+    else
+      networkManager.SendMessageStr(eventData);
   }
 }
 
+bool Game::IsRemoteBoardMessage(NetworkMsgType type) {
+  return type == NetworkMsgType::MOVE_LR || type == NetworkMsgType::ROTATE ||
+         type == NetworkMsgType::MOVE_DOWN ||
+         type == NetworkMsgType::SYNC_STATE ||
+         type == NetworkMsgType::STATE_HASH;
+}
+
+void Game::FlushRemoteInputs() {
+  remoteInputBuffer.Flush(
+      [this](const NetworkMessage &netMsg) { ApplyNetworkMessage(netMsg); });
+}
+
 // Process incoming network events
 void Game::ProcessNetworkEvents() {
   // Update NetworkManager (Handling polling for non-threaded env like
   // Emscripten)
   networkManager.Update();
 
+  if (currentNetworkState == NetworkState::RECONNECTING) {
+    UpdateReconnect();
+    if (currentNetworkState != NetworkState::RECONNECTING &&
+        currentNetworkState != NetworkState::IN_GAME)
+      return; // Grace window ran out
+  }
+
+  // Background connect finished (client side)
+  if (currentNetworkState == NetworkState::CLIENT_CONNECTING) {
+    NetworkManager::ConnectStatus status = networkManager.GetConnectStatus();
+    if (status == NetworkManager::ConnectStatus::CONNECTED) {
+      currentNetworkState = NetworkState::CONNECTED;
+      TraceLog(LOG_INFO, "NETWORK: Successfully connected to %s.",
+               hubMode ? "hub" : "host");
+      if (hubMode)
+        SendHubJoin(); // CONNECTED now means: waiting for game_start
+    } else if (status == NetworkManager::ConnectStatus::FAILED) {
+      currentNetworkState = NetworkState::CONNECTION_FAILED;
+      networkErrorMessage = std::string(hubMode ? "Hub Connection Failed: "
+                                                : "Connection Failed: ") +
+                            networkManager.GetConnectError();
+      return;
+    }
+  }
+
   // Check for successful hosting connection
   if (currentNetworkState == NetworkState::HOSTING_WAITING &&
       networkManager.IsConnected()) {
@@ -98,11 +301,23 @@ void Game::ProcessNetworkEvents() {
   // Check for unexpected disconnection (but ignore if we are just waiting for a
   // host/client) If we THINK we are connected (CONNECTED or IN_GAME) but
   // manager says NO, then we lost connection.
+  bool linkSilent =
+      currentNetworkState == NetworkState::IN_GAME && session.HasSession() &&
+      networkManager.GetMillisSinceReceive() > linkSilenceTimeoutMs;
   if ((currentNetworkState == NetworkState::CONNECTED ||
        currentNetworkState == NetworkState::IN_GAME) &&
-      !networkManager.IsConnected()) {
+      (!networkManager.IsConnected() || linkSilent)) {
+
+    // Mid-match drops are resumed instead of ending the match
+    if (currentNetworkState == NetworkState::IN_GAME && session.HasSession() &&
+        (currentGameState == GameState::PLAYING ||
+         currentGameState == GameState::PAUSED)) {
+      BeginReconnect();
+      return;
+    }
 
     TraceLog(LOG_INFO, "NETWORK: Lost connection.");
+    DumpFlightRecord("disconnect", true);
     Disconnect(); // Clean up socket
     currentNetworkState = NetworkState::CONNECTION_FAILED;
     networkErrorMessage = "Connection Lost.";
@@ -112,129 +327,524 @@ void Game::ProcessNetworkEvents() {
     return;
   }
 
-  // Poll messages
-  std::vector<std::string> messages = networkManager.PollMessages();
-  for (const std::string &msg : messages) {
-    NetworkMessage netMsg = NetworkProtocol::Parse(msg);
-
-    switch (netMsg.type) {
-    case NetworkMsgType::GAME_START:
-      // Both seed and name might be in payload, assumed parsed into struct
-      // partially or we parse manually logic here For simplicity, let's assume
-      // Parse extracts seed to intParam1. We need to parse name manually from
-      // payload if needed, or update Parse. Let's rely on Parse for now
-      // roughly.
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
-        int seed = netMsg.intParam1;
-        // Reset P1 (Self) and P2 (Remote/Host) with same seed
-        TraceLog(LOG_INFO, "NETWORK: Received GAME_START with seed %d", seed);
-
-        // Reset Logic
-        logicPlayer1.Reset(seed);
-        logicPlayer2.Reset(seed);
-
-        // Reset Timers
-        gravityTimerP1 = 0.0f;
-        dasTimerP1 = 0.0f;
-        lastMoveDirP1 = 0;
-        waitForDownReleaseP1 = false;
+  // Keepalive (also while paused): lets the peer detect a dead link
+  if (currentNetworkState == NetworkState::IN_GAME && session.HasSession()) {
+    keepaliveTimer += Platform::Get().FrameTime();
+    if (keepaliveTimer >= keepaliveInterval) {
+      keepaliveTimer = 0.0f;
+      SendGameEvent(NetworkProtocol::SerializePing(NowUs()));
+    }
+  }
 
-        gravityTimerP2 = 0.0f; // P2 is remote, its gravity is driven by events
-        dasTimerP2 = 0.0f;
-        lastMoveDirP2 = 0; // P2 is remote
+  // Poll messages
+  int64_t nowMs = NowMs();
+  std::vector<std::string> polled = networkManager.PollMessages();
+  Metrics::Get().Set(Metrics::NETWORK_QUEUE, (int64_t)polled.size());
+  for (std::string &msg : polled)
+    pendingMessages.push_back(std::move(msg));
+
+  bool wasCatchingUp = catchUp.IsActive();
+  bool catchingUp = catchUp.Update(pendingMessages.size());
+  if (catchingUp && !wasCatchingUp) {
+    TraceLog(LOG_INFO, "NETWORK: Catching up on %d queued messages.",
+             (int)pendingMessages.size());
+    FlushRemoteInputs(); // Their timing is stale as well
+  }
+  bool keep = catchUp.Drain(pendingMessages, [&](const std::string &msg) {
+    return HandlePolledMessage(msg, nowMs, catchingUp);
+  });
+  if (!keep) {
+    pendingMessages.clear(); // Remaining messages must be dropped
+    return;
+  }
+  if (catchingUp) {
+    if (!catchUp.IsActive()) {
+      TraceLog(LOG_INFO, "NETWORK: Caught up in %d frames (%.0f ms).",
+               catchUp.GetFrames(), catchUp.GetDurationMs());
+      remoteInputBuffer.Reset(); // Relearn live timing from here
+    }
+    return;
+  }
+  remoteInputBuffer.Release(nowMs, [this](const NetworkMessage &netMsg) {
+    ApplyNetworkMessage(netMsg);
+  });
+}
 
-        // Extract Host Name if possible (Simple parsing from string for now if
-        // struct inadequate) "GAME_START_HOST;SEED:123;P1_NAME:Bob"
-        std::string prefix = "P1_NAME:";
-        size_t pos = msg.find(prefix);
-        if (pos != std::string::npos) {
-          remotePlayerName = msg.substr(pos + prefix.length());
-        }
+// Returns false when the remaining queued messages must be dropped
+bool Game::HandlePolledMessage(const std::string &msg, int64_t nowMs,
+                               bool catchingUp) {
+  if (hubMode) {
+    ProcessHubMessage(msg);
+    return true;
+  }
+  NetworkMessage netMsg = NetworkProtocol::Parse(msg);
+  if (catchingUp)
+    return ApplyNetworkMessage(netMsg); // Headless: no playout pacing
+  if (IsRemoteBoardMessage(netMsg.type)) {
+    remoteInputBuffer.Push(netMsg.stampMs, nowMs, std::move(netMsg));
+    return true;
+  }
+  FlushRemoteInputs(); // Must not overtake the board stream
+  return ApplyNetworkMessage(netMsg);
+}
 
-        currentNetworkState = NetworkState::IN_GAME;
-        currentGameState = GameState::PLAYING;
+// Returns false when the remaining messages of this poll must be dropped
+bool Game::ApplyNetworkMessage(const NetworkMessage &netMsg) {
+  const std::string &msg = netMsg.payload;
+  if (clientValidation)
+    ValidateClientMessage(netMsg);
+  switch (netMsg.type) {
+  case NetworkMsgType::GAME_START:
+    // Both seed and name might be in payload, assumed parsed into struct
+    // partially or we parse manually logic here For simplicity, let's assume
+    // Parse extracts seed to intParam1. We need to parse name manually from
+    // payload if needed, or update Parse. Let's rely on Parse for now
+    // roughly.
+    if (currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+      int seed = netMsg.intParam1;
+      // Reset P1 (Self) and P2 (Remote/Host) with same seed
+      TraceLog(LOG_INFO, "NETWORK: Received GAME_START with seed %d", seed);
+      networkManager.GetRecorder().Mark(
+          TextFormat("match start, seed %d", seed));
+
+      // Reset Logic
+      logicPlayer1.Reset(seed);
+      logicPlayer2.Reset(seed);
+      desyncDetector.Reset();
+      remoteInputBuffer.Reset();
+      session.Begin(netMsg.hashParam); // 0 (older host): no resume
+      keepaliveTimer = 0.0f;
+
+      // Reset Timers
+      gravityTimerP1 = 0.0f;
+      waitForDownReleaseP1 = false;
+
+      gravityTimerP2 = 0.0f; // P2 is remote, its gravity is driven by events
+
+      // Extract Host Name if possible (Simple parsing from string for now if
+      // struct inadequate) "GAME_START_HOST;SEED:123;P1_NAME:Bob"
+      std::string prefix = "P1_NAME:";
+      size_t pos = msg.find(prefix);
+      if (pos != std::string::npos) {
+        remotePlayerName = msg.substr(pos + prefix.length());
       }
-      break;
 
-    case NetworkMsgType::MOVE_LR:
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-          currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
-        logicPlayer2.Move(netMsg.intParam1, 0);
-      }
-      break;
+      currentNetworkState = NetworkState::IN_GAME;
+      currentGameState = GameState::PLAYING;
+    }
+    break;
 
-    case NetworkMsgType::ROTATE:
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-          currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
-        logicPlayer2.Rotate();
-      }
-      break;
+  case NetworkMsgType::MOVE_LR:
+    if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
+        currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+      logicPlayer2.Move(netMsg.intParam1, 0);
+    }
+    break;
 
-    case NetworkMsgType::MOVE_DOWN:
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-          currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+  case NetworkMsgType::ROTATE:
+    if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
+        currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+      logicPlayer2.Rotate();
+    }
+    break;
+
+  case NetworkMsgType::MOVE_DOWN:
+    if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
+        currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+      if (netMsg.intParam1)
+        logicPlayer2.Move(0, 1); // Soft drop
+      else
         logicPlayer2.Tick();
-      }
-      break;
+    }
+    break;
 
-    case NetworkMsgType::SYNC_STATE: {
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-          currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+  case NetworkMsgType::SYNC_STATE: {
+    if (clientValidation && CheckClientValidation())
+      break; // Keep the mirror driven by the client's inputs only
+    if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
+        currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
 
-        // Parse SCORE
-        size_t scorePos = netMsg.payload.find("SCORE:");
-        if (scorePos != std::string::npos) {
-          try {
-            logicPlayer2.score = std::stoi(netMsg.payload.substr(scorePos + 6));
-          } catch (...) {
-          }
+      // Full resync (answer to HASH_HISTORY_REQ): also STEP and CUR piece.
+      // Checked first: a bad one drops the whole message.
+      size_t stepPos = netMsg.payload.find("STEP:");
+      size_t curPos = netMsg.payload.find("CUR:");
+      bool resync = stepPos != std::string::npos && curPos != std::string::npos;
+      int step = 0, curType = 0, curX = 0, curY = 0, curRot = 0;
+      if (resync &&
+          (sscanf(netMsg.payload.c_str() + stepPos, "STEP:%d", &step) != 1 ||
+           sscanf(netMsg.payload.c_str() + curPos, "CUR:%d,%d,%d,%d",
+                  &curType, &curX, &curY, &curRot) != 4 ||
+           step < 0 || curType < (int)PieceType::I ||
+           curType > (int)PieceType::L || curRot < 0 || curRot > 3)) {
+        TraceLog(LOG_WARNING, "DESYNC: Ignored malformed resync state");
+        break;
+      }
+
+      // Parse SCORE
+      size_t scorePos = netMsg.payload.find("SCORE:");
+      if (scorePos != std::string::npos) {
+        try {
+          logicPlayer2.score = std::stoi(netMsg.payload.substr(scorePos + 6));
+        } catch (...) {
         }
+      }
 
-        // Parse NEXT
-        size_t nextPos = netMsg.payload.find("NEXT:");
-        if (nextPos != std::string::npos) {
-          try {
-            int nextType = std::stoi(netMsg.payload.substr(nextPos + 5));
-            logicPlayer2.nextPiece = Piece(static_cast<PieceType>(nextType));
-          } catch (...) {
-          }
+      // Parse NEXT
+      size_t nextPos = netMsg.payload.find("NEXT:");
+      if (nextPos != std::string::npos) {
+        try {
+          int nextType = std::stoi(netMsg.payload.substr(nextPos + 5));
+          logicPlayer2.nextPiece = Piece(static_cast<PieceType>(nextType));
+        } catch (...) {
         }
+      }
 
-        // Parse BOARD
-        size_t boardPos = netMsg.payload.find("BOARD:");
-        if (boardPos != std::string::npos) {
-          std::string boardData = netMsg.payload.substr(boardPos + 6);
-          int idx = 0;
-          for (int r = 0; r < BOARD_HEIGHT; r++) {
-            for (int c = 0; c < BOARD_WIDTH; c++) {
-              if (idx < (int)boardData.length()) {
-                int cellVal = boardData[idx] - '0';
-                logicPlayer2.board.SetCell(r, c, cellVal);
-                idx++;
-              }
+      // Parse BOARD
+      size_t boardPos = netMsg.payload.find("BOARD:");
+      if (boardPos != std::string::npos) {
+        std::string boardData = netMsg.payload.substr(boardPos + 6);
+        int idx = 0;
+        for (int r = 0; r < BOARD_HEIGHT; r++) {
+          for (int c = 0; c < BOARD_WIDTH; c++) {
+            if (idx < (int)boardData.length()) {
+              int cellVal = boardData[idx] - '0';
+              logicPlayer2.board.SetCell(r, c, cellVal);
+              idx++;
             }
           }
         }
       }
-      break;
+
+      if (resync) {
+        logicPlayer2.currentPiece =
+            Piece(static_cast<PieceType>(curType), curX, curY);
+        logicPlayer2.currentPiece.rotation = curRot;
+        // Hashes before the resync belong to the diverged timeline
+        logicPlayer2.RestartStepHistory(step);
+        desyncDetector.OnResynced(step);
+        TraceLog(LOG_INFO, "DESYNC: Resynced remote board at step %d", step);
+      } else {
+        logicPlayer2.RefreshStepHash();
+      }
     }
-      // Check for CLIENT_READY manually if not in enum
-      if (msg.find("CLIENT_READY") == 0) {
-        if (isHost) {
-          TraceLog(LOG_INFO, "NETWORK: Client is ready.");
-          // Parse Client Name
-          std::string prefix = "P2_NAME:";
-          size_t pos = msg.find(prefix);
-          if (pos != std::string::npos) {
-            remotePlayerName = msg.substr(pos + prefix.length());
-          }
-          // Host allows starting game now (Button active check is in
-          // Draw/Update)
+    break;
+  }
+
+  case NetworkMsgType::RESUME:
+    if (isHost && currentNetworkState == NetworkState::RECONNECTING) {
+      if (!session.Matches(netMsg.hashParam)) {
+        TraceLog(LOG_WARNING, "NETWORK: Rejected resume (wrong session).");
+        networkManager.SendMessageStr("RESUME_REJECT");
+        resumePeerSeen = false;
+        resumeListening = networkManager.StartHost(networkPort);
+        return false; // Remaining messages belong to the rejected peer
+      }
+      networkManager.SendMessageStr(
+          NetworkProtocol::SerializeResumeOk(logicPlayer2.stepCounter));
+      FinishResume(netMsg.intParam1);
+    }
+    break;
+
+  case NetworkMsgType::RESUME_OK:
+    if (!isHost && currentNetworkState == NetworkState::RECONNECTING) {
+      FinishResume(netMsg.intParam1);
+    }
+    break;
+
+  case NetworkMsgType::RESUME_REJECT:
+    if (currentNetworkState == NetworkState::RECONNECTING) {
+      Disconnect();
+      currentNetworkState = NetworkState::CONNECTION_FAILED;
+      networkErrorMessage = "Session expired.";
+      currentGameState = GameState::NETWORK_SETUP;
+      return false;
+    }
+    break;
+
+  case NetworkMsgType::INPUTS:
+    if (currentNetworkState == NetworkState::IN_GAME) {
+      int applied = SessionResume::ApplyInputs(logicPlayer2, netMsg.intParam1,
+                                               netMsg.strParam1);
+      if (applied < 0) {
+        TraceLog(LOG_WARNING, "NETWORK: Catch-up gap (mirror at %d, from %d)",
+                 logicPlayer2.stepCounter, netMsg.intParam1);
+      }
+    }
+    break;
+
+  case NetworkMsgType::PING:
+    // Receiving it refreshed the silence timer. Stamped pings are echoed,
+    // and echoes of ours give the round trip for the metrics endpoint.
+    if (netMsg.intParam1)
+      Metrics::Get().Observe(Metrics::RTT, NowUs() - netMsg.stampMs);
+    else if (netMsg.stampMs >= 0)
+      SendGameEvent(NetworkProtocol::SerializePingEcho(netMsg.stampMs));
+    break;
+
+  case NetworkMsgType::STATE_HASH:
+    if (currentNetworkState == NetworkState::IN_GAME) {
+      HandleStateHash(netMsg);
+    }
+    break;
+
+  case NetworkMsgType::HASH_HISTORY_REQ:
+    if (currentNetworkState == NetworkState::IN_GAME) {
+      // Peer's mirror of our board diverged: send our per-step history so
+      // it can pinpoint the step, then a full state to resync from.
+      std::vector<uint64_t> hashes;
+      std::string inputs;
+      int fromStep = netMsg.intParam1;
+      if (!DesyncDetector::CollectHistory(logicPlayer1, fromStep,
+                                          netMsg.intParam2, hashes, inputs))
+        break; // Not a range we would ever ask for
+      SendGameEvent(
+          NetworkProtocol::SerializeHashHistory(fromStep, hashes, inputs));
+      SendResyncState();
+    }
+    break;
+
+  case NetworkMsgType::HASH_HISTORY:
+    if (currentNetworkState == NetworkState::IN_GAME) {
+      HandleHashHistory(netMsg);
+    }
+    break;
+    // Check for CLIENT_READY manually if not in enum
+    if (msg.find("CLIENT_READY") == 0) {
+      if (isHost) {
+        TraceLog(LOG_INFO, "NETWORK: Client is ready.");
+        // Parse Client Name
+        std::string prefix = "P2_NAME:";
+        size_t pos = msg.find(prefix);
+        if (pos != std::string::npos) {
+          remotePlayerName = msg.substr(pos + prefix.length());
         }
+        // Host allows starting game now (Button active check is in
+        // Draw/Update)
       }
+    }
+    break;
+  }
+  return true;
+}
+
+// Host: hand the client's inputs and claims to the validator's worker
+void Game::ValidateClientMessage(const NetworkMessage &netMsg) {
+  switch (netMsg.type) {
+  case NetworkMsgType::MOVE_LR:
+    clientValidator.Input(clientValidation, netMsg.intParam1 < 0 ? 'L' : 'R');
+    break;
+  case NetworkMsgType::ROTATE:
+    clientValidator.Input(clientValidation, 'U');
+    break;
+  case NetworkMsgType::MOVE_DOWN:
+    clientValidator.Input(clientValidation, netMsg.intParam1 ? 'D' : 'G');
+    break;
+  case NetworkMsgType::INPUTS:
+    clientValidator.Inputs(clientValidation, netMsg.intParam1,
+                           netMsg.strParam1);
+    break;
+  case NetworkMsgType::STATE_HASH:
+    clientValidator.ClaimHash(clientValidation, netMsg.intParam1,
+                              netMsg.hashParam);
+    break;
+  case NetworkMsgType::SYNC_STATE: {
+    int score = 0, step = -1;
+    size_t scorePos = netMsg.payload.find("SCORE:");
+    size_t stepPos = netMsg.payload.find("STEP:");
+    size_t boardPos = netMsg.payload.find("BOARD:");
+    if (scorePos == std::string::npos || boardPos == std::string::npos ||
+        sscanf(netMsg.payload.c_str() + scorePos, "SCORE:%d", &score) != 1)
       break;
+    if (stepPos != std::string::npos)
+      sscanf(netMsg.payload.c_str() + stepPos, "STEP:%d", &step);
+    clientValidator.ClaimState(clientValidation, step, score,
+                               netMsg.payload.substr(boardPos + 6));
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+// True once the client has been caught reporting a state its inputs do
+// not produce. Results arrive from the worker a few frames late at most.
+bool Game::CheckClientValidation() {
+  if (clientFlagged)
+    return true;
+  InputValidator::Status status = clientValidator.GetStatus(clientValidation);
+  if (!status.diverged)
+    return false;
+  clientFlagged = true;
+  TraceLog(LOG_WARNING,
+           "VALIDATION: Client report at step %d contradicts its inputs (%s); "
+           "ignoring its board and score from now on",
+           status.divergedStep, status.reason.c_str());
+  networkManager.GetRecorder().Mark(
+      TextFormat("client failed validation at step %d", status.divergedStep));
+  logicPlayer2.score = status.score;
+  return true;
+}
+
+std::string Game::BoardToString(const Logic &logic) const {
+  std::string boardStr = "";
+  for (int r = 0; r < BOARD_HEIGHT; r++) {
+    for (int c = 0; c < BOARD_WIDTH; c++) {
+      boardStr += std::to_string(logic.board.GetCell(r, c));
     }
   }
+  return boardStr;
+}
+
+// Send our full P1 state (board, score, pieces, step) so the peer's mirror
+// becomes identical to it.
+void Game::SendResyncState() {
+  const Piece &cur = logicPlayer1.currentPiece;
+  SendGameEvent(NetworkProtocol::SerializeResyncState(
+      logicPlayer1.score, (int)logicPlayer1.nextPiece.type,
+      BoardToString(logicPlayer1), logicPlayer1.stepCounter, (int)cur.type,
+      cur.x, cur.y, cur.rotation));
+}
+
+// Writes the last few thousand network messages next to the game for
+// tools/flightview. Automatic dumps are limited to one per 10 seconds.
+void Game::DumpFlightRecord(const char *reason, bool automatic) {
+  double now = Platform::Get().Time();
+  if (automatic && now - lastFlightDumpTime < 10.0)
+    return;
+  lastFlightDumpTime = now;
+  std::string path = TextFormat("flight-%s-%lld.tbfr", reason,
+                                (long long)time(nullptr));
+  std::string label =
+      std::string(isHost ? "host " : "client ") + playerName;
+  if (networkManager.GetRecorder().WriteFile(path.c_str(), label.c_str(),
+                                             reason))
+    TraceLog(LOG_INFO, "NETWORK: Flight record written to %s", path.c_str());
+  else
+    TraceLog(LOG_WARNING, "NETWORK: Could not write %s", path.c_str());
+}
+
+// The link dropped mid-match: keep playing locally and try to get the peer
+// back within the session's grace window.
+void Game::BeginReconnect() {
+  TraceLog(LOG_INFO, "NETWORK: Link lost mid-match, trying to resume...");
+  networkManager.GetRecorder().Mark("link lost");
+  DumpFlightRecord("disconnect", true);
+  networkManager.Stop();
+  session.OnDisconnected();
+  currentNetworkState = NetworkState::RECONNECTING;
+  resumeSent = false;
+  resumePeerSeen = false;
+  resumeListening = false;
+  if (!isHost) {
+    // Short attempts so a Wi-Fi handoff is bridged well under a second
+    networkManager.SetConnectOptions(1000, 3, 100);
+    networkManager.ConnectClient(currentIpAddress, networkPort);
+  }
+}
+
+void Game::UpdateReconnect() {
+  if (!session.Update(Platform::Get().FrameTime())) {
+    TraceLog(LOG_INFO, "NETWORK: Resume window expired.");
+    Disconnect();
+    currentNetworkState = NetworkState::CONNECTION_FAILED;
+    networkErrorMessage = "Connection Lost.";
+    currentGameState = GameState::NETWORK_SETUP;
+    return;
+  }
+
+  if (isHost) {
+    // Listen again on the game port; the client rejoins with RESUME
+    if (networkManager.IsConnected()) {
+      resumePeerSeen = true;
+    } else if (resumePeerSeen || !resumeListening) {
+      resumePeerSeen = false;
+      resumeListening = networkManager.StartHost(networkPort);
+    }
+    return;
+  }
+
+  NetworkManager::ConnectStatus status = networkManager.GetConnectStatus();
+  if (status == NetworkManager::ConnectStatus::CONNECTED &&
+      networkManager.IsConnected()) {
+    if (!resumeSent) {
+      // Tell the host which of its steps we already have
+      networkManager.SendMessageStr(NetworkProtocol::SerializeResume(
+          session.GetToken(), logicPlayer2.stepCounter));
+      resumeSent = true;
+    }
+  } else if (!networkManager.IsConnectPending()) {
+    resumeSent = false; // Attempts exhausted or link dropped again: retry
+    networkManager.ConnectClient(currentIpAddress, networkPort);
+  }
+}
+
+// Both sides exchanged acks: send the peer whatever of our board it missed
+// while the link was down, then carry on with live events.
+void Game::FinishResume(int peerAckStep) {
+  currentNetworkState = NetworkState::IN_GAME;
+  session.OnResumed();
+  keepaliveTimer = 0.0f;
+  TraceLog(LOG_INFO, "NETWORK: Match resumed after %.2fs (peer at step %d)",
+           session.GetLastResumeSeconds(), peerAckStep);
+  networkManager.GetRecorder().Mark(
+      TextFormat("resumed, peer at step %d", peerAckStep));
+
+  std::string inputs;
+  if (SessionResume::CollectInputs(logicPlayer1, peerAckStep, inputs)) {
+    if (!inputs.empty()) {
+      SendGameEvent(NetworkProtocol::SerializeInputs(peerAckStep + 1, inputs));
+    }
+  } else {
+    SendResyncState(); // Gap left the step ring: full snapshot instead
+  }
+  SendGameEvent(NetworkProtocol::SerializeStateHash(
+      logicPlayer1.stepCounter,
+      logicPlayer1.GetStepHash(logicPlayer1.stepCounter)));
+}
+
+void Game::HandleStateHash(const NetworkMessage &netMsg) {
+  bool alreadyPending = desyncDetector.IsResyncPending();
+  DesyncDetector::Result result =
+      desyncDetector.CheckRemote(logicPlayer2, netMsg.intParam1,
+                                 netMsg.hashParam);
+  if (result != DesyncDetector::Result::MISMATCH || alreadyPending)
+    return; // In sync, unverifiable, or a resync is already on its way
+
+  int lastGood = desyncDetector.GetLastVerifiedStep();
+  Metrics::Get().Add(Metrics::DESYNCS);
+  TraceLog(LOG_WARNING,
+           "DESYNC: Remote hash mismatch at step %d (last good step %d)",
+           netMsg.intParam1, lastGood);
+  networkManager.GetRecorder().Mark(
+      TextFormat("desync at step %d, good %d", netMsg.intParam1, lastGood));
+  DumpFlightRecord("desync", true);
+  // No more than the peer's ring holds, or the request is refused
+  int fromStep =
+      std::max(lastGood + 1, netMsg.intParam1 - Logic::STEP_HISTORY + 1);
+  SendGameEvent(
+      NetworkProtocol::SerializeHashHistoryReq(fromStep, netMsg.intParam1));
+}
+
+void Game::HandleHashHistory(const NetworkMessage &netMsg) {
+  std::vector<uint64_t> remoteHashes =
+      NetworkProtocol::ParseHashList(netMsg.payload);
+  int fromStep = netMsg.intParam1;
+  int toStep = fromStep + (int)remoteHashes.size() - 1;
+  int divergence =
+      desyncDetector.FindDivergence(logicPlayer2, fromStep, remoteHashes);
+
+  // Dump both sides for debugging: our mirror (state + applied inputs) and
+  // the inputs the remote peer says it applied over the same steps.
+  std::string dump = "DESYNC divergence step: " + std::to_string(divergence) +
+                     "\n--- local mirror of remote player ---\n" +
+                     DesyncDetector::DumpState(logicPlayer2, fromStep, toStep) +
+                     "--- remote peer ---\ninputs[" +
+                     std::to_string(fromStep) + ".." + std::to_string(toStep) +
+                     "]=" + netMsg.strParam1 + "\n";
+  TraceLog(LOG_WARNING, "DESYNC: Divergence pinpointed at step %d",
+           divergence);
+  std::string dumpFile = "desync_step" + std::to_string(divergence) + ".log";
+  SaveFileText(dumpFile.c_str(), const_cast<char *>(dump.c_str()));
 }
 
 Game::Game() {
@@ -245,6 +855,7 @@ Game::Game() {
   isHost = false;
   remotePlayerName = "Player2"; // Default for local or placeholder for network
   ipAddressInputBuffer = "127.0.0.1"; // Default IP for client connection
+  InputCapture::Install(&inputQueue);  // The window is open by now
 
   // Initialize new game over flags
   player1IsDead = false;
@@ -256,6 +867,51 @@ Game::Game() {
   // Initialize input buffer with the loaded name (or default "Player")
   playerNameInputBuffer = playerName;
 
+  // Network thread logging (async_log.h): TETRIS_LOG_FILE=path also writes
+  // it to a file, TETRIS_LOG_LEVEL=debug shows more (or warning, error).
+  const char *logFile = getenv("TETRIS_LOG_FILE");
+  const char *logLevel = getenv("TETRIS_LOG_LEVEL");
+  if (logFile || logLevel) {
+    AsyncLog::Config logConfig;
+    if (logFile)
+      logConfig.filePath = logFile;
+    if (logLevel) {
+      std::string level = logLevel;
+      logConfig.minLevel = level == "debug"     ? LOG_DEBUG
+                           : level == "warning" ? LOG_WARNING
+                           : level == "error"   ? LOG_ERROR
+                                                : LOG_INFO;
+    }
+    AsyncLog::Get().Configure(logConfig);
+  }
+
+#ifndef __EMSCRIPTEN__
+  // Prometheus metrics for hosts run in production (metrics_server.h):
+  // TETRIS_METRICS_PORT=9100 serves http://127.0.0.1:9100/metrics
+  const char *metricsPort = getenv("TETRIS_METRICS_PORT");
+  if (metricsPort && atoi(metricsPort) > 0)
+    metricsServer.Start(atoi(metricsPort));
+#endif
+
+  // Same-machine testing without the TCP stack: run both instances with
+  // TETRIS_TRANSPORT=shm (see transport.h). Unset or unknown keeps TCP.
+  const char *transportName = getenv("TETRIS_TRANSPORT");
+  TransportKind transportKind;
+  if (transportName && ParseTransportKind(transportName, transportKind)) {
+    networkManager.SetTransport(transportKind);
+    TraceLog(LOG_INFO, "NETWORK: Using %s transport", transportName);
+  }
+
+  // TETRIS_EFFECT=explosion (default), sparkle or classic (flash only)
+  const char *effectName = getenv("TETRIS_EFFECT");
+  if (effectName)
+    effects.SetStyle(Effects::StyleFromName(effectName));
+  uint32_t effectColors[BoardCells::PALETTE_SIZE];
+  for (int i = 0; i < BoardCells::PALETTE_SIZE; i++)
+    effectColors[i] =
+        EffectsRenderer::FromColor(boardRenderer.GetPalette().cells[i]);
+  effects.SetColors(effectColors);
+
   // Init Controls (Mobile UI) - Keep them below the boards
   int btnY = screenHeight - 80; // Place buttons near the bottom
   int btnSize = 80;
@@ -290,26 +946,33 @@ Game::Game() {
   int currentY = BOARD_OFFSET_Y + 320;
 
   // Calculate required button width based on text to prevent overflow
+  // (Platform: headless runs have no font to measure with)
   int btnTextFontSize = 30; // Matches the font size used in Draw()
-  int restartTextWidth = MeasureText("Restart", btnTextFontSize);
-  int pauseTextWidth = MeasureText("Pause", btnTextFontSize);
-  int changeNameTextWidth = MeasureText("Change Name", btnTextFontSize);
-  int singlePlayerTextWidth = MeasureText("1 Player", btnTextFontSize);
+  Platform &platform = Platform::Get();
+  int restartTextWidth = platform.TextWidth("Restart", btnTextFontSize);
+  int pauseTextWidth = platform.TextWidth("Pause", btnTextFontSize);
+  int changeNameTextWidth = platform.TextWidth("Change Name", btnTextFontSize);
+  int singlePlayerTextWidth = platform.TextWidth("1 Player", btnTextFontSize);
   int twoPlayerLocalTextWidth =
-      MeasureText("2 Player (Local)", btnTextFontSize);
+      platform.TextWidth("2 Player (Local)", btnTextFontSize);
   int twoPlayerNetworkTextWidth =
-      MeasureText("2 Player (Online)", btnTextFontSize);
-  int hostGameTextWidth = MeasureText("Host Game", btnTextFontSize);
-  int joinGameTextWidth = MeasureText("Join Game", btnTextFontSize);
-  int connectTextWidth = MeasureText("Connect", btnTextFontSize);
-  int startOnlineGameTextWidth = MeasureText("Start Online", btnTextFontSize);
+      platform.TextWidth("2 Player (Online)", btnTextFontSize);
+  int hostGameTextWidth = platform.TextWidth("Host Game", btnTextFontSize);
+  int joinGameTextWidth = platform.TextWidth("Join Game", btnTextFontSize);
+  int connectTextWidth = platform.TextWidth("Connect", btnTextFontSize);
+  int startOnlineGameTextWidth =
+      platform.TextWidth("Start Online", btnTextFontSize);
+  int matchmakingTextWidth = platform.TextWidth("Matchmaking", btnTextFontSize);
+  int battleRoyaleTextWidth =
+      platform.TextWidth("Battle Royale", btnTextFontSize);
 
   // Choose the maximum width and add padding (e.g., 40px total padding)
   int btnWidth =
       std::max({restartTextWidth, pauseTextWidth, changeNameTextWidth,
                 singlePlayerTextWidth, twoPlayerLocalTextWidth,
                 twoPlayerNetworkTextWidth, hostGameTextWidth, joinGameTextWidth,
-                connectTextWidth, startOnlineGameTextWidth}) +
+                connectTextWidth, startOnlineGameTextWidth,
+                matchmakingTextWidth, battleRoyaleTextWidth}) +
       40;
 
   int btnHeight = 40;
@@ -366,36 +1029,61 @@ Game::Game() {
       "2 Player (Online)",
       false};
 
-  // Initialize Network Setup Buttons (will be positioned dynamically in draw)
-  // For now, just allocate them.
-  btnHostGame = {
+  modeBtnY += btnHeight + btnVerticalGap;
+
+  btnBattleRoyale = {
       {(float)modeBtnX, (float)modeBtnY, (float)btnWidth, (float)btnHeight},
+      MAROON,
+      "Battle Royale",
+      false};
+
+  // Initialize Network Setup Buttons: a column in the middle, Connect
+  // (Cancel while connecting) below the IP keyboard. Placed here, not in
+  // Draw(), so they take clicks before anything is drawn (headless runs).
+  int netBtnY = screenHeight / 2 - btnHeight - btnVerticalGap;
+  btnHostGame = {
+      {(float)modeBtnX, (float)netBtnY, (float)btnWidth, (float)btnHeight},
       GREEN,
       "Host Game",
       false};
+  btnStartOnlineGame = {
+      {(float)modeBtnX, (float)netBtnY, (float)btnWidth, (float)btnHeight},
+      LIME,
+      "Start Online",
+      false};
+
+  netBtnY += btnHeight + btnVerticalGap;
+
   btnJoinGame = {
-      {(float)modeBtnX, (float)modeBtnY, (float)btnWidth, (float)btnHeight},
+      {(float)modeBtnX, (float)netBtnY, (float)btnWidth, (float)btnHeight},
       BLUE,
       "Join Game",
       false};
-  btnConnect = {
-      {(float)modeBtnX, (float)modeBtnY, (float)btnWidth, (float)btnHeight},
-      SKYBLUE,
-      "Connect",
-      false};
-  btnStartOnlineGame = {
-      {(float)modeBtnX, (float)modeBtnY, (float)btnWidth, (float)btnHeight},
-      LIME,
-      "Start Online",
+
+  netBtnY += btnHeight + btnVerticalGap;
+
+  btnMatchmaking = {
+      {(float)modeBtnX, (float)netBtnY, (float)btnWidth, (float)btnHeight},
+      ORANGE,
+      "Matchmaking",
       false};
+  btnConnect = {{(float)modeBtnX, (float)(screenHeight - 250 - 60),
+                 (float)btnWidth, (float)btnHeight},
+                SKYBLUE,
+                "Connect",
+                false};
 }
 
 Game::~Game() {
+  InputCapture::Uninstall();
   Disconnect(); // Ensure network resources are cleaned up on exit
 }
 
+// Headless runs neither read nor overwrite the player's saved name
 void Game::LoadPlayerName() {
-  char *fileText = LoadFileText(playerNameFilename);
+  char *fileText = Platform::Get().Headless()
+                       ? nullptr
+                       : LoadFileText(playerNameFilename);
   if (fileText != nullptr) {
     playerName = std::string(fileText);
     UnloadFileText(fileText);
@@ -412,6 +1100,8 @@ void Game::LoadPlayerName() {
 }
 
 void Game::SavePlayerName() {
+  if (Platform::Get().Headless())
+    return;
   SaveFileText(playerNameFilename, const_cast<char *>(playerName.c_str()));
 }
 
@@ -422,33 +1112,37 @@ void Game::ResetGame() {
 
   logicPlayer1.Reset(seed); // Resets board, score, and spawns a new piece
   gravityTimerP1 = 0.0f;
-  dasTimerP1 = 0.0f;
-  lastMoveDirP1 = 0;
   lastSpawnCounterP1 =
       logicPlayer1.spawnCounter; // Sync after logic.Reset() spawns a new piece
   waitForDownReleaseP1 = false;
   player1IsDead = false; // Reset dead status for P1
+  effects.Clear();
 
   if (currentMode == GameMode::TWO_PLAYER_LOCAL) {
     logicPlayer2.Reset(seed); // Use the same seed for Player 2
     gravityTimerP2 = 0.0f;
-    dasTimerP2 = 0.0f;
-    lastMoveDirP2 = 0;
     lastSpawnCounterP2 = logicPlayer2.spawnCounter;
     waitForDownReleaseP2 = false;
     player2IsDead = false; // Reset dead status for P2
   } else if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST) {
     // As host, reset both local and remote (will send initial state to client)
     logicPlayer2.Reset(seed);
+    desyncDetector.Reset();
+    remoteInputBuffer.Reset();
+    if (clientValidation)
+      clientValidator.EndMatch(clientValidation);
+    clientValidation = clientValidator.StartMatch(seed);
+    networkManager.GetRecorder().Mark(TextFormat("match start, seed %d", seed));
+    clientFlagged = false;
     gravityTimerP2 = 0.0f; // Reset for remote, but its updates will override
-    dasTimerP2 = 0.0f;
-    lastMoveDirP2 = 0;
     lastSpawnCounterP2 = logicPlayer2.spawnCounter;
     waitForDownReleaseP2 = false;
     player2IsDead = false; // Reset dead status for P2
-    // Placeholder: Send game start message with seed to client
-    SendGameEvent(TextFormat("GAME_START_HOST;SEED:%d;P1_NAME:%s", seed,
-                             playerName.c_str()));
+    // Send game start message with seed and the session token to client
+    session.Begin(SessionResume::NewToken());
+    keepaliveTimer = 0.0f;
+    SendGameEvent(NetworkProtocol::SerializeGameStart(seed, session.GetToken(),
+                                                      playerName));
     currentNetworkState = NetworkState::IN_GAME; // Host transitions to IN_GAME
   } else if (currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
     // As client, only reset P1. P2 will be reset when GAME_START_HOST message
@@ -460,6 +1154,9 @@ void Game::ResetGame() {
     // Client waits for host to send GAME_START_HOST message, which will trigger
     // logicPlayer2.Reset currentNetworkState remains CONNECTED until
     // GAME_START_HOST received, then transitions to IN_GAME
+  } else if (currentMode == GameMode::BATTLE_ROYALE_LOCAL) {
+    battleField.Reset(BATTLE_OPPONENTS, seed);
+    battlePlace = 0;
   }
 
   winnerName = ""; // Reset winner name
@@ -475,149 +1172,85 @@ void Game::ResetGame() {
 }
 
 // Helper function to handle input for a single player
-void Game::HandlePlayerInput(Logic &logic, int playerIndex, float dasDelay,
-                             float dasRate, float &dasTimer, int &lastMoveDir,
-                             int &lastSpawnCounter, bool &waitForDownRelease) {
-  // IMPORTANT: Do not process input if the player's game is over
-  if (logic.isGameOver) {
-    return;
+// Drains the input queue: each player's events, in the order they were
+// seen, become moves at the times they happened (input_queue.h)
+void Game::CollectInput() {
+  InputCapture::Sample(); // Gamepads, for builds whose loop does not pump
+  for (std::vector<InputOp> &ops : inputOps)
+    ops.clear();
+  InputEvent event;
+  while (inputQueue.Pop(event)) {
+    if (event.player < 2)
+      inputTimelines[event.player].Feed(event, inputOps[event.player]);
   }
+  double now = Platform::Get().Time();
+  for (int player = 0; player < 2; player++)
+    inputTimelines[player].Flush(now, inputOps[player]);
+}
 
-  // --- Soft Drop Safety Logic ---
-  // 1. Detect if a new piece has spawned since the last frame
-  if (logic.spawnCounter != lastSpawnCounter) {
-    lastSpawnCounter = logic.spawnCounter;
-    // If KEY_DOWN is currently held, activate the safety flag
-    if (((playerIndex == 1 && IsKeyDown(KEY_DOWN)) ||
-         (playerIndex == 2 && IsKeyDown(KEY_S))) &&
-        currentMode == GameMode::TWO_PLAYER_LOCAL) { // Only check for local P2
-      waitForDownRelease = true;
-    }
-    // For network P1, also check KEY_DOWN
-    if (playerIndex == 1 && IsKeyDown(KEY_DOWN)) {
-      waitForDownRelease = true;
-    }
-  }
-  // 2. If the safety flag is active, check if KEY_DOWN has been released
-  if (!(((playerIndex == 1 && IsKeyDown(KEY_DOWN)) ||
-         (playerIndex == 2 && IsKeyDown(KEY_S))) &&
-        currentMode == GameMode::TWO_PLAYER_LOCAL) && // Only check for local P2
-      !(playerIndex == 1 && IsKeyDown(KEY_DOWN))) {   // And P1
-    waitForDownRelease = false;
-  }
-  // --- End Soft Drop Safety Logic ---
-
-  // --- Keyboard Delayed Auto Shift (DAS) for LEFT/RIGHT movement ---
-  int currentKeyboardMoveDir = 0;
-  if (playerIndex == 1) { // Player 1 uses Arrow keys
-    if (IsKeyReleased(KEY_LEFT) && lastMoveDir == -1) {
-      dasTimer = 0.0f;
-      lastMoveDir = 0;
-    }
-    if (IsKeyReleased(KEY_RIGHT) && lastMoveDir == 1) {
-      dasTimer = 0.0f;
-      lastMoveDir = 0;
-    }
-
-    if (IsKeyDown(KEY_LEFT)) {
-      currentKeyboardMoveDir = -1;
-    }
-    if (IsKeyDown(KEY_RIGHT)) {
-      currentKeyboardMoveDir = 1;
-    }
-  } else { // Player 2 uses WASD (Only for local multiplayer)
-    if (IsKeyReleased(KEY_A) && lastMoveDir == -1) {
-      dasTimer = 0.0f;
-      lastMoveDir = 0;
-    }
-    if (IsKeyReleased(KEY_D) && lastMoveDir == 1) {
-      dasTimer = 0.0f;
-      lastMoveDir = 0;
+void Game::HandlePlayerInput(Logic &logic, int playerIndex,
+                             int &lastSpawnCounter, bool &waitForDownRelease) {
+  bool network = playerIndex == 1 &&
+                 (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
+                  currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT);
+  for (const InputOp &op : inputOps[playerIndex - 1]) {
+    // IMPORTANT: Do not process input if the player's game is over
+    if (logic.isGameOver) {
+      return;
     }
 
-    if (IsKeyDown(KEY_A)) {
-      currentKeyboardMoveDir = -1;
-    }
-    if (IsKeyDown(KEY_D)) {
-      currentKeyboardMoveDir = 1;
+    // Soft Drop Safety: a piece that spawned while the drop key was held
+    // waits for the next press of it
+    if (logic.spawnCounter != lastSpawnCounter) {
+      lastSpawnCounter = logic.spawnCounter;
+      waitForDownRelease = true;
     }
-  }
 
-  // Check for initial press or change in active DAS direction
-  if (currentKeyboardMoveDir != 0 && currentKeyboardMoveDir != lastMoveDir) {
-    logic.Move(currentKeyboardMoveDir, 0); // Initial move
-    if (playerIndex == 1 &&
-        (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-         currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT)) {
-      SendGameEvent(TextFormat("MOVE_LR;DIR:%d",
-                               currentKeyboardMoveDir)); // Send event for P1
-    }
-    dasTimer = 0.0f; // Reset timer
-    lastMoveDir = currentKeyboardMoveDir;
-  }
-  // If the same key is held down (DAS repeat)
-  else if (currentKeyboardMoveDir != 0 &&
-           currentKeyboardMoveDir == lastMoveDir) {
-    dasTimer += GetFrameTime();
-    while (dasTimer >= dasDelay) {
-      logic.Move(lastMoveDir, 0);
-      if (playerIndex == 1 &&
-          (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-           currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT)) {
-        SendGameEvent(
-            TextFormat("MOVE_LR;DIR:%d", lastMoveDir)); // Send event for P1
+    switch (op.action) {
+    case InputAction::LEFT:
+    case InputAction::RIGHT: {
+      int dir = op.action == InputAction::LEFT ? -1 : 1;
+      logic.Move(dir, 0);
+      if (network) {
+        SendGameEvent(TextFormat("MOVE_LR;DIR:%d", dir)); // Event for P1
       }
-      dasTimer -= dasRate;
+      break;
     }
-  }
-  // If no relevant keyboard key is down, reset DAS state
-  else if (currentKeyboardMoveDir == 0) {
-    dasTimer = 0.0f;
-    lastMoveDir = 0;
-  }
-  // --- End Keyboard DAS for LEFT/RIGHT ---
-
-  // --- Other Keyboard Controls ---
-  if (playerIndex == 1) { // Player 1
-    // Rotate
-    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_SPACE)) {
+    case InputAction::ROTATE:
       logic.Rotate();
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-          currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
+      if (network) {
         SendGameEvent("ROTATE"); // Send event for P1
       }
-    }
-    // Soft Drop (continuous) - now includes soft drop safety check
-    if (IsKeyDown(KEY_DOWN) && !waitForDownRelease) {
-      logic.Move(0, 1);
-      if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
-          currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
-        SendGameEvent("MOVE_DOWN"); // Send event for P1
+      break;
+    case InputAction::SOFT_DROP:
+      if (op.press) {
+        waitForDownRelease = false;
       }
-    }
-  } else { // Player 2 (Local only, not for network)
-    // Rotate
-    if (IsKeyPressed(KEY_W)) {
-      logic.Rotate();
-    }
-    // Soft Drop (continuous) - now includes soft drop safety check
-    if (IsKeyDown(KEY_S) && !waitForDownRelease) {
-      logic.Move(0, 1);
+      if (!waitForDownRelease) {
+        logic.Move(0, 1);
+        if (network) {
+          SendGameEvent(NetworkProtocol::SerializeSoftDrop()); // For P1
+        }
+      }
+      break;
+    default:
+      break;
     }
   }
-  // --- End Other Keyboard Controls ---
 }
 
 void Game::HandleInput() {
-  Vector2 mouse = GetMousePosition();
-  bool mouseClicked = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+  Platform &platform = Platform::Get();
+  Vector2 mouse = platform.MousePosition();
+  bool mouseClicked = platform.MouseButtonPressed(MOUSE_LEFT_BUTTON);
 
-  // Update cursor blink timer (always active for visual consistency)
-  cursorBlinkTimer += GetFrameTime();
-  if (cursorBlinkTimer >= 0.5f) { // Toggle every 0.5 seconds
-    showCursor = !showCursor;
-    cursorBlinkTimer = 0.0f;
-  }
+  // Cursor blink: on the wall clock, so an idle loop can wake exactly at
+  // the next toggle (NextTimerIn)
+  showCursor = std::fmod(platform.Time(), 2 * cursorBlinkInterval) <
+               cursorBlinkInterval;
+
+  // Every frame, so events from other screens never replay in a game
+  CollectInput();
 
   // --- Global Input for Restart Button ---
   btnRestart.active = false; // Reset visual state for this frame
@@ -642,7 +1275,7 @@ void Game::HandleInput() {
   }
 
   // Keyboard input for Restart (e.g., 'R' key)
-  if (IsKeyPressed(KEY_R)) {
+  if (platform.KeyPressed(KEY_R)) {
     if (currentGameState != GameState::TITLE_SCREEN &&
         currentGameState != GameState::MODE_SELECTION &&
         currentGameState != GameState::NETWORK_SETUP) {
@@ -691,7 +1324,7 @@ void Game::HandleInput() {
       currentGameState != GameState::MODE_SELECTION &&
       currentGameState != GameState::NETWORK_SETUP) {
 
-    if (IsKeyPressed(KEY_N)) {
+    if (platform.KeyPressed(KEY_N)) {
       if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
           currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
         Disconnect();
@@ -705,14 +1338,14 @@ void Game::HandleInput() {
   // --- State-specific input handling ---
   switch (currentGameState) {
   case GameState::TITLE_SCREEN: {
-    int key = GetCharPressed();
+    int key = platform.CharPressed();
     // Allow alphanumeric and some common symbols for name, limit length
     while (key > 0) {
       if ((key >= 32) && (key <= 125) &&
           (playerNameInputBuffer.length() < maxNameLength)) {
         playerNameInputBuffer += (char)key;
       }
-      key = GetCharPressed();
+      key = platform.CharPressed();
     }
 
     // OSK Input
@@ -722,13 +1355,13 @@ void Game::HandleInput() {
       playerNameInputBuffer += oskChar;
     }
 
-    if (IsKeyPressed(KEY_BACKSPACE) || oskBackspace) {
+    if (platform.KeyPressed(KEY_BACKSPACE) || oskBackspace) {
       if (!playerNameInputBuffer.empty()) {
         playerNameInputBuffer.pop_back();
       }
     }
 
-    if (IsKeyPressed(KEY_ENTER) || oskEnter) {
+    if (platform.KeyPressed(KEY_ENTER) || oskEnter) {
       if (!playerNameInputBuffer.empty()) {
         playerName = playerNameInputBuffer;
       } else {
@@ -744,6 +1377,7 @@ void Game::HandleInput() {
     btnSinglePlayer.active = false;
     btnTwoPlayerLocal.active = false;
     btnTwoPlayerNetwork.active = false;
+    btnBattleRoyale.active = false;
 
     if (CheckCollisionPointRec(mouse, btnSinglePlayer.rect)) {
       btnSinglePlayer.active = true;
@@ -772,6 +1406,14 @@ void Game::HandleInput() {
         return;
       }
     }
+    if (CheckCollisionPointRec(mouse, btnBattleRoyale.rect)) {
+      btnBattleRoyale.active = true;
+      if (mouseClicked) {
+        currentMode = GameMode::BATTLE_ROYALE_LOCAL;
+        ResetGame();
+        return;
+      }
+    }
     break;
   }
 
@@ -780,9 +1422,23 @@ void Game::HandleInput() {
     btnJoinGame.active = false;
     btnConnect.active = false;
     btnStartOnlineGame.active = false;
+    btnMatchmaking.active = false;
+
+    // While a connect is in flight the IP screen only offers Cancel
+    if (currentNetworkState == NetworkState::CLIENT_CONNECTING &&
+        networkManager.IsConnectPending()) {
+      if (CheckCollisionPointRec(mouse, btnConnect.rect)) {
+        btnConnect.active = true;
+        if (mouseClicked)
+          networkManager.CancelConnect();
+      }
+      if (platform.KeyPressed(KEY_ESCAPE))
+        networkManager.CancelConnect();
+      break;
+    }
 
     // Handle back to mode selection
-    if (IsKeyPressed(KEY_ESCAPE)) {
+    if (platform.KeyPressed(KEY_ESCAPE)) {
       Disconnect(); // Clean up any partial connections
       currentGameState = GameState::MODE_SELECTION;
       return;
@@ -805,9 +1461,18 @@ void Game::HandleInput() {
           }
         }
       }
+      if (CheckCollisionPointRec(mouse, btnMatchmaking.rect)) {
+        btnMatchmaking.active = true;
+        if (mouseClicked) {
+          // Same IP entry screen, but Connect goes to the hub
+          hubMode = true;
+          currentNetworkState = NetworkState::CLIENT_CONNECTING;
+          ipAddressInputBuffer = DEFAULT_HOST_IP;
+        }
+      }
     } else if (currentNetworkState == NetworkState::CLIENT_CONNECTING) {
       // Handle IP address input
-      int key = GetCharPressed();
+      int key = platform.CharPressed();
       bool ipChanged = false;
       while (key > 0) {
         if (((key >= 48) && (key <= 57)) || (key == 46)) { // Digits and dot
@@ -816,7 +1481,7 @@ void Game::HandleInput() {
             ipChanged = true;
           }
         }
-        key = GetCharPressed();
+        key = platform.CharPressed();
       }
 
       // OSK Input for IP
@@ -827,7 +1492,7 @@ void Game::HandleInput() {
         ipChanged = true;
       }
 
-      if (IsKeyPressed(KEY_BACKSPACE) || oskBackspace) {
+      if (platform.KeyPressed(KEY_BACKSPACE) || oskBackspace) {
         if (!ipAddressInputBuffer.empty()) {
           ipAddressInputBuffer.pop_back();
           ipChanged = true;
@@ -842,14 +1507,23 @@ void Game::HandleInput() {
         btnConnect.active = true;
         if (mouseClicked) {
           if (!ipAddressInputBuffer.empty()) {
-            ConnectToHost(ipAddressInputBuffer); // Placeholder function
+            if (hubMode) {
+              ConnectToHub(ipAddressInputBuffer);
+            } else {
+              ConnectToHost(ipAddressInputBuffer); // Placeholder function
+            }
             currentMode = GameMode::TWO_PLAYER_NETWORK_CLIENT;
           }
         }
       }
-      if (IsKeyPressed(KEY_ENTER) || oskEnter) { // Also allow enter to connect
+      // Also allow enter to connect
+      if (platform.KeyPressed(KEY_ENTER) || oskEnter) {
         if (!ipAddressInputBuffer.empty()) {
-          ConnectToHost(ipAddressInputBuffer);
+          if (hubMode) {
+            ConnectToHub(ipAddressInputBuffer);
+          } else {
+            ConnectToHost(ipAddressInputBuffer);
+          }
           currentMode = GameMode::TWO_PLAYER_NETWORK_CLIENT;
         }
       }
@@ -868,7 +1542,8 @@ void Game::HandleInput() {
       // Client just waits, no interactive buttons here.
     } else if (currentNetworkState == NetworkState::CONNECTION_FAILED) {
       // Allow user to acknowledge error and go back
-      if (IsKeyPressed(KEY_ENTER) || IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+      if (platform.KeyPressed(KEY_ENTER) ||
+          platform.MouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         Disconnect(); // Ensure clean slate
         currentNetworkState = NetworkState::DISCONNECTED;
       }
@@ -886,7 +1561,7 @@ void Game::HandleInput() {
       }
     }
     // Keyboard input for Pause (e.g., 'P' key)
-    if (IsKeyPressed(KEY_P)) {
+    if (platform.KeyPressed(KEY_P)) {
       currentGameState = GameState::PAUSED; // Toggle to paused
     }
 
@@ -903,7 +1578,7 @@ void Game::HandleInput() {
       btnRotate.active = false;
       btnDrop.active = false;
 
-      if (IsMouseButtonDown(MOUSE_LEFT_BUTTON)) {
+      if (platform.MouseButtonDown(MOUSE_LEFT_BUTTON)) {
         if (CheckCollisionPointRec(mouse, btnLeft.rect))
           btnLeft.active = true;
         if (CheckCollisionPointRec(mouse, btnRight.rect))
@@ -939,7 +1614,7 @@ void Game::HandleInput() {
         logicPlayer1.Move(0, 1);
         if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
             currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
-          SendGameEvent("MOVE_DOWN"); // Send event for P1
+          SendGameEvent(NetworkProtocol::SerializeSoftDrop()); // For P1
         }
       }
 
@@ -950,14 +1625,13 @@ void Game::HandleInput() {
     }
     // --- End Touch Controls ---
 
-    // Handle keyboard input for Player 1 (local player)
-    HandlePlayerInput(logicPlayer1, 1, dasDelay, dasRate, dasTimerP1,
-                      lastMoveDirP1, lastSpawnCounterP1, waitForDownReleaseP1);
+    // Handle keyboard and gamepad input for Player 1 (local player)
+    HandlePlayerInput(logicPlayer1, 1, lastSpawnCounterP1,
+                      waitForDownReleaseP1);
 
     // Handle keyboard input for Player 2 if in local multiplayer mode
     if (currentMode == GameMode::TWO_PLAYER_LOCAL) {
-      HandlePlayerInput(logicPlayer2, 2, dasDelay, dasRate, dasTimerP2,
-                        lastMoveDirP2, lastSpawnCounterP2,
+      HandlePlayerInput(logicPlayer2, 2, lastSpawnCounterP2,
                         waitForDownReleaseP2);
     }
     // In network mode, logicPlayer2's state is updated by network messages, not
@@ -975,7 +1649,7 @@ void Game::HandleInput() {
       }
     }
     // Keyboard input for Pause (e.g., 'P' key)
-    if (IsKeyPressed(KEY_P)) {
+    if (platform.KeyPressed(KEY_P)) {
       currentGameState = GameState::PLAYING; // Toggle back to playing
     }
     // No other game input is processed when paused
@@ -1044,9 +1718,9 @@ char Game::CheckOSKInput(int startY, bool isIpMode, bool &outEnter,
   outEnter = false;
   outBackspace = false;
 
-  if (!IsMouseButtonPressed(MOUSE_LEFT_BUTTON))
+  if (!Platform::Get().MouseButtonPressed(MOUSE_LEFT_BUTTON))
     return 0;
-  Vector2 mouse = GetMousePosition();
+  Vector2 mouse = Platform::Get().MousePosition();
 
   const char *keys =
       isIpMode ? "1234567890." : "ABCDEFGHIJKLMNOPQRSTUVWXYZ 1234567890";
@@ -1098,12 +1772,35 @@ char Game::CheckOSKInput(int startY, bool isIpMode, bool &outEnter,
 }
 
 void Game::Update() {
+  MetricsTimer tickTimer(Metrics::Get(), Metrics::TICK_DURATION);
+  // After the loop blocked on an idle screen the measured frame time is
+  // the wait, not a slow frame
+  float rawFrameTime =
+      frameTimeStale ? targetFrameTime : Platform::Get().FrameTime();
+  frameTimeStale = false;
+  if (rawFrameTime > 1.5f * targetFrameTime)
+    Metrics::Get().Add(Metrics::DROPPED_FRAMES);
+  frameTime = catchUp.BeginFrame(rawFrameTime);
+  AsyncLog::Get().Pump(); // Web builds have no drain thread
+  if (Platform::Get().KeyPressed(KEY_F9))
+    DumpFlightRecord("manual", false);
   HandleInput(); // Always handle input to check for state transitions,
                  // restart, and pause
 
   // Process network events regardless of game state, as connection can happen
   // in NETWORK_SETUP
   ProcessNetworkEvents();
+  if (clientValidation)
+    CheckClientValidation();
+  Metrics &metrics = Metrics::Get();
+  metrics.Set(Metrics::SESSIONS_ACTIVE,
+              currentNetworkState == NetworkState::IN_GAME ? 1 : 0);
+  metrics.Set(Metrics::PENDING_QUEUE, (int64_t)pendingMessages.size());
+  metrics.Set(Metrics::JITTER_QUEUE, (int64_t)remoteInputBuffer.Size());
+
+  // Particles move on in every state, so a burst still fades out behind
+  // the pause and game-over overlays (IsAnimating keeps drawing it)
+  effects.Update(frameTime);
 
   // Only update game logic if in PLAYING state
   if (currentGameState == GameState::PLAYING) {
@@ -1111,7 +1808,7 @@ void Game::Update() {
     if (!logicPlayer1.isGameOver) {
       int prevSpawnCounter = logicPlayer1.spawnCounter;
 
-      gravityTimerP1 += GetFrameTime();
+      gravityTimerP1 += frameTime;
       if (gravityTimerP1 >= gravityInterval) {
         logicPlayer1.Tick();
         gravityTimerP1 = 0.0f;
@@ -1128,14 +1825,12 @@ void Game::Update() {
         if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
             currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
           // Send SYNC_STATE with full board, score, and next piece
-          std::string boardStr = "";
-          for (int r = 0; r < BOARD_HEIGHT; r++) {
-            for (int c = 0; c < BOARD_WIDTH; c++) {
-              boardStr += std::to_string(logicPlayer1.board.GetCell(r, c));
-            }
-          }
           SendGameEvent(NetworkProtocol::SerializeSyncState(
-              logicPlayer1.score, (int)logicPlayer1.nextPiece.type, boardStr));
+              logicPlayer1.score, (int)logicPlayer1.nextPiece.type,
+              BoardToString(logicPlayer1)));
+          if (hubMode) {
+            SendHubGameState();
+          }
         }
       }
     }
@@ -1144,7 +1839,7 @@ void Game::Update() {
     // over
     if (currentMode == GameMode::TWO_PLAYER_LOCAL) {
       if (!logicPlayer2.isGameOver) {
-        gravityTimerP2 += GetFrameTime();
+        gravityTimerP2 += frameTime;
         if (gravityTimerP2 >= gravityInterval) {
           logicPlayer2.Tick();
           gravityTimerP2 = 0.0f;
@@ -1159,8 +1854,35 @@ void Game::Update() {
     // logicPlayer2.Tick() for network modes has been removed to prevent
     // desynchronization.
 
+    // Effects: new locks spawn particles
+    effects.Observe(0, logicPlayer1, (float)PlayerBoardX(0),
+                    (float)BOARD_OFFSET_Y, (float)cellSize);
+    if (currentMode == GameMode::TWO_PLAYER_LOCAL ||
+        currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
+        currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT)
+      effects.Observe(1, logicPlayer2, (float)PlayerBoardX(1),
+                      (float)BOARD_OFFSET_Y, (float)cellSize);
+
+    // --- Desync Check: report our state hash every few steps ---
+    if (currentNetworkState == NetworkState::IN_GAME &&
+        desyncDetector.ShouldReport(logicPlayer1)) {
+      SendGameEvent(NetworkProtocol::SerializeStateHash(
+          logicPlayer1.stepCounter,
+          logicPlayer1.GetStepHash(logicPlayer1.stepCounter)));
+    }
+
+    if (currentMode == GameMode::BATTLE_ROYALE_LOCAL)
+      battleField.Update(frameTime);
+
     // --- Game Over Check ---
-    if (currentMode == GameMode::SINGLE_PLAYER) {
+    if (currentMode == GameMode::BATTLE_ROYALE_LOCAL) {
+      int alive = battleField.Alive();
+      if (logicPlayer1.isGameOver || alive == 0) {
+        currentGameState = GameState::GAME_OVER;
+        battlePlace = logicPlayer1.isGameOver ? alive + 1 : 1;
+        winnerName = battlePlace == 1 ? playerName : "";
+      }
+    } else if (currentMode == GameMode::SINGLE_PLAYER) {
       if (logicPlayer1.isGameOver) {
         currentGameState = GameState::GAME_OVER;
         winnerName = playerName; // In single player, it's always P1
@@ -1174,6 +1896,9 @@ void Game::Update() {
         if (currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
             currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
           SendGameEvent("PLAYER_DEAD;ID:1"); // Notify remote player
+          if (hubMode) {
+            SendHubEvent("game_over");
+          }
         }
       }
       if (logicPlayer2.isGameOver && !player2IsDead) {
@@ -1232,55 +1957,36 @@ void Game::DrawControls() {
   }
 }
 
-void Game::DrawPlayerBoard(const Logic &logic, int boardOffsetX,
-                           int boardOffsetY) {
-  // 1. Board Background
-  DrawRectangle(boardOffsetX, boardOffsetY, BOARD_WIDTH_PX, BOARD_HEIGHT_PX,
-                DARKGRAY);
-
-  // 2. Static Grid (Locked Pieces)
-  for (int i = 0; i < 20; i++) {
-    for (int j = 0; j < 10; j++) {
-      int x = boardOffsetX + j * cellSize;
-      int y = boardOffsetY + i * cellSize;
-
-      if (logic.board.GetCell(i, j) != 0) {
-        DrawRectangle(x + 1, y + 1, cellSize - 2, cellSize - 2, RED);
-      } else {
-        DrawRectangleLines(x, y, cellSize, cellSize, Fade(LIGHTGRAY, 0.1f));
-      }
-    }
-  }
-
-  // 3. Active Piece (Current)
-  Piece p = logic.currentPiece;
-  if (p.type != PieceType::NONE) {
-    for (int i = 0; i < 4; i++) {
-      int bx, by;
-      p.GetBlock(p.rotation, i, bx, by);
-      int worldX = boardOffsetX + (p.x + bx) * cellSize;
-      int worldY = boardOffsetY + (p.y + by) * cellSize;
-
-      DrawRectangle(worldX + 1, worldY + 1, cellSize - 2, cellSize - 2, GREEN);
-    }
-  }
+int Game::PlayerBoardX(int player) const {
+  if (player == 1)
+    return BOARD_OFFSET_X_P2;
+  if (currentMode == GameMode::SINGLE_PLAYER)
+    return (screenWidth - BOARD_WIDTH_PX) / 2; // Centered
+  return BOARD_OFFSET_X_P1;
+}
 
-  // 4. Board Border
-  DrawRectangleLines(boardOffsetX, boardOffsetY, BOARD_WIDTH_PX,
-                     BOARD_HEIGHT_PX, WHITE);
+void Game::DrawPlayerBoard(const Logic &logic, int board, int boardOffsetX,
+                           int boardOffsetY) {
+  boardRenderer.Draw(board, logic, boardOffsetX, boardOffsetY, cellSize,
+                     showGhostPiece);
 }
 
-void Game::DrawPlayerNextPiece(const Logic &logic, int previewX, int previewY) {
+void Game::DrawPlayerNextFrame(int previewX, int previewY) {
   int previewSize = 6 * cellSize; // The preview box is 6 cells by 6 cells
 
-  // Draw Box
   DrawText("NEXT", previewX, previewY - 30, 20, WHITE);
   DrawRectangle(previewX, previewY, previewSize, previewSize, BLACK);
   DrawRectangleLines(previewX, previewY, previewSize, previewSize, WHITE);
+}
+
+void Game::DrawPlayerNextPiece(const Logic &logic, int previewX, int previewY) {
+  int previewSize = 6 * cellSize; // The preview box is 6 cells by 6 cells
 
-  // Draw Piece inside box
+  // Draw Piece inside the box (the frame is on the static layer)
   Piece p = logic.nextPiece;
   if (p.type != PieceType::NONE) {
+    Color color =
+        boardRenderer.GetPalette().cells[BoardCells::Slot((int)p.type)];
     // 1. Find the bounding box of the piece (min/max bx, by) for rotation 0
     int minBx = 999, maxBx = -999, minBy = 999, maxBy = -999;
     for (int i = 0; i < 4; i++) {
@@ -1324,7 +2030,8 @@ void Game::DrawPlayerNextPiece(const Logic &logic, int previewX, int previewY) {
       int drawX = drawOriginX + (bx * cellSize);
       int drawY = drawOriginY + (by * cellSize);
 
-      DrawRectangle(drawX + 1, drawY + 1, cellSize - 2, cellSize - 2, GOLD);
+      DrawRectangle(drawX + 1, drawY + 1, cellSize - 2, cellSize - 2,
+                    color);
     }
   }
 }
@@ -1332,16 +2039,127 @@ void Game::DrawPlayerNextPiece(const Logic &logic, int previewX, int previewY) {
 void Game::DrawPlayerScore(const Logic &logic, int uiAreaX, int &currentY,
                            const std::string &name) {
   // Display player name
-  DrawText(TextFormat("PLAYER: %s", name.c_str()), uiAreaX, currentY, 20,
-           WHITE);
+  float nameX = textCache.Draw("PLAYER: ", uiAreaX, currentY, 20, WHITE);
+  textCache.Draw(name, uiAreaX + nameX, currentY, 20, WHITE);
   currentY += 30; // Move down for score
 
   // Display the score
-  DrawText(TextFormat("SCORE: %d", logic.score), uiAreaX, currentY, 20, WHITE);
+  textCache.DrawNumber("SCORE: ", logic.score, uiAreaX, currentY, 20, WHITE);
   currentY += 30; // Move down for next element
 }
 
-void Game::Draw() {
+// Where P2's board and UI would be: a row of near opponents in full detail
+// above the buttons, the rest as heightmaps below it
+void Game::DrawOpponents() {
+  int count = battleField.Size();
+  int order[BoardAtlas::MAX_BOARDS];
+  int height[BoardAtlas::MAX_BOARDS];
+  for (int i = 0; i < count; i++) {
+    order[i] = i;
+    const Logic &logic = battleField.Get(i);
+    // Closest to topping out first; knocked out boards last
+    height[i] = logic.isGameOver ? -1 : BattleField::StackHeight(logic);
+  }
+  std::stable_sort(order, order + count,
+                   [&](int a, int b) { return height[a] > height[b]; });
+  int nearCount = std::min(NEAR_OPPONENTS, count);
+  BoardAtlas &atlas = opponentRenderer.GetAtlas();
+  for (int i = 0; i < count; i++)
+    atlas.SetLod(order[i], i < nearCount ? BoardAtlas::Lod::FULL
+                                         : BoardAtlas::Lod::HEIGHTMAP);
+  opponentRenderer.Update(battleField.Boards(), count);
+
+  const int nearGap = 10, farGap = 4;
+  int x = BOARD_OFFSET_X_P2;
+  int columns;
+  int nearCell =
+      BoardAtlas::FitCellSize(screenWidth - 40 - x,
+                              (int)btnRestart.rect.y - 30 - BOARD_OFFSET_Y,
+                              nearCount, nearGap, columns);
+  opponentRenderer.DrawGrid(order, nearCount, x, BOARD_OFFSET_Y, columns,
+                            nearCell, nearGap);
+  int rows = columns > 0 ? (nearCount + columns - 1) / columns : 0;
+  int farY = BOARD_OFFSET_Y + rows * (BOARD_HEIGHT * nearCell + nearGap) + 10;
+  int farCell = BoardAtlas::FitCellSize(
+      (int)btnRestart.rect.x - 20 - x, BOARD_OFFSET_Y + BOARD_HEIGHT_PX - farY,
+      count - nearCount, farGap, columns);
+  opponentRenderer.DrawGrid(order + nearCount, count - nearCount, x, farY,
+                            columns, farCell, farGap);
+}
+
+uint64_t Game::StaticLayerKey() const {
+  UiLayerKey key;
+  key.Add((uint64_t)currentGameState)
+      .Add((uint64_t)currentMode)
+      .Add((uint64_t)currentNetworkState)
+      .Add(isHost)
+      .Add(hubMode)
+      .Add(networkManager.IsConnectPending())
+      .Add(playerName)
+      .Add(playerNameInputBuffer.empty())
+      .Add(remotePlayerName)
+      .Add(currentIpAddress)
+      .Add(networkErrorMessage);
+  const Button *buttons[] = {&btnLeft,           &btnRight,
+                             &btnRotate,         &btnDrop,
+                             &btnRestart,        &btnPause,
+                             &btnChangeName,     &btnSinglePlayer,
+                             &btnTwoPlayerLocal, &btnTwoPlayerNetwork,
+                             &btnHostGame,       &btnJoinGame,
+                             &btnConnect,        &btnStartOnlineGame,
+                             &btnMatchmaking,    &btnBattleRoyale};
+  for (const Button *b : buttons)
+    key.Add(b->active).Add(b->text);
+  return key.Get();
+}
+
+// Play, network sessions (keepalives, reconnects), connect attempts,
+// queued messages and fading particles need every frame; the other screens
+// only change on input, network activity or the cursor blink
+bool Game::IsAnimating() const {
+  if (currentGameState == GameState::PLAYING)
+    return true;
+  if (currentNetworkState == NetworkState::IN_GAME ||
+      currentNetworkState == NetworkState::RECONNECTING ||
+      networkManager.IsConnectPending())
+    return true;
+  return !pendingMessages.empty() || catchUp.IsActive() ||
+         remoteInputBuffer.Size() > 0 || effects.Active();
+}
+
+double Game::NextTimerIn() const {
+  bool cursorShown = currentGameState == GameState::TITLE_SCREEN ||
+                     (currentGameState == GameState::NETWORK_SETUP &&
+                      currentNetworkState == NetworkState::CLIENT_CONNECTING);
+  if (!cursorShown)
+    return -1.0;
+  return cursorBlinkInterval -
+         std::fmod(Platform::Get().Time(), cursorBlinkInterval);
+}
+
+// Everything Draw() shows on a screen that is not animating
+uint64_t Game::FrameKey() const {
+  Vector2 mouse = Platform::Get().MousePosition(); // Debug cursor
+  UiLayerKey key;
+  key.Add(StaticLayerKey())
+      .Add(playerNameInputBuffer)
+      .Add(ipAddressInputBuffer)
+      .Add(showCursor)
+      .Add((uint64_t)(int64_t)mouse.x)
+      .Add((uint64_t)(int64_t)mouse.y)
+      .Add(winnerName)
+      .Add(clientFlagged);
+  for (const Logic *logic : {&logicPlayer1, &logicPlayer2})
+    key.Add((uint64_t)logic->score)
+        .Add((uint64_t)logic->spawnCounter)
+        .Add(logic->isGameOver);
+  return key.Get();
+}
+
+// Everything that only changes with the inputs hashed by StaticLayerKey():
+// drawn into staticLayer, not every frame. Also lays out the network
+// buttons, so it runs whenever the network state changes.
+void Game::DrawStaticLayer() {
   ClearBackground(RAYWHITE); // Clear the entire screen
   DrawRectangle(0, 0, screenWidth, screenHeight, BLACK); // Black background
 
@@ -1420,16 +2238,6 @@ void Game::Draw() {
     DrawText(promptText, (screenWidth - promptWidth) / 2, screenHeight / 2 - 40,
              promptFontSize, WHITE);
 
-    // Draw input buffer and blinking cursor
-    int inputFontSize = 30;
-    std::string displayInput = playerNameInputBuffer;
-    if (showCursor) {
-      displayInput += "_";
-    }
-    int inputWidth = MeasureText(displayInput.c_str(), inputFontSize);
-    DrawText(displayInput.c_str(), (screenWidth - inputWidth) / 2,
-             screenHeight / 2, inputFontSize, WHITE);
-
     // Instructions
     const char *enterPrompt = "PRESS ENTER OR USE KEYBOARD BELOW";
     int enterPromptFontSize = 20;
@@ -1493,6 +2301,19 @@ void Game::Draw() {
              btnTwoPlayerNetwork.rect.y +
                  (btnTwoPlayerNetwork.rect.height / 2 - (btnTextFontSize / 2)),
              btnTextFontSize, WHITE);
+
+    // Draw Battle Royale button
+    DrawRectangleRec(btnBattleRoyale.rect,
+                     btnBattleRoyale.active ? Fade(btnBattleRoyale.color, 0.5f)
+                                            : btnBattleRoyale.color);
+    DrawRectangleLinesEx(btnBattleRoyale.rect, 2, DARKGRAY);
+    btnTextWidth = MeasureText(btnBattleRoyale.text.c_str(), btnTextFontSize);
+    DrawText(btnBattleRoyale.text.c_str(),
+             btnBattleRoyale.rect.x +
+                 (btnBattleRoyale.rect.width / 2 - btnTextWidth / 2),
+             btnBattleRoyale.rect.y +
+                 (btnBattleRoyale.rect.height / 2 - (btnTextFontSize / 2)),
+             btnTextFontSize, WHITE);
     break;
   }
 
@@ -1505,14 +2326,12 @@ void Game::Draw() {
     DrawText(networkPrompt, (screenWidth - networkPromptWidth) / 2,
              screenHeight / 4, networkPromptFontSize, WHITE);
 
+    // Buttons are placed in the constructor
     int currentBtnY =
         screenHeight / 2 - btnTwoPlayerNetwork.rect.height - btnVerticalGap;
-    int btnX = (screenWidth - btnTwoPlayerNetwork.rect.width) / 2;
 
     if (currentNetworkState == NetworkState::DISCONNECTED) {
-      // Position and draw Host Game button
-      btnHostGame.rect.x = btnX;
-      btnHostGame.rect.y = currentBtnY;
+      // Draw Host Game button
       DrawRectangleRec(btnHostGame.rect, btnHostGame.active
                                              ? Fade(btnHostGame.color, 0.5f)
                                              : btnHostGame.color);
@@ -1525,11 +2344,7 @@ void Game::Draw() {
                    (btnHostGame.rect.height / 2 - (btnTextFontSize / 2)),
                btnTextFontSize, WHITE);
 
-      currentBtnY += btnHostGame.rect.height + btnVerticalGap;
-
-      // Position and draw Join Game button
-      btnJoinGame.rect.x = btnX;
-      btnJoinGame.rect.y = currentBtnY;
+      // Draw Join Game button
       DrawRectangleRec(btnJoinGame.rect, btnJoinGame.active
                                              ? Fade(btnJoinGame.color, 0.5f)
                                              : btnJoinGame.color);
@@ -1541,6 +2356,19 @@ void Game::Draw() {
                btnJoinGame.rect.y +
                    (btnJoinGame.rect.height / 2 - (btnTextFontSize / 2)),
                btnTextFontSize, WHITE);
+
+      // Draw Matchmaking (Go hub) button
+      DrawRectangleRec(btnMatchmaking.rect,
+                       btnMatchmaking.active ? Fade(btnMatchmaking.color, 0.5f)
+                                             : btnMatchmaking.color);
+      DrawRectangleLinesEx(btnMatchmaking.rect, 2, DARKGRAY);
+      btnTextWidth = MeasureText(btnMatchmaking.text.c_str(), btnTextFontSize);
+      DrawText(btnMatchmaking.text.c_str(),
+               btnMatchmaking.rect.x +
+                   (btnMatchmaking.rect.width / 2 - btnTextWidth / 2),
+               btnMatchmaking.rect.y +
+                   (btnMatchmaking.rect.height / 2 - (btnTextFontSize / 2)),
+               btnTextFontSize, WHITE);
     } else if (currentNetworkState == NetworkState::HOSTING_WAITING) {
       std::string statusText = "HOSTING... Waiting for client on IP:";
       int statusFontSize = 30;
@@ -1558,32 +2386,44 @@ void Game::Draw() {
                (screenWidth - MeasureText("Press ESC to cancel", 20)) / 2,
                screenHeight - 100, 20, LIGHTGRAY);
 
+    } else if (currentNetworkState == NetworkState::CLIENT_CONNECTING &&
+               networkManager.IsConnectPending()) {
+      int port = hubMode ? hubPort : networkPort;
+      std::string statusText = "CONNECTING TO " + currentIpAddress + ":" +
+                               std::to_string(port);
+      int statusFontSize = 30;
+      int statusWidth = MeasureText(statusText.c_str(), statusFontSize);
+      DrawText(statusText.c_str(), (screenWidth - statusWidth) / 2,
+               currentBtnY - 50, statusFontSize, WHITE);
+
+      // Connect button turns into Cancel while attempts are running
+      DrawRectangleRec(btnConnect.rect, btnConnect.active
+                                            ? Fade(MAROON, 0.5f)
+                                            : MAROON);
+      DrawRectangleLinesEx(btnConnect.rect, 2, DARKGRAY);
+      btnTextWidth = MeasureText("Cancel", btnTextFontSize);
+      DrawText("Cancel",
+               btnConnect.rect.x +
+                   (btnConnect.rect.width / 2 - btnTextWidth / 2),
+               btnConnect.rect.y +
+                   (btnConnect.rect.height / 2 - (btnTextFontSize / 2)),
+               btnTextFontSize, WHITE);
+
+      DrawText("Press ESC to cancel",
+               (screenWidth - MeasureText("Press ESC to cancel", 20)) / 2,
+               screenHeight - 100, 20, LIGHTGRAY);
+
     } else if (currentNetworkState == NetworkState::CLIENT_CONNECTING) {
-      std::string promptText = "ENTER HOST IP:";
+      std::string promptText = hubMode ? "ENTER HUB IP:" : "ENTER HOST IP:";
       int promptFontSize = 30;
       int promptWidth = MeasureText(promptText.c_str(), promptFontSize);
       DrawText(promptText.c_str(), (screenWidth - promptWidth) / 2,
                currentBtnY - 50, promptFontSize, WHITE);
 
-      std::string displayInput = ipAddressInputBuffer;
-      if (showCursor) {
-        displayInput += "_";
-      }
-      int inputFontSize = 30;
-      int inputWidth = MeasureText(displayInput.c_str(), inputFontSize);
-      DrawText(displayInput.c_str(), (screenWidth - inputWidth) / 2,
-               currentBtnY, inputFontSize, WHITE);
-
-      currentBtnY += 50 + btnVerticalGap; // Adjust button position below input
-
       // Draw OSK for IP
       DrawOSK(screenHeight - 250, true);
-      // Adjust Connect button to separate from OSK
-      currentBtnY = screenHeight - 250 - 60;
 
-      // Position and draw Connect button
-      btnConnect.rect.x = btnX;
-      btnConnect.rect.y = currentBtnY;
+      // Draw Connect button, clear of the OSK
       DrawRectangleRec(btnConnect.rect, btnConnect.active
                                             ? Fade(btnConnect.color, 0.5f)
                                             : btnConnect.color);
@@ -1610,8 +2450,6 @@ void Game::Draw() {
                  currentBtnY - 50, statusFontSize, WHITE);
 
         // Host can start the game
-        btnStartOnlineGame.rect.x = btnX;
-        btnStartOnlineGame.rect.y = currentBtnY;
         DrawRectangleRec(btnStartOnlineGame.rect,
                          btnStartOnlineGame.active
                              ? Fade(btnStartOnlineGame.color, 0.5f)
@@ -1627,15 +2465,15 @@ void Game::Draw() {
                 (btnStartOnlineGame.rect.height / 2 - (btnTextFontSize / 2)),
             btnTextFontSize, WHITE);
       } else {
-        statusText = "CONNECTED TO HOST: " + currentIpAddress;
+        statusText = (hubMode ? "IN MATCHMAKING: " : "CONNECTED TO HOST: ") +
+                     currentIpAddress;
         int statusFontSize = 30;
         int statusWidth = MeasureText(statusText.c_str(), statusFontSize);
         DrawText(statusText.c_str(), (screenWidth - statusWidth) / 2,
                  currentBtnY - 50, statusFontSize, WHITE);
-        DrawText("Waiting for host to start game...",
-                 (screenWidth -
-                  MeasureText("Waiting for host to start game...", 25)) /
-                     2,
+        const char *waitText = hubMode ? "Waiting for an opponent..."
+                                       : "Waiting for host to start game...";
+        DrawText(waitText, (screenWidth - MeasureText(waitText, 25)) / 2,
                  currentBtnY + 50, 25, LIGHTGRAY);
       }
       DrawText("Press ESC to disconnect",
@@ -1666,20 +2504,85 @@ void Game::Draw() {
     // Always draw touch controls in these states
     DrawControls();
 
-    // Determine P1 Board Position
-    int p1BoardX = BOARD_OFFSET_X_P1;
-    if (currentMode == GameMode::SINGLE_PLAYER) {
-      // Center the board
-      p1BoardX = (screenWidth - BOARD_WIDTH_PX) / 2;
+    int p1BoardX = currentMode == GameMode::SINGLE_PLAYER
+                       ? (screenWidth - BOARD_WIDTH_PX) / 2
+                       : BOARD_OFFSET_X_P1;
+    DrawPlayerNextFrame(p1BoardX + BOARD_WIDTH_PX + 20, BOARD_OFFSET_Y);
+    if (currentMode != GameMode::SINGLE_PLAYER &&
+        currentMode != GameMode::BATTLE_ROYALE_LOCAL)
+      DrawPlayerNextFrame(BOARD_OFFSET_X_P2 + BOARD_WIDTH_PX + 20,
+                          BOARD_OFFSET_Y);
+    break;
+  }
+  } // End switch (currentGameState)
+}
+
+void Game::Draw() {
+  // Backgrounds, menus, buttons and frames, redrawn only when they change
+  staticLayer.Draw(StaticLayerKey(), [this] { DrawStaticLayer(); });
+
+  switch (currentGameState) {
+  case GameState::TITLE_SCREEN: {
+    // Draw input buffer and blinking cursor
+    int inputFontSize = 30;
+    std::string displayInput = playerNameInputBuffer;
+    if (showCursor) {
+      displayInput += "_";
     }
+    int inputWidth = textCache.Measure(displayInput, inputFontSize);
+    textCache.Draw(displayInput, (screenWidth - inputWidth) / 2,
+                   screenHeight / 2, inputFontSize, WHITE);
+    break;
+  }
+
+  case GameState::MODE_SELECTION:
+    break;
+
+  case GameState::NETWORK_SETUP: {
+    // The status row of DrawStaticLayer()
+    int currentBtnY = screenHeight / 2 - btnTwoPlayerNetwork.rect.height - 10;
+    if (currentNetworkState == NetworkState::CLIENT_CONNECTING &&
+        networkManager.IsConnectPending()) {
+      bool retrying = networkManager.GetConnectStatus() ==
+                      NetworkManager::ConnectStatus::WAITING_RETRY;
+      const char *progressText = TextFormat(
+          retrying ? "%s - retrying (%d/%d)..." : "%sAttempt %d/%d...",
+          retrying ? networkManager.GetConnectError() : "",
+          networkManager.GetConnectAttempt() + (retrying ? 1 : 0),
+          networkManager.GetMaxConnectAttempts());
+      int progressWidth = textCache.Measure(progressText, 25);
+      textCache.Draw(progressText, (screenWidth - progressWidth) / 2,
+                     currentBtnY + 10, 25, LIGHTGRAY);
+    } else if (currentNetworkState == NetworkState::CLIENT_CONNECTING) {
+      std::string displayInput = ipAddressInputBuffer;
+      if (showCursor) {
+        displayInput += "_";
+      }
+      int inputFontSize = 30;
+      int inputWidth = textCache.Measure(displayInput, inputFontSize);
+      textCache.Draw(displayInput, (screenWidth - inputWidth) / 2,
+                     currentBtnY, inputFontSize, WHITE);
+    }
+    break;
+  }
+
+  case GameState::PLAYING:
+  case GameState::PAUSED:
+  case GameState::GAME_OVER: {
+    int p1BoardX = PlayerBoardX(0);
 
     // --- Draw Player 1's board and UI ---
-    DrawPlayerBoard(logicPlayer1, p1BoardX, BOARD_OFFSET_Y);
+    DrawPlayerBoard(logicPlayer1, 0, p1BoardX, BOARD_OFFSET_Y);
     int p1_ui_x = p1BoardX + BOARD_WIDTH_PX + 20;
     int p1_ui_y = BOARD_OFFSET_Y;
     DrawPlayerNextPiece(logicPlayer1, p1_ui_x, p1_ui_y);
     p1_ui_y += (6 * cellSize) + 20; // Below next piece preview
     DrawPlayerScore(logicPlayer1, p1_ui_x, p1_ui_y, playerName);
+    if (currentMode == GameMode::BATTLE_ROYALE_LOCAL) {
+      int alive = battleField.Alive() + (logicPlayer1.isGameOver ? 0 : 1);
+      textCache.DrawNumber("ALIVE: ", alive, p1_ui_x, p1_ui_y, 20, WHITE);
+      DrawOpponents();
+    }
 
     // Overlay for P1 if dead or paused
     if (currentGameState == GameState::PAUSED) {
@@ -1698,10 +2601,11 @@ void Game::Draw() {
                     Fade(BLACK, 0.7f));
       const char *p1GameOverText = "GAME OVER";
       int textFontSize = 40; // Smaller for individual board
-      int textWidth = MeasureText(p1GameOverText, textFontSize);
-      DrawText(p1GameOverText, p1BoardX + (BOARD_WIDTH_PX - textWidth) / 2,
-               BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) - textFontSize / 2,
-               textFontSize, RED);
+      int textWidth = textCache.Measure(p1GameOverText, textFontSize);
+      textCache.Draw(p1GameOverText,
+                     p1BoardX + (BOARD_WIDTH_PX - textWidth) / 2,
+                     BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) - textFontSize / 2,
+                     textFontSize, RED);
     }
 
     // --- Draw Player 2's board and UI if in local multiplayer or network
@@ -1710,7 +2614,7 @@ void Game::Draw() {
     if (currentMode == GameMode::TWO_PLAYER_LOCAL ||
         currentMode == GameMode::TWO_PLAYER_NETWORK_HOST ||
         currentMode == GameMode::TWO_PLAYER_NETWORK_CLIENT) {
-      DrawPlayerBoard(logicPlayer2, BOARD_OFFSET_X_P2, BOARD_OFFSET_Y);
+      DrawPlayerBoard(logicPlayer2, 1, BOARD_OFFSET_X_P2, BOARD_OFFSET_Y);
       int p2_ui_x = BOARD_OFFSET_X_P2 + BOARD_WIDTH_PX + 20;
       int p2_ui_y = BOARD_OFFSET_Y;
       DrawPlayerNextPiece(logicPlayer2, p2_ui_x, p2_ui_y);
@@ -1728,24 +2632,48 @@ void Game::Draw() {
                       BOARD_HEIGHT_PX, Fade(BLACK, 0.7f));
         const char *p2GameOverText = "GAME OVER";
         int textFontSize = 40;
-        int textWidth = MeasureText(p2GameOverText, textFontSize);
-        DrawText(p2GameOverText,
-                 BOARD_OFFSET_X_P2 + (BOARD_WIDTH_PX - textWidth) / 2,
-                 BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) - textFontSize / 2,
-                 textFontSize, RED);
+        int textWidth = textCache.Measure(p2GameOverText, textFontSize);
+        textCache.Draw(p2GameOverText,
+                       BOARD_OFFSET_X_P2 + (BOARD_WIDTH_PX - textWidth) / 2,
+                       BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) -
+                           textFontSize / 2,
+                       textFontSize, RED);
+      }
+
+      // Remote board is frozen while we try to resume the session
+      if (currentNetworkState == NetworkState::RECONNECTING) {
+        DrawRectangle(BOARD_OFFSET_X_P2, BOARD_OFFSET_Y, BOARD_WIDTH_PX,
+                      BOARD_HEIGHT_PX, Fade(BLACK, 0.5f));
+        const char *reconnectText = "RECONNECTING";
+        int textFontSize = 30;
+        int textWidth = textCache.Measure(reconnectText, textFontSize);
+        textCache.Draw(reconnectText,
+                       BOARD_OFFSET_X_P2 + (BOARD_WIDTH_PX - textWidth) / 2,
+                       BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) - textFontSize,
+                       textFontSize, ORANGE);
+        const char *remainingText =
+            TextFormat("%.0fs", session.GetRemaining());
+        textWidth = textCache.Measure(remainingText, 20);
+        textCache.Draw(remainingText,
+                       BOARD_OFFSET_X_P2 + (BOARD_WIDTH_PX - textWidth) / 2,
+                       BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) + 10, 20,
+                       LIGHTGRAY);
       }
     }
 
+    // Over both boards and their overlays, under the central ones
+    EffectsRenderer::Draw(effects);
+
     // --- Central Overlays for PAUSED and overall GAME_OVER ---
     if (currentGameState == GameState::PAUSED) {
       // Draw "PAUSED" text centered over P1 board
       const char *pausedText = "PAUSED";
       int textFontSizePaused = 50;
-      int textWidthPaused = MeasureText(pausedText, textFontSizePaused);
+      int textWidthPaused = textCache.Measure(pausedText, textFontSizePaused);
       int textX = p1BoardX + (BOARD_WIDTH_PX - textWidthPaused) / 2;
       int textY = BOARD_OFFSET_Y + (BOARD_HEIGHT_PX / 2) - textFontSizePaused;
 
-      DrawText(pausedText, textX, textY, textFontSizePaused, WHITE);
+      textCache.Draw(pausedText, textX, textY, textFontSizePaused, WHITE);
     } else if (currentGameState == GameState::GAME_OVER) {
       // This is the *overall* GAME OVER, meaning both players are dead in
       // 2-player, or P1 in 1-player. Draw a full-screen overlay for final
@@ -1755,59 +2683,73 @@ void Game::Draw() {
 
       const char *gameOverText = "GAME OVER";
       int textFontSize = 60;
-      int textWidth = MeasureText(gameOverText, textFontSize);
-      DrawText(gameOverText, (screenWidth - textWidth) / 2, screenHeight / 3,
-               textFontSize, RED);
-
-      if (currentMode == GameMode::SINGLE_PLAYER) {
-        std::string finalScoreDisplay =
-            "FINAL SCORE: " + std::to_string(logicPlayer1.score);
+      int textWidth = textCache.Measure(gameOverText, textFontSize);
+      textCache.Draw(gameOverText, (screenWidth - textWidth) / 2,
+                     screenHeight / 3, textFontSize, RED);
+
+      if (currentMode == GameMode::BATTLE_ROYALE_LOCAL) {
+        int placeFontSize = 40;
+        int placeWidth =
+            textCache.MeasureNumber("PLACE: #", battlePlace, placeFontSize);
+        textCache.DrawNumber("PLACE: #", battlePlace,
+                             (screenWidth - placeWidth) / 2,
+                             screenHeight / 3 + 80, placeFontSize, GOLD);
+        int scoreWidth =
+            textCache.MeasureNumber("FINAL SCORE: ", logicPlayer1.score, 30);
+        textCache.DrawNumber("FINAL SCORE: ", logicPlayer1.score,
+                             (screenWidth - scoreWidth) / 2,
+                             screenHeight / 3 + 150, 30, WHITE);
+      } else if (currentMode == GameMode::SINGLE_PLAYER) {
         int scoreFontSize = 40;
-        int scoreWidth = MeasureText(finalScoreDisplay.c_str(), scoreFontSize);
-        DrawText(finalScoreDisplay.c_str(), (screenWidth - scoreWidth) / 2,
-                 screenHeight / 3 + 80, scoreFontSize, GOLD);
+        int scoreWidth = textCache.MeasureNumber(
+            "FINAL SCORE: ", logicPlayer1.score, scoreFontSize);
+        textCache.DrawNumber("FINAL SCORE: ", logicPlayer1.score,
+                             (screenWidth - scoreWidth) / 2,
+                             screenHeight / 3 + 80, scoreFontSize, GOLD);
       } else { // Two Player Local or Network
         std::string winnerDisplay = "WINNER: " + winnerName;
         if (winnerName == "It's a Tie!") {
           winnerDisplay = "It's a Tie!";
         }
         int winnerFontSize = 40;
-        int winnerWidth = MeasureText(winnerDisplay.c_str(), winnerFontSize);
-        DrawText(winnerDisplay.c_str(), (screenWidth - winnerWidth) / 2,
-                 screenHeight / 3 + 80, winnerFontSize, GOLD);
+        int winnerWidth = textCache.Measure(winnerDisplay, winnerFontSize);
+        textCache.Draw(winnerDisplay, (screenWidth - winnerWidth) / 2,
+                       screenHeight / 3 + 80, winnerFontSize, GOLD);
 
         // Display scores for both players
         std::string p1ScoreDisplay =
             playerName + " Score: " + std::to_string(logicPlayer1.score);
         std::string p2ScoreDisplay =
             remotePlayerName + " Score: " + std::to_string(logicPlayer2.score);
+        if (clientFlagged)
+          p2ScoreDisplay += " (unverified)";
         int individualScoreFontSize = 30;
         int p1ScoreWidth =
-            MeasureText(p1ScoreDisplay.c_str(), individualScoreFontSize);
+            textCache.Measure(p1ScoreDisplay, individualScoreFontSize);
         int p2ScoreWidth =
-            MeasureText(p2ScoreDisplay.c_str(), individualScoreFontSize);
+            textCache.Measure(p2ScoreDisplay, individualScoreFontSize);
 
-        DrawText(p1ScoreDisplay.c_str(), (screenWidth - p1ScoreWidth) / 2,
-                 screenHeight / 3 + 150, individualScoreFontSize, WHITE);
-        DrawText(p2ScoreDisplay.c_str(), (screenWidth - p2ScoreWidth) / 2,
-                 screenHeight / 3 + 190, individualScoreFontSize, WHITE);
+        textCache.Draw(p1ScoreDisplay, (screenWidth - p1ScoreWidth) / 2,
+                       screenHeight / 3 + 150, individualScoreFontSize, WHITE);
+        textCache.Draw(p2ScoreDisplay, (screenWidth - p2ScoreWidth) / 2,
+                       screenHeight / 3 + 190, individualScoreFontSize, WHITE);
       }
 
       // Prompt to restart
       const char *restartPrompt = "Press R or click RESTART to play again";
       int restartPromptFontSize = 25;
       int restartPromptWidth =
-          MeasureText(restartPrompt, restartPromptFontSize);
-      DrawText(restartPrompt, (screenWidth - restartPromptWidth) / 2,
-               screenHeight - 100, restartPromptFontSize, LIGHTGRAY);
+          textCache.Measure(restartPrompt, restartPromptFontSize);
+      textCache.Draw(restartPrompt, (screenWidth - restartPromptWidth) / 2,
+                     screenHeight - 100, restartPromptFontSize, LIGHTGRAY);
     }
     break;
   }
   } // End switch (currentGameState)
 
   // --- Debug: Visual Cursor for Touch Alignment ---
-  Vector2 mousePos = GetMousePosition();
+  Vector2 mousePos = Platform::Get().MousePosition();
   DrawCircleV(mousePos, 10, Fade(RED, 0.5f));
   DrawText(TextFormat("Input: %0.0f,%0.0f", mousePos.x, mousePos.y),
            mousePos.x + 15, mousePos.y, 20, RED);
-}
\ No newline at end of file
+}
@@ -1,7 +1,25 @@
 #pragma once
+#include "battle_field.h"
+#include "board_renderer.h"
+#include "catch_up.h"
+#include "desync_detector.h"
+#include "effects_renderer.h"
+#include "input_capture.h"
+#include "input_validator.h"
+#include "jitter_buffer.h"
 #include "logic.h"
+#include "metrics.h"
+#ifndef __EMSCRIPTEN__
+#include "metrics_server.h"
+#endif
+#include "multi_board_renderer.h"
 #include "network_manager.h" // Include NetworkManager
+#include "network_protocol.h"
+#include "platform.h"
 #include "raylib.h"
+#include "session_resume.h"
+#include "text_cache.h"
+#include "ui_layer.h"
 
 // ... (existing code)
 
@@ -20,6 +38,7 @@ void SendGameEvent(const std::string &eventData); // e.g., "move_left", "rotate"
 void ProcessNetworkEvents();     // Called in Update() to read incoming messages
 std::string GetLocalIPAddress(); // Placeholder to get local IP
 
+#include <deque>
 #include <map> // For storing player names
 #include <string>
 #include <vector> // Required for std::vector in max initialization
@@ -46,7 +65,8 @@ enum class GameMode {
   SINGLE_PLAYER,
   TWO_PLAYER_LOCAL,
   TWO_PLAYER_NETWORK_HOST,  // New: Player is hosting an online game
-  TWO_PLAYER_NETWORK_CLIENT // New: Player is joining an online game
+  TWO_PLAYER_NETWORK_CLIENT, // New: Player is joining an online game
+  BATTLE_ROYALE_LOCAL        // Practice: one player against many bots
 };
 
 // New: Define network states for managing connection flow within NETWORK_SETUP
@@ -56,6 +76,7 @@ enum class NetworkState {
   CLIENT_CONNECTING, // Client is attempting to connect to a host
   CONNECTED,         // Connection established, waiting for game to start
   IN_GAME,           // Network game is actively playing
+  RECONNECTING,      // Link dropped mid-match; resuming within grace window
   CONNECTION_FAILED  // New: Connection attempt failed or lost
 };
 
@@ -69,6 +90,15 @@ public:
   void DrawControls();
   void ResetGame(); // Resets the entire game state
 
+  // For the event-driven main loop (frame_scheduler.h)
+  GameState GetState() const { return currentGameState; }
+  bool IsAnimating() const; // Changes every frame without any input
+  double NextTimerIn() const; // Seconds to the next timed redraw, -1: none
+  uint64_t FrameKey() const;  // What a non-animating frame depends on
+  // The next Update() steps by the target frame time: GetFrameTime()
+  // includes time the loop spent blocked
+  void SetFrameTimeStale(bool stale) { frameTimeStale = stale; }
+
 private:
   Logic logicPlayer1; // Player 1's game logic (local player)
   Logic logicPlayer2; // Player 2's game logic (local or remote player)
@@ -99,15 +129,14 @@ private:
       15; // Maximum length for IP address (e.g., 255.255.255.255)
   std::string
       currentIpAddress; // Stores the IP address being hosted on or connected to
-#if defined(__EMSCRIPTEN__)
-  const int networkPort = 12346; // Port for Web/WebSocket Proxy
-#else
-  const int networkPort = 12345; // Default port for Desktop (Raw TCP)
-#endif
+  // Desktop hosts accept raw TCP and browser WebSocket clients on one port
+  const int networkPort = 12345;
+  const int hubPort = 8080; // Go matchmaking hub (server.go, /ws endpoint)
+  bool hubMode = false;     // Matchmaking via the hub instead of direct TCP
   std::string networkErrorMessage; // To display error reason
 
-  // Cursor for name/IP input
-  float cursorBlinkTimer = 0.0f;
+  // Cursor for name/IP input, blinking on the wall clock
+  static constexpr double cursorBlinkInterval = 0.5;
   bool showCursor = true;
 
   // Gravity
@@ -115,13 +144,16 @@ private:
   float gravityTimerP2 = 0.0f;
   float gravityInterval = 1.0f; // 1 sec
 
-  // Delayed Auto Shift (DAS) for movement
-  float dasTimerP1 = 0.0f; // Timer for auto shift P1
-  float dasTimerP2 = 0.0f; // Timer for auto shift P2
-  float dasDelay = 0.2f;   // Initial delay before repeating (e.g., 0.2s)
-  float dasRate = 0.05f;   // Speed of repeating (e.05s)
-  int lastMoveDirP1 = 0;   // -1 for left, 1 for right, 0 for none/reset P1
-  int lastMoveDirP2 = 0;   // -1 for left, 1 for right, 0 for none/reset P2
+  // Delayed Auto Shift (DAS) for movement, replayed from timestamped
+  // events (input_queue.h) rather than from per-frame key state
+  float dasDelay = 0.2f;              // Initial delay before repeating
+  float dasRate = 0.05f;              // Speed of repeating
+  float softDropRate = 1.0f / 60.0f; // Soft drop repeat while held
+  InputQueue inputQueue;
+  InputTimeline inputTimelines[2] = {
+      InputTimeline(dasDelay, dasRate, softDropRate),
+      InputTimeline(dasDelay, dasRate, softDropRate)};
+  std::vector<InputOp> inputOps[2]; // This frame's moves, per player
 
   const int cellSize = 30;
   // Screen 1200x600.
@@ -160,6 +192,8 @@ private:
   Button btnJoinGame;
   Button btnConnect;         // To initiate client connection
   Button btnStartOnlineGame; // Host-only: to start game once client connected
+  Button btnMatchmaking;     // Join the Go hub's matchmaking pool
+  Button btnBattleRoyale;    // Practice against BATTLE_OPPONENTS bots
 
   // Soft Drop Safety (Reset on Spawn)
   int lastSpawnCounterP1 = 0;        // Tracks logicPlayer1.spawnCounter
@@ -171,20 +205,108 @@ private:
   void LoadPlayerName();
   void SavePlayerName();
 
+  // Boards are drawn as one shader quad each (board_renderer.h)
+  BoardRenderer boardRenderer;
+  bool showGhostPiece = true; // Landing preview of the active piece
+
+  // Battle royale practice: bot opponents as miniboards, the NEAR_OPPONENTS
+  // closest to topping out in full detail, the rest as heightmaps
+  static constexpr int BATTLE_OPPONENTS = 99;
+  static constexpr int NEAR_OPPONENTS = 8;
+  BattleField battleField;
+  MultiBoardRenderer opponentRenderer;
+  int battlePlace = 0; // Final placement, 1 = won
+  void DrawOpponents();
+
+  // Lock and line-clear particles (effects.h); TETRIS_EFFECT picks the
+  // style, which is also sent to the hub as our effectType
+  Effects effects;
+  int PlayerBoardX(int player) const;
+
+  // Menus, buttons and frames, cached between frames (ui_layer.h)
+  UiLayer staticLayer{screenWidth, screenHeight};
+  uint64_t StaticLayerKey() const;
+  void DrawStaticLayer();
+  TextCache textCache; // Laid-out HUD strings drawn every frame
+
   // Helper functions for drawing player-specific elements
-  void DrawPlayerBoard(const Logic &logic, int boardOffsetX, int boardOffsetY);
+  void DrawPlayerBoard(const Logic &logic, int board, int boardOffsetX,
+                       int boardOffsetY);
+  void DrawPlayerNextFrame(int previewX, int previewY);
   void DrawPlayerNextPiece(const Logic &logic, int previewX, int previewY);
   void DrawPlayerScore(const Logic &logic, int uiAreaX, int &currentY,
                        const std::string &name);
-  void HandlePlayerInput(Logic &logic, int playerIndex, float dasDelay,
-                         float dasRate, float &dasTimer, int &lastMoveDir,
-                         int &lastSpawnCounter, bool &waitForDownRelease);
+  void CollectInput();
+  void HandlePlayerInput(Logic &logic, int playerIndex, int &lastSpawnCounter,
+                         bool &waitForDownRelease);
+
+  // Desync detection (network modes): P1 reports its state hash every few
+  // steps, P2's mirror is checked against it and resynced on mismatch.
+  DesyncDetector desyncDetector;
+  std::string BoardToString(const Logic &logic) const;
+  void SendResyncState();
+  void HandleStateHash(const NetworkMessage &netMsg);
+  void HandleHashHistory(const NetworkMessage &netMsg);
+
+  // Session resume after transient drops (see session_resume.h)
+  SessionResume session;
+  const float keepaliveInterval = 1.0f; // Seconds between PINGs in game
+  const int linkSilenceTimeoutMs = 3000; // No data for this long = drop
+  float keepaliveTimer = 0.0f;
+  bool resumeSent = false;      // Client: RESUME sent on this connection
+  bool resumeListening = false; // Host: listener up for the resuming client
+  bool resumePeerSeen = false;  // Host: a client connected during resume
+  void BeginReconnect();
+  void UpdateReconnect();
+  void FinishResume(int peerAckStep);
+
+  // Remote board playback: inputs (and the SYNC_STATE/STATE_HASH that
+  // follow them) replay at the sender's cadence instead of all at once
+  // when TCP delivers a burst. Anything else flushes it first.
+  JitterBuffer<NetworkMessage> remoteInputBuffer;
+  static bool IsRemoteBoardMessage(NetworkMsgType type);
+  bool ApplyNetworkMessage(const NetworkMessage &netMsg);
+  void FlushRemoteInputs();
+  static int64_t NowMs() { return (int64_t)(Platform::Get().Time() * 1e3); }
+  static int64_t NowUs() { return (int64_t)(Platform::Get().Time() * 1e6); }
+
+  // Host: replays the client's inputs to check the board and score it
+  // reports; a client caught lying gets its SYNC_STATE ignored
+  InputValidator clientValidator;
+  int clientValidation = 0; // Validator match id, 0 when not validating
+  bool clientFlagged = false;
+  void ValidateClientMessage(const NetworkMessage &netMsg);
+  bool CheckClientValidation();
+
+  // Frame pacing as set in main.cpp; slower frames count as dropped
+  const float targetFrameTime = 1.0f / 60.0f;
+#ifndef __EMSCRIPTEN__
+  MetricsServer metricsServer; // Off unless TETRIS_METRICS_PORT is set
+#endif
+
+  // Post-mortem record of the network traffic (flight_recorder.h)
+  double lastFlightDumpTime = -1000.0;
+  void DumpFlightRecord(const char *reason, bool automatic);
+
+  // Falling behind (backgrounded tab): polled messages wait here and are
+  // applied within a per-frame budget, bypassing the jitter buffer
+  CatchUp catchUp;
+  std::deque<std::string> pendingMessages;
+  float frameTime = 0.0f; // GetFrameTime(), clamped by catchUp
+  bool frameTimeStale = false;
+  bool HandlePolledMessage(const std::string &msg, int64_t nowMs,
+                           bool catchingUp);
 
   // Private network-related methods (placeholders for actual network calls)
   void StartHosting();
   void StopHosting();
   void ConnectToHost(const std::string &ip);
+  void ConnectToHub(const std::string &ip);
+  void SendHubJoin();
   void Disconnect();
+  void ProcessHubMessage(const std::string &json);
+  void SendHubEvent(const char *type);
+  void SendHubGameState();
   void
   SendGameEvent(const std::string &eventData); // e.g., "move_left", "rotate"
   void ProcessNetworkEvents(); // Called in Update() to read incoming messages
@@ -0,0 +1,400 @@
+#ifndef HUB_CODEC_H
+#define HUB_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string_view>
+
+// Streaming JSON codec for the Go hub's Message{type,payload} schema
+// (server.go). Writing goes into a caller-owned buffer and reading returns
+// string_views into the received frame, so neither side allocates.
+namespace HubJson {
+
+enum class MsgType {
+  UNKNOWN,
+  IDENTITY,
+  ROOM_STATUS,
+  JOIN_GAME,
+  WAITING_FOR_OPPONENT,
+  GAME_START,
+  GAME_STATE,
+  ATTACK,
+  GAME_OVER,
+  PAUSE,
+  RESUME,
+  PLAYER_LEFT,
+};
+
+inline MsgType ParseType(std::string_view type) {
+  struct Entry {
+    const char *name;
+    MsgType type;
+  };
+  static const Entry table[] = {
+      {"identity", MsgType::IDENTITY},
+      {"room_status", MsgType::ROOM_STATUS},
+      {"join_game", MsgType::JOIN_GAME},
+      {"waiting_for_opponent", MsgType::WAITING_FOR_OPPONENT},
+      {"game_start", MsgType::GAME_START},
+      {"game_state", MsgType::GAME_STATE},
+      {"attack", MsgType::ATTACK},
+      {"game_over", MsgType::GAME_OVER},
+      {"pause", MsgType::PAUSE},
+      {"resume", MsgType::RESUME},
+      {"player_left", MsgType::PLAYER_LEFT},
+  };
+  for (const Entry &e : table) {
+    if (type == e.name)
+      return e.type;
+  }
+  return MsgType::UNKNOWN;
+}
+
+// ---------------------------------------------------------------- Writer --
+
+class Writer {
+public:
+  Writer(char *buffer, size_t capacity) : buf(buffer), cap(capacity) {}
+
+  Writer &BeginObject() { return Open('{'); }
+  Writer &EndObject() { return Close('}'); }
+  Writer &BeginArray() { return Open('['); }
+  Writer &EndArray() { return Close(']'); }
+
+  Writer &Key(const char *key) {
+    Separator();
+    Quoted(key, strlen(key));
+    Put(':');
+    afterKey = true;
+    return *this;
+  }
+
+  Writer &String(std::string_view value) {
+    Separator();
+    Quoted(value.data(), value.size());
+    return *this;
+  }
+
+  Writer &Int(long long value) {
+    Separator();
+    char tmp[24];
+    int n = snprintf(tmp, sizeof(tmp), "%lld", value);
+    Append(tmp, (size_t)n);
+    return *this;
+  }
+
+  Writer &Bool(bool value) {
+    Separator();
+    if (value)
+      Append("true", 4);
+    else
+      Append("false", 5);
+    return *this;
+  }
+
+  // Message{type,payload} envelope: call EndMessage() after the payload
+  Writer &BeginMessage(const char *type) {
+    BeginObject().Key("type").String(type).Key("payload");
+    return *this;
+  }
+  Writer &EndMessage() { return EndObject(); }
+
+  bool Ok() const { return !overflow && depth == 0; }
+  size_t Size() const { return len; }
+  const char *Data() const { return buf; }
+
+private:
+  Writer &Open(char c) {
+    Separator();
+    Put(c);
+    if (depth < 32)
+      needComma &= ~(1u << depth);
+    depth++;
+    return *this;
+  }
+
+  Writer &Close(char c) {
+    if (depth > 0)
+      depth--;
+    Put(c);
+    if (depth > 0 && depth <= 32)
+      needComma |= 1u << (depth - 1);
+    return *this;
+  }
+
+  void Separator() {
+    if (afterKey) {
+      afterKey = false;
+      return;
+    }
+    if (depth == 0 || depth > 32)
+      return;
+    uint32_t bit = 1u << (depth - 1);
+    if (needComma & bit)
+      Put(',');
+    needComma |= bit;
+  }
+
+  void Quoted(const char *s, size_t n) {
+    Put('"');
+    for (size_t i = 0; i < n; i++) {
+      char c = s[i];
+      if (c == '"' || c == '\\') {
+        Put('\\');
+        Put(c);
+      } else if ((unsigned char)c < 0x20) {
+        char tmp[7];
+        snprintf(tmp, sizeof(tmp), "\\u%04x", (unsigned)(unsigned char)c);
+        Append(tmp, 6);
+      } else {
+        Put(c);
+      }
+    }
+    Put('"');
+  }
+
+  void Put(char c) {
+    if (len < cap)
+      buf[len++] = c;
+    else
+      overflow = true;
+  }
+
+  void Append(const char *s, size_t n) {
+    for (size_t i = 0; i < n; i++)
+      Put(s[i]);
+  }
+
+  char *buf;
+  size_t cap;
+  size_t len = 0;
+  int depth = 0;
+  uint32_t needComma = 0; // Bit per nesting level: next value needs ','
+  bool afterKey = false;
+  bool overflow = false;
+};
+
+// ---------------------------------------------------------------- Reader --
+
+inline void SkipWhitespace(const char *&p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+    p++;
+}
+
+// Advance past one JSON value (any type). Returns false on malformed input.
+inline bool SkipValue(const char *&p, const char *end) {
+  SkipWhitespace(p, end);
+  if (p >= end)
+    return false;
+  if (*p == '"') {
+    for (p++; p < end; p++) {
+      if (*p == '\\')
+        p++;
+      else if (*p == '"') {
+        p++;
+        return true;
+      }
+    }
+    return false;
+  }
+  if (*p == '{' || *p == '[') {
+    int nesting = 0;
+    for (; p < end; p++) {
+      if (*p == '"') {
+        if (!SkipValue(p, end))
+          return false;
+        p--;
+      } else if (*p == '{' || *p == '[') {
+        nesting++;
+      } else if (*p == '}' || *p == ']') {
+        if (--nesting == 0) {
+          p++;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+  // Literal: number, true, false, null
+  const char *start = p;
+  while (p < end && *p != ',' && *p != '}' && *p != ']' && *p != ' ' &&
+         *p != '\n' && *p != '\r' && *p != '\t')
+    p++;
+  return p > start;
+}
+
+// Raw slice of the value of `key` in the top level of `object`
+inline bool FindMember(std::string_view object, std::string_view key,
+                       std::string_view &outValue) {
+  const char *p = object.data();
+  const char *end = p + object.size();
+  SkipWhitespace(p, end);
+  if (p >= end || *p != '{')
+    return false;
+  p++;
+  while (true) {
+    SkipWhitespace(p, end);
+    if (p >= end || *p == '}')
+      return false;
+    const char *keyStart = p;
+    if (*p != '"' || !SkipValue(p, end))
+      return false;
+    std::string_view memberKey(keyStart + 1, (size_t)(p - keyStart - 2));
+    SkipWhitespace(p, end);
+    if (p >= end || *p != ':')
+      return false;
+    p++;
+    SkipWhitespace(p, end);
+    const char *valueStart = p;
+    if (!SkipValue(p, end))
+      return false;
+    if (memberKey == key) {
+      outValue = std::string_view(valueStart, (size_t)(p - valueStart));
+      return true;
+    }
+    SkipWhitespace(p, end);
+    if (p < end && *p == ',')
+      p++;
+  }
+}
+
+// Raw string contents (still escaped) without the quotes
+inline bool AsString(std::string_view raw, std::string_view &out) {
+  if (raw.size() < 2 || raw.front() != '"' || raw.back() != '"')
+    return false;
+  out = raw.substr(1, raw.size() - 2);
+  return true;
+}
+
+inline bool AsInt(std::string_view raw, long long &out) {
+  if (raw.empty())
+    return false;
+  size_t i = 0;
+  bool negative = raw[0] == '-';
+  if (negative)
+    i++;
+  if (i >= raw.size())
+    return false;
+  long long value = 0;
+  for (; i < raw.size() && raw[i] >= '0' && raw[i] <= '9'; i++)
+    value = value * 10 + (raw[i] - '0');
+  out = negative ? -value : value;
+  return true;
+}
+
+inline bool AsBool(std::string_view raw, bool &out) {
+  if (raw == "true") {
+    out = true;
+    return true;
+  }
+  if (raw == "false") {
+    out = false;
+    return true;
+  }
+  return false;
+}
+
+// Decode JSON escapes of a string body into a caller buffer (truncates and
+// always NUL-terminates). Non-ASCII \u escapes become '?'.
+inline size_t Unescape(std::string_view s, char *out, size_t cap) {
+  if (cap == 0)
+    return 0;
+  size_t n = 0;
+  for (size_t i = 0; i < s.size() && n + 1 < cap; i++) {
+    char c = s[i];
+    if (c == '\\' && i + 1 < s.size()) {
+      char e = s[++i];
+      switch (e) {
+      case 'n':
+        c = '\n';
+        break;
+      case 't':
+        c = '\t';
+        break;
+      case 'r':
+        c = '\r';
+        break;
+      case 'b':
+        c = '\b';
+        break;
+      case 'f':
+        c = '\f';
+        break;
+      case 'u': {
+        unsigned code = 0;
+        for (int k = 0; k < 4 && i + 1 < s.size(); k++) {
+          char h = s[++i];
+          code = code * 16 + (unsigned)(h <= '9' ? h - '0' : (h | 32) - 'a' + 10);
+        }
+        c = code < 0x80 ? (char)code : '?';
+        break;
+      }
+      default:
+        c = e; // \" \\ \/
+      }
+    }
+    out[n++] = c;
+  }
+  out[n] = '\0';
+  return n;
+}
+
+// Iterates the elements of a JSON array as raw slices
+class ArrayCursor {
+public:
+  explicit ArrayCursor(std::string_view array)
+      : p(array.data()), end(array.data() + array.size()) {
+    SkipWhitespace(p, end);
+    valid = p < end && *p == '[';
+    if (valid)
+      p++;
+  }
+
+  bool Next(std::string_view &outElement) {
+    if (!valid)
+      return false;
+    SkipWhitespace(p, end);
+    if (p < end && *p == ',') {
+      p++;
+      SkipWhitespace(p, end);
+    }
+    if (p >= end || *p == ']')
+      return false;
+    const char *start = p;
+    if (!SkipValue(p, end)) {
+      valid = false;
+      return false;
+    }
+    outElement = std::string_view(start, (size_t)(p - start));
+    return true;
+  }
+
+private:
+  const char *p;
+  const char *end;
+  bool valid;
+};
+
+// Splits a hub frame into its type and raw payload slice. A missing payload
+// (e.g. {"type":"player_left"}) yields an empty view.
+struct MessageView {
+  MsgType type = MsgType::UNKNOWN;
+  std::string_view typeName;
+  std::string_view payload;
+};
+
+inline bool ParseMessage(std::string_view json, MessageView &out) {
+  std::string_view rawType;
+  if (!FindMember(json, "type", rawType) || !AsString(rawType, out.typeName))
+    return false;
+  out.type = ParseType(out.typeName);
+  if (!FindMember(json, "payload", out.payload))
+    out.payload = std::string_view();
+  return true;
+}
+
+} // namespace HubJson
+
+#endif
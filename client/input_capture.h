@@ -0,0 +1,173 @@
+#ifndef INPUT_CAPTURE_H
+#define INPUT_CAPTURE_H
+
+#include "input_queue.h"
+#include "raylib.h"
+
+// raylib's backend, on desktop and web, is GLFW. raylib installs its own
+// key callback in InitWindow(); glfwSetKeyCallback() hands it back, so ours
+// runs first and then forwards every event to it.
+extern "C" {
+struct GLFWwindow;
+typedef void (*GLFWkeyfun)(GLFWwindow *, int, int, int, int);
+GLFWwindow *glfwGetCurrentContext(void);
+GLFWkeyfun glfwSetKeyCallback(GLFWwindow *window, GLFWkeyfun callback);
+#if !defined(PLATFORM_WEB)
+struct GLFWgamepadstate {
+  unsigned char buttons[15];
+  float axes[6];
+};
+int glfwGetGamepadState(int jid, GLFWgamepadstate *state);
+#endif
+}
+
+// Feeds InputQueue (input_queue.h) with the game's keys and gamepad
+// buttons, stamped with GetTime() when the event is dispatched:
+//  - keys from the GLFW callback, as each event pump runs, so a press
+//    and release between two frames are two events;
+//  - gamepads have no callback: Sample() after each pump compares their
+//    state (desktop: straight from GLFW; web: raylib's per-frame state).
+// GLFW delivers events on the main thread only, during a pump, so the
+// stamps are as fine as the loop pumps: main.cpp pumps while it waits for
+// the next frame, and a browser dispatches key events as they happen.
+class InputCapture {
+public:
+  static constexpr int PLAYERS = 2;
+  static constexpr int GAMEPADS = 2; // Gamepad i plays for player i
+
+  // After InitWindow()
+  static void Install(InputQueue *queue) {
+    State &state = Get();
+    state.queue = queue;
+    GLFWwindow *window = glfwGetCurrentContext();
+    if (window && !state.installed) {
+      state.previous = glfwSetKeyCallback(window, OnKey);
+      state.installed = true;
+    }
+  }
+
+  // Before CloseWindow(): raylib's callback goes back in place
+  static void Uninstall() {
+    State &state = Get();
+    GLFWwindow *window = state.installed ? glfwGetCurrentContext() : nullptr;
+    if (window)
+      glfwSetKeyCallback(window, state.previous);
+    state.installed = false;
+    state.queue = nullptr;
+  }
+
+  // After each event pump. No window (headless), no gamepads.
+  static void Sample() {
+    State &state = Get();
+    if (!state.queue || !state.installed)
+      return;
+    double now = GetTime();
+    for (int pad = 0; pad < GAMEPADS; pad++) {
+      bool down[(int)InputAction::COUNT] = {};
+      ReadGamepad(pad, down);
+      for (int a = 0; a < (int)InputAction::COUNT; a++) {
+        if (down[a] == state.pad[pad][a])
+          continue;
+        state.pad[pad][a] = down[a];
+        state.queue->Push({now, (uint8_t)pad, (InputAction)a, down[a]});
+      }
+    }
+  }
+
+  // A key event that did not come from GLFW: headless runs play their
+  // scripts through here (script_platform.h). Other keys are ignored.
+  static void Inject(int key, bool down, double time) {
+    State &state = Get();
+    int player;
+    InputAction input;
+    if (state.queue && MapKey(key, player, input))
+      state.queue->Push({time, (uint8_t)player, input, down});
+  }
+
+  // The game's keys: arrows and space for player 0, WASD for player 1
+  static bool MapKey(int key, int &player, InputAction &action) {
+    switch (key) {
+    case KEY_LEFT:
+      player = 0, action = InputAction::LEFT;
+      return true;
+    case KEY_RIGHT:
+      player = 0, action = InputAction::RIGHT;
+      return true;
+    case KEY_UP:
+    case KEY_SPACE:
+      player = 0, action = InputAction::ROTATE;
+      return true;
+    case KEY_DOWN:
+      player = 0, action = InputAction::SOFT_DROP;
+      return true;
+    case KEY_A:
+      player = 1, action = InputAction::LEFT;
+      return true;
+    case KEY_D:
+      player = 1, action = InputAction::RIGHT;
+      return true;
+    case KEY_W:
+      player = 1, action = InputAction::ROTATE;
+      return true;
+    case KEY_S:
+      player = 1, action = InputAction::SOFT_DROP;
+      return true;
+    default:
+      return false;
+    }
+  }
+
+private:
+  struct State {
+    InputQueue *queue = nullptr;
+    GLFWkeyfun previous = nullptr;
+    bool installed = false;
+    bool pad[GAMEPADS][(int)InputAction::COUNT] = {};
+  };
+
+  static State &Get() {
+    static State state;
+    return state;
+  }
+
+  static void OnKey(GLFWwindow *window, int key, int scancode, int action,
+                    int mods) {
+    State &state = Get();
+    int player;
+    InputAction input;
+    // GLFW_PRESS = 1, GLFW_RELEASE = 0; GLFW_REPEAT (2) is the OS's
+    // auto-repeat, the timeline repeats on its own
+    if (state.queue && action != 2 && MapKey(key, player, input))
+      state.queue->Push({GetTime(), (uint8_t)player, input, action == 1});
+    if (state.previous)
+      state.previous(window, key, scancode, action, mods);
+  }
+
+  // D-pad shifts and soft drops, the bottom face button rotates
+  static void ReadGamepad(int pad, bool *down) {
+#if defined(PLATFORM_WEB)
+    if (!IsGamepadAvailable(pad))
+      return;
+    down[(int)InputAction::LEFT] =
+        IsGamepadButtonDown(pad, GAMEPAD_BUTTON_LEFT_FACE_LEFT);
+    down[(int)InputAction::RIGHT] =
+        IsGamepadButtonDown(pad, GAMEPAD_BUTTON_LEFT_FACE_RIGHT);
+    down[(int)InputAction::ROTATE] =
+        IsGamepadButtonDown(pad, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
+    down[(int)InputAction::SOFT_DROP] =
+        IsGamepadButtonDown(pad, GAMEPAD_BUTTON_LEFT_FACE_DOWN);
+#else
+    GLFWgamepadstate state;
+    if (!glfwGetGamepadState(pad, &state))
+      return;
+    // GLFW_GAMEPAD_BUTTON_A = 0, DPAD_RIGHT = 12, DPAD_DOWN = 13,
+    // DPAD_LEFT = 14
+    down[(int)InputAction::LEFT] = state.buttons[14];
+    down[(int)InputAction::RIGHT] = state.buttons[12];
+    down[(int)InputAction::ROTATE] = state.buttons[0];
+    down[(int)InputAction::SOFT_DROP] = state.buttons[13];
+#endif
+  }
+};
+
+#endif
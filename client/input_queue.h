@@ -0,0 +1,155 @@
+#ifndef INPUT_QUEUE_H
+#define INPUT_QUEUE_H
+
+#include <cstdint>
+#include <vector>
+
+// Timestamped game input. Key and gamepad changes are queued as events
+// with the time they were seen (input_capture.h), instead of polling key
+// state once per frame, so presses shorter than a frame still count. Each
+// frame an InputTimeline per player replays its events in time order and
+// turns them into moves at the exact times they happen:
+//  - a press moves at once; DAS repeats start dasDelay later, then come
+//    every dasRate (ARR), for as long as the key is held;
+//  - the last direction pressed wins; releasing it while the other
+//    direction is held switches back, with a fresh move and charge;
+//  - soft drop repeats every softDropRate while held.
+// Repeats due between two events are emitted between them, so charge and
+// repeats do not depend on the frame rate.
+enum class InputAction : uint8_t { LEFT, RIGHT, ROTATE, SOFT_DROP, COUNT };
+
+struct InputEvent {
+  double time = 0; // Seconds, GetTime()
+  uint8_t player = 0;
+  InputAction action = InputAction::LEFT;
+  bool down = false;
+};
+
+// A move for the game to apply, in time order
+struct InputOp {
+  double time = 0;
+  InputAction action = InputAction::LEFT;
+  bool press = false; // From a press, not a repeat
+};
+
+// Fixed-size FIFO of events in the order they were seen. Full: the newest
+// event is dropped (and counted), the older ones are still replayed.
+class InputQueue {
+public:
+  static constexpr int CAPACITY = 256;
+
+  bool Push(const InputEvent &event) {
+    if (count == CAPACITY) {
+      dropped++;
+      return false;
+    }
+    events[(head + count++) % CAPACITY] = event;
+    return true;
+  }
+
+  bool Pop(InputEvent &event) {
+    if (count == 0)
+      return false;
+    event = events[head];
+    head = (head + 1) % CAPACITY;
+    count--;
+    return true;
+  }
+
+  int Size() const { return count; }
+  uint64_t Dropped() const { return dropped; }
+
+private:
+  InputEvent events[CAPACITY];
+  int head = 0;
+  int count = 0;
+  uint64_t dropped = 0;
+};
+
+class InputTimeline {
+public:
+  // Longest stretch of repeats replayed at once: after a stall (a
+  // backgrounded window) a held key does not fire a burst of moves
+  static constexpr double MAX_CATCH_UP = 0.25;
+
+  InputTimeline(double dasDelay = 0.2, double dasRate = 0.05,
+                double softDropRate = 1.0 / 60.0)
+      : dasDelay(dasDelay), dasRate(dasRate), softDropRate(softDropRate) {}
+
+  // One event of this player; ops due up to it, then its own, go to out
+  void Feed(const InputEvent &event, std::vector<InputOp> &out) {
+    Flush(event.time, out);
+    int a = (int)event.action;
+    if (held[a] == event.down)
+      return; // Repeated press or release (focus changes, two devices)
+    held[a] = event.down;
+    switch (event.action) {
+    case InputAction::LEFT:
+    case InputAction::RIGHT: {
+      int other = (int)(event.action == InputAction::LEFT ? InputAction::RIGHT
+                                                          : InputAction::LEFT);
+      if (event.down)
+        StartShift(event.action, event.time, out);
+      else if (shiftHeld && shift == event.action && held[other])
+        StartShift((InputAction)other, event.time, out);
+      else if (shift == event.action)
+        shiftHeld = false;
+      break;
+    }
+    case InputAction::ROTATE:
+      if (event.down)
+        out.push_back({event.time, InputAction::ROTATE, true});
+      break;
+    case InputAction::SOFT_DROP:
+      if (event.down) {
+        out.push_back({event.time, InputAction::SOFT_DROP, true});
+        nextDrop = event.time + softDropRate;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Repeats due up to until, in time order
+  void Flush(double until, std::vector<InputOp> &out) {
+    double from = until - MAX_CATCH_UP;
+    if (shiftHeld && nextShift < from)
+      nextShift += dasRate * (int)((from - nextShift) / dasRate + 1);
+    if (held[(int)InputAction::SOFT_DROP] && nextDrop < from)
+      nextDrop += softDropRate * (int)((from - nextDrop) / softDropRate + 1);
+    for (;;) {
+      bool shiftDue = shiftHeld && nextShift <= until;
+      bool dropDue = held[(int)InputAction::SOFT_DROP] && nextDrop <= until;
+      if (shiftDue && (!dropDue || nextShift <= nextDrop)) {
+        out.push_back({nextShift, shift, false});
+        nextShift += dasRate;
+      } else if (dropDue) {
+        out.push_back({nextDrop, InputAction::SOFT_DROP, false});
+        nextDrop += softDropRate;
+      } else {
+        break;
+      }
+    }
+  }
+
+  bool IsHeld(InputAction action) const { return held[(int)action]; }
+
+private:
+  void StartShift(InputAction direction, double time,
+                  std::vector<InputOp> &out) {
+    shift = direction;
+    shiftHeld = true;
+    nextShift = time + dasDelay;
+    out.push_back({time, direction, true});
+  }
+
+  double dasDelay, dasRate, softDropRate;
+  bool held[(int)InputAction::COUNT] = {};
+  InputAction shift = InputAction::LEFT; // Direction DAS is charging
+  bool shiftHeld = false;
+  double nextShift = 0; // Time of the next DAS/ARR repeat
+  double nextDrop = 0;  // Time of the next soft drop repeat
+};
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Input for headless runs (script_platform.h): what the player did, frame
+// by frame, one step per line. Written by hand or recorded from a window
+// with TETRIS_RECORD_INPUT.
+//
+//   # frame action arguments
+//   0   click 700 340      # left button pressed and released at x, y
+//   30  key ENTER          # pressed for one frame (IsKeyPressed)
+//   31  text Alice
+//   60  down LEFT          # held from this frame (game keys, DAS)
+//   75  up LEFT
+//   90  press 80 600       # left button held at x, y ...
+//   95  mouse 90 600       # ... dragged ...
+//   99  release            # ... and let go
+//
+// Frames count from 0 and never go back. Key names are raylib's without
+// the KEY_ prefix: A-Z, 0-9, SPACE, ENTER, ESCAPE, BACKSPACE, TAB, LEFT,
+// RIGHT, UP, DOWN, F1-F12. Typed text (GetCharPressed) is the rest of
+// the line, '#' included.
+enum class ScriptAction { KEY, DOWN, UP, TEXT, MOUSE, PRESS, RELEASE, CLICK };
+
+struct ScriptStep {
+  int frame = 0;
+  ScriptAction action = ScriptAction::KEY;
+  int key = 0; // KEY, DOWN, UP
+  int x = 0;   // MOUSE, PRESS, CLICK
+  int y = 0;
+  std::string text; // TEXT
+};
+
+class InputScript {
+public:
+  const std::vector<ScriptStep> &Steps() const { return steps; }
+  bool Empty() const { return steps.empty(); }
+  // One past the last step's frame: the length of one pass
+  int Frames() const { return steps.empty() ? 0 : steps.back().frame + 1; }
+
+  // Steps must come in frame order
+  bool Add(const ScriptStep &step) {
+    if (step.frame < 0 || (!steps.empty() && step.frame < steps.back().frame))
+      return false;
+    steps.push_back(step);
+    return true;
+  }
+
+  // A typed character, added to the frame's text if it already has some
+  bool AddText(int frame, char c) {
+    if (!steps.empty() && steps.back().frame == frame &&
+        steps.back().action == ScriptAction::TEXT) {
+      steps.back().text += c;
+      return true;
+    }
+    ScriptStep step;
+    step.frame = frame;
+    step.action = ScriptAction::TEXT;
+    step.text = std::string(1, c);
+    return Add(step);
+  }
+
+  // Replaces the steps; on error says which line and keeps none
+  bool Parse(const std::string &source, std::string &error) {
+    steps.clear();
+    std::istringstream in(source);
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++) {
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      ScriptStep step;
+      bool blank = false;
+      if (!ParseLine(line, step, blank) || (!blank && !Add(step))) {
+        error = "line " + std::to_string(number) + ": " + line;
+        steps.clear();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool Load(const std::string &path, std::string &error) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if (!f) {
+      error = "cannot open " + path;
+      return false;
+    }
+    std::string source;
+    char buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+      source.append(buffer, n);
+    fclose(f);
+    return Parse(source, error);
+  }
+
+  std::string Format() const {
+    std::string out;
+    char line[64];
+    for (const ScriptStep &step : steps) {
+      snprintf(line, sizeof(line), "%d %s", step.frame,
+               ACTION_NAMES[(int)step.action]);
+      out += line;
+      switch (step.action) {
+      case ScriptAction::KEY:
+      case ScriptAction::DOWN:
+      case ScriptAction::UP:
+        out += ' ';
+        out += KeyName(step.key);
+        break;
+      case ScriptAction::TEXT:
+        out += ' ' + step.text;
+        break;
+      case ScriptAction::MOUSE:
+      case ScriptAction::PRESS:
+      case ScriptAction::CLICK:
+        snprintf(line, sizeof(line), " %d %d", step.x, step.y);
+        out += line;
+        break;
+      case ScriptAction::RELEASE:
+        break;
+      }
+      out += '\n';
+    }
+    return out;
+  }
+
+  // raylib's KeyboardKey values (GLFW's); 0 for an unknown name
+  static int KeyCode(const std::string &name) {
+    if (name.size() == 1 && ((name[0] >= 'A' && name[0] <= 'Z') ||
+                             (name[0] >= '0' && name[0] <= '9')))
+      return name[0]; // KEY_A = 'A', KEY_ZERO = '0'
+    if (name.size() >= 2 && name[0] == 'F' &&
+        name.find_first_not_of("0123456789", 1) == std::string::npos) {
+      int n = atoi(name.c_str() + 1);
+      return n >= 1 && n <= 12 ? 289 + n : 0; // KEY_F1 = 290
+    }
+    for (const NamedKey &key : NAMED_KEYS)
+      if (name == key.name)
+        return key.code;
+    return 0;
+  }
+
+  // nullptr for a key KeyCode() has no name for
+  static const char *KeyName(int code) {
+    static const std::vector<std::string> singles = [] {
+      std::vector<std::string> names(128);
+      for (char c = '0'; c <= 'Z'; c++)
+        names[c] = std::string(1, c);
+      return names;
+    }();
+    if ((code >= 'A' && code <= 'Z') || (code >= '0' && code <= '9'))
+      return singles[code].c_str();
+    static const char *F_KEYS[12] = {"F1", "F2", "F3", "F4",  "F5",  "F6",
+                                     "F7", "F8", "F9", "F10", "F11", "F12"};
+    if (code >= 290 && code <= 301)
+      return F_KEYS[code - 290];
+    for (const NamedKey &key : NAMED_KEYS)
+      if (code == key.code)
+        return key.name;
+    return nullptr;
+  }
+
+private:
+  struct NamedKey {
+    const char *name;
+    int code;
+  };
+  static constexpr NamedKey NAMED_KEYS[] = {
+      {"SPACE", 32}, {"ESCAPE", 256}, {"ENTER", 257}, {"TAB", 258},
+      {"BACKSPACE", 259}, {"RIGHT", 262}, {"LEFT", 263}, {"DOWN", 264},
+      {"UP", 265}};
+  static constexpr const char *ACTION_NAMES[] = {
+      "key", "down", "up", "text", "mouse", "press", "release", "click"};
+
+  // A step, or blank for an empty or comment-only line
+  static bool ParseLine(const std::string &line, ScriptStep &step,
+                        bool &blank) {
+    std::istringstream in(line);
+    std::string action;
+    if (!(in >> step.frame)) {
+      size_t first = line.find_first_not_of(" \t");
+      blank = first == std::string::npos || line[first] == '#';
+      return blank;
+    }
+    if (!(in >> action))
+      return false;
+    int a = 0;
+    while (a < 8 && action != ACTION_NAMES[a])
+      a++;
+    if (a == 8)
+      return false;
+    step.action = (ScriptAction)a;
+    switch (step.action) {
+    case ScriptAction::KEY:
+    case ScriptAction::DOWN:
+    case ScriptAction::UP: {
+      std::string name;
+      in >> name;
+      step.key = KeyCode(name);
+      if (step.key == 0)
+        return false;
+      break;
+    }
+    case ScriptAction::TEXT: {
+      // Everything after the one space, '#' and spaces included
+      std::streamoff at = in.tellg();
+      if (at < 0 || (size_t)at + 1 >= line.size())
+        return false;
+      step.text = line.substr((size_t)at + 1);
+      return true;
+    }
+    case ScriptAction::MOUSE:
+    case ScriptAction::PRESS:
+    case ScriptAction::CLICK:
+      if (!(in >> step.x >> step.y))
+        return false;
+      break;
+    case ScriptAction::RELEASE:
+      break;
+    }
+    std::string rest;
+    return !(in >> rest) || rest[0] == '#'; // Nothing else but a comment
+  }
+
+  std::vector<ScriptStep> steps;
+};
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef INPUT_VALIDATOR_H
+#define INPUT_VALIDATOR_H
+
+#include "logic.h"
+#include "session_resume.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Host-side check that a client's reported board is one its own inputs can
+// produce. Each match keeps a shadow Logic seeded like the client's; the
+// input stream is replayed into it on a worker thread and every claim the
+// client makes (STATE_HASH, the board and score in SYNC_STATE) is compared
+// against the shadow at the same step.
+//
+// The shadow is never touched by SYNC_STATE or resyncs, so a client cannot
+// talk it into a state. A step gap the client never filled (a resume that
+// fell out of its history ring) makes the match unverifiable rather than
+// diverged: the host cannot tell from that alone whether anyone cheated.
+//
+// Callers enqueue from one thread and read results with GetStatus(); one
+// worker serves any number of matches. A replayed input is well under a
+// microsecond, so a match at a few hundred inputs per minute costs far
+// less than 1% of a core.
+class InputValidator {
+public:
+  struct Status {
+    bool diverged = false; // A claim contradicted the inputs
+    bool lost = false;     // Input gap: claims can no longer be checked
+    int divergedStep = -1;
+    std::string reason;
+    int checks = 0;        // Claims compared so far
+    int verifiedStep = 0;  // Last step a claim was confirmed at
+    int step = 0;          // Shadow position
+    int score = 0;         // Score the inputs actually earn
+  };
+
+  InputValidator() {}
+  ~InputValidator() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable())
+      worker.join();
+  }
+
+  InputValidator(const InputValidator &) = delete;
+  InputValidator &operator=(const InputValidator &) = delete;
+
+  // Returns the id used by every other call. Starts the worker on first use.
+  int StartMatch(int seed) {
+    int id = nextMatchId++;
+    {
+      std::lock_guard<std::mutex> lock(statusMutex);
+      published[id] = Status();
+    }
+    Enqueue(Event{Event::START, id, seed, 0, 0, std::string()});
+    if (!worker.joinable())
+      worker = std::thread(&InputValidator::Run, this);
+    return id;
+  }
+
+  void EndMatch(int id) {
+    Enqueue(Event{Event::END, id, 0, 0, 0, std::string()});
+    std::lock_guard<std::mutex> lock(statusMutex);
+    published.erase(id);
+  }
+
+  // One live action: Logic step codes L/R/D/U/G
+  void Input(int id, char code) {
+    Enqueue(Event{Event::INPUTS, id, -1, 0, 0, std::string(1, code)});
+  }
+
+  // Steps fromStep.. sent after a resume (NetworkProtocol INPUTS)
+  void Inputs(int id, int fromStep, const std::string &codes) {
+    Enqueue(Event{Event::INPUTS, id, fromStep, 0, 0, codes});
+  }
+
+  void ClaimHash(int id, int step, uint64_t hash) {
+    Enqueue(Event{Event::HASH, id, step, 0, hash, std::string()});
+  }
+
+  // board: BOARD_HEIGHT * BOARD_WIDTH cell digits as in SYNC_STATE.
+  // step < 0: the claim refers to the inputs received so far.
+  void ClaimState(int id, int step, int score, const std::string &board) {
+    Enqueue(Event{Event::STATE, id, step, score, 0, board});
+  }
+
+  Status GetStatus(int id) const {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    auto it = published.find(id);
+    return it == published.end() ? Status() : it->second;
+  }
+
+  // Blocks until everything enqueued so far has been processed
+  void WaitIdle() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [&]() { return queue.empty() && !busy; });
+  }
+
+  // Worker time spent replaying and comparing
+  double GetBusySeconds() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return busySeconds;
+  }
+
+private:
+  struct Event {
+    enum Kind : char { START, END, INPUTS, HASH, STATE } kind;
+    int match;
+    int step; // START: seed
+    int score;
+    uint64_t hash;
+    std::string data; // Input codes or board digits
+  };
+
+  struct PendingHash {
+    int step;
+    uint64_t hash;
+  };
+
+  struct Match {
+    Logic shadow;
+    Status status;
+    std::vector<PendingHash> pending; // Claims ahead of the inputs
+  };
+
+  void Enqueue(Event event) {
+    bool wasEmpty;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      wasEmpty = queue.empty();
+      queue.push_back(std::move(event));
+    }
+    if (wasEmpty)
+      wake.notify_one();
+  }
+
+  void Run() {
+    std::vector<Event> batch;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      wake.wait(lock, [&]() { return stopping || !queue.empty(); });
+      if (queue.empty())
+        return; // Stopping
+      batch.swap(queue);
+      busy = true;
+      lock.unlock();
+
+      auto start = std::chrono::steady_clock::now();
+      std::vector<int> touched;
+      for (Event &event : batch) {
+        Process(event);
+        if (touched.empty() || touched.back() != event.match)
+          touched.push_back(event.match);
+      }
+      batch.clear();
+      Publish(touched);
+      double seconds = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+      lock.lock();
+      busySeconds += seconds;
+      busy = false;
+      if (queue.empty())
+        idle.notify_all();
+    }
+  }
+
+  void Process(const Event &event) {
+    if (event.kind == Event::START) {
+      Match &match = matches[event.match];
+      match.shadow.Reset(event.step);
+      match.status = Status();
+      match.pending.clear();
+      return;
+    }
+    auto it = matches.find(event.match);
+    if (it == matches.end())
+      return;
+    Match &match = it->second;
+    if (event.kind == Event::END) {
+      matches.erase(it);
+      return;
+    }
+    if (match.status.lost)
+      return;
+    Logic &shadow = match.shadow;
+
+    switch (event.kind) {
+    case Event::INPUTS: {
+      int from = event.step < 0 ? shadow.stepCounter + 1 : event.step;
+      if (SessionResume::ApplyInputs(shadow, from, event.data) < 0) {
+        match.status.lost = true;
+        match.status.reason = "input gap at step " +
+                              std::to_string(shadow.stepCounter + 1);
+        return;
+      }
+      // Claims that arrived ahead of their inputs
+      for (size_t i = 0; i < match.pending.size();) {
+        if (match.pending[i].step > shadow.stepCounter) {
+          i++;
+          continue;
+        }
+        CheckHash(match, match.pending[i].step, match.pending[i].hash);
+        match.pending.erase(match.pending.begin() + i);
+      }
+      break;
+    }
+    case Event::HASH:
+      if (event.step > shadow.stepCounter) {
+        if (match.pending.size() < MAX_PENDING)
+          match.pending.push_back(PendingHash{event.step, event.hash});
+      } else {
+        CheckHash(match, event.step, event.hash);
+      }
+      break;
+    case Event::STATE: {
+      int step = event.step < 0 ? shadow.stepCounter : event.step;
+      if (step != shadow.stepCounter)
+        break; // Not comparable: the shadow keeps no old boards
+      match.status.checks++;
+      if (event.score != shadow.score)
+        Diverge(match, step,
+                "score " + std::to_string(event.score) + ", inputs earn " +
+                    std::to_string(shadow.score));
+      else if (event.data != BoardDigits(shadow))
+        Diverge(match, step, "board");
+      else if (step > match.status.verifiedStep)
+        match.status.verifiedStep = step;
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  void CheckHash(Match &match, int step, uint64_t hash) {
+    uint64_t expected = match.shadow.GetStepHash(step);
+    if (expected == 0)
+      return; // Left the history ring
+    match.status.checks++;
+    if (hash != expected)
+      Diverge(match, step, "state hash");
+    else if (step > match.status.verifiedStep)
+      match.status.verifiedStep = step;
+  }
+
+  static void Diverge(Match &match, int step, const std::string &reason) {
+    if (match.status.diverged)
+      return; // Keep the first one
+    match.status.diverged = true;
+    match.status.divergedStep = step;
+    match.status.reason = reason;
+  }
+
+  static std::string BoardDigits(const Logic &logic) {
+    std::string digits;
+    digits.reserve(BOARD_HEIGHT * BOARD_WIDTH);
+    for (int r = 0; r < BOARD_HEIGHT; r++)
+      for (int c = 0; c < BOARD_WIDTH; c++)
+        digits += std::to_string(logic.board.GetCell(r, c));
+    return digits;
+  }
+
+  void Publish(const std::vector<int> &touched) {
+    std::lock_guard<std::mutex> lock(statusMutex);
+    for (int id : touched) {
+      auto match = matches.find(id);
+      auto status = published.find(id);
+      if (match == matches.end() || status == published.end())
+        continue;
+      match->second.status.step = match->second.shadow.stepCounter;
+      match->second.status.score = match->second.shadow.score;
+      status->second = match->second.status;
+    }
+  }
+
+  static const size_t MAX_PENDING = 64;
+
+  // Producer side
+  int nextMatchId = 1;
+  std::thread worker;
+
+  mutable std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable idle;
+  std::vector<Event> queue;
+  bool stopping = false;
+  bool busy = false;
+  double busySeconds = 0.0;
+
+  mutable std::mutex statusMutex;
+  std::map<int, Status> published;
+
+  // Worker only
+  std::map<int, Match> matches;
+};
+
+#endif
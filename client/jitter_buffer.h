@@ -0,0 +1,147 @@
+#ifndef JITTER_BUFFER_H
+#define JITTER_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+
+// Adaptive playout buffer for time-stamped remote events.
+//
+// Each event carries the sender's clock (ms) when it was produced. The
+// receiver learns the fastest observed transit as a baseline (a windowed
+// minimum of arrival - stamp, so clock offsets cancel out) and replays each
+// event at stamp + baseline + delay, i.e. with the sender's original
+// cadence. The delay follows the measured jitter: it jumps up to cover a
+// late burst (fast attack) and drifts back down (slow release). When the
+// buffer holds more delay than needed, playback runs at (1 + catchUpRate)
+// speed until it is back on target.
+//
+// Events without a stamp keep their place in the queue and play with the
+// stamped event before them. Order is always preserved.
+template <typename T> class JitterBuffer {
+public:
+  struct Config {
+    int minDelayMs = 0;
+    int maxDelayMs = 250;          // No event waits longer than this
+    float catchUpRate = 0.25f;     // Extra playback speed while over target
+    float releaseFactor = 1.0f / 32; // Per event: how fast the target decays
+    int baselineWindowMs = 2000;   // Windowed minimum: adapts to route changes
+    size_t maxItems = 512;         // Beyond this everything plays at once
+  };
+
+  JitterBuffer() : JitterBuffer(Config()) {}
+  explicit JitterBuffer(const Config &config) : config(config) {}
+
+  // stampMs < 0: no timing information (e.g. an older peer)
+  void Push(int64_t stampMs, int64_t nowMs, T item) {
+    if (stampMs >= 0)
+      Observe(stampMs, nowMs);
+    else
+      stampMs = lastStampMs;
+    queue.push_back(Entry{stampMs, nowMs, std::move(item)});
+  }
+
+  // Hands every event that is due by nowMs to apply(T&), oldest first.
+  // Call once per frame. Returns the number of events applied.
+  template <typename F> int Release(int64_t nowMs, F &&apply) {
+    AdvanceDelay(nowMs);
+    int released = 0;
+    while (!queue.empty() && IsDue(queue.front(), nowMs)) {
+      T item = std::move(queue.front().item);
+      queue.pop_front();
+      apply(item);
+      released++;
+    }
+    return released;
+  }
+
+  // Everything now, in order (before a message that must not overtake them)
+  template <typename F> int Flush(F &&apply) {
+    int released = 0;
+    while (!queue.empty()) {
+      T item = std::move(queue.front().item);
+      queue.pop_front();
+      apply(item);
+      released++;
+    }
+    return released;
+  }
+
+  // New match or new peer: forget timing and drop queued events
+  void Reset() { *this = JitterBuffer(config); }
+
+  size_t Size() const { return queue.size(); }
+  float GetDelayMs() const { return delayMs; }        // Currently applied
+  float GetTargetDelayMs() const { return targetMs; } // What jitter calls for
+  int64_t GetBaselineMs() const { return baselineMs; }
+  int GetCatchUpFrames() const { return catchUpFrames; }
+
+private:
+  struct Entry {
+    int64_t stampMs;
+    int64_t arrivalMs;
+    T item;
+  };
+
+  void Observe(int64_t stampMs, int64_t nowMs) {
+    int64_t offset = nowMs - stampMs;
+    if (!hasTiming) {
+      hasTiming = true;
+      windowMin = previousWindowMin = offset;
+      windowStartMs = nowMs;
+    } else if (nowMs - windowStartMs >= config.baselineWindowMs) {
+      previousWindowMin = windowMin;
+      windowMin = offset;
+      windowStartMs = nowMs;
+    } else if (offset < windowMin) {
+      windowMin = offset;
+    }
+    baselineMs = windowMin < previousWindowMin ? windowMin : previousWindowMin;
+
+    float excess = (float)(offset - baselineMs);
+    if (excess > targetMs)
+      targetMs = excess;
+    else
+      targetMs += (excess - targetMs) * config.releaseFactor;
+    if (targetMs < config.minDelayMs)
+      targetMs = (float)config.minDelayMs;
+    if (targetMs > config.maxDelayMs)
+      targetMs = (float)config.maxDelayMs;
+    lastStampMs = stampMs;
+  }
+
+  void AdvanceDelay(int64_t nowMs) {
+    int64_t dt = lastReleaseMs < 0 ? 0 : nowMs - lastReleaseMs;
+    lastReleaseMs = nowMs;
+    if (delayMs < targetMs) {
+      delayMs = targetMs; // Hold once rather than stutter repeatedly
+    } else if (delayMs > targetMs) {
+      delayMs -= config.catchUpRate * (float)dt;
+      if (delayMs < targetMs)
+        delayMs = targetMs;
+      catchUpFrames++;
+    }
+  }
+
+  bool IsDue(const Entry &e, int64_t nowMs) const {
+    if (!hasTiming || e.stampMs < 0)
+      return true;
+    return e.stampMs + baselineMs + (int64_t)delayMs <= nowMs ||
+           nowMs - e.arrivalMs >= config.maxDelayMs ||
+           queue.size() > config.maxItems;
+  }
+
+  Config config;
+  std::deque<Entry> queue;
+  bool hasTiming = false;
+  int64_t lastStampMs = -1;
+  int64_t windowMin = 0, previousWindowMin = 0, windowStartMs = 0;
+  int64_t baselineMs = 0;
+  float targetMs = 0.0f;
+  float delayMs = 0.0f;
+  int64_t lastReleaseMs = -1;
+  int catchUpFrames = 0;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <cstdio>
+
+// Fixed-size log-linear histogram of durations in microseconds (HDR style):
+// exact below 16us, then 16 sub-buckets per power of two, i.e. at most ~6%
+// relative error up to ~18 minutes. Recording is a few integer ops and no
+// allocation, so one instance per thread can sit on a hot path; Merge()
+// combines per-thread instances for reporting.
+class LatencyHistogram {
+public:
+  static const int SUB_BUCKETS = 16;
+  static const int BUCKET_COUNT = SUB_BUCKETS + 37 * SUB_BUCKETS;
+
+  void Record(int64_t us) {
+    if (us < 0)
+      us = 0;
+    counts[Index(us)]++;
+    total++;
+    sumUs += us;
+    if (us > maxUs)
+      maxUs = us;
+  }
+
+  void Merge(const LatencyHistogram &other) {
+    for (int i = 0; i < BUCKET_COUNT; i++)
+      counts[i] += other.counts[i];
+    total += other.total;
+    sumUs += other.sumUs;
+    if (other.maxUs > maxUs)
+      maxUs = other.maxUs;
+  }
+
+  void Clear() { *this = LatencyHistogram(); }
+
+  uint64_t Count() const { return total; }
+  int64_t Max() const { return maxUs; }
+  double Mean() const { return total ? (double)sumUs / total : 0.0; }
+
+  // Value at quantile q (0..1), reported as the bucket midpoint
+  int64_t Percentile(double q) const {
+    if (total == 0)
+      return 0;
+    uint64_t rank = (uint64_t)(q * (double)(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+      seen += counts[i];
+      if (seen >= rank) {
+        int64_t mid = BucketLow(i) + (BucketWidth(i) - 1) / 2;
+        return mid < maxUs ? mid : maxUs;
+      }
+    }
+    return maxUs;
+  }
+
+  // "n=1234 mean=210us p50=180us p99=900us p99.9=1.9ms max=2.3ms"
+  void Format(char *buf, size_t cap) const {
+    char p50[24], p99[24], p999[24], max[24], mean[24];
+    FormatUs(Percentile(0.50), p50, sizeof(p50));
+    FormatUs(Percentile(0.99), p99, sizeof(p99));
+    FormatUs(Percentile(0.999), p999, sizeof(p999));
+    FormatUs(maxUs, max, sizeof(max));
+    FormatUs((int64_t)Mean(), mean, sizeof(mean));
+    snprintf(buf, cap, "n=%llu mean=%s p50=%s p99=%s p99.9=%s max=%s",
+             (unsigned long long)total, mean, p50, p99, p999, max);
+  }
+
+  static void FormatUs(int64_t us, char *buf, size_t cap) {
+    if (us < 1000)
+      snprintf(buf, cap, "%lldus", (long long)us);
+    else if (us < 1000000)
+      snprintf(buf, cap, "%.1fms", us / 1000.0);
+    else
+      snprintf(buf, cap, "%.2fs", us / 1000000.0);
+  }
+
+  static int Index(int64_t us) {
+    if (us < SUB_BUCKETS)
+      return (int)us;
+    int power = 63 - __builtin_clzll((unsigned long long)us); // >= 4
+    int shift = power - 4;
+    int index = SUB_BUCKETS + shift * SUB_BUCKETS +
+                (int)((us >> shift) - SUB_BUCKETS);
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+  }
+
+  static int64_t BucketLow(int index) {
+    if (index < SUB_BUCKETS)
+      return index;
+    int shift = (index - SUB_BUCKETS) / SUB_BUCKETS;
+    int sub = (index - SUB_BUCKETS) % SUB_BUCKETS;
+    return (int64_t)(SUB_BUCKETS + sub) << shift;
+  }
+
+  static int64_t BucketWidth(int index) {
+    if (index < SUB_BUCKETS)
+      return 1;
+    return (int64_t)1 << ((index - SUB_BUCKETS) / SUB_BUCKETS);
+  }
+
+private:
+  uint64_t counts[BUCKET_COUNT] = {};
+  uint64_t total = 0;
+  int64_t sumUs = 0;
+  int64_t maxUs = 0;
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "logic.h"
+#include "state_hash.h"
 #include <cstring> // For memset
 #include <random>
 
@@ -23,6 +24,7 @@ Logic::Logic() : dist(1, 7) {
 
   // Initialize score
   score = 0;
+  RefreshStepHash();
 }
 
 void Logic::SpawnPiece() {
@@ -49,8 +51,10 @@ void Logic::SpawnPiece() {
 }
 
 void Logic::Tick() {
-  if (isGameOver)
+  if (isGameOver) {
+    RecordStep('G');
     return; // Do nothing if game is over
+  }
 
   // Check if the piece could move down. If not, it means it collided,
   // so lock it and spawn a new one.
@@ -63,11 +67,15 @@ void Logic::Tick() {
     SpawnPiece(); // This will now correctly use nextPiece and generate a new
                   // one.
   }
+  RecordStep('G');
 }
 
 void Logic::Move(int dx, int dy) {
-  if (isGameOver)
+  char input = dx < 0 ? 'L' : (dx > 0 ? 'R' : 'D');
+  if (isGameOver) {
+    RecordStep(input);
     return; // Cannot move if game is over
+  }
 
   Piece next = currentPiece;
   next.x += dx;
@@ -75,11 +83,14 @@ void Logic::Move(int dx, int dy) {
   if (IsValidPosition(next)) {
     currentPiece = next;
   }
+  RecordStep(input);
 }
 
 void Logic::Rotate() {
-  if (isGameOver)
+  if (isGameOver) {
+    RecordStep('U');
     return; // Cannot rotate if game is over
+  }
 
   Piece next = currentPiece;
   next.rotation = (next.rotation + 1) % 4;
@@ -88,6 +99,7 @@ void Logic::Rotate() {
     currentPiece = next;
   }
   // TODO: Add Wall Kick (try checking x-1, x+1, etc.)
+  RecordStep('U');
 }
 
 bool Logic::IsValidPosition(const Piece &p) const {
@@ -116,6 +128,9 @@ void Logic::LockPiece() {
   if (isGameOver)
     return; // Cannot lock if game is over
 
+  lastLock = LockEvent();
+  lastLock.type = currentPiece.type;
+  lockCounter++;
   for (int i = 0; i < 4; i++) {
     int bx, by;
     currentPiece.GetBlock(currentPiece.rotation, i, bx, by);
@@ -127,6 +142,8 @@ void Logic::LockPiece() {
     if (boardX >= 0 && boardX < BOARD_WIDTH && boardY >= 0 &&
         boardY < BOARD_HEIGHT) {
       board.SetCell(boardY, boardX, (int)currentPiece.type);
+      lastLock.blockRows[lastLock.blockCount] = boardY;
+      lastLock.blockCols[lastLock.blockCount++] = boardX;
     }
   }
   CheckLines();
@@ -148,6 +165,9 @@ void Logic::CheckLines() {
     }
 
     if (full) {
+      // Rows above a cleared row have moved down by one per cleared row
+      if (linesClearedThisTurn < 4)
+        lastLock.clearedRows[linesClearedThisTurn] = y - linesClearedThisTurn;
       linesClearedThisTurn++;
       // Shift all rows above down by one
       for (int r = y; r > 0; r--) {
@@ -164,6 +184,8 @@ void Logic::CheckLines() {
     }
   }
 
+  lastLock.linesCleared = linesClearedThisTurn;
+
   // Award points based on lines cleared
   if (linesClearedThisTurn > 0) {
     switch (linesClearedThisTurn) {
@@ -193,8 +215,13 @@ void Logic::Reset(int seed) {
 
   // Reset game state variables
   spawnCounter = 0;
+  stepCounter = 0;
+  memset(stepHashes, 0, sizeof(stepHashes));
+  memset(stepInputs, 0, sizeof(stepInputs));
   score = 0; // Reset score
   isGameOver = false;
+  lockCounter = 0;
+  lastLock = LockEvent();
 
   // Re-seed RNG if a specific seed is provided, or generate a new random one
   if (seed != -1) {
@@ -214,4 +241,47 @@ void Logic::Reset(int seed) {
   nextPiece.y = 0;
   nextPiece.rotation = 0;
   SpawnPiece();
-}
\ No newline at end of file
+  RefreshStepHash(); // Step 0 is the freshly seeded state
+}
+
+uint64_t Logic::StateHash() const {
+  uint64_t h = board.GetHash();
+  h ^= StateHash::PieceKey(StateHash::DOMAIN_CURRENT, (int)currentPiece.type,
+                           currentPiece.x, currentPiece.y,
+                           currentPiece.rotation);
+  h ^= StateHash::PieceKey(StateHash::DOMAIN_NEXT, (int)nextPiece.type, 0, 0,
+                           0);
+  h ^= StateHash::ValueKey(StateHash::DOMAIN_SCORE, score);
+  if (isGameOver)
+    h ^= StateHash::ValueKey(StateHash::DOMAIN_GAME_OVER, 1);
+  return h;
+}
+
+void Logic::RecordStep(char input) {
+  stepCounter++;
+  stepInputs[stepCounter % STEP_HISTORY] = input;
+  stepHashes[stepCounter % STEP_HISTORY] = StateHash();
+}
+
+void Logic::RefreshStepHash() {
+  stepHashes[stepCounter % STEP_HISTORY] = StateHash();
+}
+
+void Logic::RestartStepHistory(int step) {
+  stepCounter = step;
+  memset(stepHashes, 0, sizeof(stepHashes));
+  memset(stepInputs, 0, sizeof(stepInputs));
+  RefreshStepHash();
+}
+
+uint64_t Logic::GetStepHash(int step) const {
+  if (step < 0 || step > stepCounter || stepCounter - step >= STEP_HISTORY)
+    return 0;
+  return stepHashes[step % STEP_HISTORY];
+}
+
+char Logic::GetStepInput(int step) const {
+  if (step <= 0 || step > stepCounter || stepCounter - step >= STEP_HISTORY)
+    return 0;
+  return stepInputs[step % STEP_HISTORY];
+}
@@ -3,6 +3,7 @@
 
 #include "board.h"
 #include "piece.h"
+#include <cstdint>
 #include <random>
 
 const int BOARD_WIDTH = 10;
@@ -35,7 +36,36 @@ public:
   int spawnCounter = 0; // New: Tracks how many pieces have spawned
   int score;            // Feature: Stores the current game score
 
+  // What the last LockPiece() placed and cleared, for effects (effects.h).
+  // lockCounter tells a new lock from one already seen.
+  struct LockEvent {
+    PieceType type = PieceType::NONE;
+    int blockCount = 0;
+    int blockRows[4] = {}, blockCols[4] = {};
+    int linesCleared = 0;
+    int clearedRows[4] = {}; // Rows as they were before the clear
+  };
+  int lockCounter = 0;
+  LockEvent lastLock;
+
+  // Desync detection: every external action (Move/Rotate/Tick) is one step.
+  // The state hash after each step is kept in a small ring so a peer's
+  // reported hash for step N can be checked without re-simulating.
+  static const int STEP_HISTORY = 256;
+  int stepCounter = 0;              // Number of actions applied since Reset
+  uint64_t StateHash() const;       // O(1): board hash is incremental
+  uint64_t GetStepHash(int step) const; // 0 if step is outside the ring
+  char GetStepInput(int step) const;    // Action code, 0 if unknown
+  void RefreshStepHash(); // Re-record after external edits (SYNC_STATE)
+  // Full resync to `step`: forgets every recorded step, then records the
+  // current state as that step
+  void RestartStepHistory(int step);
+
 private:
+  void RecordStep(char input);
+  uint64_t stepHashes[STEP_HISTORY] = {};
+  char stepInputs[STEP_HISTORY] = {};
+
   std::mt19937 rng;
   std::uniform_int_distribution<int> dist;
 };
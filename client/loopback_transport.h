@@ -0,0 +1,227 @@
+#ifndef LOOPBACK_TRANSPORT_H
+#define LOOPBACK_TRANSPORT_H
+
+#include "transport.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// One direction of an in-process connection: a bounded byte ring. Writers
+// block while it is full, like a TCP send buffer, so a fast sender cannot
+// grow memory without bound.
+class LoopbackPipe {
+public:
+  static const size_t CAPACITY = 256 * 1024;
+
+  LoopbackPipe() : ring(CAPACITY) {}
+
+  int Write(const char *data, size_t len) {
+    size_t written = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (written < len) {
+      changed.wait(lock, [&]() { return closed || size < CAPACITY; });
+      if (closed)
+        return -1;
+      size_t chunk = std::min(len - written, CAPACITY - size);
+      size_t writePos = (readPos + size) % CAPACITY;
+      size_t first = std::min(chunk, CAPACITY - writePos);
+      memcpy(&ring[writePos], data + written, first);
+      memcpy(&ring[0], data + written + first, chunk - first);
+      size += chunk;
+      written += chunk;
+      changed.notify_all();
+    }
+    return (int)len;
+  }
+
+  // timeoutMs 0 waits forever. Returns -1 on timeout or reader shutdown.
+  int Read(char *buf, size_t cap, int timeoutMs, bool consume) {
+    std::unique_lock<std::mutex> lock(mutex);
+    auto ready = [&]() { return size > 0 || closed || writerDone; };
+    if (timeoutMs > 0) {
+      if (!changed.wait_for(lock, std::chrono::milliseconds(timeoutMs), ready))
+        return -1;
+    } else {
+      changed.wait(lock, ready);
+    }
+    if (size == 0)
+      return closed ? -1 : 0; // 0: writer finished, orderly close
+    size_t chunk = std::min(cap, size);
+    size_t first = std::min(chunk, CAPACITY - readPos);
+    memcpy(buf, &ring[readPos], first);
+    memcpy(buf + first, &ring[0], chunk - first);
+    if (consume) {
+      readPos = (readPos + chunk) % CAPACITY;
+      size -= chunk;
+      changed.notify_all();
+    }
+    return (int)chunk;
+  }
+
+  // Writer side is done: the reader drains what is left, then sees 0
+  void FinishWriting() {
+    std::lock_guard<std::mutex> lock(mutex);
+    writerDone = true;
+    changed.notify_all();
+  }
+
+  // Reader side is gone: wake everyone, further writes fail
+  void Close() {
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    changed.notify_all();
+  }
+
+private:
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<char> ring;
+  size_t readPos = 0;
+  size_t size = 0;
+  bool writerDone = false;
+  bool closed = false;
+};
+
+class LoopbackStream : public TransportStream {
+public:
+  LoopbackStream(std::shared_ptr<LoopbackPipe> in,
+                 std::shared_ptr<LoopbackPipe> out)
+      : in(std::move(in)), out(std::move(out)) {}
+  ~LoopbackStream() override { Shutdown(); }
+
+  int Send(const char *data, size_t len) override {
+    return out->Write(data, len);
+  }
+
+  int Recv(char *buf, size_t cap) override {
+    return in->Read(buf, cap, recvTimeoutMs, true);
+  }
+
+  int Peek(char *buf, size_t cap, int timeoutMs) override {
+    int n = in->Read(buf, cap, timeoutMs > 0 ? timeoutMs : 1, false);
+    return n < 0 ? 0 : n;
+  }
+
+  void SetRecvTimeout(int timeoutMs) override { recvTimeoutMs = timeoutMs; }
+
+  void Shutdown() override {
+    in->Close();
+    out->FinishWriting();
+  }
+
+  // A connected pair, as socketpair() would return
+  static void CreatePair(std::unique_ptr<TransportStream> &a,
+                         std::unique_ptr<TransportStream> &b) {
+    std::shared_ptr<LoopbackPipe> ab = std::make_shared<LoopbackPipe>();
+    std::shared_ptr<LoopbackPipe> ba = std::make_shared<LoopbackPipe>();
+    a.reset(new LoopbackStream(ba, ab));
+    b.reset(new LoopbackStream(ab, ba));
+  }
+
+private:
+  std::shared_ptr<LoopbackPipe> in;
+  std::shared_ptr<LoopbackPipe> out;
+  std::atomic<int> recvTimeoutMs{0};
+};
+
+class LoopbackListener;
+
+// Process-wide table of listening "ports"
+class LoopbackRegistry {
+public:
+  static LoopbackRegistry &Get() {
+    static LoopbackRegistry registry;
+    return registry;
+  }
+
+  std::mutex mutex;
+  std::map<int, LoopbackListener *> listeners;
+};
+
+class LoopbackListener : public TransportListener {
+public:
+  explicit LoopbackListener(int port) : port(port) {}
+  ~LoopbackListener() override { Close(); }
+
+  std::unique_ptr<TransportStream> Accept() override {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [&]() { return closed || !pending.empty(); });
+    if (closed)
+      return nullptr;
+    std::unique_ptr<TransportStream> stream = std::move(pending.front());
+    pending.pop_front();
+    return stream;
+  }
+
+  void Close() override {
+    {
+      LoopbackRegistry &registry = LoopbackRegistry::Get();
+      std::lock_guard<std::mutex> lock(registry.mutex);
+      auto it = registry.listeners.find(port);
+      if (it != registry.listeners.end() && it->second == this)
+        registry.listeners.erase(it);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    closed = true;
+    pending.clear();
+    changed.notify_all();
+  }
+
+  // Called by connectors with the registry lock held, so the listener
+  // cannot be destroyed underneath them
+  void Enqueue(std::unique_ptr<TransportStream> stream) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending.push_back(std::move(stream));
+    changed.notify_all();
+  }
+
+private:
+  int port;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::deque<std::unique_ptr<TransportStream>> pending;
+  bool closed = false;
+};
+
+// In-process connections; the address is ignored and ports live in a
+// process-wide table, so tests never need a free TCP port.
+class LoopbackTransport : public Transport {
+public:
+  TransportKind Kind() const override { return TransportKind::LOOPBACK; }
+
+  std::unique_ptr<TransportListener> Listen(int port,
+                                            const char *&error) override {
+    LoopbackRegistry &registry = LoopbackRegistry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (registry.listeners.count(port)) {
+      error = "Port already in use";
+      return nullptr;
+    }
+    LoopbackListener *listener = new LoopbackListener(port);
+    registry.listeners[port] = listener;
+    return std::unique_ptr<TransportListener>(listener);
+  }
+
+  std::unique_ptr<TransportStream>
+  Connect(const std::string &, int port, int, const std::atomic<bool> &,
+          const char *&error) override {
+    LoopbackRegistry &registry = LoopbackRegistry::Get();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto it = registry.listeners.find(port);
+    if (it == registry.listeners.end()) {
+      error = "Connection refused";
+      return nullptr;
+    }
+    std::unique_ptr<TransportStream> client, server;
+    LoopbackStream::CreatePair(client, server);
+    it->second->Enqueue(std::move(server));
+    return client;
+  }
+};
+
+#endif
@@ -1,21 +1,85 @@
+#include "frame_pacer.h"
+#include "frame_scheduler.h"
 #include "game.h"
+#include "input_capture.h"
 #include "raylib.h"
+#include "script_platform.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <bitset>
+#include <string>
 
 #if defined(PLATFORM_WEB)
 #include <emscripten/emscripten.h>
+#else
+// raylib's desktop backend is GLFW, linked into raylib. raylib has no call
+// to block for events with a timeout, or to end such a wait from another
+// thread (the network thread, through NetworkManager::SetWakeHandler).
+extern "C" void glfwWaitEventsTimeout(double timeout);
+extern "C" void glfwPollEvents(void);
+extern "C" void glfwPostEmptyEvent(void);
 #endif
 
 // Global game instance for the loop callback
 Game *gameInstance = nullptr;
+FrameScheduler frameScheduler; // Skips redraws and blocks on idle screens
+FramePacer framePacer;         // Late input sampling, input latency
+
+// Stamps key and mouse button changes for FramePacer, and samples the
+// gamepads: called right after each event pump, so the time is when the
+// loop saw the change
+void StampInput() {
+  InputCapture::Sample();
+  static std::bitset<KEY_KP_EQUAL + 1 + MOUSE_BUTTON_BACK + 1> last;
+  std::bitset<KEY_KP_EQUAL + 1 + MOUSE_BUTTON_BACK + 1> down;
+  for (int key = KEY_SPACE; key <= KEY_KP_EQUAL; key++)
+    down[key] = IsKeyDown(key);
+  for (int button = 0; button <= MOUSE_BUTTON_BACK; button++)
+    down[KEY_KP_EQUAL + 1 + button] = IsMouseButtonDown(button);
+  if (down != last)
+    framePacer.InputEvent(GetTime());
+  last = down;
+}
+
+// Per-screen frame and CPU totals go to the metrics; a summary is logged
+// whenever the screen changes
+void AccountFrame() {
+  double cpu = (double)std::clock() / CLOCKS_PER_SEC;
+  if (!frameScheduler.Account((int)gameInstance->GetState(), GetTime(), cpu))
+    return;
+  const FrameScheduler::Visit &visit = frameScheduler.LastVisit();
+  TraceLog(LOG_INFO,
+           "FRAME: %s for %.1f s: %d frames drawn, %d skipped, CPU %.1f%%",
+           Metrics::SCREEN_NAMES[visit.screen], visit.seconds, visit.drawn,
+           visit.skipped,
+           visit.seconds > 0 ? 100.0 * visit.cpuSeconds / visit.seconds : 0.0);
+  if (framePacer.Latency().Count() > 0) {
+    char summary[192];
+    framePacer.Latency().Format(summary, sizeof(summary));
+    TraceLog(LOG_INFO, "FRAME: input to frame submitted: %s, %llu missed",
+             summary, (unsigned long long)framePacer.Missed());
+    framePacer.ClearLatency();
+  }
+}
 
 void UpdateDrawFrame() {
   if (!gameInstance)
     return;
 
   // 1. Update
+  Platform::Get().BeginFrame();
+  gameInstance->SetFrameTimeStale(frameScheduler.FrameTimeStale());
   gameInstance->Update();
 
-  // 2. Draw
+  // 2. Draw, unless an idle screen looks the same as last frame
+  if (!frameScheduler.ShouldDraw(gameInstance->IsAnimating(),
+                                 gameInstance->FrameKey())) {
+    PollInputEvents(); // What EndDrawing() would have done
+    AccountFrame();
+    return;
+  }
   BeginDrawing();
   ClearBackground(BLACK); // Changed to BLACK for a darker main app background
   DrawText("Tetris Battle Client", 10, 10, 20,
@@ -26,9 +90,148 @@ void UpdateDrawFrame() {
   gameInstance->Draw();
 
   EndDrawing();
+  AccountFrame();
 }
 
-int main() {
+#if !defined(PLATFORM_WEB)
+// --headless: the whole Game state machine (menus, network setup, play,
+// game over) driven by an input script (input_script.h) on a virtual
+// 60 FPS clock, with no window: Update() only, back to back, as fast as
+// the CPU goes. Reports how long Update() took per frame.
+struct HeadlessOptions {
+  std::string script;
+  long long frames = 0; // 0: one pass of the script
+  bool verbose = false; // Keep the game's INFO logs
+};
+
+void PrintUsage() {
+  printf("Usage: TetrisClient [--headless SCRIPT [options]]\n"
+         "  --headless SCRIPT    Play SCRIPT with no window, unthrottled\n"
+         "  --frames N           Frames to run, repeating the script "
+         "(default: one pass)\n"
+         "  --verbose            Keep the game's INFO logs\n"
+         "With no options the game opens its window. TETRIS_RECORD_INPUT="
+         "PATH\nrecords a windowed session as a script.\n");
+}
+
+bool ParseArgs(int argc, char **argv, HeadlessOptions &opt) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      exit(0);
+    }
+    if (arg == "--verbose") {
+      opt.verbose = true;
+      continue;
+    }
+    if (!value) {
+      fprintf(stderr, "Missing value for %s\n", arg.c_str());
+      return false;
+    }
+    i++;
+    if (arg == "--headless")
+      opt.script = value;
+    else if (arg == "--frames")
+      opt.frames = atoll(value);
+    else {
+      fprintf(stderr, "Unknown option %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return !opt.script.empty() && opt.frames >= 0;
+}
+
+int RunHeadless(const HeadlessOptions &opt) {
+  InputScript script;
+  std::string error;
+  if (!script.Load(opt.script, error)) {
+    fprintf(stderr, "%s: %s\n", opt.script.c_str(), error.c_str());
+    return 1;
+  }
+  long long frames = opt.frames > 0 ? opt.frames : script.Frames();
+  if (frames == 0) {
+    fprintf(stderr, "%s: no steps and no --frames\n", opt.script.c_str());
+    return 1;
+  }
+  if (!opt.verbose) {
+    SetTraceLogLevel(LOG_WARNING);
+    AsyncLog::Get().SetLevel(LOG_WARNING); // Network threads
+  }
+
+  ScriptPlatform platform(script);
+  Platform::Set(&platform);
+  gameInstance = new Game();
+
+  LatencyHistogram updateTimes; // Spikes; most frames take under 1 us
+  double updateSeconds = 0;
+  long long screenFrames[Metrics::SCREEN_COUNT] = {};
+  uint64_t allocations = Metrics::Get().Collect().allocations;
+  double cpuStart = (double)std::clock() / CLOCKS_PER_SEC;
+  auto start = std::chrono::steady_clock::now();
+  for (long long frame = 0; frame < frames; frame++) {
+    platform.BeginFrame();
+    auto before = std::chrono::steady_clock::now();
+    gameInstance->Update();
+    auto after = std::chrono::steady_clock::now();
+    updateSeconds += std::chrono::duration<double>(after - before).count();
+    updateTimes.Record(
+        std::chrono::duration_cast<std::chrono::microseconds>(after - before)
+            .count());
+    int screen = (int)gameInstance->GetState();
+    if (screen >= 0 && screen < Metrics::SCREEN_COUNT)
+      screenFrames[screen]++;
+  }
+  double wall = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+  double cpu = (double)std::clock() / CLOCKS_PER_SEC - cpuStart;
+  allocations = Metrics::Get().Collect().allocations - allocations;
+  double simulated = frames * ScriptPlatform::FRAME_TIME;
+
+  char summary[192];
+  updateTimes.Format(summary, sizeof(summary));
+  printf("frames     %lld (%.1f passes of %s)\n", frames,
+         script.Frames() ? (double)frames / script.Frames() : 0.0,
+         opt.script.c_str());
+  printf("wall       %.3f s, %.1f s simulated: %.0fx real time, %.0f "
+         "frames/s\n",
+         wall, simulated, wall > 0 ? simulated / wall : 0.0,
+         wall > 0 ? frames / wall : 0.0);
+  printf("cpu        %.3f s (%.0f%% of wall)\n", cpu,
+         wall > 0 ? 100.0 * cpu / wall : 0.0);
+  printf("update     %.3f us mean, %s\n", 1e6 * updateSeconds / frames,
+         summary);
+  printf("allocs     %.1f per frame\n",
+         frames ? (double)allocations / frames : 0.0);
+  for (int screen = 0; screen < Metrics::SCREEN_COUNT; screen++)
+    if (screenFrames[screen])
+      printf("screen     %-15s %lld frames\n", Metrics::SCREEN_NAMES[screen],
+             screenFrames[screen]);
+
+  delete gameInstance;
+  gameInstance = nullptr;
+  Platform::Set(nullptr);
+  return 0;
+}
+#endif
+
+int main(int argc, char **argv) {
+#if !defined(PLATFORM_WEB)
+  if (argc > 1) {
+    HeadlessOptions opt;
+    if (!ParseArgs(argc, argv, opt)) {
+      PrintUsage();
+      return 1;
+    }
+    return RunHeadless(opt);
+  }
+#else
+  (void)argc;
+  (void)argv;
+#endif
+
   const int screenWidth = 1400;
   const int screenHeight = 750; // Increased for touch controls
 
@@ -42,18 +245,65 @@ int main() {
   // 1 means simulate infinite loop
   emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
 #else
-  SetTargetFPS(60);
+  // The loop paces itself (frame_pacer.h) instead of raylib's timer, so
+  // it can pump events while it waits: input is stamped as it arrives.
+  // Latency mode samples input as late as the recent render cost allows.
+  const char *lowLatency = getenv("TETRIS_LOW_LATENCY");
+  bool latencyMode = lowLatency && atoi(lowLatency) > 0;
+  framePacer.SetLateSampling(latencyMode);
+  if (latencyMode)
+    TraceLog(LOG_INFO, "FRAME: Latency mode, input sampled before the "
+                       "deadline");
+  // Records this session as a headless input script (script_platform.h)
+  const char *recordPath = getenv("TETRIS_RECORD_INPUT");
+  RecordingPlatform recorder(Platform::Get());
+  if (recordPath && *recordPath)
+    Platform::Set(&recorder);
+  NetworkManager::SetWakeHandler(glfwPostEmptyEvent);
   while (!WindowShouldClose()) {
+    if (!gameInstance->IsAnimating())
+      framePacer.Restart();
+    // Input wakes the wait, so each change is stamped as it arrives
+    double wakeAt = framePacer.WakeAt();
+    for (double now = GetTime(); now < wakeAt; now = GetTime()) {
+      glfwWaitEventsTimeout(wakeAt - now);
+      StampInput();
+    }
+    glfwPollEvents(); // Latest input, without raylib's pressed-state swap
+    StampInput();
+    double sampleTime = GetTime();
     UpdateDrawFrame();
+    if (frameScheduler.Drew())
+      framePacer.FrameSubmitted(sampleTime, GetTime());
+    // Idle screens sleep until input, network activity or their next timer
+    double wait = frameScheduler.WaitTimeout(gameInstance->IsAnimating(),
+                                             gameInstance->NextTimerIn());
+    if (wait > 0) {
+      glfwWaitEventsTimeout(wait);
+      frameScheduler.Waited();
+    }
+  }
+  NetworkManager::SetWakeHandler(nullptr);
+  if (recordPath && *recordPath) {
+    Platform::Set(nullptr);
+    FILE *f = fopen(recordPath, "w");
+    std::string steps = recorder.Script().Format();
+    if (!f || fwrite(steps.data(), 1, steps.size(), f) != steps.size())
+      TraceLog(LOG_WARNING, "INPUT: Cannot write %s", recordPath);
+    else
+      TraceLog(LOG_INFO, "INPUT: %d frames recorded to %s",
+               recorder.Script().Frames(), recordPath);
+    if (f)
+      fclose(f);
   }
 #endif
 
-  CloseWindow();
-
   // Cleanup (Note: WebAssembly usually kills memory on exit anyway, but good
-  // practice)
+  // practice). Before CloseWindow: the game frees its textures and shaders.
   if (gameInstance)
     delete gameInstance;
 
+  CloseWindow();
+
   return 0;
 }
\ No newline at end of file
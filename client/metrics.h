@@ -0,0 +1,373 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "network_protocol.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Process-wide counters, gauges and histograms for headless hosts, exported
+// in the Prometheus text format (metrics_server.h serves them over HTTP).
+//
+// Counters and histograms live in per-thread shards: recording is a relaxed
+// load and store on memory no other thread writes, so the network threads
+// and the game loop never contend or lock. A scrape sums the shards of all
+// threads; shards of exited threads are folded into a retired total so
+// counters never go backwards. Gauges are single values set by their owner.
+class Metrics {
+public:
+  // Counters are labelled by message type where it applies (label 0, i.e.
+  // UNKNOWN, otherwise). Hub JSON documents count as UNKNOWN.
+  enum Counter {
+    MESSAGES_IN,
+    MESSAGES_OUT,
+    BYTES_IN,
+    BYTES_OUT,
+    DROPPED_FRAMES, // Frames that took over 1.5x the target frame time
+    DESYNCS,        // State hash mismatches that triggered a resync
+    // Labelled by screen (SCREEN_NAMES) instead of message type
+    FRAMES_DRAWN,   // Main loop passes that drew
+    FRAMES_IDLE,    // Passes that skipped drawing (frame_scheduler.h)
+    SCREEN_WALL_US, // Time spent on each screen
+    SCREEN_CPU_US,  // Process CPU time spent on each screen
+    COUNTER_COUNT
+  };
+
+  enum Gauge {
+    SESSIONS_ACTIVE,
+    NETWORK_QUEUE,  // Messages handed over by the last PollMessages()
+    PENDING_QUEUE,  // Polled, not yet applied (catch_up.h)
+    JITTER_QUEUE,   // Remote inputs waiting for playout (jitter_buffer.h)
+    GAUGE_COUNT
+  };
+
+  enum Histogram {
+    RTT,           // PING round trip, game thread to game thread
+    TICK_DURATION, // One Game::Update()
+    INPUT_LATENCY, // Key or button change to its frame's submission
+    HISTOGRAM_COUNT
+  };
+
+  static constexpr int LABEL_COUNT = (int)NetworkMsgType::PING + 1;
+  // GameState order
+  static constexpr int SCREEN_COUNT = 6;
+  static constexpr const char *SCREEN_NAMES[SCREEN_COUNT] = {
+      "title", "mode_selection", "network_setup",
+      "playing", "paused", "game_over"};
+  static_assert(SCREEN_COUNT <= LABEL_COUNT, "screens share the label space");
+  static constexpr int BUCKET_COUNT = 12;
+  // Upper bounds in microseconds, shared by all histograms
+  static constexpr int64_t BUCKET_US[BUCKET_COUNT] = {
+      100,   250,   500,    1000,   2500,   5000,
+      10000, 25000, 50000,  100000, 250000, 1000000};
+
+  Metrics() : id(NextId()) {}
+  Metrics(const Metrics &) = delete;
+  Metrics &operator=(const Metrics &) = delete;
+
+  static Metrics &Get() {
+    static Metrics instance;
+    return instance;
+  }
+
+  void Add(Counter counter, uint64_t n = 1, int label = 0) {
+    Bump(LocalShard().counters[counter][Clamp(label)], n);
+  }
+
+  void CountMessage(bool in, NetworkMsgType type, size_t bytes) {
+    Shard &shard = LocalShard();
+    int label = Clamp((int)type);
+    Bump(shard.counters[in ? MESSAGES_IN : MESSAGES_OUT][label], 1);
+    Bump(shard.counters[in ? BYTES_IN : BYTES_OUT][label], bytes);
+  }
+
+  void Observe(Histogram histogram, int64_t us) {
+    if (us < 0)
+      us = 0;
+    Shard &shard = LocalShard();
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT && us > BUCKET_US[bucket])
+      bucket++;
+    Bump(shard.buckets[histogram][bucket], 1); // BUCKET_COUNT: +Inf
+    Bump(shard.sumUs[histogram], (uint64_t)us);
+  }
+
+  void Set(Gauge gauge, int64_t value) {
+    gauges[gauge].store(value, std::memory_order_relaxed);
+  }
+
+  // From a replaced operator new, where registering a shard would recurse
+  // into the allocator; the one shared atomic is cheap next to malloc.
+  void CountAllocation() {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Totals over every thread so far
+  struct Snapshot {
+    uint64_t counters[COUNTER_COUNT][LABEL_COUNT] = {};
+    uint64_t buckets[HISTOGRAM_COUNT][BUCKET_COUNT + 1] = {};
+    uint64_t sumUs[HISTOGRAM_COUNT] = {};
+    int64_t gauges[GAUGE_COUNT] = {};
+    uint64_t allocations = 0;
+
+    uint64_t Total(Counter counter) const {
+      uint64_t sum = 0;
+      for (uint64_t n : counters[counter])
+        sum += n;
+      return sum;
+    }
+
+    uint64_t Count(Histogram histogram) const {
+      uint64_t sum = 0;
+      for (uint64_t n : buckets[histogram])
+        sum += n;
+      return sum;
+    }
+  };
+
+  Snapshot Collect() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    Snapshot out = retired;
+    for (size_t i = 0; i < shards.size();) {
+      Accumulate(out, *shards[i]);
+      if (shards[i]->retired.load(std::memory_order_acquire)) {
+        Accumulate(retired, *shards[i]); // Final values: no more writes
+        shards[i] = shards.back();
+        shards.pop_back();
+      } else {
+        i++;
+      }
+    }
+    for (int g = 0; g < GAUGE_COUNT; g++)
+      out.gauges[g] = gauges[g].load(std::memory_order_relaxed);
+    out.allocations = allocations.load(std::memory_order_relaxed);
+    return out;
+  }
+
+  // Prometheus text exposition format, version 0.0.4
+  std::string Render() {
+    Snapshot s = Collect();
+    std::string out;
+    out.reserve(8192);
+
+    static const char *const DIRECTION[2] = {"in", "out"};
+    Header(out, "tetris_messages_total", "counter",
+           "Network messages by direction and type.");
+    for (int d = 0; d < 2; d++)
+      for (int t = 0; t < LABEL_COUNT; t++)
+        if (s.counters[MESSAGES_IN + d][t] || t == 0)
+          Line(out, "tetris_messages_total", DIRECTION[d], t,
+               s.counters[MESSAGES_IN + d][t]);
+    Header(out, "tetris_message_bytes_total", "counter",
+           "Network payload bytes by direction and type.");
+    for (int d = 0; d < 2; d++)
+      for (int t = 0; t < LABEL_COUNT; t++)
+        if (s.counters[BYTES_IN + d][t] || t == 0)
+          Line(out, "tetris_message_bytes_total", DIRECTION[d], t,
+               s.counters[BYTES_IN + d][t]);
+
+    Scalar(out, "tetris_dropped_frames_total", "counter",
+           "Frames that took over 1.5x the target frame time.",
+           (int64_t)s.Total(DROPPED_FRAMES));
+    Scalar(out, "tetris_desyncs_total", "counter",
+           "State hash mismatches that triggered a resync.",
+           (int64_t)s.Total(DESYNCS));
+    Scalar(out, "tetris_allocations_total", "counter",
+           "Heap allocations (operator new) by the process.",
+           (int64_t)s.allocations);
+
+    Scalar(out, "tetris_sessions_active", "gauge",
+           "Matches in progress.", s.gauges[SESSIONS_ACTIVE]);
+    Header(out, "tetris_queue_depth", "gauge",
+           "Messages waiting in each queue.");
+    static const char *const QUEUES[] = {"network", "pending", "jitter"};
+    for (int q = 0; q < 3; q++) {
+      char line[128];
+      snprintf(line, sizeof(line), "tetris_queue_depth{queue=\"%s\"} %lld\n",
+               QUEUES[q], (long long)s.gauges[NETWORK_QUEUE + q]);
+      out += line;
+    }
+
+    Header(out, "tetris_frames_total", "counter",
+           "Main loop passes by screen and whether they drew.");
+    for (int screen = 0; screen < SCREEN_COUNT; screen++)
+      for (int drawn = 1; drawn >= 0; drawn--)
+        ScreenLine(out, "tetris_frames_total", screen,
+                   drawn ? "drawn=\"true\"" : "drawn=\"false\"",
+                   (double)s.counters[drawn ? FRAMES_DRAWN : FRAMES_IDLE]
+                                     [screen]);
+    Header(out, "tetris_screen_seconds_total", "counter",
+           "Wall time spent on each screen.");
+    for (int screen = 0; screen < SCREEN_COUNT; screen++)
+      ScreenLine(out, "tetris_screen_seconds_total", screen, nullptr,
+                 s.counters[SCREEN_WALL_US][screen] / 1e6);
+    Header(out, "tetris_screen_cpu_seconds_total", "counter",
+           "Process CPU time spent on each screen.");
+    for (int screen = 0; screen < SCREEN_COUNT; screen++)
+      ScreenLine(out, "tetris_screen_cpu_seconds_total", screen, nullptr,
+                 s.counters[SCREEN_CPU_US][screen] / 1e6);
+
+    HistogramLines(out, s, RTT, "tetris_rtt_seconds",
+                   "PING round trip time between the game loops.");
+    HistogramLines(out, s, TICK_DURATION, "tetris_tick_duration_seconds",
+                   "Time spent in one simulation update.");
+    HistogramLines(out, s, INPUT_LATENCY, "tetris_input_latency_seconds",
+                   "Key or button change to the submission of the first "
+                   "frame that sampled it.");
+    return out;
+  }
+
+private:
+  struct Shard {
+    std::atomic<uint64_t> counters[COUNTER_COUNT][LABEL_COUNT] = {};
+    std::atomic<uint64_t> buckets[HISTOGRAM_COUNT][BUCKET_COUNT + 1] = {};
+    std::atomic<uint64_t> sumUs[HISTOGRAM_COUNT] = {};
+    std::atomic<bool> retired{false};
+  };
+
+  // Single writer: no read-modify-write needed, readers see whole values
+  static void Bump(std::atomic<uint64_t> &value, uint64_t n) {
+    value.store(value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+  }
+
+  static int Clamp(int label) {
+    return label >= 0 && label < LABEL_COUNT ? label : 0;
+  }
+
+  static void Accumulate(Snapshot &into, const Shard &shard) {
+    for (int c = 0; c < COUNTER_COUNT; c++)
+      for (int l = 0; l < LABEL_COUNT; l++)
+        into.counters[c][l] +=
+            shard.counters[c][l].load(std::memory_order_relaxed);
+    for (int h = 0; h < HISTOGRAM_COUNT; h++) {
+      for (int b = 0; b <= BUCKET_COUNT; b++)
+        into.buckets[h][b] +=
+            shard.buckets[h][b].load(std::memory_order_relaxed);
+      into.sumUs[h] += shard.sumUs[h].load(std::memory_order_relaxed);
+    }
+  }
+
+  static void Header(std::string &out, const char *name, const char *type,
+                     const char *help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+  }
+
+  static void Line(std::string &out, const char *name, const char *direction,
+                   int type, uint64_t value) {
+    char line[160];
+    snprintf(line, sizeof(line),
+             "%s{direction=\"%s\",type=\"%s\"} %llu\n", name, direction,
+             NetworkProtocol::TypeName((NetworkMsgType)type),
+             (unsigned long long)value);
+    out += line;
+  }
+
+  static void ScreenLine(std::string &out, const char *name, int screen,
+                         const char *extraLabel, double value) {
+    char line[160];
+    snprintf(line, sizeof(line), "%s{screen=\"%s\"%s%s} %.15g\n", name,
+             SCREEN_NAMES[screen], extraLabel ? "," : "",
+             extraLabel ? extraLabel : "", value);
+    out += line;
+  }
+
+  static void Scalar(std::string &out, const char *name, const char *type,
+                     const char *help, int64_t value) {
+    Header(out, name, type, help);
+    char line[128];
+    snprintf(line, sizeof(line), "%s %lld\n", name, (long long)value);
+    out += line;
+  }
+
+  static void HistogramLines(std::string &out, const Snapshot &s,
+                             Histogram h, const char *name,
+                             const char *help) {
+    Header(out, name, "histogram", help);
+    char line[160];
+    uint64_t cumulative = 0;
+    for (int b = 0; b <= BUCKET_COUNT; b++) {
+      cumulative += s.buckets[h][b];
+      if (b < BUCKET_COUNT)
+        snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %llu\n", name,
+                 BUCKET_US[b] / 1e6, (unsigned long long)cumulative);
+      else
+        snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n", name,
+                 (unsigned long long)cumulative);
+      out += line;
+    }
+    snprintf(line, sizeof(line), "%s_sum %.6f\n%s_count %llu\n", name,
+             s.sumUs[h] / 1e6, name, (unsigned long long)cumulative);
+    out += line;
+  }
+
+  // This thread's shard for this registry, registered on first use. Marked
+  // retired when the thread exits; the next scrape folds it into the total.
+  Shard &LocalShard() {
+    struct Local {
+      std::vector<std::pair<uint64_t, std::shared_ptr<Shard>>> shards;
+      ~Local() {
+        for (auto &entry : shards)
+          entry.second->retired.store(true, std::memory_order_release);
+      }
+    };
+    thread_local Local local;
+    for (auto &entry : local.shards)
+      if (entry.first == id)
+        return *entry.second;
+    std::shared_ptr<Shard> shard = std::make_shared<Shard>();
+    {
+      std::lock_guard<std::mutex> lock(registryMutex);
+      shards.push_back(shard);
+    }
+    local.shards.emplace_back(id, shard);
+    return *shard;
+  }
+
+  static uint64_t NextId() {
+    static std::atomic<uint64_t> next{1};
+    return next.fetch_add(1);
+  }
+
+  const uint64_t id; // Tells this registry's shards apart per thread
+  std::atomic<int64_t> gauges[GAUGE_COUNT] = {};
+  std::atomic<uint64_t> allocations{0};
+
+  std::mutex registryMutex; // Registration and scrapes only
+  std::vector<std::shared_ptr<Shard>> shards;
+  Snapshot retired; // Sum of the shards of exited threads
+};
+
+// Times a scope into a histogram
+class MetricsTimer {
+public:
+  MetricsTimer(Metrics &metrics, Metrics::Histogram histogram)
+      : metrics(metrics), histogram(histogram), start(Clock::now()) {}
+  ~MetricsTimer() {
+    metrics.Observe(histogram,
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        Clock::now() - start)
+                        .count());
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+  Metrics &metrics;
+  Metrics::Histogram histogram;
+  Clock::time_point start;
+};
+
+#endif
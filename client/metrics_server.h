@@ -0,0 +1,147 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include "async_log.h"
+#include "metrics.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstring>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// Serves Metrics::Render() as GET /metrics on 127.0.0.1 for a local
+// Prometheus (or curl). One thread, one request per connection; a scrape
+// only takes the registry lock to sum the shards. Desktop only.
+class MetricsServer {
+public:
+  explicit MetricsServer(Metrics &metrics = Metrics::Get())
+      : metrics(metrics) {}
+  ~MetricsServer() { Stop(); }
+
+  MetricsServer(const MetricsServer &) = delete;
+  MetricsServer &operator=(const MetricsServer &) = delete;
+
+  // Port 0 picks a free one (see GetPort())
+  bool Start(int port) {
+    Stop();
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0)
+      return false;
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Never exposed
+    socklen_t len = sizeof(addr);
+    if (bind(listenFd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, 8) < 0 ||
+        getsockname(listenFd, (struct sockaddr *)&addr, &len) < 0) {
+      LogAsync(AsyncLog::LEVEL_WARNING,
+               "METRICS: Cannot listen on 127.0.0.1:%d", port);
+      close(listenFd);
+      listenFd = -1;
+      return false;
+    }
+    boundPort = ntohs(addr.sin_port);
+    running = true;
+    thread = std::thread(&MetricsServer::Serve, this);
+    LogAsync(AsyncLog::LEVEL_INFO,
+             "METRICS: Serving http://127.0.0.1:%d/metrics", boundPort);
+    return true;
+  }
+
+  void Stop() {
+    running = false;
+    if (thread.joinable())
+      thread.join(); // Serve() polls with a timeout
+    if (listenFd >= 0)
+      close(listenFd);
+    listenFd = -1;
+  }
+
+  int GetPort() const { return boundPort; }
+
+private:
+  static constexpr int POLL_MS = 100;
+  static constexpr int REQUEST_TIMEOUT_MS = 1000;
+
+  void Serve() {
+    while (running) {
+      struct pollfd p = {listenFd, POLLIN, 0};
+      if (poll(&p, 1, POLL_MS) <= 0)
+        continue;
+      int fd = accept(listenFd, nullptr, nullptr);
+      if (fd < 0)
+        continue;
+      Handle(fd);
+      close(fd);
+    }
+  }
+
+  void Handle(int fd) {
+    // Without the timeout one silent connection would hold this thread,
+    // and Stop() with it, forever
+    struct timeval t = {REQUEST_TIMEOUT_MS / 1000,
+                        (REQUEST_TIMEOUT_MS % 1000) * 1000};
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t)) < 0)
+      return;
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.size() < 8192) {
+      ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+      if (n <= 0)
+        return;
+      request.append(buffer, (size_t)n);
+    }
+
+    std::string body;
+    const char *status = "200 OK";
+    if (request.compare(0, 13, "GET /metrics ") == 0 ||
+        request.compare(0, 13, "GET /metrics?") == 0) {
+      body = metrics.Render();
+    } else {
+      status = "404 Not Found";
+      body = "Try /metrics\n";
+    }
+    char head[192];
+    snprintf(head, sizeof(head),
+             "HTTP/1.1 %s\r\n"
+             "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+             "Content-Length: %zu\r\n"
+             "Connection: close\r\n\r\n",
+             status, body.size());
+    SendAll(fd, head, strlen(head));
+    SendAll(fd, body.data(), body.size());
+  }
+
+  static void SendAll(int fd, const char *data, size_t len) {
+    while (len > 0) {
+      ssize_t n = send(fd, data, len, SEND_FLAGS);
+      if (n <= 0)
+        return;
+      data += n;
+      len -= (size_t)n;
+    }
+  }
+
+#ifdef MSG_NOSIGNAL
+  static const int SEND_FLAGS = MSG_NOSIGNAL; // A scraper that hung up
+#else
+  static const int SEND_FLAGS = 0;
+#endif
+
+  Metrics &metrics;
+  int listenFd = -1;
+  int boundPort = 0;
+  std::atomic<bool> running{false};
+  std::thread thread;
+};
+
+#endif
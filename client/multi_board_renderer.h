@@ -0,0 +1,205 @@
+#ifndef MULTI_BOARD_RENDERER_H
+#define MULTI_BOARD_RENDERER_H
+
+#include "board_atlas.h"
+#include "board_renderer.h"
+#include "raylib.h"
+
+// Opponent miniboards, 8 to 100 of them. All boards live in one atlas
+// texture (board_atlas.h); each is one textured quad whose texture
+// coordinates select its tile, and a shared fragment shader turns the cell
+// codes into colors. Every quad of a DrawGrid() call has the same texture
+// and shader, so raylib batches the whole grid into a single draw call.
+// Only the atlas rows that changed are uploaded each frame.
+//
+// Owns GPU resources: create and destroy it while the window is open.
+class MultiBoardRenderer {
+public:
+  MultiBoardRenderer() : palette(BoardPalette::Classic()) {}
+  MultiBoardRenderer(const MultiBoardRenderer &) = delete;
+  MultiBoardRenderer &operator=(const MultiBoardRenderer &) = delete;
+  ~MultiBoardRenderer() { Unload(); }
+
+  BoardAtlas &GetAtlas() { return atlas; }
+
+  // Once per frame, before DrawGrid()
+  void Update(const Logic *const *boards, int count) {
+    if (!loaded)
+      Load();
+    atlas.Update(boards, count);
+    int first, last;
+    if (useShader && atlas.GetDirtyRows(first, last)) {
+      Rectangle rows = {0, (float)first, (float)BoardAtlas::WIDTH,
+                        (float)(last - first)};
+      UpdateTextureRec(texture, rows, atlas.Data() + first * BoardAtlas::WIDTH);
+    }
+    atlas.ClearDirty();
+  }
+
+  // Boards (atlas tiles) left to right, top to bottom, columns per row
+  void DrawGrid(const int *boards, int count, int x, int y, int columns,
+                int cellSize, int gap) {
+    if (count <= 0 || columns <= 0 || cellSize <= 0)
+      return;
+    int width = BOARD_WIDTH * cellSize, height = BOARD_HEIGHT * cellSize;
+    if (!useShader) {
+      for (int i = 0; i < count; i++)
+        DrawRectangles(boards[i], x + i % columns * (width + gap),
+                       y + i / columns * (height + gap), cellSize);
+      return;
+    }
+    float px = (float)cellSize;
+    SetShaderValue(shader, cellPxLoc, &px, SHADER_UNIFORM_FLOAT);
+    BeginShaderMode(shader);
+    for (int i = 0; i < count; i++) {
+      Rectangle source = {(float)BoardAtlas::TileX(boards[i]),
+                          (float)BoardAtlas::TileY(boards[i]),
+                          (float)BOARD_WIDTH, (float)BOARD_HEIGHT};
+      Rectangle dest = {(float)(x + i % columns * (width + gap)),
+                        (float)(y + i / columns * (height + gap)),
+                        (float)width, (float)height};
+      DrawTexturePro(texture, source, dest, {0, 0}, 0.0f, WHITE);
+    }
+    EndShaderMode();
+  }
+
+  void Unload() {
+    if (!loaded)
+      return;
+    if (useShader) {
+      UnloadTexture(texture);
+      UnloadShader(shader);
+    }
+    texture = {};
+    loaded = useShader = false;
+  }
+
+private:
+  void Load() {
+    loaded = true;
+    shader = LoadShaderFromMemory(nullptr, FRAGMENT_SHADER);
+    int paletteLoc = GetShaderLocation(shader, "palette");
+    useShader = paletteLoc >= 0; // See BoardRenderer::Load()
+    if (!useShader) {
+      TraceLog(LOG_WARNING, "BOARD: miniboard shader unavailable, drawing "
+                            "rectangles");
+      return;
+    }
+    cellPxLoc = GetShaderLocation(shader, "cellPx");
+
+    float colors[BoardCells::PALETTE_SIZE * 4];
+    for (int i = 0; i < BoardCells::PALETTE_SIZE; i++)
+      Normalize(palette.cells[i], colors + i * 4);
+    SetShaderValueV(shader, paletteLoc, colors, SHADER_UNIFORM_VEC4,
+                    BoardCells::PALETTE_SIZE);
+    float color[4];
+    Normalize(palette.background, color);
+    SetShaderValue(shader, GetShaderLocation(shader, "background"), color,
+                   SHADER_UNIFORM_VEC4);
+    Normalize(palette.border, color);
+    SetShaderValue(shader, GetShaderLocation(shader, "border"), color,
+                   SHADER_UNIFORM_VEC4);
+    float atlasSize[2] = {(float)BoardAtlas::WIDTH,
+                          (float)BoardAtlas::HEIGHT};
+    SetShaderValue(shader, GetShaderLocation(shader, "atlasSize"), atlasSize,
+                   SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, GetShaderLocation(shader, "ghostAlpha"),
+                   &palette.ghostAlpha, SHADER_UNIFORM_FLOAT);
+
+    Image image = {(void *)atlas.Data(), BoardAtlas::WIDTH,
+                   BoardAtlas::HEIGHT, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE};
+    texture = LoadTextureFromImage(image);
+    SetTextureFilter(texture, TEXTURE_FILTER_POINT);
+    SetTextureWrap(texture, TEXTURE_WRAP_CLAMP); // NPOT on GLES2
+  }
+
+  static void Normalize(Color c, float *out) {
+    out[0] = c.r / 255.0f;
+    out[1] = c.g / 255.0f;
+    out[2] = c.b / 255.0f;
+    out[3] = c.a / 255.0f;
+  }
+
+  // Fallback: the shader's output as rectangles, empty cells skipped
+  void DrawRectangles(int board, int x, int y, int cellSize) {
+    int width = BOARD_WIDTH * cellSize, height = BOARD_HEIGHT * cellSize;
+    DrawRectangle(x, y, width, height, palette.background);
+    int inset = cellSize >= 4 ? 1 : 0;
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        int code = atlas.At(board, r, c);
+        if (code == 0)
+          continue;
+        Color color = palette.cells[code % BoardCells::LAYER_STRIDE];
+        if (code / BoardCells::LAYER_STRIDE == BoardCells::GHOST)
+          color = ColorAlphaBlend(palette.background,
+                                  Fade(color, palette.ghostAlpha), WHITE);
+        DrawRectangle(x + c * cellSize + inset, y + r * cellSize + inset,
+                      cellSize - 2 * inset, cellSize - 2 * inset, color);
+      }
+    }
+    DrawRectangleLines(x, y, width, height, palette.border);
+  }
+
+  // Like BoardRenderer's shader, from texture coordinates alone: any tile
+  // can be drawn at any place without per-board uniforms. Cells of 4 px or
+  // less are drawn solid, without the inset and the grid.
+  static constexpr const char *FRAGMENT_SHADER =
+#if defined(PLATFORM_WEB) || defined(PLATFORM_ANDROID)
+      "#version 100\n"
+      "precision mediump float;\n"
+      "varying vec2 fragTexCoord;\n"
+      "varying vec4 fragColor;\n"
+      "#define TEXTURE texture2D\n"
+      "#define OUT_COLOR gl_FragColor\n"
+#else
+      "#version 330\n"
+      "in vec2 fragTexCoord;\n"
+      "in vec4 fragColor;\n"
+      "out vec4 finalColor;\n"
+      "#define TEXTURE texture\n"
+      "#define OUT_COLOR finalColor\n"
+#endif
+      "uniform sampler2D texture0;\n" // Atlas of cell codes
+      "uniform vec4 palette[9];\n"
+      "uniform vec4 background;\n"
+      "uniform vec4 border;\n"
+      "uniform vec2 atlasSize;\n" // Cells
+      "uniform float cellPx;\n"   // Screen pixels per cell
+      "uniform float ghostAlpha;\n"
+      "void main() {\n"
+      "  vec2 cellPos = fragTexCoord * atlasSize;\n"
+      "  vec2 boardPx = vec2(10.0, 20.0) * cellPx;\n"
+      "  vec2 px = mod(cellPos, vec2(10.0, 20.0)) * cellPx;\n"
+      "  vec2 inCell = fract(cellPos) * cellPx;\n"
+      "  bool inset = cellPx <= 4.0 ||\n"
+      "               (inCell.x >= 1.0 && inCell.y >= 1.0 &&\n"
+      "                inCell.x < cellPx - 1.0 && inCell.y < cellPx - 1.0);\n"
+      "  float code = floor(TEXTURE(texture0, fragTexCoord).r * 255.0 + 0.5);\n"
+      "  float layer = floor(code / 16.0);\n"
+      "  float slot = code - layer * 16.0;\n"
+      "  vec4 block = palette[0];\n"
+      "  for (int i = 1; i < 9; i++)\n"
+      "    if (float(i) == slot) block = palette[i];\n"
+      "  vec4 color = background;\n"
+      "  if (slot != 0.0 && inset) {\n"
+      "    color = layer == 2.0\n"
+      "        ? vec4(mix(background.rgb, block.rgb, ghostAlpha), 1.0)\n"
+      "        : block;\n"
+      "  }\n"
+      "  if (px.x < 1.0 || px.y < 1.0 || px.x >= boardPx.x - 1.0 ||\n"
+      "      px.y >= boardPx.y - 1.0)\n"
+      "    color = border;\n"
+      "  OUT_COLOR = color * fragColor;\n"
+      "}\n";
+
+  BoardAtlas atlas;
+  BoardPalette palette;
+  bool loaded = false;
+  bool useShader = false;
+  Texture2D texture = {};
+  Shader shader = {};
+  int cellPxLoc = -1;
+};
+
+#endif
@@ -1,67 +1,61 @@
 #ifndef NETWORK_MANAGER_H
 #define NETWORK_MANAGER_H
 
+#include "async_log.h"
+#include "flight_recorder.h"
+#include "metrics.h"
+#include "network_protocol.h"
 #include "raylib.h"
+#include "transport.h"
+#include "websocket_frame.h"
+#include <algorithm>
 #include <arpa/inet.h>
 #include <atomic>
-#include <fcntl.h>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>
-#include <netinet/tcp.h> // For TCP_NODELAY
+#include <random>
 #include <string>
-#include <sys/select.h>
-#include <sys/socket.h>
-#include <unistd.h>
 #include <vector>
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
-// Emscripten doesn't support std::thread well without headers/flags
-// We will use a polling approach in the main loop.
+#include <emscripten/websocket.h>
+// Emscripten doesn't support std::thread well without headers/flags.
+// The browser's WebSocket delivers frames through callbacks on the main
+// thread instead (see OpenWebSocket), so no polling is needed either.
 #else
+#include "loopback_transport.h"
+#include "shm_transport.h"
+#include "tcp_transport.h"
+#include <chrono>
 #include <thread>
 #endif
 
 class NetworkManager {
 public:
   NetworkManager()
-      : currentSocket(-1), isRunning(false), isConnected(false), isHost(false),
-        pendingData("") {}
+      : isRunning(false), isConnected(false), isHost(false),
+        hubMode(false), wsPeer(false), pendingData(""),
+        maskRng(std::random_device{}()) {}
 
   ~NetworkManager() { Stop(); }
 
   bool StartHost(int port) {
 #ifdef __EMSCRIPTEN__
-    TraceLog(LOG_WARNING, "NETWORK: Hosting not supported on Web/WASM yet.");
+    LogAsync(LOG_WARNING, "NETWORK: Hosting not supported on Web/WASM yet.");
     return false;
 #else
     Stop(); // Ensure clean state
     isHost = true;
 
-    currentSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (currentSocket < 0)
-      return false;
-
-    // Enable TCP_NODELAY
-    int flag = 1;
-    setsockopt(currentSocket, IPPROTO_TCP, TCP_NODELAY, (char *)&flag,
-               sizeof(int));
-
-    // Allow reuse address
-    int opt = 1;
-    setsockopt(currentSocket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
-
-    struct sockaddr_in serverAddr;
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_addr.s_addr = INADDR_ANY;
-    serverAddr.sin_port = htons(port);
-
-    if (bind(currentSocket, (struct sockaddr *)&serverAddr,
-             sizeof(serverAddr)) < 0) {
-      return false;
-    }
-
-    if (listen(currentSocket, 1) < 0) {
+    transport = CreateTransport(transportKind);
+    const char *error = "";
+    listener = transport->Listen(port, error);
+    if (!listener) {
+      LogAsync(LOG_WARNING, "NETWORK: Cannot host on %s port %d: %s",
+               TransportKindName(transportKind), port, error);
       return false;
     }
 
@@ -71,76 +65,93 @@ public:
 #endif
   }
 
-  bool ConnectClient(const std::string &ip, int port) {
-    Stop(); // Ensure clean state
-    isHost = false;
+  // Backend for the next StartHost()/ConnectClient() (see transport.h).
+  // The hub is always reached over TCP, and so is everything on the web.
+  void SetTransport(TransportKind kind) { transportKind = kind; }
+  TransportKind GetTransportKind() const { return transportKind; }
+
+  // Progress of the connect started by ConnectClient/ConnectHub. Attempts
+  // run off the game thread (network thread on desktop, browser callbacks
+  // on the web) so the UI keeps rendering while a host is unreachable.
+  enum class ConnectStatus {
+    IDLE,
+    CONNECTING,    // Attempt in progress
+    WAITING_RETRY, // Attempt failed, backing off before the next one
+    CONNECTED,
+    FAILED,        // All attempts failed; see GetConnectError()
+  };
+
+  // Per-attempt timeout, number of attempts and the first retry delay
+  // (doubled after every failed attempt, capped at MAX_BACKOFF_MS).
+  // Called without arguments it restores the defaults.
+  void SetConnectOptions(int timeoutMs = DEFAULT_CONNECT_TIMEOUT_MS,
+                         int maxAttempts = DEFAULT_CONNECT_ATTEMPTS,
+                         int backoffMs = DEFAULT_CONNECT_BACKOFF_MS) {
+    connectTimeoutMs = timeoutMs;
+    connectMaxAttempts = maxAttempts < 1 ? 1 : maxAttempts;
+    connectBackoffMs = backoffMs;
+  }
 
-    currentSocket = socket(AF_INET, SOCK_STREAM, 0);
-    if (currentSocket < 0)
-      return false;
+  // Starts connecting to a game host; returns false only if the attempt
+  // could not be started (e.g. malformed IP). Poll GetConnectStatus().
+  bool ConnectClient(const std::string &ip, int port) {
+    return BeginConnect(ip, port, "");
+  }
 
-    // Enable TCP_NODELAY
-    int flag = 1;
-    setsockopt(currentSocket, IPPROTO_TCP, TCP_NODELAY, (char *)&flag,
-               sizeof(int));
+  // Connect to the Go matchmaking hub (server.go) over WebSocket. Incoming
+  // hub frames are queued verbatim (one JSON document per entry) and can be
+  // decoded with HubJson::ParseMessage. Send with SendHubMessage() once
+  // GetConnectStatus() reports CONNECTED.
+  bool ConnectHub(const std::string &ip, int port,
+                  const std::string &path = "/ws") {
+    return BeginConnect(ip, port, path);
+  }
 
-    struct sockaddr_in serverAddr;
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(port);
+  // Abort a pending connect (or drop an established one) from the UI
+  void CancelConnect() {
+    Stop();
+    LogAsync(LOG_INFO, "NETWORK: Connect cancelled.");
+  }
 
-    if (inet_pton(AF_INET, ip.c_str(), &serverAddr.sin_addr) <= 0) {
-      return false;
-    }
+  ConnectStatus GetConnectStatus() const { return connectStatus; }
+  bool IsConnectPending() const {
+    return connectStatus == ConnectStatus::CONNECTING ||
+           connectStatus == ConnectStatus::WAITING_RETRY;
+  }
+  int GetConnectAttempt() const { return connectAttempt; }
+  int GetMaxConnectAttempts() const { return connectMaxAttempts; }
+  const char *GetConnectError() const { return connectError; }
 
+  // Send one hub JSON document as a masked text frame
+  void SendHubMessage(const char *json, size_t len) {
+    if (!isConnected || !hubMode)
+      return;
+    RecordMessage(FlightRecorder::OUT, json, len);
 #ifdef __EMSCRIPTEN__
-    // Non-blocking connect for Web
-    fcntl(currentSocket, F_SETFL, O_NONBLOCK);
-
-    int res = connect(currentSocket, (struct sockaddr *)&serverAddr,
-                      sizeof(serverAddr));
-    if (res < 0 && errno != EINPROGRESS) {
-      TraceLog(LOG_ERROR, "NETWORK: Connect failed immediately: %d", errno);
-      close(currentSocket);
-      currentSocket = -1;
-      return false;
-    }
-
-    // We are "connecting". IsConnected will be true once we confirm in Update()
-    // but for simplicity, let's mark as connected so game transitions,
-    // and if it fails later, we disconnect.
-    // Actually, emscripten sockets over websocket behave a bit differently.
-    // Let's assume connected for now and handle errors in Update.
-    isConnected = true;
-    isRunning = true;
-    TraceLog(LOG_INFO, "NETWORK: Async connect started...");
-    return true;
-
+    WebSocketSend(std::string(json, len), true);
 #else
-    // Blocking connect for Desktop
-    if (connect(currentSocket, (struct sockaddr *)&serverAddr,
-                sizeof(serverAddr)) < 0) {
-      close(currentSocket);
-      currentSocket = -1;
-      return false;
-    }
-
-    isConnected = true;
-    isRunning = true;
-    networkThread = std::thread(&NetworkManager::ClientLoop, this);
-    return true;
+    SendFrame(WebSocket::OP_TEXT, json, len);
 #endif
   }
 
+  bool IsHubMode() const { return hubMode; }
+
   void Stop() {
     isRunning = false;
     isConnected = false;
 
-    if (currentSocket != -1) {
-      shutdown(currentSocket, SHUT_RDWR);
-      close(currentSocket);
-      currentSocket = -1;
+#ifdef __EMSCRIPTEN__
+    CloseWebSocket();
+#else
+    {
+      // Wake the network thread out of Accept()/Recv()
+      std::lock_guard<std::mutex> lock(sendMutex);
+      if (listener)
+        listener->Close();
+      if (stream)
+        stream->Shutdown();
     }
-#ifndef __EMSCRIPTEN__
+    bool joined = true;
     if (networkThread.joinable()) {
       // Check if we are trying to join ourselves (which causes a crash)
       if (std::this_thread::get_id() != networkThread.get_id()) {
@@ -150,72 +161,63 @@ public:
         // (though we should avoid calling Stop from within thread)
         // But since we fixed ReadLoop, this is just a safety guard.
         networkThread.detach();
+        joined = false;
       }
     }
+    if (joined) { // The thread may still be using them otherwise
+      std::lock_guard<std::mutex> lock(sendMutex);
+      stream.reset();
+      listener.reset();
+      transport.reset();
+    }
 #endif
+    hubMode = false;
+    wsPeer = false;
+    connectStatus = ConnectStatus::IDLE;
     std::lock_guard<std::mutex> lock(queueMutex);
     messageQueue.clear();
     pendingData = "";
+    wsDecoder.Clear();
   }
 
   void SendMessageStr(const std::string &msg) {
-    if (!isConnected || currentSocket == -1)
-      return;
-
-    std::string payload = msg + "\n";
-    send(currentSocket, payload.c_str(), payload.length(), 0);
-  }
-
-  // Called every frame to handle network tasks (polling)
-  void Update() {
 #ifdef __EMSCRIPTEN__
-    if (!isRunning || currentSocket == -1)
+    if (isConnected) {
+      RecordMessage(FlightRecorder::OUT, msg.data(), msg.size());
+      WebSocketSend(msg, false);
+    }
+#else
+    if (!isConnected)
       return;
+    RecordMessage(FlightRecorder::OUT, msg.data(), msg.size());
 
-    // Check if we are writable (connected)
-    fd_set wset;
-    FD_ZERO(&wset);
-    FD_SET(currentSocket, &wset);
-    struct timeval t = {0, 0};
-    int rc = select(currentSocket + 1, NULL, &wset, NULL, &t);
-
-    if (rc > 0 && FD_ISSET(currentSocket, &wset)) {
-      // Connected or error
-      int error = 0;
-      socklen_t len = sizeof(error);
-      if (getsockopt(currentSocket, SOL_SOCKET, SO_ERROR, &error, &len) < 0 ||
-          error != 0) {
-        TraceLog(LOG_INFO, "NETWORK: Socket connect failed: %d", error);
-        Stop();
-        return;
-      }
-    } else {
-      // Still connecting or not writable
+    if (wsPeer) { // Browser client: one message per frame, no '\n' framing
+      SendFrame(WebSocket::OP_BINARY, msg.data(), msg.size());
       return;
     }
 
-    // Handshake check (Emscripten specific)
-    // Actually relying on recv to return EAGAIN is standard for non-blocking.
-    // But if we get 0, it's closed.
-
-    char buffer[1024];
-    int bytesRead = recv(currentSocket, buffer, sizeof(buffer) - 1, 0);
+    std::string payload = msg + "\n";
+    std::lock_guard<std::mutex> lock(sendMutex);
+    if (stream)
+      stream->Send(payload.data(), payload.size());
+#endif
+  }
 
-    if (bytesRead > 0) {
-      buffer[bytesRead] = '\0';
-      pendingData += buffer;
-      ProcessPendingData();
-    } else if (bytesRead == 0) {
-      // If we just connected, getting 0 immediately is suspicious.
-      // But if it's truly closed, we must stop.
-      TraceLog(LOG_INFO, "NETWORK: Connection closed by remote.");
-      Stop();
-    } else {
-      if (errno != EAGAIN && errno != EWOULDBLOCK) {
-        TraceLog(LOG_INFO, "NETWORK: Socket error: %d",
-                 errno); // Down level to INFO
-        Stop();
-      }
+  // Called every frame to handle network tasks. Both transports are event
+  // driven (reader thread on desktop, WebSocket callbacks on the web); on
+  // the web this only drives connect timeouts and retries.
+  void Update() {
+#ifdef __EMSCRIPTEN__
+    double now = emscripten_get_now();
+    if (connectStatus == ConnectStatus::CONNECTING &&
+        (webSocketFailed || now - attemptStartMs > connectTimeoutMs)) {
+      if (!webSocketFailed)
+        connectError = "Connection timed out";
+      CloseWebSocket();
+      OnAttemptFailed(now);
+    } else if (connectStatus == ConnectStatus::WAITING_RETRY &&
+               now >= retryAtMs) {
+      StartWebSocketAttempt();
     }
 #endif
   }
@@ -229,24 +231,287 @@ public:
 
   bool IsConnected() const { return isConnected; }
 
+  // Called on the network thread whenever data arrives or the link comes up
+  // or goes down, so a main loop blocked on window events can wake up
+  // (frame_scheduler.h). Must be safe to call from any thread.
+  static void SetWakeHandler(void (*handler)()) { WakeHandler() = handler; }
+
+  // Every message in and out, for post-mortems (see flight_recorder.h)
+  FlightRecorder &GetRecorder() { return recorder; }
+
+  // Time since the peer last sent anything; lets the game notice links that
+  // died silently (e.g. a Wi-Fi handoff) long before TCP does.
+  int GetMillisSinceReceive() const { return (int)(NowMs() - lastReceiveMs); }
+
 private:
-  int currentSocket;
 #ifndef __EMSCRIPTEN__
   std::thread networkThread;
 #endif
   std::atomic<bool> isRunning;
   std::atomic<bool> isConnected;
   bool isHost;
-
+  bool hubMode; // WebSocket framing to the Go hub instead of '\n' lines
+  bool wsPeer;  // Host side: accepted client is a browser WebSocket
+
+  std::mutex sendMutex; // Game thread sends, network thread answers pings;
+                        // also guards swapping the pointers below
+  TransportKind transportKind = TransportKind::TCP;
+  std::unique_ptr<Transport> transport;
+  std::unique_ptr<TransportListener> listener; // Host, until a peer arrives
+  std::unique_ptr<TransportStream> stream;     // The connected peer
   std::mutex queueMutex;
   std::vector<std::string> messageQueue;
   std::string pendingData; // For partial reads
+  WebSocket::FrameDecoder wsDecoder;
+  std::mt19937 maskRng; // Client frame masks (RFC 6455 5.3); sendMutex
+  FlightRecorder recorder;
+
+  void RecordMessage(FlightRecorder::Direction direction, const char *data,
+                     size_t len) {
+    NetworkMsgType type = NetworkProtocol::PeekType(data, len);
+    recorder.Record(direction, (uint8_t)type, data, len);
+    Metrics::Get().CountMessage(direction == FlightRecorder::IN, type, len);
+  }
+
+  static constexpr int DEFAULT_CONNECT_TIMEOUT_MS = 3000;
+  static constexpr int DEFAULT_CONNECT_ATTEMPTS = 3;
+  static constexpr int DEFAULT_CONNECT_BACKOFF_MS = 500;
+  static constexpr int MAX_BACKOFF_MS = 4000;
+  std::atomic<ConnectStatus> connectStatus{ConnectStatus::IDLE};
+  std::atomic<int> connectAttempt{0};
+  std::atomic<const char *> connectError{""}; // Static strings only
+  std::atomic<int64_t> lastReceiveMs{0};
+  int connectTimeoutMs = DEFAULT_CONNECT_TIMEOUT_MS;
+  int connectMaxAttempts = DEFAULT_CONNECT_ATTEMPTS;
+  int connectBackoffMs = DEFAULT_CONNECT_BACKOFF_MS;
+  std::string connectIp;
+  int connectPort = 0;
+  std::string connectPath; // Non-empty: WebSocket upgrade to the hub
+
+  static int64_t NowMs() {
+#ifdef __EMSCRIPTEN__
+    return (int64_t)emscripten_get_now();
+#else
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+  }
+
+  bool BeginConnect(const std::string &ip, int port, const std::string &path) {
+    Stop(); // Ensure clean state
+    isHost = false;
+    hubMode = !path.empty();
+    connectIp = ip;
+    connectPort = port;
+    connectPath = path;
+    connectAttempt = 0;
+    connectError = "";
+
+#ifdef __EMSCRIPTEN__
+    retryDelayMs = connectBackoffMs;
+    isRunning = true;
+    StartWebSocketAttempt();
+    return true;
+#else
+    transport = CreateTransport(hubMode ? TransportKind::TCP : transportKind);
+    struct in_addr addr;
+    if (transport->Kind() == TransportKind::TCP &&
+        inet_pton(AF_INET, ip.c_str(), &addr) <= 0) {
+      connectError = "Invalid IP address";
+      connectStatus = ConnectStatus::FAILED;
+      return false;
+    }
+    connectStatus = ConnectStatus::CONNECTING;
+    isRunning = true;
+    networkThread = std::thread(&NetworkManager::ConnectLoop, this);
+    return true;
+#endif
+  }
+
+#ifdef __EMSCRIPTEN__
+  EMSCRIPTEN_WEBSOCKET_T webSocket = 0;
+  bool webSocketFailed = false; // Set by callbacks, handled in Update()
+  double attemptStartMs = 0;
+  double retryAtMs = 0;
+  int retryDelayMs = 0;
+
+  void StartWebSocketAttempt() {
+    connectAttempt = connectAttempt + 1;
+    connectStatus = ConnectStatus::CONNECTING;
+    attemptStartMs = emscripten_get_now();
+    webSocketFailed = false;
+    std::string url = "ws://" + connectIp + ":" + std::to_string(connectPort) +
+                      (connectPath.empty() ? "/" : connectPath);
+    if (!OpenWebSocket(url))
+      webSocketFailed = true;
+  }
+
+  void OnAttemptFailed(double now) {
+    if (connectAttempt >= connectMaxAttempts) {
+      connectStatus = ConnectStatus::FAILED;
+      isRunning = false;
+      return;
+    }
+    connectStatus = ConnectStatus::WAITING_RETRY;
+    retryAtMs = now + retryDelayMs;
+    retryDelayMs = std::min(retryDelayMs * 2, MAX_BACKOFF_MS);
+  }
+
+  bool OpenWebSocket(const std::string &url) {
+    if (!emscripten_websocket_is_supported()) {
+      connectError = "WebSocket not supported";
+      return false;
+    }
+    EmscriptenWebSocketCreateAttributes attr;
+    emscripten_websocket_init_create_attributes(&attr);
+    attr.url = url.c_str();
+    attr.protocols = NULL;
+    attr.createOnMainThread = EM_TRUE;
+
+    webSocket = emscripten_websocket_new(&attr);
+    if (webSocket <= 0) {
+      LogAsync(LOG_ERROR, "NETWORK: WebSocket creation failed: %d",
+               (int)webSocket);
+      connectError = "WebSocket creation failed";
+      webSocket = 0;
+      return false;
+    }
+    emscripten_websocket_set_onopen_callback(webSocket, this, OnWebSocketOpen);
+    emscripten_websocket_set_onmessage_callback(webSocket, this,
+                                                OnWebSocketMessage);
+    emscripten_websocket_set_onerror_callback(webSocket, this,
+                                              OnWebSocketError);
+    emscripten_websocket_set_onclose_callback(webSocket, this,
+                                              OnWebSocketClose);
+    LogAsync(LOG_INFO, "NETWORK: WebSocket connecting to %s (attempt %d/%d)",
+             url.c_str(), (int)connectAttempt, connectMaxAttempts);
+    return true;
+  }
+
+  void CloseWebSocket() {
+    if (webSocket > 0) {
+      // delete also unregisters the callbacks, so none fire after this
+      emscripten_websocket_close(webSocket, 1000, "");
+      emscripten_websocket_delete(webSocket);
+      webSocket = 0;
+    }
+  }
+
+  void WebSocketSend(const std::string &msg, bool text) {
+    if (webSocket <= 0)
+      return;
+    if (text)
+      emscripten_websocket_send_utf8_text(webSocket, msg.c_str());
+    else
+      emscripten_websocket_send_binary(webSocket, (void *)msg.data(),
+                                       (uint32_t)msg.size());
+  }
+
+  static EM_BOOL OnWebSocketOpen(int, const EmscriptenWebSocketOpenEvent *,
+                                 void *userData) {
+    NetworkManager *self = (NetworkManager *)userData;
+    self->lastReceiveMs = NowMs();
+    self->isConnected = true;
+    self->connectStatus = ConnectStatus::CONNECTED;
+    LogAsync(LOG_INFO, "NETWORK: WebSocket open.");
+    return EM_TRUE;
+  }
+
+  // Each browser message event is one complete frame, queued as one message
+  // for the next PollMessages() (at most one frame of added latency).
+  static EM_BOOL OnWebSocketMessage(int,
+                                    const EmscriptenWebSocketMessageEvent *e,
+                                    void *userData) {
+    NetworkManager *self = (NetworkManager *)userData;
+    self->lastReceiveMs = NowMs();
+    size_t len = e->numBytes;
+    if (e->isText && len > 0 && e->data[len - 1] == '\0')
+      len--; // Text payloads arrive NUL-terminated
+    std::string payload((const char *)e->data, len);
+    if (!payload.empty() && payload.back() == '\n')
+      payload.pop_back();
+    if (payload.empty())
+      return EM_TRUE;
+    self->RecordMessage(FlightRecorder::IN, payload.data(), payload.size());
+    std::lock_guard<std::mutex> lock(self->queueMutex);
+    self->messageQueue.push_back(payload);
+    return EM_TRUE;
+  }
+
+  // Before onopen an error/close is a failed attempt (retried from Update);
+  // afterwards it clears isConnected, which the game reports as lost.
+  static void OnWebSocketDown(NetworkManager *self, const char *reason) {
+    if (self->connectStatus == ConnectStatus::CONNECTING) {
+      self->connectError = reason;
+      self->webSocketFailed = true;
+    }
+    self->isConnected = false;
+  }
+
+  static EM_BOOL OnWebSocketError(int, const EmscriptenWebSocketErrorEvent *,
+                                  void *userData) {
+    LogAsync(LOG_INFO, "NETWORK: WebSocket error.");
+    OnWebSocketDown((NetworkManager *)userData, "Connection failed");
+    return EM_TRUE;
+  }
+
+  static EM_BOOL OnWebSocketClose(int, const EmscriptenWebSocketCloseEvent *e,
+                                  void *userData) {
+    LogAsync(LOG_INFO, "NETWORK: WebSocket closed (code %d).", (int)e->code);
+    OnWebSocketDown((NetworkManager *)userData, "Connection refused");
+    return EM_TRUE;
+  }
+#endif
+
+  // Clients must mask their frames, servers must not (RFC 6455 5.1)
+  void SendFrame(uint8_t opcode, const char *data, size_t len) {
+    std::lock_guard<std::mutex> lock(sendMutex); // Also guards maskRng
+    uint32_t maskKey = isHost ? 0 : ((uint32_t)maskRng() | 1);
+    std::string frame = WebSocket::EncodeFrame(opcode, data, len, maskKey);
+    if (stream)
+      stream->Send(frame.data(), frame.size());
+  }
+
+  static std::atomic<void (*)()> &WakeHandler() {
+    static std::atomic<void (*)()> handler{nullptr};
+    return handler;
+  }
+  static void Wake() {
+    if (void (*handler)() = WakeHandler().load())
+      handler();
+  }
+
+  // Returns false when the peer closed the WebSocket or sent garbage
+  bool ProcessWebSocketData() {
+    uint8_t opcode;
+    std::string payload;
+    while (true) {
+      WebSocket::FrameDecoder::Status status = wsDecoder.Next(opcode, payload);
+      if (status == WebSocket::FrameDecoder::Status::NEED_MORE)
+        return true;
+      if (status == WebSocket::FrameDecoder::Status::ERROR)
+        return false;
+      if (opcode == WebSocket::OP_PING) {
+        SendFrame(WebSocket::OP_PONG, payload.data(), payload.size());
+      } else if (opcode == WebSocket::OP_CLOSE) {
+        SendFrame(WebSocket::OP_CLOSE, payload.data(), payload.size());
+        return false;
+      } else if (opcode == WebSocket::OP_TEXT ||
+                 opcode == WebSocket::OP_BINARY) {
+        RecordMessage(FlightRecorder::IN, payload.data(), payload.size());
+        std::lock_guard<std::mutex> lock(queueMutex);
+        messageQueue.push_back(payload);
+      }
+    }
+  }
 
   void ProcessPendingData() {
     size_t pos;
     while ((pos = pendingData.find('\n')) != std::string::npos) {
       std::string msg = pendingData.substr(0, pos);
       if (!msg.empty()) {
+        RecordMessage(FlightRecorder::IN, msg.data(), msg.size());
         std::lock_guard<std::mutex> lock(queueMutex);
         messageQueue.push_back(msg);
       }
@@ -255,54 +520,224 @@ private:
   }
 
 #ifndef __EMSCRIPTEN__
+  static std::unique_ptr<Transport> CreateTransport(TransportKind kind) {
+    switch (kind) {
+    case TransportKind::LOOPBACK:
+      return std::unique_ptr<Transport>(new LoopbackTransport());
+    case TransportKind::SHARED_MEMORY:
+      return std::unique_ptr<Transport>(new ShmTransport());
+    default:
+      return std::unique_ptr<Transport>(new TcpTransport());
+    }
+  }
+
+  // Hands a connected stream to the rest of the class, unless Stop() got
+  // in first (then it is dropped here and Stop() has nothing to wake).
+  bool PublishStream(std::unique_ptr<TransportStream> connected) {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    if (!isRunning)
+      return false;
+    stream = std::move(connected);
+    listener.reset(); // One peer per session
+    return true;
+  }
+
+  void DropStream() {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    stream.reset();
+  }
+
   void HostLoop() {
-    TraceLog(LOG_INFO,
-             "NETWORK: Host thread started, waiting for connection...");
-    struct sockaddr_in clientAddr;
-    socklen_t clientLen = sizeof(clientAddr);
-
-    int clientSocket =
-        accept(currentSocket, (struct sockaddr *)&clientAddr, &clientLen);
-    if (clientSocket < 0) {
-      TraceLog(LOG_INFO, "NETWORK: Accept failed or stopped.");
+    LogAsync(LOG_INFO,
+             "NETWORK: Host thread started, waiting for connection (%s)...",
+             TransportKindName(transport->Kind()));
+    std::unique_ptr<TransportStream> accepted = listener->Accept();
+    if (!accepted || !PublishStream(std::move(accepted))) {
+      LogAsync(LOG_INFO, "NETWORK: Accept failed or stopped.");
       isRunning = false;
       return;
     }
 
-    // Enable TCP_NODELAY for accepted client socket
-    int flag = 1;
-    setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, (char *)&flag,
-               sizeof(int));
+    // Browsers can only reach us over TCP
+    if (transport->Kind() == TransportKind::TCP && !AcceptWebSocketUpgrade()) {
+      LogAsync(LOG_INFO, "NETWORK: WebSocket upgrade failed.");
+      isRunning = false;
+      return;
+    }
 
-    TraceLog(LOG_INFO, "NETWORK: Client connected!");
+    LogAsync(LOG_INFO, "NETWORK: Client connected%s!",
+             wsPeer ? " (WebSocket)" : "");
+    lastReceiveMs = NowMs();
     isConnected = true;
-
-    close(currentSocket); // Close listener
-    currentSocket = clientSocket;
+    Wake();
 
     ReadLoop();
   }
 
+  // Browser clients open with an HTTP upgrade request right after connecting,
+  // while desktop clients stay silent until GAME_START. Wait briefly for a
+  // "GET " and, if present, complete the RFC 6455 handshake so web builds
+  // can connect without a proxy. Returns false only on a failed upgrade.
+  bool AcceptWebSocketUpgrade() {
+    char peek[4];
+    int n = stream->Peek(peek, sizeof(peek), 250);
+    if (n < 4 || memcmp(peek, "GET ", 4) != 0)
+      return true; // Silent: raw TCP peer
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos) {
+      int bytesRead = stream->Recv(buffer, sizeof(buffer));
+      if (bytesRead <= 0 || request.size() > 8192)
+        return false;
+      request.append(buffer, bytesRead);
+    }
+    size_t headerEnd = request.find("\r\n\r\n") + 4;
+    std::string key = WebSocket::FindHeader(request.substr(0, headerEnd),
+                                            "Sec-WebSocket-Key");
+    if (key.empty())
+      return false;
+    std::string response = WebSocket::BuildServerHandshake(key);
+    stream->Send(response.data(), response.size());
+
+    wsPeer = true;
+    wsDecoder.Clear();
+    wsDecoder.Feed(request.data() + headerEnd, request.size() - headerEnd);
+    return ProcessWebSocketData();
+  }
+
+  // Network thread: connect attempts with timeout and backoff, then read
+  void ConnectLoop() {
+    int backoffMs = connectBackoffMs;
+    for (int attempt = 1; attempt <= connectMaxAttempts && isRunning;
+         attempt++) {
+      connectAttempt = attempt;
+      connectStatus = ConnectStatus::CONNECTING;
+      LogAsync(LOG_INFO, "NETWORK: Connecting to %s:%d (attempt %d/%d)",
+               connectIp.c_str(), connectPort, attempt, connectMaxAttempts);
+
+      const char *error = "";
+      std::unique_ptr<TransportStream> connected = transport->Connect(
+          connectIp, connectPort, connectTimeoutMs, isRunning, error);
+      if (!connected) {
+        connectError = error;
+      } else if (!PublishStream(std::move(connected))) {
+        break; // Cancelled while the connect completed
+      } else if (hubMode && !HubHandshake()) {
+        DropStream();
+      }
+      if (stream) {
+        lastReceiveMs = NowMs();
+        isConnected = true;
+        connectStatus = ConnectStatus::CONNECTED;
+        Wake();
+        LogAsync(LOG_INFO, "NETWORK: Connected to %s:%d%s", connectIp.c_str(),
+                 connectPort, connectPath.c_str());
+        ClientLoop();
+        return;
+      }
+      if (attempt == connectMaxAttempts || !isRunning)
+        break;
+      connectStatus = ConnectStatus::WAITING_RETRY;
+      if (!SleepWhileRunning(backoffMs))
+        break;
+      backoffMs = std::min(backoffMs * 2, MAX_BACKOFF_MS);
+    }
+    if (isRunning) {
+      LogAsync(LOG_INFO, "NETWORK: Connect failed: %s",
+               (const char *)connectError);
+      connectStatus = ConnectStatus::FAILED;
+      Wake();
+    }
+    isRunning = false;
+  }
+
+  // Sleeps in short slices so Stop()/CancelConnect() is never held up
+  bool SleepWhileRunning(int ms) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (isRunning && std::chrono::steady_clock::now() < deadline)
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    return isRunning;
+  }
+
+  // RFC 6455 opening handshake on a freshly connected socket, bounded by
+  // the connect timeout so a silent server cannot stall the attempt.
+  bool HubHandshake() {
+    uint8_t nonce[16];
+    {
+      std::lock_guard<std::mutex> lock(sendMutex);
+      for (uint8_t &b : nonce)
+        b = (uint8_t)maskRng();
+    }
+    std::string key = WebSocket::Base64(nonce, sizeof(nonce));
+    std::string request = WebSocket::BuildClientHandshake(
+        connectIp, connectPort, connectPath, key);
+    stream->Send(request.data(), request.size());
+
+    stream->SetRecvTimeout(connectTimeoutMs);
+    std::string response;
+    char buffer[1024];
+    while (response.find("\r\n\r\n") == std::string::npos) {
+      int bytesRead = stream->Recv(buffer, sizeof(buffer));
+      if (bytesRead <= 0 || response.size() > 8192) {
+        connectError = "Hub handshake failed";
+        return false;
+      }
+      response.append(buffer, bytesRead);
+    }
+    stream->SetRecvTimeout(0);
+
+    size_t headerEnd = response.find("\r\n\r\n") + 4;
+    std::string head = response.substr(0, headerEnd);
+    if (head.find(" 101 ") == std::string::npos ||
+        WebSocket::FindHeader(head, "Sec-WebSocket-Accept") !=
+            WebSocket::ComputeAcceptKey(key)) {
+      connectError = "Hub rejected WebSocket upgrade";
+      return false;
+    }
+    wsDecoder.Clear();
+    // Bytes after the handshake already belong to the frame stream
+    wsDecoder.Feed(response.data() + headerEnd, response.size() - headerEnd);
+    return true;
+  }
+
   void ClientLoop() {
-    TraceLog(LOG_INFO, "NETWORK: Client thread started reading...");
+    LogAsync(LOG_INFO, "NETWORK: Client thread started reading...");
+    if (hubMode && !ProcessWebSocketData()) { // Frames read with handshake
+      isConnected = false;
+      return;
+    }
     ReadLoop();
   }
 
   void ReadLoop() {
     char buffer[1024];
     while (isRunning && isConnected) {
-      int bytesRead = recv(currentSocket, buffer, sizeof(buffer) - 1, 0);
+      int bytesRead = stream->Recv(buffer, sizeof(buffer) - 1);
       if (bytesRead <= 0) {
-        TraceLog(LOG_INFO,
+        LogAsync(LOG_INFO,
                  "NETWORK: Connection closed or error. Stopping ReadLoop.");
         break; // Exit loop, thread finishes naturally. Don't call Stop() here!
       }
+      lastReceiveMs = NowMs();
+      if (hubMode || wsPeer) {
+        wsDecoder.Feed(buffer, bytesRead);
+        if (!ProcessWebSocketData()) {
+          LogAsync(LOG_INFO, "NETWORK: Peer closed the WebSocket.");
+          break;
+        }
+        Wake();
+        continue;
+      }
       buffer[bytesRead] = '\0';
       pendingData += buffer;
       ProcessPendingData();
+      Wake();
     }
     // Ensure flags are cleared when loop exits
     isConnected = false;
+    Wake();
   }
 #endif
 };
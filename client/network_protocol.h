@@ -1,6 +1,12 @@
 #ifndef NETWORK_PROTOCOL_H
 #define NETWORK_PROTOCOL_H
 
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -13,6 +19,14 @@ enum class NetworkMsgType {
   ROTATE,
   MOVE_DOWN,
   SYNC_STATE,
+  STATE_HASH,       // Periodic desync check: step + state hash
+  HASH_HISTORY_REQ, // Ask peer for per-step hashes after a mismatch
+  HASH_HISTORY,     // Per-step hashes + inputs, used to pinpoint divergence
+  RESUME,           // Client rejoins a match: session token + ack step
+  RESUME_OK,        // Host accepted the resume: its ack step
+  RESUME_REJECT,    // Unknown/expired session
+  INPUTS,           // Catch-up inputs for steps FROM.. after a resume
+  PING,             // Keepalive so silent drops are noticed quickly
   // Add more as needed
 };
 
@@ -20,7 +34,10 @@ struct NetworkMessage {
   NetworkMsgType type;
   std::string payload; // Raw payload for handling specific logic
   int intParam1 = 0;
+  int intParam2 = 0;
+  uint64_t hashParam = 0;
   std::string strParam1 = "";
+  int64_t stampMs = -1; // Sender's clock for inputs (T:), -1 if absent
 };
 
 class NetworkProtocol {
@@ -29,43 +46,353 @@ public:
     return "MOVE_LR;DIR:" + std::to_string(dir);
   }
 
+  // MOVE_LR / ROTATE / MOVE_DOWN: the receiver replays the remote board
+  static bool IsInput(const std::string &msg) {
+    return msg.compare(0, 7, "MOVE_LR") == 0 ||
+           msg.compare(0, 6, "ROTATE") == 0 ||
+           msg.compare(0, 9, "MOVE_DOWN") == 0;
+  }
+
+  // Soft drop (Logic::Move(0, 1)), unlike a plain MOVE_DOWN gravity tick,
+  // never locks the piece. Older peers read it as a tick.
+  static std::string SerializeSoftDrop() { return "MOVE_DOWN;SOFT:1"; }
+
+  // Appends the send time so the peer can replay inputs at their original
+  // cadence (JitterBuffer). Older peers ignore the extra field.
+  static std::string WithStamp(const std::string &input, int64_t stampMs) {
+    return input + ";T:" + std::to_string(stampMs);
+  }
+
+  // Keepalive carrying the sender's clock, in a unit of its choosing. A
+  // peer that understands it returns the stamp unchanged (SerializePingEcho)
+  // so the sender can measure the round trip; older peers ignore both,
+  // which still refreshes their silence timer.
+  static std::string SerializePing(int64_t stamp) {
+    return "PING;T:" + std::to_string(stamp);
+  }
+
+  static std::string SerializePingEcho(int64_t stamp) {
+    return "PING;ECHO:" + std::to_string(stamp);
+  }
+
   static std::string SerializeGameStart(int seed, const std::string &name) {
     return "GAME_START_HOST;SEED:" + std::to_string(seed) + ";P1_NAME:" + name;
   }
 
+  // P1_NAME stays last: older clients read the name up to the end
+  static std::string SerializeGameStart(int seed, uint64_t session,
+                                        const std::string &name) {
+    return "GAME_START_HOST;SEED:" + std::to_string(seed) +
+           ";SESSION:" + ToHex(session) + ";P1_NAME:" + name;
+  }
+
+  // ackStep: last step of the receiver's board that the sender has applied
+  static std::string SerializeResume(uint64_t session, int ackStep) {
+    return "RESUME;SESSION:" + ToHex(session) +
+           ";STEP:" + std::to_string(ackStep);
+  }
+
+  static std::string SerializeResumeOk(int ackStep) {
+    return "RESUME_OK;STEP:" + std::to_string(ackStep);
+  }
+
+  // inputs[i] is the action code (Logic::GetStepInput) of step fromStep + i
+  static std::string SerializeInputs(int fromStep, const std::string &inputs) {
+    return "INPUTS;FROM:" + std::to_string(fromStep) + ";IN:" + inputs;
+  }
+
   static std::string SerializeSyncState(int score, int nextType,
                                         const std::string &boardData) {
     return "SYNC_STATE;SCORE:" + std::to_string(score) +
            ";NEXT:" + std::to_string(nextType) + ";BOARD:" + boardData;
   }
 
+  // Full resync: like SYNC_STATE but also carries the step counter and the
+  // active piece so the receiver's mirror becomes identical to the sender.
+  static std::string SerializeResyncState(int score, int nextType,
+                                          const std::string &boardData,
+                                          int step, int curType, int curX,
+                                          int curY, int curRot) {
+    return "SYNC_STATE;SCORE:" + std::to_string(score) +
+           ";NEXT:" + std::to_string(nextType) +
+           ";STEP:" + std::to_string(step) + ";CUR:" +
+           std::to_string(curType) + "," + std::to_string(curX) + "," +
+           std::to_string(curY) + "," + std::to_string(curRot) +
+           ";BOARD:" + boardData;
+  }
+
+  static std::string SerializeStateHash(int step, uint64_t hash) {
+    return "STATE_HASH;STEP:" + std::to_string(step) + ";HASH:" + ToHex(hash);
+  }
+
+  static std::string SerializeHashHistoryReq(int fromStep, int toStep) {
+    return "HASH_HISTORY_REQ;FROM:" + std::to_string(fromStep) +
+           ";TO:" + std::to_string(toStep);
+  }
+
+  // hashes[i] / inputs[i] belong to step fromStep + i
+  static std::string SerializeHashHistory(int fromStep,
+                                          const std::vector<uint64_t> &hashes,
+                                          const std::string &inputs) {
+    std::string out = "HASH_HISTORY;FROM:" + std::to_string(fromStep) + ";H:";
+    for (size_t i = 0; i < hashes.size(); i++) {
+      if (i > 0)
+        out += ",";
+      out += ToHex(hashes[i]);
+    }
+    return out + ";IN:" + inputs;
+  }
+
+  // Parse the "H:" list of a HASH_HISTORY payload; empty if malformed
+  static std::vector<uint64_t> ParseHashList(const std::string &payload) {
+    std::vector<uint64_t> out;
+    if (!ReadHashList(payload, out))
+      out.clear();
+    return out;
+  }
+
+  static bool ReadHashList(const std::string &payload,
+                           std::vector<uint64_t> &out) {
+    size_t pos = payload.find("H:");
+    if (pos == std::string::npos)
+      return true;
+    pos += 2;
+    size_t end = payload.find(';', pos);
+    std::string list = payload.substr(pos, end == std::string::npos
+                                               ? std::string::npos
+                                               : end - pos);
+    size_t start = 0;
+    while (start < list.size()) {
+      size_t comma = list.find(',', start);
+      std::string item = list.substr(
+          start, comma == std::string::npos ? std::string::npos
+                                            : comma - start);
+      if (!item.empty()) {
+        bool ok = true;
+        out.push_back(ParseHex(item.c_str(), ok));
+        if (!ok)
+          return false;
+      }
+      if (comma == std::string::npos)
+        break;
+      start = comma + 1;
+    }
+    return true;
+  }
+
+  static std::string ToHex(uint64_t value) {
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)value);
+    return buf;
+  }
+
+  // Message type from the prefix alone, without parsing fields or
+  // allocating; agrees with Parse(). Used by the flight recorder.
+  static NetworkMsgType PeekType(const char *msg, size_t len) {
+    static const struct {
+      const char *prefix;
+      NetworkMsgType type;
+    } PREFIXES[] = {
+        // Longer prefixes first where one extends another
+        {"MOVE_LR", NetworkMsgType::MOVE_LR},
+        {"GAME_START", NetworkMsgType::GAME_START},
+        {"ROTATE", NetworkMsgType::ROTATE},
+        {"MOVE_DOWN", NetworkMsgType::MOVE_DOWN},
+        {"SYNC_STATE", NetworkMsgType::SYNC_STATE},
+        {"STATE_HASH", NetworkMsgType::STATE_HASH},
+        {"HASH_HISTORY_REQ", NetworkMsgType::HASH_HISTORY_REQ},
+        {"HASH_HISTORY", NetworkMsgType::HASH_HISTORY},
+        {"RESUME_OK", NetworkMsgType::RESUME_OK},
+        {"RESUME_REJECT", NetworkMsgType::RESUME_REJECT},
+        {"RESUME", NetworkMsgType::RESUME},
+        {"INPUTS", NetworkMsgType::INPUTS},
+    };
+    for (const auto &p : PREFIXES) {
+      size_t n = std::char_traits<char>::length(p.prefix);
+      if (len >= n && memcmp(msg, p.prefix, n) == 0)
+        return p.type;
+    }
+    if (len >= 4 && memcmp(msg, "PING", 4) == 0 &&
+        (len == 4 || msg[4] == ';'))
+      return NetworkMsgType::PING;
+    return NetworkMsgType::UNKNOWN;
+  }
+
+  static const char *TypeName(NetworkMsgType type) {
+    switch (type) {
+    case NetworkMsgType::CONNECT_REQ:
+      return "CONNECT_REQ";
+    case NetworkMsgType::GAME_START:
+      return "GAME_START";
+    case NetworkMsgType::MOVE_LR:
+      return "MOVE_LR";
+    case NetworkMsgType::ROTATE:
+      return "ROTATE";
+    case NetworkMsgType::MOVE_DOWN:
+      return "MOVE_DOWN";
+    case NetworkMsgType::SYNC_STATE:
+      return "SYNC_STATE";
+    case NetworkMsgType::STATE_HASH:
+      return "STATE_HASH";
+    case NetworkMsgType::HASH_HISTORY_REQ:
+      return "HASH_HISTORY_REQ";
+    case NetworkMsgType::HASH_HISTORY:
+      return "HASH_HISTORY";
+    case NetworkMsgType::RESUME:
+      return "RESUME";
+    case NetworkMsgType::RESUME_OK:
+      return "RESUME_OK";
+    case NetworkMsgType::RESUME_REJECT:
+      return "RESUME_REJECT";
+    case NetworkMsgType::INPUTS:
+      return "INPUTS";
+    case NetworkMsgType::PING:
+      return "PING";
+    default:
+      return "UNKNOWN";
+    }
+  }
+
+  // Never throws: a message whose numbers do not parse is UNKNOWN
   static NetworkMessage Parse(const std::string &msg) {
     NetworkMessage out;
     out.type = NetworkMsgType::UNKNOWN;
     out.payload = msg; // Simplify: always store payload
+    bool ok = true;
 
     if (msg.find("MOVE_LR") == 0) {
       out.type = NetworkMsgType::MOVE_LR;
       size_t pos = msg.find("DIR:");
       if (pos != std::string::npos) {
-        out.intParam1 = std::stoi(msg.substr(pos + 4));
+        out.intParam1 = ParseInt(msg.c_str() + pos + 4, ok);
       }
+      out.stampMs = ParseStamp(msg, ok);
     } else if (msg.find("GAME_START") == 0) {
       out.type = NetworkMsgType::GAME_START;
       size_t seedPos = msg.find("SEED:");
       if (seedPos != std::string::npos) {
-        out.intParam1 = std::stoi(msg.substr(seedPos + 5));
+        out.intParam1 = ParseInt(msg.c_str() + seedPos + 5, ok);
       }
+      out.hashParam = ParseHexField(msg, "SESSION:", ok);
     } else if (msg.find("ROTATE") == 0) {
       out.type = NetworkMsgType::ROTATE;
+      out.stampMs = ParseStamp(msg, ok);
     } else if (msg.find("MOVE_DOWN") == 0) {
       out.type = NetworkMsgType::MOVE_DOWN;
+      out.intParam1 = ParseIntField(msg, "SOFT:", ok); // 1: soft drop
+      out.stampMs = ParseStamp(msg, ok);
     } else if (msg.find("SYNC_STATE") == 0) {
       out.type = NetworkMsgType::SYNC_STATE;
+    } else if (msg.find("STATE_HASH") == 0) {
+      out.type = NetworkMsgType::STATE_HASH;
+      out.intParam1 = ParseIntField(msg, "STEP:", ok);
+      size_t hashPos = msg.find("HASH:");
+      if (hashPos != std::string::npos) {
+        out.hashParam = ParseHex(msg.c_str() + hashPos + 5, ok);
+      }
+    } else if (msg.find("HASH_HISTORY_REQ") == 0) {
+      out.type = NetworkMsgType::HASH_HISTORY_REQ;
+      out.intParam1 = ParseIntField(msg, "FROM:", ok);
+      out.intParam2 = ParseIntField(msg, "TO:", ok);
+    } else if (msg.find("HASH_HISTORY") == 0) {
+      out.type = NetworkMsgType::HASH_HISTORY;
+      out.intParam1 = ParseIntField(msg, "FROM:", ok);
+      std::vector<uint64_t> hashes;
+      ok = ReadHashList(msg, hashes) && ok;
+      size_t inPos = msg.find("IN:");
+      if (inPos != std::string::npos) {
+        out.strParam1 = msg.substr(inPos + 3);
+      }
+    } else if (msg.find("RESUME_OK") == 0) {
+      out.type = NetworkMsgType::RESUME_OK;
+      out.intParam1 = ParseIntField(msg, "STEP:", ok);
+    } else if (msg.find("RESUME_REJECT") == 0) {
+      out.type = NetworkMsgType::RESUME_REJECT;
+    } else if (msg.find("RESUME") == 0) {
+      out.type = NetworkMsgType::RESUME;
+      out.hashParam = ParseHexField(msg, "SESSION:", ok);
+      out.intParam1 = ParseIntField(msg, "STEP:", ok);
+    } else if (msg.find("INPUTS") == 0) {
+      out.type = NetworkMsgType::INPUTS;
+      out.intParam1 = ParseIntField(msg, "FROM:", ok);
+      size_t inPos = msg.find("IN:");
+      if (inPos != std::string::npos) {
+        out.strParam1 = msg.substr(inPos + 3);
+      }
+    } else if (msg == "PING" || msg.compare(0, 5, "PING;") == 0) {
+      out.type = NetworkMsgType::PING;
+      out.stampMs = ParseStamp(msg, ok); // Opaque stamp; -1: bare PING
+      size_t echoPos = msg.find(";ECHO:");
+      if (echoPos != std::string::npos) {
+        out.intParam1 = 1; // Echo of our own stamp
+        out.stampMs = ParseInt64(msg.c_str() + echoPos + 6, ok);
+      }
     }
 
+    if (!ok)
+      out.type = NetworkMsgType::UNKNOWN;
     return out;
   }
+
+private:
+  // Numbers from the peer: no exceptions. Anything but a number in range
+  // clears ok and reads as 0.
+  static int64_t ParseInt64(const char *text, bool &ok) {
+    errno = 0;
+    char *end;
+    long long value = strtoll(text, &end, 10);
+    if (end == text || errno == ERANGE) {
+      ok = false;
+      return 0;
+    }
+    return value;
+  }
+
+  static int ParseInt(const char *text, bool &ok) {
+    int64_t value = ParseInt64(text, ok);
+    if (value < INT32_MIN || value > INT32_MAX) {
+      ok = false;
+      return 0;
+    }
+    return (int)value;
+  }
+
+  static uint64_t ParseHex(const char *text, bool &ok) {
+    errno = 0;
+    char *end;
+    unsigned long long value = strtoull(text, &end, 16);
+    if (end == text || errno == ERANGE || text[0] == '-' || text[0] == '+' ||
+        isspace((unsigned char)text[0])) {
+      ok = false;
+      return 0;
+    }
+    return value;
+  }
+
+  static int ParseIntField(const std::string &msg, const char *key,
+                           bool &ok) {
+    size_t pos = msg.find(key);
+    if (pos == std::string::npos)
+      return 0;
+    return ParseInt(msg.c_str() + pos + std::char_traits<char>::length(key),
+                    ok);
+  }
+
+  static int64_t ParseStamp(const std::string &msg, bool &ok) {
+    size_t pos = msg.find(";T:");
+    if (pos == std::string::npos)
+      return -1;
+    return ParseInt64(msg.c_str() + pos + 3, ok);
+  }
+
+  static uint64_t ParseHexField(const std::string &msg, const char *key,
+                                bool &ok) {
+    size_t pos = msg.find(key);
+    if (pos == std::string::npos)
+      return 0;
+    return ParseHex(msg.c_str() + pos + std::char_traits<char>::length(key),
+                    ok);
+  }
 };
 
 #endif
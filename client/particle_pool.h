@@ -0,0 +1,96 @@
+#ifndef PARTICLE_POOL_H
+#define PARTICLE_POOL_H
+
+#include <cstdint>
+#include <vector>
+
+// Fixed-capacity particle storage as a struct of arrays: each attribute is
+// its own contiguous array, so Update() is a straight loop over floats the
+// compiler vectorizes. All memory is allocated once, in the constructor;
+// live particles are kept packed at [0, Count()) by moving the last one
+// into each slot that dies. Spawn() on a full pool drops the particle.
+class ParticlePool {
+public:
+  static constexpr int DEFAULT_CAPACITY = 8192;
+
+  explicit ParticlePool(int capacity = DEFAULT_CAPACITY)
+      : capacity(capacity), x(capacity), y(capacity), vx(capacity),
+        vy(capacity), gravity(capacity), life(capacity),
+        invLifetime(capacity), size(capacity), color(capacity) {}
+
+  // Pixels and seconds; color is 0xRRGGBBAA. False if the pool is full.
+  bool Spawn(float px, float py, float pvx, float pvy, float pgravity,
+             float lifetime, float psize, uint32_t pcolor) {
+    if (count >= capacity || lifetime <= 0) {
+      dropped++;
+      return false;
+    }
+    int i = count++;
+    x[i] = px;
+    y[i] = py;
+    vx[i] = pvx;
+    vy[i] = pvy;
+    gravity[i] = pgravity;
+    life[i] = lifetime;
+    invLifetime[i] = 1.0f / lifetime;
+    size[i] = psize;
+    color[i] = pcolor;
+    return true;
+  }
+
+  void Update(float dt) {
+    int n = count;
+    float *px = x.data(), *py = y.data();
+    float *pvx = vx.data(), *pvy = vy.data();
+    const float *pg = gravity.data();
+    float *plife = life.data();
+    for (int i = 0; i < n; i++) {
+      pvy[i] += pg[i] * dt;
+      px[i] += pvx[i] * dt;
+      py[i] += pvy[i] * dt;
+      plife[i] -= dt;
+    }
+    for (int i = 0; i < n;) {
+      if (plife[i] > 0) {
+        i++;
+        continue;
+      }
+      Move(--n, i);
+    }
+    count = n;
+  }
+
+  void Clear() { count = 0; }
+
+  int Count() const { return count; }
+  int Capacity() const { return capacity; }
+  uint64_t Dropped() const { return dropped; }
+
+  const float *X() const { return x.data(); }
+  const float *Y() const { return y.data(); }
+  const float *Size() const { return size.data(); }
+  const uint32_t *Color() const { return color.data(); }
+  // Remaining life, 1 at spawn down to 0
+  float Fraction(int i) const { return life[i] * invLifetime[i]; }
+
+private:
+  void Move(int from, int to) {
+    x[to] = x[from];
+    y[to] = y[from];
+    vx[to] = vx[from];
+    vy[to] = vy[from];
+    gravity[to] = gravity[from];
+    life[to] = life[from];
+    invLifetime[to] = invLifetime[from];
+    size[to] = size[from];
+    color[to] = color[from];
+  }
+
+  int capacity;
+  int count = 0;
+  uint64_t dropped = 0;
+  std::vector<float> x, y, vx, vy, gravity, life, invLifetime, size;
+  std::vector<uint32_t> color;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include "raylib.h"
+
+// Where Game gets its input, clock and text metrics. The default forwards
+// to raylib and its window; headless runs (script_platform.h) swap in one
+// that plays an InputScript on a virtual clock, so the whole Game state
+// machine runs with no window, no GPU and no frame cap.
+class Platform {
+public:
+  virtual ~Platform() = default;
+
+  // Before each Update(): the frame's input becomes current
+  virtual void BeginFrame() {}
+
+  virtual double Time() = 0;      // Seconds, GetTime()
+  virtual float FrameTime() = 0;  // Seconds, GetFrameTime()
+  virtual bool KeyPressed(int key) = 0;
+  virtual int CharPressed() = 0; // 0 when no more were typed
+  virtual Vector2 MousePosition() = 0;
+  virtual bool MouseButtonPressed(int button) = 0;
+  virtual bool MouseButtonDown(int button) = 0;
+  // Width of text in the default font, for layout that input depends on
+  virtual int TextWidth(const char *text, int fontSize) = 0;
+
+  // No window: nothing is drawn and nothing is saved to disk
+  virtual bool Headless() const { return false; }
+
+  static Platform &Get() { return *Current(); }
+  // nullptr puts the window back
+  static void Set(Platform *platform);
+
+private:
+  static Platform *&Current();
+};
+
+// raylib, as the game has always used it
+class WindowPlatform : public Platform {
+public:
+  double Time() override { return GetTime(); }
+  float FrameTime() override { return GetFrameTime(); }
+  bool KeyPressed(int key) override { return IsKeyPressed(key); }
+  int CharPressed() override { return GetCharPressed(); }
+  Vector2 MousePosition() override { return GetMousePosition(); }
+  bool MouseButtonPressed(int button) override {
+    return IsMouseButtonPressed(button);
+  }
+  bool MouseButtonDown(int button) override {
+    return IsMouseButtonDown(button);
+  }
+  int TextWidth(const char *text, int fontSize) override {
+    return MeasureText(text, fontSize);
+  }
+
+  static WindowPlatform &Get() {
+    static WindowPlatform window;
+    return window;
+  }
+};
+
+inline Platform *&Platform::Current() {
+  static Platform *current = &WindowPlatform::Get();
+  return current;
+}
+
+inline void Platform::Set(Platform *platform) {
+  Current() = platform ? platform : &WindowPlatform::Get();
+}
+
+#endif
@@ -0,0 +1,308 @@
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// RGBA8 images to PNG files in memory, with no zlib. Thumbnails are flat
+// rectangles of a few colors, so a small encoder does well on them:
+//  - every row uses the Up filter, so rows that repeat the one above are
+//    all zeros;
+//  - deflate is one fixed-Huffman block with greedy LZ77 matching (one
+//    hash slot per 3-byte prefix, 32 KiB window), which turns runs of a
+//    pixel (distance 4) and of zeros (distance 1) into long matches.
+// One writer per thread; its buffers are reused between images.
+class PngWriter {
+public:
+  // Appends the file to out; false if the size is not usable
+  bool Encode(const uint8_t *rgba, int width, int height, std::string &out) {
+    if (width <= 0 || height <= 0 || width > (1 << 24) / 4)
+      return false;
+    size_t stride = (size_t)width * 4;
+    raw.resize((stride + 1) * height);
+    for (int y = 0; y < height; y++) {
+      uint8_t *line = &raw[(stride + 1) * y];
+      const uint8_t *row = rgba + stride * y;
+      line[0] = 2; // Up
+      if (y == 0) {
+        memcpy(line + 1, row, stride);
+        continue;
+      }
+      SubtractRow(line + 1, row, row - stride, stride);
+    }
+
+    static const uint8_t SIGNATURE[8] = {0x89, 'P', 'N', 'G',
+                                         '\r', '\n', 0x1a, '\n'};
+    out.append((const char *)SIGNATURE, 8);
+    uint8_t header[13];
+    Put32(header, (uint32_t)width);
+    Put32(header + 4, (uint32_t)height);
+    header[8] = 8;  // Bits per channel
+    header[9] = 6;  // RGBA
+    header[10] = 0; // Deflate
+    header[11] = 0; // Adaptive filters
+    header[12] = 0; // Not interlaced
+    AppendChunk(out, "IHDR", header, 13);
+
+    zlib.clear();
+    zlib.push_back(0x78); // Deflate, 32 KiB window
+    zlib.push_back(0x01); // No dictionary, header check
+    Deflate(raw.data(), raw.size());
+    uint8_t adler[4];
+    Put32(adler, Adler32(raw.data(), raw.size()));
+    zlib.insert(zlib.end(), adler, adler + 4);
+    AppendChunk(out, "IDAT", zlib.data(), zlib.size());
+    AppendChunk(out, "IEND", nullptr, 0);
+    return true;
+  }
+
+  static uint32_t Crc32(const uint8_t *data, size_t size,
+                        uint32_t crc = 0) {
+    static const std::vector<uint32_t> table = [] {
+      std::vector<uint32_t> t(256);
+      for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+          c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        t[n] = c;
+      }
+      return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+      crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+  }
+
+  static uint32_t Adler32(const uint8_t *data, size_t size) {
+    uint32_t a = 1, b = 0;
+    while (size > 0) {
+      size_t n = size < 5552 ? size : 5552; // No overflow before the mod
+      size -= n;
+      while (n--) {
+        a += *data++;
+        b += a;
+      }
+      a %= 65521;
+      b %= 65521;
+    }
+    return b << 16 | a;
+  }
+
+private:
+  static constexpr int HASH_BITS = 15;
+  static constexpr int WINDOW = 32768;
+  static constexpr int MIN_MATCH = 3;
+  static constexpr int MAX_MATCH = 258;
+  static constexpr int MAX_INSERT = 16; // Longer matches: tail only
+
+  // out = row - above, bytewise: the Up filter
+  static void SubtractRow(uint8_t *out, const uint8_t *row,
+                          const uint8_t *above, size_t size) {
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= size; i += 16) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(row + i));
+      __m128i b = _mm_loadu_si128((const __m128i *)(above + i));
+      _mm_storeu_si128((__m128i *)(out + i), _mm_sub_epi8(a, b));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 16 <= size; i += 16)
+      vst1q_u8(out + i, vsubq_u8(vld1q_u8(row + i), vld1q_u8(above + i)));
+#endif
+    for (; i < size; i++)
+      out[i] = (uint8_t)(row[i] - above[i]);
+  }
+
+  static void Put32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+  }
+
+  static void AppendChunk(std::string &out, const char *type,
+                          const uint8_t *data, size_t size) {
+    uint8_t word[4];
+    Put32(word, (uint32_t)size);
+    out.append((const char *)word, 4);
+    out.append(type, 4);
+    if (size)
+      out.append((const char *)data, size);
+    uint32_t crc = Crc32((const uint8_t *)type, 4);
+    Put32(word, Crc32(data, size, crc));
+    out.append((const char *)word, 4);
+  }
+
+  // Deflate's bit order: values LSB first, Huffman codes MSB first
+  void PutBits(uint32_t value, int count) {
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+      zlib.push_back((uint8_t)bitBuffer);
+      bitBuffer >>= 8;
+      bitCount -= 8;
+    }
+  }
+  // The fixed literal/length code (RFC 1951, 3.2.6), bits reversed once
+  void PutSymbol(int symbol) {
+    struct Code {
+      uint16_t bits;
+      uint8_t length;
+    };
+    static const std::vector<Code> codes = [] {
+      std::vector<Code> table(288);
+      for (int s = 0; s < 288; s++) {
+        uint32_t code = s < 144   ? 0x30 + s
+                        : s < 256 ? 0x190 + s - 144
+                        : s < 280 ? s - 256
+                                  : 0xc0 + s - 280;
+        int length = s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8;
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; i++)
+          reversed |= (code >> i & 1) << (length - 1 - i);
+        table[s] = {(uint16_t)reversed, (uint8_t)length};
+      }
+      return table;
+    }();
+    PutBits(codes[symbol].bits, codes[symbol].length);
+  }
+
+  void PutMatch(int length, int distance) {
+    static const uint16_t LENGTH_BASE[29] = {
+        3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+        31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1,
+                                             1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                             4, 4, 4, 4, 5, 5, 5, 5, 0};
+    // Length code of each match length
+    static const std::vector<uint8_t> lengthCode = [] {
+      std::vector<uint8_t> table(MAX_MATCH + 1);
+      for (int l = 0, n = MIN_MATCH; n <= MAX_MATCH; n++) {
+        while (l < 28 && LENGTH_BASE[l + 1] <= n)
+          l++;
+        table[n] = (uint8_t)l;
+      }
+      return table;
+    }();
+    int l = lengthCode[length];
+    PutSymbol(257 + l);
+    PutBits(length - LENGTH_BASE[l], LENGTH_EXTRA[l]);
+
+    // Distance codes pair up per power of two: 1-4 are codes 0-3, then
+    // code 2k or 2k+1 by the bit below the top one of distance - 1
+    int d = distance - 1;
+    int code = d;
+    if (d >= 4) {
+      int top = 31 - CountLeadingZeros((uint32_t)d);
+      code = 2 * top + (d >> (top - 1) & 1);
+    }
+    int extra = code < 4 ? 0 : code / 2 - 1;
+    PutBits(Reverse5(code), 5);
+    PutBits(d & ((1 << extra) - 1), extra);
+  }
+
+  static int CountLeadingZeros(uint32_t v) {
+#if defined(__GNUC__)
+    return __builtin_clz(v);
+#else
+    int n = 0;
+    for (uint32_t bit = 0x80000000u; !(v & bit); bit >>= 1)
+      n++;
+    return n;
+#endif
+  }
+
+  static uint32_t Reverse5(uint32_t v) {
+    return (v & 1) << 4 | (v & 2) << 2 | (v & 4) | (v & 8) >> 2 | (v & 16) >> 4;
+  }
+
+  // Common prefix of a and b, up to limit, 8 bytes per compare
+  static size_t MatchLength(const uint8_t *a, const uint8_t *b,
+                            size_t limit) {
+    size_t n = 0;
+    while (n + 8 <= limit) {
+      uint64_t x, y;
+      memcpy(&x, a + n, 8);
+      memcpy(&y, b + n, 8);
+      if (x != y) {
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        return n + __builtin_ctzll(x ^ y) / 8;
+#else
+        break;
+#endif
+      }
+      n += 8;
+    }
+    while (n < limit && a[n] == b[n])
+      n++;
+    return n;
+  }
+
+  static uint32_t Hash(const uint8_t *p) {
+    uint32_t v = (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16;
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+  }
+
+  void Deflate(const uint8_t *data, size_t size) {
+    bitBuffer = 0;
+    bitCount = 0;
+    PutBits(1, 1); // Final block
+    PutBits(1, 2); // Fixed Huffman
+    // Positions are stored as base + i + 1, so entries from earlier images
+    // (below base) read as empty and the table is only cleared on wrap
+    if (head.empty() || (uint64_t)base + size + 1 > UINT32_MAX) {
+      head.assign((size_t)1 << HASH_BITS, 0);
+      base = 0;
+    }
+    size_t i = 0;
+    while (i < size) {
+      int length = 0, distance = 0;
+      if (i + MIN_MATCH <= size) {
+        uint32_t h = Hash(data + i);
+        int64_t candidate = (int64_t)head[h] - base - 1;
+        head[h] = base + (uint32_t)i + 1;
+        if (candidate >= 0 && (int64_t)i - candidate <= WINDOW) {
+          size_t limit = size - i < MAX_MATCH ? size - i : MAX_MATCH;
+          size_t n = MatchLength(data + candidate, data + i, limit);
+          if (n >= MIN_MATCH) {
+            length = (int)n;
+            distance = (int)(i - candidate);
+          }
+        }
+      }
+      if (length == 0) {
+        PutSymbol(data[i++]);
+        continue;
+      }
+      PutMatch(length, distance);
+      // Index the matched bytes too, so the next match can start anywhere;
+      // long ones (runs) only at their end, as zlib's fast levels do
+      size_t end = i + length;
+      i = length > MAX_INSERT ? end - MIN_MATCH : i + 1;
+      for (; i < end; i++)
+        if (i + MIN_MATCH <= size)
+          head[Hash(data + i)] = base + (uint32_t)i + 1;
+    }
+    base += (uint32_t)size + 1;
+    PutSymbol(256); // End of block
+    if (bitCount > 0)
+      PutBits(0, 8 - bitCount);
+  }
+
+  std::vector<uint8_t> raw;  // Filtered scanlines
+  std::vector<uint8_t> zlib; // IDAT payload
+  std::vector<uint32_t> head; // Last position of each 3-byte hash
+  uint32_t base = 0;
+  uint32_t bitBuffer = 0;
+  int bitCount = 0;
+};
+
+#endif
@@ -2,7 +2,6 @@
 
 # --- Configuration ---
 BUILD_DIR="build-web"
-WEBSOCKIFY_PORT="12346"
 GAME_PORT="12345"
 HTTP_PORT="8000"
 
@@ -48,15 +47,10 @@ fi
 cd ..
 echo "✅ Build successful!"
 
-# --- 3. Start Websockify ---
-echo "🔄 Starting Websockify to proxy $WEBSOCKIFY_PORT -> $LOCAL_IP:$GAME_PORT"
-# Kill existing websockify if any (be careful not to kill system processes, strictly match python module)
-pkill -f "websockify $WEBSOCKIFY_PORT"
-
-# Run websockify in background
-python3 -m websockify $WEBSOCKIFY_PORT $LOCAL_IP:$GAME_PORT &
-WEBSOCKIFY_PID=$!
-echo "   (PID: $WEBSOCKIFY_PID)"
+# --- 3. Game Host ---
+# Web clients connect straight to the desktop host's WebSocket accept path on
+# $GAME_PORT; no websockify proxy is needed any more.
+echo "🎮 Web clients join a desktop host directly on $LOCAL_IP:$GAME_PORT"
 
 # --- 4. Start HTTP Server ---
 echo "🌐 Starting HTTP Server on port $HTTP_PORT"
@@ -79,7 +73,6 @@ echo "🛑 Press Ctrl+C to stop servers."
 cleanup() {
     echo ""
     echo "🛑 Stopping servers..."
-    kill $WEBSOCKIFY_PID
     kill $HTTP_PID
     exit 0
 }
@@ -0,0 +1,216 @@
+#ifndef SCRIPT_PLATFORM_H
+#define SCRIPT_PLATFORM_H
+
+#include "input_capture.h"
+#include "input_script.h"
+#include "platform.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Headless input: plays an InputScript, one script frame per BeginFrame(),
+// on a virtual clock that advances exactly one frame each time, however
+// fast the loop runs. The script starts over when it runs out.
+// Game keys go through InputCapture like real key events, stamped half a
+// frame before the frame that sees them; everything else is answered from
+// the current frame's steps.
+class ScriptPlatform : public Platform {
+public:
+  static constexpr double FRAME_TIME = 1.0 / 60.0;
+
+  explicit ScriptPlatform(const InputScript &script) : script(script) {}
+
+  int64_t Frame() const { return frame; }
+
+  void BeginFrame() override {
+    frame++;
+    time = frame * FRAME_TIME;
+    keys.clear();
+    chars.clear();
+    nextChar = 0;
+    buttonPressed = false;
+    if (releaseNext)
+      buttonDown = releaseNext = false;
+    int length = script.Frames();
+    if (length == 0)
+      return;
+    int local = (int)(frame % length);
+    if (local == 0)
+      next = 0;
+    const std::vector<ScriptStep> &steps = script.Steps();
+    for (; next < steps.size() && steps[next].frame == local; next++)
+      Apply(steps[next]);
+  }
+
+  double Time() override { return time; }
+  float FrameTime() override { return (float)FRAME_TIME; }
+  bool KeyPressed(int key) override {
+    return std::find(keys.begin(), keys.end(), key) != keys.end();
+  }
+  int CharPressed() override {
+    return nextChar < chars.size() ? (unsigned char)chars[nextChar++] : 0;
+  }
+  Vector2 MousePosition() override { return mouse; }
+  bool MouseButtonPressed(int button) override {
+    return button == MOUSE_BUTTON_LEFT && buttonPressed;
+  }
+  bool MouseButtonDown(int button) override {
+    return button == MOUSE_BUTTON_LEFT && buttonDown;
+  }
+  // No font is loaded: glyphs count as the default font's usual 5 of 10
+  // px plus 1 px spacing, narrow ones as 1. Only button widths depend on
+  // this, and those buttons are centred or right-aligned, so a click near
+  // a button's middle hits it both here and in a window.
+  int TextWidth(const char *text, int fontSize) override {
+    int units = 0;
+    for (const char *c = text; *c; c++)
+      units += strchr("il.,:;!|'", *c) ? 2 : 6;
+    int size = fontSize < 10 ? 10 : fontSize;
+    return units > 0 ? (units - 1) * size / 10 : 0;
+  }
+  bool Headless() const override { return true; }
+
+private:
+  void Apply(const ScriptStep &step) {
+    double stamp = time - FRAME_TIME / 2; // Between the last frame and this
+    switch (step.action) {
+    case ScriptAction::KEY:
+      keys.push_back(step.key);
+      InputCapture::Inject(step.key, true, stamp);
+      InputCapture::Inject(step.key, false, stamp);
+      break;
+    case ScriptAction::DOWN:
+      keys.push_back(step.key);
+      InputCapture::Inject(step.key, true, stamp);
+      break;
+    case ScriptAction::UP:
+      InputCapture::Inject(step.key, false, stamp);
+      break;
+    case ScriptAction::TEXT:
+      chars += step.text;
+      break;
+    case ScriptAction::MOUSE:
+      mouse = {(float)step.x, (float)step.y};
+      break;
+    case ScriptAction::PRESS:
+    case ScriptAction::CLICK:
+      mouse = {(float)step.x, (float)step.y};
+      buttonPressed = buttonDown = true;
+      releaseNext = step.action == ScriptAction::CLICK;
+      break;
+    case ScriptAction::RELEASE:
+      buttonDown = false;
+      break;
+    }
+  }
+
+  const InputScript &script;
+  size_t next = 0; // Next step of this pass
+  int64_t frame = -1;
+  double time = 0;
+  std::vector<int> keys; // Pressed this frame
+  std::string chars;     // Typed this frame
+  size_t nextChar = 0;
+  Vector2 mouse = {0, 0};
+  bool buttonPressed = false;
+  bool buttonDown = false;
+  bool releaseNext = false; // Held by a click: up again next frame
+};
+
+// Records what a player does in a window as an InputScript that a headless
+// run can play back, frame for frame (TETRIS_RECORD_INPUT). Wraps the
+// window platform: keys and text are recorded as Game reads them, game
+// keys, the mouse button and drags from the raw state at BeginFrame().
+// Frames, not times: a replay steps at 60 FPS however the window ran.
+class RecordingPlatform : public Platform {
+public:
+  explicit RecordingPlatform(Platform &inner) : inner(inner) {}
+
+  const InputScript &Script() const { return script; }
+
+  void BeginFrame() override {
+    inner.BeginFrame();
+    frame++;
+    for (int key = KEY_SPACE; key <= KEY_KP_EQUAL; key++) {
+      int player;
+      InputAction action;
+      if (!InputCapture::MapKey(key, player, action) ||
+          IsKeyDown(key) == gameKeys[key])
+        continue;
+      gameKeys[key] = !gameKeys[key];
+      Record(gameKeys[key] ? ScriptAction::DOWN : ScriptAction::UP, key);
+    }
+    Vector2 position = inner.MousePosition();
+    bool down = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+    ScriptStep step;
+    step.frame = frame;
+    step.x = (int)position.x;
+    step.y = (int)position.y;
+    if (down != buttonDown)
+      step.action = down ? ScriptAction::PRESS : ScriptAction::RELEASE;
+    else if (down && (step.x != lastX || step.y != lastY))
+      step.action = ScriptAction::MOUSE;
+    else
+      return;
+    script.Add(step);
+    buttonDown = down;
+    lastX = step.x;
+    lastY = step.y;
+  }
+
+  double Time() override { return inner.Time(); }
+  float FrameTime() override { return inner.FrameTime(); }
+  bool KeyPressed(int key) override {
+    bool pressed = inner.KeyPressed(key);
+    if (pressed && InputScript::KeyName(key) && !RecordedThisFrame(key))
+      Record(ScriptAction::KEY, key);
+    return pressed;
+  }
+  int CharPressed() override {
+    int c = inner.CharPressed();
+    if (c < 32 || c > 126) // The game only takes printable ASCII
+      return c;
+    script.AddText(frame, (char)c);
+    return c;
+  }
+  Vector2 MousePosition() override { return inner.MousePosition(); }
+  bool MouseButtonPressed(int button) override {
+    return inner.MouseButtonPressed(button);
+  }
+  bool MouseButtonDown(int button) override {
+    return inner.MouseButtonDown(button);
+  }
+  int TextWidth(const char *text, int fontSize) override {
+    return inner.TextWidth(text, fontSize);
+  }
+
+private:
+  void Record(ScriptAction action, int key) {
+    ScriptStep step;
+    step.frame = frame;
+    step.action = action;
+    step.key = key;
+    script.Add(step);
+  }
+
+  // Game may ask about the same key more than once a frame
+  bool RecordedThisFrame(int key) const {
+    const std::vector<ScriptStep> &steps = script.Steps();
+    for (auto it = steps.rbegin(); it != steps.rend() && it->frame == frame;
+         ++it)
+      if (it->action == ScriptAction::KEY && it->key == key)
+        return true;
+    return false;
+  }
+
+  Platform &inner;
+  InputScript script;
+  int frame = -1;
+  bool gameKeys[KEY_KP_EQUAL + 1] = {};
+  bool buttonDown = false;
+  int lastX = 0, lastY = 0;
+};
+
+#endif
@@ -0,0 +1,130 @@
+#ifndef SESSION_RESUME_H
+#define SESSION_RESUME_H
+
+#include "logic.h"
+#include <cstdint>
+#include <random>
+#include <string>
+
+// Keeps a network match alive across short connection drops.
+//
+// The host issues a random session token with GAME_START. When the link
+// drops mid-match both sides keep playing locally and the client reconnects
+// within `graceSeconds`, presenting the token plus the last step it applied
+// of the host's board; the host answers with its own ack. Each side then
+// sends the inputs the peer missed (taken from Logic's step ring) or, when
+// the gap no longer fits the ring, a full snapshot.
+class SessionResume {
+public:
+  explicit SessionResume(float graceSeconds = 10.0f)
+      : graceSeconds(graceSeconds) {}
+
+  // A match started with this token
+  void Begin(uint64_t sessionToken) {
+    token = sessionToken;
+    reconnecting = false;
+    elapsed = 0.0f;
+  }
+
+  // Match over or abandoned: nothing left to resume
+  void End() {
+    token = 0;
+    reconnecting = false;
+  }
+
+  bool HasSession() const { return token != 0; }
+  uint64_t GetToken() const { return token; }
+  bool Matches(uint64_t other) const { return token != 0 && other == token; }
+
+  void OnDisconnected() {
+    reconnecting = true;
+    elapsed = 0.0f;
+  }
+
+  // Advance the grace timer; false once the window has run out
+  bool Update(float dt) {
+    if (!reconnecting)
+      return true;
+    elapsed += dt;
+    return elapsed < graceSeconds;
+  }
+
+  void OnResumed() {
+    reconnecting = false;
+    resumeCount++;
+    lastResumeSeconds = elapsed;
+  }
+
+  bool IsReconnecting() const { return reconnecting; }
+  float GetRemaining() const { return graceSeconds - elapsed; }
+  int GetResumeCount() const { return resumeCount; }
+  float GetLastResumeSeconds() const { return lastResumeSeconds; }
+
+  static uint64_t NewToken() {
+    std::random_device rd;
+    uint64_t value = ((uint64_t)rd() << 32) | rd();
+    return value ? value : 1; // 0 means "no session"
+  }
+
+  // Inputs of `local` for the steps after `ackStep`, i.e. what the peer's
+  // mirror is missing. False if part of that range already left the ring.
+  static bool CollectInputs(const Logic &local, int ackStep,
+                            std::string &outInputs) {
+    outInputs.clear();
+    if (ackStep > local.stepCounter)
+      return false; // Peer claims to be ahead of us: needs a snapshot
+    for (int step = ackStep + 1; step <= local.stepCounter; step++) {
+      char input = local.GetStepInput(step);
+      if (input == 0)
+        return false;
+      outInputs += input;
+    }
+    return true;
+  }
+
+  // Replay inputs for steps fromStep.. onto the mirror. Steps the mirror
+  // already applied are skipped. Returns the number of steps applied, or -1
+  // if there is a gap (fromStep beyond the mirror's next step).
+  static int ApplyInputs(Logic &mirror, int fromStep,
+                         const std::string &inputs) {
+    if (fromStep > mirror.stepCounter + 1)
+      return -1;
+    int applied = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      int step = fromStep + (int)i;
+      if (step <= mirror.stepCounter)
+        continue;
+      switch (inputs[i]) {
+      case 'L':
+        mirror.Move(-1, 0);
+        break;
+      case 'R':
+        mirror.Move(1, 0);
+        break;
+      case 'D':
+        mirror.Move(0, 1);
+        break;
+      case 'U':
+        mirror.Rotate();
+        break;
+      case 'G':
+        mirror.Tick();
+        break;
+      default:
+        return -1;
+      }
+      applied++;
+    }
+    return applied;
+  }
+
+private:
+  float graceSeconds;
+  uint64_t token = 0;
+  bool reconnecting = false;
+  float elapsed = 0.0f; // Time spent in the current reconnect
+  int resumeCount = 0;
+  float lastResumeSeconds = 0.0f;
+};
+
+#endif
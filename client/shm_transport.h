@@ -0,0 +1,311 @@
+#ifndef SHM_TRANSPORT_H
+#define SHM_TRANSPORT_H
+
+#include "transport.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+// Two processes on one machine exchanging bytes through a POSIX shared
+// memory segment named after the port. The segment holds one lock-free
+// single-producer/single-consumer ring per direction; each side only ever
+// writes its own ring's head and the other ring's tail, so no locks cross
+// the process boundary. Waiting spins briefly, then yields, then naps.
+//
+// One segment carries one connection: Listen() creates it, the first
+// Connect() claims it and Accept() hands the host its end and unlinks the
+// name so the port can be listened on again.
+namespace ShmDetail {
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared memory rings need lock-free 64-bit atomics");
+
+const uint32_t MAGIC = 0x54425348; // "TBSH"
+const size_t RING_CAPACITY = 1 << 20;
+
+enum SegmentState : uint32_t { INITIALIZING = 0, LISTENING, CONNECTED, ABANDONED };
+
+struct Ring {
+  alignas(64) std::atomic<uint64_t> head; // Total bytes written
+  alignas(64) std::atomic<uint64_t> tail; // Total bytes read
+  alignas(64) std::atomic<uint32_t> writerDone;
+  std::atomic<uint32_t> readerClosed;
+  char data[RING_CAPACITY];
+};
+
+struct Segment {
+  uint32_t magic;
+  std::atomic<uint32_t> state;
+  std::atomic<int32_t> hostPid; // Lets a new host reclaim a crashed one's port
+  Ring toClient;
+  Ring toHost;
+};
+
+inline void SegmentName(int port, char *out, size_t cap) {
+  snprintf(out, cap, "/tetris-shm-%d", port); // Short: macOS allows 31 chars
+}
+
+// Owns the mapping; shared by the listener and the streams it produced
+struct Mapping {
+  Segment *segment = nullptr;
+  ~Mapping() {
+    if (segment)
+      munmap(segment, sizeof(Segment));
+  }
+};
+
+inline std::shared_ptr<Mapping> Map(int fd) {
+  void *addr =
+      mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED)
+    return nullptr;
+  std::shared_ptr<Mapping> mapping = std::make_shared<Mapping>();
+  mapping->segment = (Segment *)addr;
+  return mapping;
+}
+
+// Spin, then yield, then sleep: sub-microsecond handoff while both sides
+// are busy without burning a core while a peer is idle
+class Backoff {
+public:
+  void Wait() {
+    if (spins < 64) {
+      spins++;
+    } else if (spins < 128) {
+      spins++;
+      std::this_thread::yield();
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+  }
+  void Reset() { spins = 0; }
+
+private:
+  int spins = 0;
+};
+
+} // namespace ShmDetail
+
+class ShmStream : public TransportStream {
+public:
+  ShmStream(std::shared_ptr<ShmDetail::Mapping> mapping, bool isHost)
+      : mapping(std::move(mapping)) {
+    ShmDetail::Segment *segment = this->mapping->segment;
+    in = isHost ? &segment->toHost : &segment->toClient;
+    out = isHost ? &segment->toClient : &segment->toHost;
+  }
+  ~ShmStream() override { Shutdown(); }
+
+  int Send(const char *data, size_t len) override {
+    const size_t cap = ShmDetail::RING_CAPACITY;
+    size_t written = 0;
+    ShmDetail::Backoff backoff;
+    while (written < len) {
+      if (shut || out->readerClosed.load(std::memory_order_acquire))
+        return -1;
+      uint64_t head = out->head.load(std::memory_order_relaxed);
+      uint64_t space = cap - (head - out->tail.load(std::memory_order_acquire));
+      if (space == 0) {
+        backoff.Wait();
+        continue;
+      }
+      backoff.Reset();
+      size_t chunk = (size_t)std::min<uint64_t>(len - written, space);
+      size_t pos = (size_t)(head % cap);
+      size_t first = std::min(chunk, cap - pos);
+      memcpy(out->data + pos, data + written, first);
+      memcpy(out->data, data + written + first, chunk - first);
+      out->head.store(head + chunk, std::memory_order_release);
+      written += chunk;
+    }
+    return (int)len;
+  }
+
+  int Recv(char *buf, size_t cap) override {
+    return Read(buf, cap, recvTimeoutMs, true);
+  }
+
+  int Peek(char *buf, size_t cap, int timeoutMs) override {
+    int n = Read(buf, cap, timeoutMs > 0 ? timeoutMs : 1, false);
+    return n < 0 ? 0 : n;
+  }
+
+  void SetRecvTimeout(int timeoutMs) override { recvTimeoutMs = timeoutMs; }
+
+  void Shutdown() override {
+    shut = true;
+    in->readerClosed.store(1, std::memory_order_release);
+    out->writerDone.store(1, std::memory_order_release);
+  }
+
+private:
+  int Read(char *buf, size_t cap, int timeoutMs, bool consume) {
+    const size_t ringCap = ShmDetail::RING_CAPACITY;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeoutMs);
+    ShmDetail::Backoff backoff;
+    while (true) {
+      if (shut)
+        return -1;
+      uint64_t tail = in->tail.load(std::memory_order_relaxed);
+      uint64_t avail = in->head.load(std::memory_order_acquire) - tail;
+      if (avail > 0) {
+        size_t chunk = (size_t)std::min<uint64_t>(cap, avail);
+        size_t pos = (size_t)(tail % ringCap);
+        size_t first = std::min(chunk, ringCap - pos);
+        memcpy(buf, in->data + pos, first);
+        memcpy(buf + first, in->data, chunk - first);
+        if (consume)
+          in->tail.store(tail + chunk, std::memory_order_release);
+        return (int)chunk;
+      }
+      // Re-check head after seeing writerDone so no final bytes are lost
+      if (in->writerDone.load(std::memory_order_acquire) &&
+          in->head.load(std::memory_order_acquire) == tail)
+        return 0;
+      if (timeoutMs > 0 && std::chrono::steady_clock::now() > deadline)
+        return -1;
+      backoff.Wait();
+    }
+  }
+
+  std::shared_ptr<ShmDetail::Mapping> mapping;
+  ShmDetail::Ring *in;
+  ShmDetail::Ring *out;
+  std::atomic<bool> shut{false};
+  std::atomic<int> recvTimeoutMs{0};
+};
+
+class ShmListener : public TransportListener {
+public:
+  ShmListener(std::shared_ptr<ShmDetail::Mapping> mapping, int port)
+      : mapping(std::move(mapping)) {
+    ShmDetail::SegmentName(port, name, sizeof(name));
+  }
+  ~ShmListener() override { Close(); }
+
+  std::unique_ptr<TransportStream> Accept() override {
+    ShmDetail::Segment *segment = mapping->segment;
+    ShmDetail::Backoff backoff;
+    while (!closed) {
+      if (segment->state.load(std::memory_order_acquire) ==
+          ShmDetail::CONNECTED) {
+        if (accepted.exchange(true))
+          break; // One connection per segment
+        shm_unlink(name); // Free the port for the next Listen()
+        return std::unique_ptr<TransportStream>(new ShmStream(mapping, true));
+      }
+      backoff.Wait();
+    }
+    return nullptr;
+  }
+
+  void Close() override {
+    closed = true;
+    uint32_t expected = ShmDetail::LISTENING;
+    if (mapping->segment->state.compare_exchange_strong(
+            expected, ShmDetail::ABANDONED))
+      shm_unlink(name);
+  }
+
+private:
+  std::shared_ptr<ShmDetail::Mapping> mapping;
+  char name[32];
+  std::atomic<bool> closed{false};
+  std::atomic<bool> accepted{false};
+};
+
+class ShmTransport : public Transport {
+public:
+  TransportKind Kind() const override { return TransportKind::SHARED_MEMORY; }
+
+  std::unique_ptr<TransportListener> Listen(int port,
+                                            const char *&error) override {
+    char name[32];
+    ShmDetail::SegmentName(port, name, sizeof(name));
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST) {
+      if (HasLiveListener(name)) {
+        error = "Port already in use";
+        return nullptr;
+      }
+      shm_unlink(name); // Left behind by a crashed or finished process
+      fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+    if (fd < 0) {
+      error = "Could not create shared memory";
+      return nullptr;
+    }
+    std::shared_ptr<ShmDetail::Mapping> mapping;
+    if (ftruncate(fd, sizeof(ShmDetail::Segment)) == 0)
+      mapping = ShmDetail::Map(fd);
+    close(fd);
+    if (!mapping) {
+      shm_unlink(name);
+      error = "Could not map shared memory";
+      return nullptr;
+    }
+    ShmDetail::Segment *segment =
+        new (mapping->segment) ShmDetail::Segment(); // Zeroed atomics
+    segment->magic = ShmDetail::MAGIC;
+    segment->hostPid.store((int32_t)getpid(), std::memory_order_relaxed);
+    segment->state.store(ShmDetail::LISTENING, std::memory_order_release);
+    return std::unique_ptr<TransportListener>(new ShmListener(mapping, port));
+  }
+
+  std::unique_ptr<TransportStream>
+  Connect(const std::string &, int port, int, const std::atomic<bool> &,
+          const char *&error) override {
+    char name[32];
+    ShmDetail::SegmentName(port, name, sizeof(name));
+    std::shared_ptr<ShmDetail::Mapping> mapping = OpenSegment(name);
+    if (!mapping) {
+      error = "Connection refused";
+      return nullptr;
+    }
+    uint32_t expected = ShmDetail::LISTENING;
+    if (!mapping->segment->state.compare_exchange_strong(
+            expected, ShmDetail::CONNECTED, std::memory_order_acq_rel)) {
+      error = "Connection refused"; // Taken by another client or abandoned
+      return nullptr;
+    }
+    return std::unique_ptr<TransportStream>(new ShmStream(mapping, false));
+  }
+
+private:
+  static std::shared_ptr<ShmDetail::Mapping> OpenSegment(const char *name) {
+    int fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0)
+      return nullptr;
+    struct stat info;
+    std::shared_ptr<ShmDetail::Mapping> mapping;
+    if (fstat(fd, &info) == 0 &&
+        (size_t)info.st_size >= sizeof(ShmDetail::Segment))
+      mapping = ShmDetail::Map(fd);
+    close(fd);
+    if (mapping && mapping->segment->magic != ShmDetail::MAGIC)
+      mapping.reset();
+    return mapping;
+  }
+
+  static bool HasLiveListener(const char *name) {
+    std::shared_ptr<ShmDetail::Mapping> mapping = OpenSegment(name);
+    if (!mapping || mapping->segment->state.load() != ShmDetail::LISTENING)
+      return false;
+    int32_t pid = mapping->segment->hostPid.load();
+    return pid > 0 && (kill(pid, 0) == 0 || errno == EPERM);
+  }
+};
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef SOFT_RASTER_H
+#define SOFT_RASTER_H
+
+#include "board_cells.h"
+#include "session_resume.h"
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// BoardPalette (board_renderer.h) without raylib: packed pixels, the grid
+// and ghost colors already blended over the background
+struct SoftPalette {
+  uint32_t background;
+  uint32_t grid;
+  uint32_t border;
+  uint32_t cells[BoardCells::PALETTE_SIZE];
+  uint32_t ghosts[BoardCells::PALETTE_SIZE];
+
+  // Same colors as BoardPalette::Classic()
+  static SoftPalette Classic();
+};
+
+// CPU-only renderer for board thumbnails and replay previews: draws what
+// BoardRenderer draws into an RGBA buffer, with no window or GL context,
+// so headless tools and servers can use it. Everything is axis-aligned
+// rectangles, so drawing is span fills, 4 pixels per store with SSE2 or
+// NEON. One SoftRaster per thread; the buffer is reused between images.
+class SoftRaster {
+public:
+  static constexpr int STRIP_GAP = 2; // Pixels between replay frames
+
+  // Pixels are R, G, B, A bytes in memory (PNG order), whatever the
+  // endianness. rgba is 0xRRGGBBAA, as in particle_pool.h.
+  static uint32_t Pack(uint32_t rgba) {
+    uint8_t bytes[4] = {(uint8_t)(rgba >> 24), (uint8_t)(rgba >> 16),
+                        (uint8_t)(rgba >> 8), (uint8_t)rgba};
+    uint32_t pixel;
+    memcpy(&pixel, bytes, 4);
+    return pixel;
+  }
+  static uint32_t Unpack(uint32_t pixel) {
+    uint8_t b[4];
+    memcpy(b, &pixel, 4);
+    return (uint32_t)b[0] << 24 | (uint32_t)b[1] << 16 |
+           (uint32_t)b[2] << 8 | b[3];
+  }
+
+  void Resize(int w, int h) {
+    width = w > 0 ? w : 0;
+    height = h > 0 ? h : 0;
+    pixels.resize((size_t)width * height); // Keeps its capacity
+  }
+
+  int Width() const { return width; }
+  int Height() const { return height; }
+  const uint8_t *Data() const {
+    return reinterpret_cast<const uint8_t *>(pixels.data());
+  }
+  uint32_t At(int x, int y) const { return pixels[(size_t)y * width + x]; }
+
+  void Clear(uint32_t pixel) { FillSpan(pixels.data(), width * height, pixel); }
+
+  // Clipped to the buffer
+  void FillRect(int x, int y, int w, int h, uint32_t pixel) {
+    int x0 = x < 0 ? 0 : x, y0 = y < 0 ? 0 : y;
+    int x1 = x + w > width ? width : x + w;
+    int y1 = y + h > height ? height : y + h;
+    if (x0 >= x1)
+      return;
+    for (int row = y0; row < y1; row++)
+      FillSpan(&pixels[(size_t)row * width + x0], x1 - x0, pixel);
+  }
+
+  // One-pixel outline, like DrawRectangleLines()
+  void StrokeRect(int x, int y, int w, int h, uint32_t pixel) {
+    FillRect(x, y, w, 1, pixel);
+    FillRect(x, y + h - 1, w, 1, pixel);
+    FillRect(x, y + 1, 1, h - 2, pixel);
+    FillRect(x + w - 1, y + 1, 1, h - 2, pixel);
+  }
+
+  static void FillSpan(uint32_t *dst, int count, uint32_t pixel) {
+    int i = 0;
+#if defined(__SSE2__)
+    __m128i v = _mm_set1_epi32((int)pixel);
+    for (; i + 16 <= count; i += 16) {
+      _mm_storeu_si128((__m128i *)(dst + i), v);
+      _mm_storeu_si128((__m128i *)(dst + i + 4), v);
+      _mm_storeu_si128((__m128i *)(dst + i + 8), v);
+      _mm_storeu_si128((__m128i *)(dst + i + 12), v);
+    }
+    for (; i + 4 <= count; i += 4)
+      _mm_storeu_si128((__m128i *)(dst + i), v);
+#elif defined(__ARM_NEON)
+    uint32x4_t v = vdupq_n_u32(pixel);
+    for (; i + 16 <= count; i += 16) {
+      vst1q_u32(dst + i, v);
+      vst1q_u32(dst + i + 4, v);
+      vst1q_u32(dst + i + 8, v);
+      vst1q_u32(dst + i + 12, v);
+    }
+    for (; i + 4 <= count; i += 4)
+      vst1q_u32(dst + i, v);
+#endif
+    for (; i < count; i++)
+      dst[i] = pixel;
+  }
+
+  static int BoardWidth(int cellSize) { return BOARD_WIDTH * cellSize; }
+  static int BoardHeight(int cellSize) { return BOARD_HEIGHT * cellSize; }
+
+  // One board's BoardCells codes at (x, y), as BoardRenderer's fallback
+  // draws them. Below 4 pixels a cell has no room for its inset and below
+  // 6 the grid would be all there is to see, so both are left out.
+  void DrawBoard(const uint8_t *codes, int x, int y, int cellSize,
+                 const SoftPalette &palette) {
+    int w = BoardWidth(cellSize), h = BoardHeight(cellSize);
+    FillRect(x, y, w, h, palette.background);
+    int inset = cellSize >= 4 ? 1 : 0;
+    bool grid = cellSize >= 6;
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      int cy = y + r * cellSize;
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        int code = codes[r * BOARD_WIDTH + c];
+        int cx = x + c * cellSize;
+        if (code == 0) {
+          if (grid)
+            StrokeRect(cx, cy, cellSize, cellSize, palette.grid);
+          continue;
+        }
+        int slot = code % BoardCells::LAYER_STRIDE;
+        if (slot >= BoardCells::PALETTE_SIZE)
+          slot = BoardCells::OTHER;
+        uint32_t pixel = code / BoardCells::LAYER_STRIDE == BoardCells::GHOST
+                             ? palette.ghosts[slot]
+                             : palette.cells[slot];
+        FillRect(cx + inset, cy + inset, cellSize - 2 * inset,
+                 cellSize - 2 * inset, pixel);
+      }
+    }
+    StrokeRect(x, y, w, h, palette.border);
+  }
+
+  // The whole buffer becomes one board: the locked cells only
+  void RenderBoard(const Board &board, int cellSize,
+                   const SoftPalette &palette) {
+    uint8_t codes[BoardCells::CELL_COUNT];
+    for (int r = 0; r < BOARD_HEIGHT; r++)
+      for (int c = 0; c < BOARD_WIDTH; c++) {
+        int value = board.GetCell(r, c);
+        codes[r * BOARD_WIDTH + c] =
+            value ? BoardCells::Code(BoardCells::LOCKED,
+                                     BoardCells::Slot(value))
+                  : 0;
+      }
+    Resize(BoardWidth(cellSize), BoardHeight(cellSize));
+    DrawBoard(codes, 0, 0, cellSize, palette);
+  }
+
+  // ... or a game in progress, active piece (and ghost) included
+  void RenderLogic(const Logic &logic, int cellSize, bool showGhost,
+                   const SoftPalette &palette) {
+    uint8_t codes[BoardCells::CELL_COUNT];
+    BoardCells::Build(logic, showGhost, codes);
+    Resize(BoardWidth(cellSize), BoardHeight(cellSize));
+    DrawBoard(codes, 0, 0, cellSize, palette);
+  }
+
+  // Replay preview: a game replayed from its seed and step inputs (the
+  // codes of Logic::GetStepInput), shown as frames side by side, each
+  // after an equal share of the steps; the last frame is the final board.
+  // False if an input code is unknown.
+  bool RenderReplay(int seed, const std::string &inputs, int frames,
+                    int cellSize, const SoftPalette &palette) {
+    if (frames < 1)
+      frames = 1;
+    int w = BoardWidth(cellSize), h = BoardHeight(cellSize);
+    Resize(frames * w + (frames - 1) * STRIP_GAP, h);
+    Clear(0); // Transparent gaps
+    replay.Reset(seed);
+    size_t done = 0;
+    for (int f = 0; f < frames; f++) {
+      size_t upTo = inputs.size() * (f + 1) / frames;
+      if (SessionResume::ApplyInputs(replay, replay.stepCounter + 1,
+                                     inputs.substr(done, upTo - done)) < 0)
+        return false;
+      done = upTo;
+      uint8_t codes[BoardCells::CELL_COUNT];
+      BoardCells::Build(replay, false, codes);
+      DrawBoard(codes, f * (w + STRIP_GAP), 0, cellSize, palette);
+    }
+    return true;
+  }
+
+private:
+  int width = 0, height = 0;
+  std::vector<uint32_t> pixels;
+  Logic replay; // Reused by RenderReplay
+};
+
+inline SoftPalette SoftPalette::Classic() {
+  // 0xRRGGBBAA of raylib's named colors
+  const uint32_t DARKGRAY = 0x505050ff, LIGHTGRAY = 0xc8c8c8ff;
+  const uint32_t GRAY = 0x828282ff, WHITE = 0xffffffff;
+  const float GRID_ALPHA = 0.1f, GHOST_ALPHA = 0.3f; // As in Classic()
+  auto over = [](uint32_t fg, uint32_t bg, float alpha) {
+    uint32_t out = 0xff;
+    for (int shift = 8; shift <= 24; shift += 8) {
+      float f = (float)(fg >> shift & 0xff), b = (float)(bg >> shift & 0xff);
+      out |= (uint32_t)(b + (f - b) * alpha + 0.5f) << shift;
+    }
+    return out;
+  };
+  const uint32_t cells[BoardCells::PALETTE_SIZE] = {
+      DARKGRAY,   // Empty
+      0x66bfffff, // I: SKYBLUE
+      0xfdf900ff, // O: YELLOW
+      0xc87affff, // T: PURPLE
+      0x00e430ff, // S: GREEN
+      0xe62937ff, // Z: RED
+      0x0079f1ff, // J: BLUE
+      0xffa100ff, // L: ORANGE
+      GRAY,       // OTHER
+  };
+  SoftPalette p;
+  p.background = SoftRaster::Pack(DARKGRAY);
+  p.grid = SoftRaster::Pack(over(LIGHTGRAY, DARKGRAY, GRID_ALPHA));
+  p.border = SoftRaster::Pack(WHITE);
+  for (int i = 0; i < BoardCells::PALETTE_SIZE; i++) {
+    p.cells[i] = SoftRaster::Pack(cells[i]);
+    p.ghosts[i] = SoftRaster::Pack(over(cells[i], DARKGRAY, GHOST_ALPHA));
+  }
+  return p;
+}
+
+#endif
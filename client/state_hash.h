@@ -0,0 +1,50 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+#include <cstdint>
+
+// Cheap, platform-independent hashing used for desync detection.
+// Zobrist-style: every (slot, value) pair maps to a pseudo-random 64-bit key
+// and a state hash is the XOR of the keys of its parts, so single-cell changes
+// can be applied incrementally with two XORs.
+namespace StateHash {
+
+// SplitMix64 finalizer: good avalanche, no tables, same result on every peer.
+inline uint64_t Mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Key for a board cell. Empty cells (value 0) contribute nothing so an empty
+// board hashes to 0 and Board::Reset() does not need to recompute anything.
+inline uint64_t CellKey(int index, int value) {
+  if (value == 0)
+    return 0;
+  return Mix(((uint64_t)(uint32_t)index << 32) | (uint32_t)value);
+}
+
+// Domain-separated keys for the non-board parts of a Logic state.
+enum Domain : uint64_t {
+  DOMAIN_CURRENT = 0x1000000000ULL,
+  DOMAIN_NEXT = 0x2000000000ULL,
+  DOMAIN_SCORE = 0x3000000000ULL,
+  DOMAIN_GAME_OVER = 0x4000000000ULL,
+};
+
+inline uint64_t PieceKey(uint64_t domain, int type, int x, int y,
+                         int rotation) {
+  uint64_t packed = ((uint64_t)(type & 0xFF) << 24) |
+                    ((uint64_t)(x & 0xFF) << 16) |
+                    ((uint64_t)(y & 0xFF) << 8) | (uint64_t)(rotation & 0x3);
+  return Mix(domain | packed);
+}
+
+inline uint64_t ValueKey(uint64_t domain, int value) {
+  return Mix(domain ^ ((uint64_t)(uint32_t)value << 4));
+}
+
+} // namespace StateHash
+
+#endif
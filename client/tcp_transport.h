@@ -0,0 +1,180 @@
+#ifndef TCP_TRANSPORT_H
+#define TCP_TRANSPORT_H
+
+#include "transport.h"
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h> // For TCP_NODELAY
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// The original NetworkManager sockets: AF_INET, TCP_NODELAY, blocking
+// reads on the network thread.
+class TcpStream : public TransportStream {
+public:
+  explicit TcpStream(int fd) : fd(fd) {
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(int));
+  }
+  ~TcpStream() override { close(fd); }
+
+  int Send(const char *data, size_t len) override {
+    size_t sent = 0;
+    while (sent < len) {
+      ssize_t n = send(fd, data + sent, len - sent, SEND_FLAGS);
+      if (n < 0 && errno == EINTR)
+        continue;
+      if (n <= 0)
+        return -1;
+      sent += (size_t)n;
+    }
+    return (int)len;
+  }
+
+  int Recv(char *buf, size_t cap) override {
+    return (int)recv(fd, buf, cap, 0);
+  }
+
+  int Peek(char *buf, size_t cap, int timeoutMs) override {
+    fd_set rset;
+    FD_ZERO(&rset);
+    FD_SET(fd, &rset);
+    struct timeval t = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    if (select(fd + 1, &rset, NULL, NULL, &t) <= 0)
+      return 0;
+    return (int)recv(fd, buf, cap, MSG_PEEK);
+  }
+
+  void SetRecvTimeout(int timeoutMs) override {
+    struct timeval t = {timeoutMs / 1000, (timeoutMs % 1000) * 1000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t));
+  }
+
+  void Shutdown() override { shutdown(fd, SHUT_RDWR); }
+
+private:
+#ifdef MSG_NOSIGNAL
+  static const int SEND_FLAGS = MSG_NOSIGNAL; // EPIPE instead of SIGPIPE
+#else
+  static const int SEND_FLAGS = 0;
+#endif
+  int fd;
+};
+
+class TcpListener : public TransportListener {
+public:
+  explicit TcpListener(int fd) : fd(fd) {}
+  ~TcpListener() override { close(fd); }
+
+  std::unique_ptr<TransportStream> Accept() override {
+    struct sockaddr_in clientAddr;
+    socklen_t clientLen = sizeof(clientAddr);
+    int clientSocket = accept(fd, (struct sockaddr *)&clientAddr, &clientLen);
+    if (clientSocket < 0)
+      return nullptr;
+    return std::unique_ptr<TransportStream>(new TcpStream(clientSocket));
+  }
+
+  // shutdown() wakes a thread blocked in accept()
+  void Close() override { shutdown(fd, SHUT_RDWR); }
+
+private:
+  int fd;
+};
+
+class TcpTransport : public Transport {
+public:
+  TransportKind Kind() const override { return TransportKind::TCP; }
+
+  std::unique_ptr<TransportListener> Listen(int port,
+                                            const char *&error) override {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      error = "Could not create socket";
+      return nullptr;
+    }
+    int opt = 1; // Allow reuse address
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    struct sockaddr_in serverAddr;
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_addr.s_addr = INADDR_ANY;
+    serverAddr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&serverAddr, sizeof(serverAddr)) < 0 ||
+        listen(fd, 1) < 0) {
+      error = "Port already in use";
+      close(fd);
+      return nullptr;
+    }
+    return std::unique_ptr<TransportListener>(new TcpListener(fd));
+  }
+
+  // Non-blocking connect polled in 50ms slices so cancellation is prompt;
+  // the returned socket is blocking again for the reader thread.
+  std::unique_ptr<TransportStream>
+  Connect(const std::string &address, int port, int timeoutMs,
+          const std::atomic<bool> &running, const char *&error) override {
+    struct sockaddr_in serverAddr;
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &serverAddr.sin_addr) <= 0) {
+      error = "Invalid IP address";
+      return nullptr;
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      error = "Could not create socket";
+      return nullptr;
+    }
+    int flags = fcntl(fd, F_GETFL, 0);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+
+    int res = connect(fd, (struct sockaddr *)&serverAddr, sizeof(serverAddr));
+    int connectErrno = res == 0 ? 0 : errno;
+    if (connectErrno == EINPROGRESS) {
+      auto deadline = std::chrono::steady_clock::now() +
+                      std::chrono::milliseconds(timeoutMs);
+      connectErrno = ETIMEDOUT;
+      while (running && std::chrono::steady_clock::now() < deadline) {
+        fd_set wset;
+        FD_ZERO(&wset);
+        FD_SET(fd, &wset);
+        struct timeval t = {0, 50000}; // Re-check cancellation every 50ms
+        if (select(fd + 1, NULL, &wset, NULL, &t) > 0) {
+          socklen_t len = sizeof(connectErrno);
+          if (getsockopt(fd, SOL_SOCKET, SO_ERROR, &connectErrno, &len) < 0)
+            connectErrno = errno;
+          break;
+        }
+      }
+    }
+    if (connectErrno != 0) {
+      error = ErrorText(connectErrno);
+      close(fd);
+      return nullptr;
+    }
+    fcntl(fd, F_SETFL, flags);
+    return std::unique_ptr<TransportStream>(new TcpStream(fd));
+  }
+
+  static const char *ErrorText(int error) {
+    switch (error) {
+    case ETIMEDOUT:
+      return "Connection timed out";
+    case ECONNREFUSED:
+      return "Connection refused";
+    case EHOSTUNREACH:
+    case ENETUNREACH:
+      return "Host unreachable";
+    default:
+      return "Connection failed";
+    }
+  }
+};
+
+#endif
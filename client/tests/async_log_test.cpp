@@ -0,0 +1,161 @@
+#include "../async_log.h"
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// A log that writes only to a temporary file and is drained by hand
+struct FileLog {
+  explicit FileLog(int ratePerSecond = 0, bool drainThread = false) {
+    char name[] = "/tmp/async_log_testXXXXXX";
+    int fd = mkstemp(name);
+    close(fd);
+    path = name;
+    AsyncLog::Config config;
+    config.toStdout = false;
+    config.filePath = path;
+    config.ratePerSecond = ratePerSecond;
+    config.drainThread = drainThread;
+    config.drainIntervalMs = 1;
+    log.reset(new AsyncLog(config));
+  }
+  ~FileLog() {
+    log.reset();
+    remove(path.c_str());
+  }
+
+  std::vector<std::string> Lines() {
+    std::ifstream in(path);
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line))
+      lines.push_back(line);
+    return lines;
+  }
+
+  std::string path;
+  std::unique_ptr<AsyncLog> log;
+};
+
+bool EndsWith(const std::string &text, const std::string &tail) {
+  return text.size() >= tail.size() &&
+         text.compare(text.size() - tail.size(), tail.size(), tail) == 0;
+}
+
+} // namespace
+
+// Arguments are captured at the call, formatted only at drain time
+TEST(AsyncLogTest, FormatsCapturedArgumentsLater) {
+  FileLog f;
+  {
+    std::string peer = "10.0.0.7";
+    f.log->Write(AsyncLog::LEVEL_INFO, "NETWORK: %s:%d took %.1f ms",
+                 peer.c_str(), 7000, 12.5);
+    f.log->Write(AsyncLog::LEVEL_WARNING, "code %c, %s, size %zu", 'G',
+                 std::string("temporary"), (size_t)42);
+    peer.assign("overwritten");
+  }
+  EXPECT_TRUE(f.Lines().empty());
+  EXPECT_EQ(f.log->Drain(), 2u);
+
+  std::vector<std::string> lines = f.Lines();
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_TRUE(EndsWith(lines[0], "INFO: NETWORK: 10.0.0.7:7000 took 12.5 ms"))
+      << lines[0];
+  EXPECT_TRUE(EndsWith(lines[1], "WARNING: code G, temporary, size 42"))
+      << lines[1];
+}
+
+TEST(AsyncLogTest, SkipsMessagesBelowTheLevel) {
+  FileLog f;
+  f.log->SetLevel(AsyncLog::LEVEL_WARNING);
+  f.log->Write(AsyncLog::LEVEL_DEBUG, "debug");
+  f.log->Write(AsyncLog::LEVEL_INFO, "info");
+  f.log->Write(AsyncLog::LEVEL_ERROR, "error %d", 1);
+  f.log->Drain();
+  std::vector<std::string> lines = f.Lines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_TRUE(EndsWith(lines[0], "ERROR: error 1"));
+}
+
+// A spinning call site is capped; the loss is reported once
+TEST(AsyncLogTest, RateLimitsEachCallSite) {
+  FileLog f(10);
+  for (int i = 0; i < 100; i++) {
+    f.log->Write(AsyncLog::LEVEL_INFO, "retry %d", i);
+    if (i < 3)
+      f.log->Write(AsyncLog::LEVEL_INFO, "other site %d", i);
+  }
+  f.log->Drain();
+
+  int retries = 0, others = 0, reports = 0;
+  for (const std::string &line : f.Lines()) {
+    retries += line.find("retry") != std::string::npos;
+    others += line.find("other site") != std::string::npos;
+    reports += line.find("rate limited") != std::string::npos;
+  }
+  // 10 per second, so 20 if the loop straddled a second boundary
+  EXPECT_GE(retries, 10);
+  EXPECT_LE(retries, 20);
+  EXPECT_EQ(others, 3);
+  EXPECT_EQ(reports, 1);
+  EXPECT_EQ(f.log->GetSuppressed(), (uint64_t)(100 - retries));
+}
+
+// The writer never waits for the drain side
+TEST(AsyncLogTest, FullRingDropsInsteadOfBlocking) {
+  FileLog f;
+  size_t total = AsyncLog::RING_SLOTS + 25;
+  for (size_t i = 0; i < total; i++)
+    f.log->Write(AsyncLog::LEVEL_INFO, "message %zu", i);
+  EXPECT_EQ(f.log->GetDropped(), 25u);
+  EXPECT_EQ(f.log->Drain(), AsyncLog::RING_SLOTS);
+
+  // Space again once drained
+  f.log->Write(AsyncLog::LEVEL_INFO, "after");
+  EXPECT_EQ(f.log->Drain(), 1u);
+  std::vector<std::string> lines = f.Lines();
+  ASSERT_FALSE(lines.empty());
+  EXPECT_TRUE(EndsWith(lines.back(), "INFO: after"));
+}
+
+// Many threads, background drain: nothing lost, merged in time order
+TEST(AsyncLogTest, DrainThreadCollectsEveryThread) {
+  const int THREADS = 4, MESSAGES = 300;
+  FileLog f(0, true);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++)
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < MESSAGES; i++) {
+        f.log->Write(AsyncLog::LEVEL_INFO, "thread %d message %d", t, i);
+        if (i % 64 == 63)
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  f.log.reset(); // Stops the drain thread after a final drain
+
+  std::vector<std::string> lines = f.Lines();
+  ASSERT_EQ(lines.size(), (size_t)(THREADS * MESSAGES));
+  std::vector<int> next(THREADS, 0);
+  double lastTime = 0.0;
+  for (const std::string &line : lines) {
+    double time = 0.0;
+    int t = -1, i = -1;
+    ASSERT_EQ(sscanf(line.c_str(), "[%lf] INFO: thread %d message %d", &time,
+                     &t, &i),
+              3)
+        << line;
+    ASSERT_TRUE(t >= 0 && t < THREADS);
+    EXPECT_EQ(i, next[t]++);
+    EXPECT_GE(time, lastTime);
+    lastTime = time;
+  }
+}
@@ -0,0 +1,131 @@
+#include "../battle_field.h"
+#include "../board_atlas.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+Logic EmptyLogic() {
+  Logic logic;
+  logic.Reset(1);
+  logic.currentPiece = Piece(); // No active piece
+  return logic;
+}
+
+} // namespace
+
+TEST(BoardAtlasTest, BoardsGoToTheirOwnTiles) {
+  std::vector<Logic> logics(12, EmptyLogic());
+  logics[0].board.SetCell(19, 0, (int)PieceType::I);
+  logics[11].board.SetCell(0, 9, (int)PieceType::Z);
+  std::vector<const Logic *> boards;
+  for (const Logic &logic : logics)
+    boards.push_back(&logic);
+
+  BoardAtlas atlas;
+  EXPECT_EQ(atlas.Update(boards.data(), (int)boards.size()), 12);
+  EXPECT_EQ(atlas.At(0, 19, 0), BoardCells::Code(BoardCells::LOCKED, 1));
+  EXPECT_EQ(atlas.At(11, 0, 9), BoardCells::Code(BoardCells::LOCKED, 5));
+  // Board 11 is the second tile of the second atlas row
+  EXPECT_EQ(BoardAtlas::TileX(11), BOARD_WIDTH);
+  EXPECT_EQ(BoardAtlas::TileY(11), BOARD_HEIGHT);
+  int topRight = BOARD_HEIGHT * BoardAtlas::WIDTH + 2 * BOARD_WIDTH - 1;
+  EXPECT_EQ(atlas.Data()[topRight], BoardCells::Code(BoardCells::LOCKED, 5));
+}
+
+TEST(BoardAtlasTest, OnlyChangedRowsAreDirty) {
+  Logic logic = EmptyLogic();
+  const Logic *boards[] = {&logic, &logic, &logic};
+  BoardAtlas atlas;
+  int first, last;
+  EXPECT_TRUE(atlas.GetDirtyRows(first, last)); // Initial upload
+  atlas.Update(boards, 3);
+  atlas.ClearDirty();
+
+  atlas.Update(boards, 3);
+  EXPECT_FALSE(atlas.GetDirtyRows(first, last));
+
+  logic.board.SetCell(7, 3, (int)PieceType::T);
+  atlas.Update(boards, 3);
+  ASSERT_TRUE(atlas.GetDirtyRows(first, last));
+  EXPECT_EQ(first, 7);
+  EXPECT_EQ(last, 8);
+}
+
+// Far boards: columns filled below their highest block, refreshed on a
+// staggered fraction of frames
+TEST(BoardAtlasTest, HeightmapBoardsUpdateAtReducedRate) {
+  Logic logic = EmptyLogic();
+  logic.board.SetCell(15, 2, (int)PieceType::L); // A hole below at 16..18
+  logic.board.SetCell(19, 2, (int)PieceType::L);
+  std::vector<const Logic *> boards(8, &logic);
+
+  BoardAtlas atlas;
+  atlas.SetFarInterval(4);
+  for (int i = 0; i < 8; i++)
+    atlas.SetLod(i, BoardAtlas::Lod::HEIGHTMAP);
+  EXPECT_EQ(atlas.Update(boards.data(), 8), 8); // First build: all
+  uint8_t fill = BoardCells::Code(BoardCells::LOCKED, BoardCells::OTHER);
+  EXPECT_EQ(atlas.At(0, 14, 2), 0);
+  for (int r = 15; r < BOARD_HEIGHT; r++)
+    EXPECT_EQ(atlas.At(0, r, 2), fill);
+  EXPECT_EQ(atlas.At(0, 19, 3), 0);
+
+  int rebuilt = 0;
+  for (int frame = 0; frame < 4; frame++) {
+    int n = atlas.Update(boards.data(), 8);
+    EXPECT_EQ(n, 2); // 8 boards over 4 frames
+    rebuilt += n;
+  }
+  EXPECT_EQ(rebuilt, 8);
+
+  // Back to full detail: rebuilt right away
+  atlas.SetLod(5, BoardAtlas::Lod::FULL);
+  logic.board.SetCell(19, 3, (int)PieceType::O);
+  atlas.Update(boards.data(), 8);
+  EXPECT_EQ(atlas.At(5, 19, 3), BoardCells::Code(BoardCells::LOCKED, 2));
+  EXPECT_EQ(atlas.At(5, 17, 2), 0); // The hole shows again
+}
+
+TEST(BoardAtlasTest, ToppedOutBoardsAreDimmed) {
+  Logic logic = EmptyLogic();
+  logic.board.SetCell(19, 0, (int)PieceType::S);
+  logic.isGameOver = true;
+  const Logic *boards[] = {&logic};
+  BoardAtlas atlas;
+  atlas.Update(boards, 1);
+  EXPECT_EQ(atlas.At(0, 19, 0), BoardCells::Code(BoardCells::GHOST, 4));
+}
+
+TEST(BoardAtlasTest, FitCellSize) {
+  int columns;
+  // 8 near boards across a 725 x 290 strip
+  EXPECT_EQ(BoardAtlas::FitCellSize(725, 290, 8, 10, columns), 8);
+  EXPECT_EQ(columns, 8);
+  // 91 far boards in 365 x 420
+  EXPECT_EQ(BoardAtlas::FitCellSize(365, 420, 91, 4, columns), 2);
+  EXPECT_EQ(columns, 15);
+  EXPECT_EQ(BoardAtlas::FitCellSize(5, 5, 1, 0, columns), 0);
+}
+
+TEST(BattleFieldTest, BotsPlayUntilTheyTopOut) {
+  BattleField field;
+  field.Reset(20, 7);
+  EXPECT_EQ(field.Size(), 20);
+  EXPECT_EQ(field.Alive(), 20);
+  for (int frame = 0; frame < 60 * 600 && field.Alive() > 0; frame++)
+    field.Update(1.0f / 60);
+  EXPECT_EQ(field.Alive(), 0);
+  EXPECT_GT(BattleField::StackHeight(field.Get(0)), 15);
+
+  // The same seed plays the same match
+  BattleField a, b;
+  a.Reset(5, 3);
+  b.Reset(5, 3);
+  for (int frame = 0; frame < 600; frame++) {
+    a.Update(1.0f / 60);
+    b.Update(1.0f / 60);
+  }
+  for (int i = 0; i < 5; i++)
+    EXPECT_EQ(a.Get(i).StateHash(), b.Get(i).StateHash());
+}
@@ -0,0 +1,67 @@
+#include "../board_cells.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+Logic EmptyLogic() {
+  Logic logic;
+  logic.Reset(1);
+  logic.currentPiece = Piece(); // No active piece
+  return logic;
+}
+
+} // namespace
+
+// Locked cells keep their piece color instead of one color for all
+TEST(BoardCellsTest, LockedCellsKeepTheirPalette) {
+  Logic logic = EmptyLogic();
+  logic.board.SetCell(19, 0, (int)PieceType::I);
+  logic.board.SetCell(19, 1, (int)PieceType::Z);
+  logic.board.SetCell(19, 2, 42); // A peer's unknown value
+
+  BoardCells cells;
+  ASSERT_TRUE(cells.Update(logic, false));
+  EXPECT_EQ(cells.At(19, 0), BoardCells::Code(BoardCells::LOCKED, 1));
+  EXPECT_EQ(cells.At(19, 1), BoardCells::Code(BoardCells::LOCKED, 5));
+  EXPECT_EQ(cells.At(19, 2),
+            BoardCells::Code(BoardCells::LOCKED, BoardCells::OTHER));
+  EXPECT_EQ(cells.At(19, 3), 0);
+}
+
+TEST(BoardCellsTest, ActivePieceAndGhost) {
+  Logic logic = EmptyLogic();
+  logic.currentPiece = Piece(PieceType::O, 4, 0); // Blocks in columns 5, 6
+
+  BoardCells cells;
+  cells.Update(logic, true);
+  uint8_t active = BoardCells::Code(BoardCells::ACTIVE, 2);
+  uint8_t ghost = BoardCells::Code(BoardCells::GHOST, 2);
+  EXPECT_EQ(cells.At(0, 5), active);
+  EXPECT_EQ(cells.At(1, 6), active);
+  EXPECT_EQ(cells.At(18, 5), ghost); // Resting on the floor
+  EXPECT_EQ(cells.At(19, 6), ghost);
+  EXPECT_EQ(cells.At(17, 5), 0);
+
+  // The ghost lands on the stack and is optional
+  logic.board.SetCell(19, 5, (int)PieceType::T);
+  cells.Update(logic, true);
+  EXPECT_EQ(cells.At(17, 5), ghost);
+  EXPECT_EQ(cells.At(18, 6), ghost);
+  cells.Update(logic, false);
+  EXPECT_EQ(cells.At(17, 5), 0);
+  EXPECT_EQ(cells.At(0, 5), active);
+}
+
+// The renderer re-uploads the texture only when Update() reports a change
+TEST(BoardCellsTest, ReportsOnlyChanges) {
+  Logic logic = EmptyLogic();
+  logic.currentPiece = Piece(PieceType::T, 3, 0);
+  BoardCells cells;
+  EXPECT_TRUE(cells.Update(logic, true)); // First frame
+  EXPECT_FALSE(cells.Update(logic, true));
+  logic.Move(1, 0);
+  EXPECT_TRUE(cells.Update(logic, true));
+  EXPECT_FALSE(cells.Update(logic, true));
+  logic.board.SetCell(10, 0, (int)PieceType::L);
+  EXPECT_TRUE(cells.Update(logic, true));
+}
@@ -0,0 +1,82 @@
+#include "../catch_up.h"
+#include <chrono>
+#include <deque>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+void BusyWaitUs(int us) {
+  auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(us);
+  while (std::chrono::steady_clock::now() < until) {
+  }
+}
+} // namespace
+
+TEST(CatchUpTest, ClampsFrameTime) {
+  CatchUp catchUp;
+  EXPECT_FLOAT_EQ(catchUp.BeginFrame(1.0f / 60), 1.0f / 60);
+  EXPECT_FLOAT_EQ(catchUp.BeginFrame(30.0f), 0.1f);
+}
+
+TEST(CatchUpTest, SmallBacklogDrainsAtOnce) {
+  CatchUp catchUp;
+  catchUp.BeginFrame(1.0f / 60);
+  std::deque<int> queue = {1, 2, 3};
+  EXPECT_FALSE(catchUp.Update(queue.size()));
+  std::vector<int> applied;
+  EXPECT_TRUE(catchUp.Drain(queue, [&](int i) {
+    applied.push_back(i);
+    return true;
+  }));
+  EXPECT_EQ(applied, (std::vector<int>{1, 2, 3}));
+  EXPECT_FALSE(catchUp.IsActive());
+}
+
+// 400 items of ~0.1ms each with a 4ms budget: spread over several frames,
+// in order, and live again once the queue is empty
+TEST(CatchUpTest, LargeBacklogIsSpreadOverFrames) {
+  CatchUp catchUp;
+  std::deque<int> queue;
+  for (int i = 0; i < 400; i++)
+    queue.push_back(i);
+  std::vector<int> applied;
+  int frames = 0;
+  catchUp.BeginFrame(1.0f / 60);
+  ASSERT_TRUE(catchUp.Update(queue.size()));
+  while (catchUp.IsActive() && frames < 1000) {
+    size_t before = applied.size();
+    catchUp.Drain(queue, [&](int i) {
+      BusyWaitUs(100);
+      applied.push_back(i);
+      return true;
+    });
+    EXPECT_GT(applied.size(), before);
+    frames++;
+    catchUp.BeginFrame(1.0f / 60);
+    catchUp.Update(queue.size());
+  }
+  ASSERT_EQ(applied.size(), 400u);
+  for (int i = 0; i < 400; i++)
+    ASSERT_EQ(applied[i], i);
+  EXPECT_GE(frames, 5);
+  EXPECT_EQ(catchUp.GetFrames(), frames);
+  EXPECT_EQ(catchUp.GetStartBacklog(), 400u);
+  EXPECT_FALSE(catchUp.IsActive());
+}
+
+TEST(CatchUpTest, StallWithBacklogStartsCatchUp) {
+  CatchUp catchUp;
+  catchUp.BeginFrame(2.0f); // Tab was in the background
+  EXPECT_FALSE(catchUp.Update(0));
+  EXPECT_TRUE(catchUp.Update(5));
+}
+
+TEST(CatchUpTest, StopsWhenApplyRefuses) {
+  CatchUp catchUp;
+  std::deque<int> queue = {1, 2, 3};
+  catchUp.BeginFrame(1.0f);
+  ASSERT_TRUE(catchUp.Update(queue.size()));
+  EXPECT_FALSE(catchUp.Drain(queue, [](int i) { return i != 2; }));
+  EXPECT_EQ(queue.size(), 1u);
+  EXPECT_FALSE(catchUp.IsActive());
+}
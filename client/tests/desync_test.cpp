@@ -0,0 +1,197 @@
+#include "../desync_detector.h"
+#include "../logic.h"
+#include "../network_protocol.h"
+#include <gtest/gtest.h>
+
+// Board hash must match a from-scratch recomputation after arbitrary edits
+TEST(StateHashTest, BoardHashIsIncremental) {
+  Board a;
+  Board b;
+  a.SetCell(19, 0, 3);
+  a.SetCell(19, 1, 4);
+  a.SetCell(19, 0, 0); // Clearing a cell removes its key again
+  b.SetCell(19, 1, 4);
+  EXPECT_EQ(a.GetHash(), b.GetHash());
+  EXPECT_NE(a.GetHash(), 0u);
+
+  a.Reset();
+  EXPECT_EQ(a.GetHash(), 0u);
+}
+
+TEST(StateHashTest, SameInputsSameHashes) {
+  Logic p1;
+  Logic p2;
+  p1.Reset(4242);
+  p2.Reset(4242);
+  EXPECT_EQ(p1.StateHash(), p2.StateHash());
+
+  for (int i = 0; i < 100; i++) {
+    p1.Move(i % 3 - 1, 0);
+    p2.Move(i % 3 - 1, 0);
+    p1.Tick();
+    p2.Tick();
+  }
+  EXPECT_EQ(p1.stepCounter, 200);
+  EXPECT_EQ(p1.StateHash(), p2.StateHash());
+  EXPECT_EQ(p1.GetStepHash(150), p2.GetStepHash(150));
+  EXPECT_EQ(p1.GetStepInput(199), 'L');
+  EXPECT_EQ(p1.GetStepInput(200), 'G');
+}
+
+TEST(StateHashTest, HistoryWindow) {
+  Logic logic;
+  logic.Reset(1);
+  EXPECT_NE(logic.GetStepHash(0), 0u);
+  for (int i = 0; i < Logic::STEP_HISTORY + 10; i++) {
+    logic.Rotate();
+  }
+  EXPECT_EQ(logic.GetStepHash(0), 0u); // Fell out of the ring
+  EXPECT_EQ(logic.GetStepHash(logic.stepCounter + 1), 0u);
+  EXPECT_EQ(logic.GetStepHash(logic.stepCounter), logic.StateHash());
+}
+
+TEST(DesyncDetectorTest, DetectsAndPinpointsDivergence) {
+  Logic remote; // The peer's own board
+  Logic mirror; // Our copy, driven by the peer's inputs
+  remote.Reset(777);
+  mirror.Reset(777);
+  DesyncDetector detector(10);
+
+  for (int i = 0; i < 10; i++) {
+    remote.Move(1, 0);
+    mirror.Move(1, 0);
+  }
+  ASSERT_TRUE(detector.ShouldReport(remote));
+  EXPECT_EQ(detector.CheckRemote(mirror, remote.stepCounter,
+                                 remote.GetStepHash(remote.stepCounter)),
+            DesyncDetector::Result::MATCH);
+  EXPECT_EQ(detector.GetLastVerifiedStep(), 10);
+
+  // Step 14 diverges: remote soft-drops while the mirror applies gravity
+  for (int i = 0; i < 3; i++) {
+    remote.Move(-1, 0);
+    mirror.Move(-1, 0);
+  }
+  remote.Move(0, 1);
+  mirror.Tick();
+  mirror.board.SetCell(19, 0, 5); // Diverge the boards as well
+  mirror.RefreshStepHash();
+  for (int i = 0; i < 6; i++) {
+    remote.Rotate();
+    mirror.Rotate();
+  }
+
+  ASSERT_TRUE(detector.ShouldReport(remote));
+  EXPECT_EQ(detector.CheckRemote(mirror, 20, remote.GetStepHash(20)),
+            DesyncDetector::Result::MISMATCH);
+  EXPECT_TRUE(detector.IsResyncPending());
+
+  std::vector<uint64_t> hashes;
+  std::string inputs;
+  int fromStep = 11;
+  ASSERT_TRUE(
+      DesyncDetector::CollectHistory(remote, fromStep, 20, hashes, inputs));
+  EXPECT_EQ(fromStep, 11);
+  EXPECT_EQ(inputs, "LLLDUUUUUU");
+  EXPECT_EQ(detector.FindDivergence(mirror, 11, hashes), 14);
+
+  detector.OnResynced(20);
+  EXPECT_FALSE(detector.IsResyncPending());
+  EXPECT_EQ(detector.GetDesyncCount(), 1);
+}
+
+// HASH_HISTORY_REQ ranges come from the peer: never loop past the ring
+TEST(DesyncDetectorTest, HistoryRequestIsBoundedByTheRing) {
+  Logic logic;
+  logic.Reset(1);
+  for (int i = 0; i < 300; i++)
+    logic.Rotate();
+  std::vector<uint64_t> hashes;
+  std::string inputs;
+  int fromStep = -2000000000;
+  EXPECT_FALSE(
+      DesyncDetector::CollectHistory(logic, fromStep, 0, hashes, inputs));
+  fromStep = -2000000000;
+  EXPECT_FALSE(DesyncDetector::CollectHistory(logic, fromStep, 2000000000,
+                                              hashes, inputs));
+  fromStep = 10;
+  EXPECT_FALSE(
+      DesyncDetector::CollectHistory(logic, fromStep, 9, hashes, inputs));
+  EXPECT_TRUE(hashes.empty());
+  EXPECT_TRUE(inputs.empty());
+
+  // Older steps than the ring holds are skipped, not reported as unknown
+  fromStep = 40;
+  ASSERT_TRUE(
+      DesyncDetector::CollectHistory(logic, fromStep, 60, hashes, inputs));
+  EXPECT_EQ(fromStep, 300 - Logic::STEP_HISTORY + 1);
+  EXPECT_EQ(hashes.size(), 16u);
+  EXPECT_EQ(hashes[0], logic.GetStepHash(fromStep));
+  EXPECT_EQ(inputs, std::string(16, 'U'));
+}
+
+// A full resync drops the diverged timeline's hashes
+TEST(DesyncDetectorTest, ResyncRestartsStepHistory) {
+  Logic mirror;
+  mirror.Reset(1);
+  for (int i = 0; i < 40; i++)
+    mirror.Rotate();
+  mirror.RestartStepHistory(30);
+  EXPECT_EQ(mirror.stepCounter, 30);
+  EXPECT_EQ(mirror.GetStepHash(30), mirror.StateHash());
+  EXPECT_EQ(mirror.GetStepHash(29), 0u);
+  EXPECT_EQ(mirror.GetStepInput(30), 0);
+
+  DesyncDetector detector;
+  detector.OnResynced(30);
+  EXPECT_EQ(detector.CheckRemote(mirror, 20, 0x1234),
+            DesyncDetector::Result::UNKNOWN);
+  mirror.Rotate();
+  EXPECT_EQ(mirror.GetStepInput(31), 'U');
+}
+
+TEST(DesyncDetectorTest, UnknownStepIsNotAMismatch) {
+  Logic mirror;
+  mirror.Reset(1);
+  DesyncDetector detector;
+  EXPECT_EQ(detector.CheckRemote(mirror, 50, 0x1234),
+            DesyncDetector::Result::UNKNOWN);
+  EXPECT_FALSE(detector.IsResyncPending());
+}
+
+TEST(NetworkProtocolTest, StateHashRoundTrip) {
+  std::string msg =
+      NetworkProtocol::SerializeStateHash(120, 0xDEADBEEF01234567ULL);
+  NetworkMessage out = NetworkProtocol::Parse(msg);
+  EXPECT_EQ(out.type, NetworkMsgType::STATE_HASH);
+  EXPECT_EQ(out.intParam1, 120);
+  EXPECT_EQ(out.hashParam, 0xDEADBEEF01234567ULL);
+}
+
+TEST(NetworkProtocolTest, HashHistoryRoundTrip) {
+  NetworkMessage req =
+      NetworkProtocol::Parse(NetworkProtocol::SerializeHashHistoryReq(5, 9));
+  EXPECT_EQ(req.type, NetworkMsgType::HASH_HISTORY_REQ);
+  EXPECT_EQ(req.intParam1, 5);
+  EXPECT_EQ(req.intParam2, 9);
+
+  std::vector<uint64_t> hashes = {1, 0xABCDEFULL, 0xFFFFFFFFFFFFFFFFULL};
+  std::string msg = NetworkProtocol::SerializeHashHistory(5, hashes, "LRG");
+  NetworkMessage out = NetworkProtocol::Parse(msg);
+  EXPECT_EQ(out.type, NetworkMsgType::HASH_HISTORY);
+  EXPECT_EQ(out.intParam1, 5);
+  EXPECT_EQ(out.strParam1, "LRG");
+  EXPECT_EQ(NetworkProtocol::ParseHashList(out.payload), hashes);
+}
+
+TEST(NetworkProtocolTest, MalformedNumbersAreUnknown) {
+  for (const char *msg :
+       {"STATE_HASH;STEP:abc;HASH:1", "STATE_HASH;STEP:5;HASH:zz",
+        "STATE_HASH;STEP:99999999999;HASH:1", "HASH_HISTORY_REQ;FROM:x;TO:9",
+        "HASH_HISTORY;FROM:5;H:1,q,3;IN:LRG", "MOVE_LR;DIR:",
+        "MOVE_DOWN;SOFT:-"})
+    EXPECT_EQ(NetworkProtocol::Parse(msg).type, NetworkMsgType::UNKNOWN)
+        << msg;
+  EXPECT_TRUE(NetworkProtocol::ParseHashList("H:1,q,3").empty());
+  EXPECT_EQ(NetworkProtocol::Parse("STATE_HASH;STEP:-2;HASH:ff").intParam1, -2);
+}
@@ -0,0 +1,123 @@
+#include "../effects.h"
+#include <gtest/gtest.h>
+
+TEST(ParticlePoolTest, MovesAndRemovesDeadParticlesInPlace) {
+  ParticlePool pool(4);
+  EXPECT_TRUE(pool.Spawn(0, 0, 10, 0, 0, 1.0f, 2, 0xff0000ff));
+  EXPECT_TRUE(pool.Spawn(5, 5, 0, 0, 100, 0.25f, 2, 0x00ff00ff));
+  EXPECT_TRUE(pool.Spawn(9, 9, 0, -10, 0, 2.0f, 2, 0x0000ffff));
+  EXPECT_EQ(pool.Count(), 3);
+
+  pool.Update(0.5f); // The short-lived one dies
+  ASSERT_EQ(pool.Count(), 2);
+  EXPECT_FLOAT_EQ(pool.X()[0], 5.0f);
+  EXPECT_FLOAT_EQ(pool.Fraction(0), 0.5f);
+  // The last particle moved into the dead one's slot
+  EXPECT_EQ(pool.Color()[1], 0x0000ffffu);
+  EXPECT_FLOAT_EQ(pool.Y()[1], 4.0f);
+  EXPECT_FLOAT_EQ(pool.Fraction(1), 0.75f);
+
+  pool.Update(1.0f);
+  EXPECT_EQ(pool.Count(), 1);
+  pool.Update(1.0f);
+  EXPECT_EQ(pool.Count(), 0);
+}
+
+TEST(ParticlePoolTest, FullPoolDropsNewParticles) {
+  ParticlePool pool(2);
+  EXPECT_TRUE(pool.Spawn(0, 0, 0, 0, 0, 1, 1, 0));
+  EXPECT_TRUE(pool.Spawn(0, 0, 0, 0, 0, 1, 1, 0));
+  EXPECT_FALSE(pool.Spawn(0, 0, 0, 0, 0, 1, 1, 0));
+  EXPECT_EQ(pool.Count(), 2);
+  EXPECT_EQ(pool.Dropped(), 1u);
+}
+
+namespace {
+
+// Bottom row full but for column 0, and an I piece dropped in vertically
+Logic AboutToClear(int lines) {
+  Logic logic;
+  logic.Reset(1);
+  for (int r = BOARD_HEIGHT - lines; r < BOARD_HEIGHT; r++)
+    for (int c = 1; c < BOARD_WIDTH; c++)
+      logic.board.SetCell(r, c, (int)PieceType::O);
+  logic.currentPiece = Piece(PieceType::I);
+  logic.currentPiece.rotation = 1;
+  logic.currentPiece.x = -2;
+  logic.currentPiece.y = BOARD_HEIGHT - 4;
+  return logic;
+}
+
+} // namespace
+
+TEST(EffectsTest, LocksAndClearsSpawnOnce) {
+  Effects effects;
+  Logic logic = AboutToClear(4);
+  effects.Observe(0, logic, 100, 40, 30);
+  EXPECT_FALSE(effects.Active()); // Nothing locked yet
+
+  logic.LockPiece(); // A Tetris
+  effects.Observe(0, logic, 100, 40, 30);
+  int tetris = 4 * BOARD_WIDTH * Effects::PARTICLES_PER_CELL * 4;
+  EXPECT_EQ(effects.Particles().Count(), tetris + 4 * Effects::LOCK_PARTICLES);
+  ASSERT_EQ(effects.FlashCount(), 4);
+  EXPECT_FLOAT_EQ(effects.GetFlash(0).y, 40 + 19 * 30);
+  EXPECT_EQ(effects.GetFlash(0).color, Effects::LineColor(4));
+
+  int count = effects.Particles().Count();
+  effects.Observe(0, logic, 100, 40, 30); // Same lock: nothing new
+  EXPECT_EQ(effects.Particles().Count(), count);
+
+  effects.Update(Effects::FLASH_TIME);
+  EXPECT_EQ(effects.FlashCount(), 0);
+  for (int i = 0; i < 200; i++)
+    effects.Update(1.0f / 60);
+  EXPECT_FALSE(effects.Active());
+}
+
+TEST(EffectsTest, BoardsAreTrackedApartAndResetsSpawnNothing) {
+  Effects effects;
+  Logic first = AboutToClear(1), second = AboutToClear(2);
+  first.LockPiece();
+  first.LockPiece(); // Two locks seen as one: only the last one shows
+  effects.Observe(0, first, 0, 0, 10);
+  effects.Observe(1, second, 0, 0, 10);
+  EXPECT_EQ(effects.FlashCount(), 0); // The second lock cleared nothing
+  int count = effects.Particles().Count();
+  EXPECT_GT(count, 0);
+
+  first.Reset(2);
+  effects.Observe(0, first, 0, 0, 10);
+  EXPECT_EQ(effects.Particles().Count(), count);
+  first = AboutToClear(1);
+  first.LockPiece();
+  effects.Observe(0, first, 0, 0, 10);
+  EXPECT_EQ(effects.FlashCount(), 1);
+}
+
+TEST(EffectsTest, ClassicStyleOnlyFlashes) {
+  EXPECT_EQ(Effects::StyleFromName("classic"), Effects::Style::CLASSIC);
+  EXPECT_EQ(Effects::StyleFromName("sparkle"), Effects::Style::SPARKLE);
+  EXPECT_EQ(Effects::StyleFromName("wave"), Effects::Style::EXPLOSION);
+  EXPECT_STREQ(Effects::StyleName(Effects::Style::SPARKLE), "sparkle");
+
+  Effects effects;
+  effects.SetStyle(Effects::Style::CLASSIC);
+  Logic logic = AboutToClear(2);
+  logic.LockPiece();
+  effects.Observe(0, logic, 0, 0, 30);
+  EXPECT_EQ(effects.Particles().Count(), 0);
+  EXPECT_EQ(effects.FlashCount(), 2);
+}
+
+// Both boards clearing a Tetris at once stay within the pool
+TEST(EffectsTest, TwoTetrisesFitTheDefaultPool) {
+  Effects effects;
+  Logic a = AboutToClear(4), b = AboutToClear(4);
+  a.LockPiece();
+  b.LockPiece();
+  effects.Observe(0, a, 0, 0, 30);
+  effects.Observe(1, b, 400, 0, 30);
+  EXPECT_EQ(effects.Particles().Dropped(), 0u);
+  EXPECT_LE(effects.Particles().Count(), ParticlePool::DEFAULT_CAPACITY);
+}
@@ -0,0 +1,135 @@
+#include "../flight_recorder.h"
+#include "../network_protocol.h"
+#include <cstddef>
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+TEST(FlightRecorderTest, KeepsTheLastCapacityEntriesInOrder) {
+  FlightRecorder recorder;
+  size_t total = FlightRecorder::CAPACITY + 100;
+  for (size_t i = 0; i < total; i++) {
+    std::string msg = "MOVE_LR;DIR:1;T:" + std::to_string(i);
+    recorder.Record(FlightRecorder::OUT, (uint8_t)NetworkMsgType::MOVE_LR,
+                    msg.data(), msg.size());
+  }
+  std::vector<FlightRecorder::Entry> entries = recorder.Snapshot();
+  ASSERT_EQ(entries.size(), FlightRecorder::CAPACITY);
+  EXPECT_EQ(std::string(entries.front().preview, entries.front().previewLen),
+            "MOVE_LR;DIR:1;T:100");
+  for (size_t i = 1; i < entries.size(); i++)
+    EXPECT_GE(entries[i].timeUs, entries[i - 1].timeUs);
+}
+
+TEST(FlightRecorderTest, LongMessagesKeepSizeAndPreview) {
+  FlightRecorder recorder;
+  std::string board(300, '0');
+  recorder.Record(FlightRecorder::IN, (uint8_t)NetworkMsgType::SYNC_STATE,
+                  board.data(), board.size());
+  recorder.Mark("desync at step 5");
+  std::vector<FlightRecorder::Entry> entries = recorder.Snapshot();
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[0].size, 300u);
+  EXPECT_EQ(entries[0].previewLen, FlightRecorder::PREVIEW);
+  EXPECT_EQ(entries[1].direction, FlightRecorder::MARK);
+  EXPECT_EQ(std::string(entries[1].preview, entries[1].previewLen),
+            "desync at step 5");
+}
+
+// Concurrent writers never produce torn or duplicated entries
+TEST(FlightRecorderTest, ConcurrentWriters) {
+  FlightRecorder recorder;
+  const int THREADS = 4, PER_THREAD = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([&recorder, t]() {
+      for (int i = 0; i < PER_THREAD; i++) {
+        char msg[32];
+        int len = snprintf(msg, sizeof(msg), "%d:%d", t, i);
+        recorder.Record(FlightRecorder::IN, 0, msg, (size_t)len);
+      }
+    });
+  }
+  for (std::thread &thread : threads)
+    thread.join();
+  std::vector<FlightRecorder::Entry> entries = recorder.Snapshot();
+  EXPECT_EQ(entries.size(), FlightRecorder::CAPACITY);
+  int last[THREADS] = {-1, -1, -1, -1};
+  for (const FlightRecorder::Entry &e : entries) {
+    int t = -1, i = -1;
+    std::string text(e.preview, e.previewLen);
+    ASSERT_EQ(sscanf(text.c_str(), "%d:%d", &t, &i), 2) << text;
+    ASSERT_GE(t, 0);
+    ASSERT_LT(t, THREADS);
+    EXPECT_GT(i, last[t]); // Each writer's entries stay in order
+    last[t] = i;
+  }
+}
+
+TEST(FlightRecorderTest, FileRoundTrip) {
+  FlightRecorder recorder;
+  recorder.Record(FlightRecorder::OUT, (uint8_t)NetworkMsgType::PING, "PING",
+                  4);
+  recorder.Record(FlightRecorder::IN, (uint8_t)NetworkMsgType::ROTATE,
+                  "ROTATE", 6);
+  char path[] = "/tmp/tbfr_testXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  ASSERT_TRUE(recorder.WriteFile(path, "host alice", "manual"));
+
+  FlightRecorder::FileHeader header;
+  std::vector<FlightRecorder::Entry> entries;
+  ASSERT_TRUE(FlightRecorder::ReadFile(path, header, entries));
+  remove(path);
+  EXPECT_STREQ(header.label, "host alice");
+  EXPECT_STREQ(header.reason, "manual");
+  ASSERT_EQ(entries.size(), 2u);
+  EXPECT_EQ(entries[1].type, (uint8_t)NetworkMsgType::ROTATE);
+  EXPECT_EQ(std::string(entries[1].preview, entries[1].previewLen), "ROTATE");
+}
+
+TEST(FlightRecorderTest, RejectsCountBeyondTheFile) {
+  FlightRecorder recorder;
+  recorder.Record(FlightRecorder::OUT, (uint8_t)NetworkMsgType::PING, "PING",
+                  4);
+  char path[] = "/tmp/tbfr_testXXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+  close(fd);
+  ASSERT_TRUE(recorder.WriteFile(path, "host", "manual"));
+
+  FlightRecorder::FileHeader header;
+  std::vector<FlightRecorder::Entry> entries;
+  for (uint32_t count : {2u, (uint32_t)FlightRecorder::CAPACITY + 1,
+                         0xffffffffu}) {
+    FILE *file = fopen(path, "r+b");
+    ASSERT_NE(file, nullptr);
+    fseek(file, offsetof(FlightRecorder::FileHeader, count), SEEK_SET);
+    fwrite(&count, sizeof(count), 1, file);
+    fclose(file);
+    EXPECT_FALSE(FlightRecorder::ReadFile(path, header, entries)) << count;
+    EXPECT_TRUE(entries.empty()) << count;
+  }
+  remove(path);
+}
+
+TEST(FlightRecorderTest, PeekTypeAgreesWithParse) {
+  const char *messages[] = {
+      "MOVE_LR;DIR:-1;T:5", "GAME_START_HOST;SEED:1;P1_NAME:x",
+      "ROTATE",             "MOVE_DOWN;SOFT:1",
+      "SYNC_STATE;SCORE:0", "STATE_HASH;STEP:3;HASH:ab",
+      "HASH_HISTORY_REQ;FROM:1;TO:2", "HASH_HISTORY;FROM:1;H:1;IN:L",
+      "RESUME;SESSION:1;STEP:2", "RESUME_OK;STEP:2",
+      "RESUME_REJECT",      "INPUTS;FROM:1;IN:LR",
+      "PING",               "PING;T:5",
+      "PING;ECHO:5",        "PLAYER_DEAD;ID:1",
+      "{\"type\":\"game_state\"}"};
+  for (const char *msg : messages) {
+    EXPECT_EQ(NetworkProtocol::PeekType(msg, strlen(msg)),
+              NetworkProtocol::Parse(msg).type)
+        << msg;
+  }
+}
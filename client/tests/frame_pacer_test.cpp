@@ -0,0 +1,75 @@
+#include "../frame_pacer.h"
+#include <gtest/gtest.h>
+
+TEST(FramePacerTest, WakesBeforeTheDeadlineByTheRenderCost) {
+  Metrics metrics;
+  FramePacer pacer(0.016, metrics);
+  pacer.SetLateSampling(true);
+  pacer.SetMargin(0.001);
+  // Frames submitted every 16 ms, 3 ms after their input was sampled
+  double t = 10.0;
+  for (int i = 0; i < 10; i++, t += 0.016)
+    pacer.FrameSubmitted(t - 0.003, t);
+  EXPECT_NEAR(pacer.RenderCost(), 0.003, 1e-9);
+  // The last frame went out at t - 16 ms; the next deadline is t
+  EXPECT_NEAR(pacer.WakeAt(), t - 0.003 - 0.001, 1e-9);
+  EXPECT_EQ(pacer.Missed(), 0u);
+}
+
+TEST(FramePacerTest, DefaultFramesStartOnePeriodApart) {
+  Metrics metrics;
+  FramePacer pacer(0.016, metrics);
+  EXPECT_LE(pacer.WakeAt(), 0.0); // Right away
+  pacer.FrameSubmitted(1.0, 1.005);
+  EXPECT_NEAR(pacer.WakeAt(), 1.016, 1e-9);
+  pacer.FrameSubmitted(1.0165, 1.020); // Woke a little late
+  EXPECT_NEAR(pacer.WakeAt(), 1.032, 1e-9); // Cadence, not sample + period
+}
+
+TEST(FramePacerTest, RenderCostIsAHighQuantile) {
+  Metrics metrics;
+  FramePacer pacer(0.016, metrics);
+  double t = 0;
+  for (int i = 0; i < FramePacer::COST_WINDOW; i++, t += 0.016)
+    pacer.FrameSubmitted(t - (i % 10 == 0 ? 0.008 : 0.002), t);
+  // One frame in ten costs 8 ms: below the 90th percentile
+  EXPECT_NEAR(pacer.RenderCost(), 0.002, 1e-9);
+  for (int i = 0; i < FramePacer::COST_WINDOW; i++, t += 0.016)
+    pacer.FrameSubmitted(t - (i % 5 == 0 ? 0.008 : 0.002), t);
+  EXPECT_NEAR(pacer.RenderCost(), 0.008, 1e-9); // One in five: above
+}
+
+TEST(FramePacerTest, MissedDeadlinesReanchorTheCadence) {
+  Metrics metrics;
+  FramePacer pacer(0.016, metrics);
+  pacer.SetLateSampling(true);
+  pacer.SetMargin(0);
+  pacer.FrameSubmitted(0.998, 1.0);
+  pacer.FrameSubmitted(1.014, 1.016);
+  pacer.FrameSubmitted(1.050, 1.052); // 20 ms late
+  EXPECT_EQ(pacer.Missed(), 1u);
+  EXPECT_NEAR(pacer.WakeAt(), 1.068 - pacer.RenderCost(), 1e-9);
+
+  pacer.Restart(); // Back from an idle screen: not a miss
+  pacer.FrameSubmitted(5.0, 5.002);
+  EXPECT_EQ(pacer.Missed(), 1u);
+}
+
+TEST(FramePacerTest, MeasuresInputToSubmittedFrame) {
+  Metrics metrics;
+  FramePacer pacer(0.016, metrics);
+  pacer.InputEvent(1.000);
+  pacer.InputEvent(1.004);
+  pacer.InputEvent(1.013); // After the frame sampled its input
+  pacer.FrameSubmitted(1.010, 1.012);
+  ASSERT_EQ(pacer.Latency().Count(), 2u);
+  EXPECT_NEAR(pacer.Latency().Max(), 12000, 1);
+
+  pacer.FrameSubmitted(1.020, 1.023); // Shows the third one
+  EXPECT_EQ(pacer.Latency().Count(), 3u);
+  EXPECT_NEAR(pacer.Latency().Max(), 12000, 1);
+  Metrics::Snapshot s = metrics.Collect();
+  EXPECT_EQ(s.Count(Metrics::INPUT_LATENCY), 3u);
+  pacer.ClearLatency();
+  EXPECT_EQ(pacer.Latency().Count(), 0u);
+}
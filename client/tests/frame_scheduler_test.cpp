@@ -0,0 +1,90 @@
+#include "../frame_scheduler.h"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(FrameSchedulerTest, AnimatingScreensDrawEveryPassWithoutWaiting) {
+  Metrics metrics;
+  FrameScheduler scheduler(metrics);
+  for (int i = 0; i < 3; i++)
+    EXPECT_TRUE(scheduler.ShouldDraw(true, 42));
+  EXPECT_EQ(scheduler.WaitTimeout(true, 0.3), 0.0);
+  EXPECT_FALSE(scheduler.FrameTimeStale());
+}
+
+TEST(FrameSchedulerTest, IdleScreensDrawOnlyWhenTheKeyChanges) {
+  Metrics metrics;
+  FrameScheduler scheduler(metrics);
+  EXPECT_TRUE(scheduler.ShouldDraw(false, 1)); // First frame
+  EXPECT_FALSE(scheduler.ShouldDraw(false, 1));
+  EXPECT_FALSE(scheduler.ShouldDraw(false, 1));
+  EXPECT_TRUE(scheduler.ShouldDraw(false, 2)); // E.g. a key was typed
+  EXPECT_FALSE(scheduler.ShouldDraw(false, 2));
+  EXPECT_TRUE(scheduler.ShouldDraw(true, 2)); // Play started
+}
+
+TEST(FrameSchedulerTest, WaitsUntilTheNextTimer) {
+  FrameScheduler scheduler;
+  EXPECT_DOUBLE_EQ(scheduler.WaitTimeout(false, 0.25), 0.25);
+  EXPECT_DOUBLE_EQ(scheduler.WaitTimeout(false, -1.0),
+                   FrameScheduler::MAX_WAIT);
+  EXPECT_DOUBLE_EQ(scheduler.WaitTimeout(false, 30.0),
+                   FrameScheduler::MAX_WAIT);
+}
+
+// The first frame drawn after idling measures the idle time as its frame
+// time; only the update that reads it is told to ignore it
+TEST(FrameSchedulerTest, FrameTimeAfterIdlingIsStale) {
+  Metrics metrics;
+  FrameScheduler scheduler(metrics);
+  scheduler.ShouldDraw(false, 1);
+  EXPECT_FALSE(scheduler.FrameTimeStale());
+  scheduler.Waited();
+  scheduler.ShouldDraw(false, 1); // Skipped
+  EXPECT_FALSE(scheduler.FrameTimeStale());
+  scheduler.ShouldDraw(true, 1); // Drawn after idling
+  EXPECT_TRUE(scheduler.FrameTimeStale());
+  scheduler.ShouldDraw(true, 1);
+  EXPECT_FALSE(scheduler.FrameTimeStale());
+
+  scheduler.ShouldDraw(true, 1);
+  scheduler.Waited(); // A wait alone also spans the next frame time
+  scheduler.ShouldDraw(true, 1);
+  EXPECT_TRUE(scheduler.FrameTimeStale());
+}
+
+TEST(FrameSchedulerTest, AccountsTimeAndFramesPerScreen) {
+  Metrics metrics;
+  FrameScheduler scheduler(metrics);
+  const int title = 0, playing = 3;
+
+  // Title: one drawn frame, then two idle passes; 2 s wall, 0.1 s CPU
+  scheduler.ShouldDraw(false, 7);
+  EXPECT_FALSE(scheduler.Account(title, 10.0, 1.0));
+  scheduler.ShouldDraw(false, 7);
+  EXPECT_FALSE(scheduler.Account(title, 11.0, 1.05));
+  scheduler.ShouldDraw(false, 7);
+  EXPECT_FALSE(scheduler.Account(title, 12.0, 1.1));
+  scheduler.ShouldDraw(true, 7);
+  EXPECT_TRUE(scheduler.Account(playing, 12.5, 1.4));
+
+  const FrameScheduler::Visit &visit = scheduler.LastVisit();
+  EXPECT_EQ(visit.screen, title);
+  EXPECT_DOUBLE_EQ(visit.seconds, 2.5); // Up to the pass that switched
+  EXPECT_NEAR(visit.cpuSeconds, 0.4, 1e-9);
+  EXPECT_EQ(visit.drawn, 1);
+  EXPECT_EQ(visit.skipped, 2);
+
+  Metrics::Snapshot s = metrics.Collect();
+  EXPECT_EQ(s.counters[Metrics::FRAMES_DRAWN][title], 1u);
+  EXPECT_EQ(s.counters[Metrics::FRAMES_IDLE][title], 2u);
+  EXPECT_EQ(s.counters[Metrics::FRAMES_DRAWN][playing], 1u);
+  EXPECT_EQ(s.counters[Metrics::SCREEN_WALL_US][title], 2500000u);
+  EXPECT_NEAR((double)s.counters[Metrics::SCREEN_CPU_US][title], 400000, 1);
+
+  std::string text = metrics.Render();
+  EXPECT_NE(
+      text.find("tetris_frames_total{screen=\"title\",drawn=\"false\"} 2"),
+      std::string::npos);
+  EXPECT_NE(text.find("tetris_screen_seconds_total{screen=\"title\"} 2.5"),
+            std::string::npos);
+}
@@ -0,0 +1,197 @@
+#include "../hub_codec.h"
+#include "../websocket_frame.h"
+#include <gtest/gtest.h>
+#include <string>
+
+TEST(HubJsonTest, WriteJoinGame) {
+  char buffer[128];
+  HubJson::Writer writer(buffer, sizeof(buffer));
+  writer.BeginMessage("join_game")
+      .BeginObject()
+      .Key("name")
+      .String("Oat \"Rice\"")
+      .Key("showGhostPiece")
+      .Bool(true)
+      .EndObject()
+      .EndMessage();
+  ASSERT_TRUE(writer.Ok());
+  EXPECT_EQ(std::string(writer.Data(), writer.Size()),
+            "{\"type\":\"join_game\",\"payload\":{\"name\":\"Oat "
+            "\\\"Rice\\\"\",\"showGhostPiece\":true}}");
+}
+
+TEST(HubJsonTest, WriterReportsOverflow) {
+  char buffer[8];
+  HubJson::Writer writer(buffer, sizeof(buffer));
+  writer.BeginMessage("game_state").BeginObject().EndObject().EndMessage();
+  EXPECT_FALSE(writer.Ok());
+}
+
+TEST(HubJsonTest, ParseGameStart) {
+  std::string json = "{ \"type\" : \"game_start\", \"payload\": {"
+                     "\"opponentId\":\"42\",\"opponentName\":\"Bob\\u0021\","
+                     "\"matchId\":\"room-1\",\"attackMode\":\"lines\"} }";
+  HubJson::MessageView msg;
+  ASSERT_TRUE(HubJson::ParseMessage(json, msg));
+  EXPECT_EQ(msg.type, HubJson::MsgType::GAME_START);
+
+  std::string_view raw, value;
+  ASSERT_TRUE(HubJson::FindMember(msg.payload, "opponentName", raw));
+  ASSERT_TRUE(HubJson::AsString(raw, value));
+  char name[16];
+  HubJson::Unescape(value, name, sizeof(name));
+  EXPECT_STREQ(name, "Bob!");
+
+  ASSERT_TRUE(HubJson::FindMember(msg.payload, "attackMode", raw));
+  ASSERT_TRUE(HubJson::AsString(raw, value));
+  EXPECT_EQ(value, "lines");
+}
+
+TEST(HubJsonTest, ParseMessageWithoutPayload) {
+  HubJson::MessageView msg;
+  ASSERT_TRUE(HubJson::ParseMessage("{\"type\":\"player_left\"}", msg));
+  EXPECT_EQ(msg.type, HubJson::MsgType::PLAYER_LEFT);
+  EXPECT_TRUE(msg.payload.empty());
+}
+
+TEST(HubJsonTest, GridRoundTrip) {
+  char buffer[256];
+  HubJson::Writer writer(buffer, sizeof(buffer));
+  writer.BeginMessage("game_state").BeginObject().Key("grid").BeginArray();
+  for (int r = 0; r < 3; r++) {
+    writer.BeginArray();
+    for (int c = 0; c < 4; c++)
+      writer.Int(r * 4 + c);
+    writer.EndArray();
+  }
+  writer.EndArray().Key("score").Int(-300).EndObject().EndMessage();
+  ASSERT_TRUE(writer.Ok());
+
+  HubJson::MessageView msg;
+  ASSERT_TRUE(
+      HubJson::ParseMessage(std::string_view(writer.Data(), writer.Size()), msg));
+  EXPECT_EQ(msg.type, HubJson::MsgType::GAME_STATE);
+
+  std::string_view grid, row, cell, raw;
+  ASSERT_TRUE(HubJson::FindMember(msg.payload, "grid", grid));
+  HubJson::ArrayCursor rows(grid);
+  int expected = 0;
+  while (rows.Next(row)) {
+    HubJson::ArrayCursor cells(row);
+    long long value;
+    while (cells.Next(cell)) {
+      ASSERT_TRUE(HubJson::AsInt(cell, value));
+      EXPECT_EQ(value, expected++);
+    }
+  }
+  EXPECT_EQ(expected, 12);
+
+  long long score;
+  ASSERT_TRUE(HubJson::FindMember(msg.payload, "score", raw));
+  ASSERT_TRUE(HubJson::AsInt(raw, score));
+  EXPECT_EQ(score, -300);
+}
+
+// Example from RFC 6455 section 1.3
+TEST(WebSocketTest, AcceptKey) {
+  EXPECT_EQ(WebSocket::ComputeAcceptKey("dGhlIHNhbXBsZSBub25jZQ=="),
+            "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+}
+
+// Host side of a browser connection: answer the upgrade, send unmasked
+TEST(WebSocketTest, ServerHandshakeAndUnmaskedFrame) {
+  std::string request = "GET / HTTP/1.1\r\nHost: 10.0.0.2:12345\r\n"
+                        "Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n\r\n";
+  std::string response = WebSocket::BuildServerHandshake(
+      WebSocket::FindHeader(request, "Sec-WebSocket-Key"));
+  EXPECT_EQ(response.find("HTTP/1.1 101 "), 0u);
+  EXPECT_EQ(WebSocket::FindHeader(response, "Sec-WebSocket-Accept"),
+            "s3pPLMBiTxaQ9kYGzzhZRbK+xOo=");
+
+  std::string msg = "GAME_START_HOST;SEED:7;P1_NAME:HOST";
+  std::string frame =
+      WebSocket::EncodeFrame(WebSocket::OP_BINARY, msg.data(), msg.size(), 0);
+  EXPECT_EQ(frame.size(), 2 + msg.size());
+  EXPECT_EQ(frame.substr(2), msg);
+
+  WebSocket::FrameDecoder decoder;
+  uint8_t opcode;
+  std::string out;
+  decoder.Feed(frame.data(), frame.size());
+  ASSERT_EQ(decoder.Next(opcode, out), WebSocket::FrameDecoder::Status::MESSAGE);
+  EXPECT_EQ(opcode, WebSocket::OP_BINARY);
+  EXPECT_EQ(out, msg);
+}
+
+TEST(WebSocketTest, FindHeaderIsCaseInsensitive) {
+  std::string head = "HTTP/1.1 101 Switching Protocols\r\n"
+                     "sec-websocket-accept: abc=\r\n\r\n";
+  EXPECT_EQ(WebSocket::FindHeader(head, "Sec-WebSocket-Accept"), "abc=");
+  EXPECT_EQ(WebSocket::FindHeader(head, "Upgrade"), "");
+}
+
+TEST(WebSocketTest, MaskedFrameRoundTrip) {
+  std::string payload(300, 'x'); // Needs the 16-bit extended length
+  std::string frame = WebSocket::EncodeFrame(WebSocket::OP_TEXT, payload.data(),
+                                             payload.size(), 0x12345678);
+  EXPECT_EQ(frame.size(), 4 + 4 + payload.size());
+  EXPECT_NE(frame.substr(8), payload); // Masked on the wire
+
+  WebSocket::FrameDecoder decoder;
+  uint8_t opcode;
+  std::string out;
+  // Byte-by-byte delivery must still produce exactly one message
+  for (size_t i = 0; i + 1 < frame.size(); i++) {
+    decoder.Feed(&frame[i], 1);
+    EXPECT_EQ(decoder.Next(opcode, out),
+              WebSocket::FrameDecoder::Status::NEED_MORE);
+  }
+  decoder.Feed(&frame[frame.size() - 1], 1);
+  ASSERT_EQ(decoder.Next(opcode, out), WebSocket::FrameDecoder::Status::MESSAGE);
+  EXPECT_EQ(opcode, WebSocket::OP_TEXT);
+  EXPECT_EQ(out, payload);
+}
+
+TEST(WebSocketTest, FragmentsAndControlFrames) {
+  // "Hel" (TEXT, no FIN) + PING + "lo" (CONTINUATION, FIN), server-style
+  std::string wire;
+  wire += std::string("\x01\x03Hel", 5);
+  wire += WebSocket::EncodeFrame(WebSocket::OP_PING, "p", 1, 0);
+  wire += std::string("\x80\x02lo", 4);
+
+  WebSocket::FrameDecoder decoder;
+  decoder.Feed(wire.data(), wire.size());
+  uint8_t opcode;
+  std::string out;
+  ASSERT_EQ(decoder.Next(opcode, out), WebSocket::FrameDecoder::Status::MESSAGE);
+  EXPECT_EQ(opcode, WebSocket::OP_PING);
+  EXPECT_EQ(out, "p");
+  ASSERT_EQ(decoder.Next(opcode, out), WebSocket::FrameDecoder::Status::MESSAGE);
+  EXPECT_EQ(opcode, WebSocket::OP_TEXT);
+  EXPECT_EQ(out, "Hello");
+  EXPECT_EQ(decoder.Next(opcode, out),
+            WebSocket::FrameDecoder::Status::NEED_MORE);
+}
+
+TEST(WebSocketTest, FragmentsCannotGrowPastTheMessageLimit) {
+  // 1000-byte fragments that never set FIN: the decoder gives up once the
+  // message would pass 1 MiB instead of buffering them forever
+  std::string fragment(1000, 'x');
+  std::string header("\x01\x7e\x03\xe8", 4); // TEXT, no FIN, 16-bit length
+  WebSocket::FrameDecoder decoder;
+  uint8_t opcode;
+  std::string out;
+  WebSocket::FrameDecoder::Status status =
+      WebSocket::FrameDecoder::Status::NEED_MORE;
+  int frames = 0;
+  for (; frames < 2000 &&
+         status == WebSocket::FrameDecoder::Status::NEED_MORE;
+       frames++) {
+    std::string frame = header + fragment;
+    decoder.Feed(frame.data(), frame.size());
+    header[0] = '\x00'; // CONTINUATION from here on
+    status = decoder.Next(opcode, out);
+  }
+  EXPECT_EQ(status, WebSocket::FrameDecoder::Status::ERROR);
+  EXPECT_EQ(frames, (1 << 20) / 1000 + 1);
+}
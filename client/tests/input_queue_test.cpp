@@ -0,0 +1,123 @@
+#include "../input_queue.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+InputEvent Key(double time, InputAction action, bool down) {
+  return {time, 0, action, down};
+}
+
+} // namespace
+
+TEST(InputQueueTest, FullQueueDropsNewEvents) {
+  InputQueue queue;
+  for (int i = 0; i < InputQueue::CAPACITY; i++)
+    EXPECT_TRUE(queue.Push(Key(i, InputAction::LEFT, i % 2 == 0)));
+  EXPECT_FALSE(queue.Push(Key(999, InputAction::RIGHT, true)));
+  EXPECT_EQ(queue.Size(), InputQueue::CAPACITY);
+  EXPECT_EQ(queue.Dropped(), 1u);
+
+  InputEvent event;
+  ASSERT_TRUE(queue.Pop(event));
+  EXPECT_EQ(event.time, 0);
+  EXPECT_TRUE(queue.Push(Key(1000, InputAction::RIGHT, true))); // Wraps
+  for (int i = 1; i < InputQueue::CAPACITY; i++)
+    ASSERT_TRUE(queue.Pop(event));
+  ASSERT_TRUE(queue.Pop(event));
+  EXPECT_EQ(event.time, 1000);
+  EXPECT_FALSE(queue.Pop(event));
+}
+
+// Repeats land at press + delay + k * rate, whatever the frame times
+TEST(InputTimelineTest, RepeatsAtExactTimesBetweenFrames) {
+  InputTimeline timeline(0.2, 0.05);
+  std::vector<InputOp> ops;
+  timeline.Feed(Key(1.003, InputAction::RIGHT, true), ops);
+  timeline.Flush(1.016, ops);
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_TRUE(ops[0].press);
+  EXPECT_EQ(ops[0].action, InputAction::RIGHT);
+
+  timeline.Flush(1.290, ops); // One long frame
+  ASSERT_EQ(ops.size(), 3u);
+  EXPECT_NEAR(ops[1].time, 1.203, 1e-9);
+  EXPECT_NEAR(ops[2].time, 1.253, 1e-9);
+  EXPECT_FALSE(ops[1].press);
+
+  timeline.Feed(Key(1.300, InputAction::RIGHT, false), ops);
+  timeline.Flush(2.0, ops);
+  EXPECT_EQ(ops.size(), 3u); // 1.303 never came
+}
+
+TEST(InputTimelineTest, TapShorterThanAFrameMovesOnce) {
+  InputTimeline timeline;
+  std::vector<InputOp> ops;
+  timeline.Feed(Key(1.001, InputAction::LEFT, true), ops);
+  timeline.Feed(Key(1.004, InputAction::LEFT, false), ops);
+  timeline.Feed(Key(1.006, InputAction::ROTATE, true), ops);
+  timeline.Feed(Key(1.008, InputAction::ROTATE, false), ops);
+  timeline.Flush(1.016, ops);
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].action, InputAction::LEFT);
+  EXPECT_EQ(ops[1].action, InputAction::ROTATE);
+  EXPECT_FALSE(timeline.IsHeld(InputAction::LEFT));
+}
+
+TEST(InputTimelineTest, LastDirectionWinsAndReleaseSwitchesBack) {
+  InputTimeline timeline(0.2, 0.05);
+  std::vector<InputOp> ops;
+  timeline.Feed(Key(0.0, InputAction::LEFT, true), ops);
+  timeline.Feed(Key(0.1, InputAction::RIGHT, true), ops);
+  timeline.Flush(0.25, ops); // Left's charge was lost
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[1].action, InputAction::RIGHT);
+
+  timeline.Feed(Key(0.36, InputAction::RIGHT, false), ops); // Left held
+  ASSERT_EQ(ops.size(), 5u);
+  EXPECT_EQ(ops[3].action, InputAction::RIGHT); // Right's repeats first
+  EXPECT_NEAR(ops[3].time, 0.35, 1e-9);
+  EXPECT_EQ(ops[4].action, InputAction::LEFT);
+  EXPECT_NEAR(ops[4].time, 0.36, 1e-9);
+  EXPECT_TRUE(ops[4].press);
+  ops.clear();
+  timeline.Flush(0.57, ops); // Fresh charge from 0.36
+  ASSERT_EQ(ops.size(), 1u);
+  EXPECT_NEAR(ops[0].time, 0.56, 1e-9);
+
+  timeline.Feed(Key(0.6, InputAction::LEFT, false), ops);
+  ops.clear();
+  timeline.Flush(1.0, ops);
+  EXPECT_TRUE(ops.empty());
+}
+
+TEST(InputTimelineTest, SoftDropRepeatsBesideAShift) {
+  InputTimeline timeline(0.2, 0.05, 0.02);
+  std::vector<InputOp> ops;
+  timeline.Feed(Key(0.0, InputAction::SOFT_DROP, true), ops);
+  timeline.Feed(Key(0.01, InputAction::SOFT_DROP, true), ops); // Ignored
+  timeline.Flush(0.065, ops);
+  ASSERT_EQ(ops.size(), 4u);
+  EXPECT_TRUE(ops[0].press);
+  EXPECT_NEAR(ops[3].time, 0.06, 1e-9);
+
+  ops.clear();
+  timeline.Feed(Key(0.07, InputAction::LEFT, true), ops);
+  timeline.Flush(0.275, ops);
+  // Left at 0.07 and 0.27, drops every 20 ms from 0.08, in time order
+  ASSERT_EQ(ops.size(), 12u);
+  for (size_t i = 1; i < ops.size(); i++)
+    EXPECT_LE(ops[i - 1].time, ops[i].time);
+  EXPECT_EQ(ops.front().action, InputAction::LEFT);
+  EXPECT_EQ(ops.back().action, InputAction::LEFT);
+}
+
+TEST(InputTimelineTest, StallsDoNotReplayABurst) {
+  InputTimeline timeline(0.2, 0.05);
+  std::vector<InputOp> ops;
+  timeline.Feed(Key(0.0, InputAction::RIGHT, true), ops);
+  timeline.Flush(5.0, ops); // The window was in the background
+  // The press, then only what fits the last MAX_CATCH_UP seconds
+  int repeats = (int)(InputTimeline::MAX_CATCH_UP / 0.05);
+  EXPECT_LE((int)ops.size(), 1 + repeats + 1);
+  EXPECT_GE(ops[1].time, 5.0 - InputTimeline::MAX_CATCH_UP);
+}
@@ -0,0 +1,91 @@
+#include "../input_script.h"
+#include <gtest/gtest.h>
+
+TEST(InputScriptTest, ParsesEveryAction) {
+  InputScript script;
+  std::string error;
+  ASSERT_TRUE(script.Parse("# Title screen\n"
+                           "0 text Al # ice\n"
+                           "\n"
+                           "  30 key ENTER   # To mode selection\r\n"
+                           "31 click 700 340\n"
+                           "60 down LEFT\n"
+                           "60 up F9\n"
+                           "90 press 80 600\n"
+                           "95 mouse 90 -5\n"
+                           "99 release\n",
+                           error))
+      << error;
+  const std::vector<ScriptStep> &steps = script.Steps();
+  ASSERT_EQ(steps.size(), 8u);
+  EXPECT_EQ(steps[0].action, ScriptAction::TEXT);
+  EXPECT_EQ(steps[0].text, "Al # ice"); // Text runs to the end of the line
+  EXPECT_EQ(steps[1].frame, 30);
+  EXPECT_EQ(steps[1].action, ScriptAction::KEY);
+  EXPECT_EQ(steps[1].key, 257);
+  EXPECT_EQ(steps[2].action, ScriptAction::CLICK);
+  EXPECT_EQ(steps[2].x, 700);
+  EXPECT_EQ(steps[2].y, 340);
+  EXPECT_EQ(steps[3].key, 263);
+  EXPECT_EQ(steps[4].action, ScriptAction::UP);
+  EXPECT_EQ(steps[4].key, 298);
+  EXPECT_EQ(steps[6].y, -5);
+  EXPECT_EQ(steps[7].action, ScriptAction::RELEASE);
+  EXPECT_EQ(script.Frames(), 100);
+}
+
+TEST(InputScriptTest, FormatRoundTrips) {
+  InputScript script;
+  std::string error;
+  const char *source = "0 text  a b\n" // Leading space kept
+                       "2 key A\n"
+                       "2 key 7\n"
+                       "3 down SPACE\n"
+                       "4 up BACKSPACE\n"
+                       "5 key F12\n"
+                       "6 press 1 2\n"
+                       "6 mouse 3 4\n"
+                       "7 release\n"
+                       "8 click 5 6\n";
+  ASSERT_TRUE(script.Parse(source, error)) << error;
+  EXPECT_EQ(script.Steps()[0].text, " a b");
+  EXPECT_EQ(script.Format(), source);
+}
+
+TEST(InputScriptTest, RejectsBadLines) {
+  const char *bad[] = {"0 jump",       "0 key",        "0 key KEY_A",
+                       "0 key F13",    "0 key a",      "0 click 1",
+                       "0 release 1",  "0 text",       "x key A",
+                       "5 key A\n4 key B", "-1 key A", "0 down A B"};
+  for (const char *source : bad) {
+    InputScript script;
+    std::string error;
+    EXPECT_FALSE(script.Parse(source, error)) << source;
+    EXPECT_TRUE(script.Empty());
+    EXPECT_EQ(error.compare(0, 5, "line "), 0) << error;
+  }
+  InputScript script;
+  std::string error;
+  EXPECT_FALSE(script.Parse("1 key A\n2 key Q\n3 key ?\n", error));
+  EXPECT_EQ(error, "line 3: 3 key ?");
+  EXPECT_TRUE(script.Parse("", error));
+  EXPECT_EQ(script.Frames(), 0);
+}
+
+TEST(InputScriptTest, KeyNamesAndTextSteps) {
+  for (int code : {32, 48, 57, 65, 90, 256, 257, 258, 259, 262, 263, 264,
+                   265, 290, 301}) {
+    const char *name = InputScript::KeyName(code);
+    ASSERT_NE(name, nullptr) << code;
+    EXPECT_EQ(InputScript::KeyCode(name), code) << name;
+  }
+  EXPECT_EQ(InputScript::KeyName(340), nullptr); // Left shift
+  EXPECT_EQ(InputScript::KeyCode("F0"), 0);
+
+  InputScript script;
+  EXPECT_TRUE(script.AddText(4, 'h'));
+  EXPECT_TRUE(script.AddText(4, 'i'));
+  EXPECT_TRUE(script.AddText(5, '!'));
+  EXPECT_FALSE(script.AddText(3, 'x')); // Frames never go back
+  EXPECT_EQ(script.Format(), "4 text hi\n5 text !\n");
+}
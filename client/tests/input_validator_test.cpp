@@ -0,0 +1,126 @@
+#include "../input_validator.h"
+#include <gtest/gtest.h>
+#include <random>
+
+namespace {
+std::string Digits(const Logic &logic) {
+  std::string out;
+  for (int r = 0; r < BOARD_HEIGHT; r++)
+    for (int c = 0; c < BOARD_WIDTH; c++)
+      out += std::to_string(logic.board.GetCell(r, c));
+  return out;
+}
+
+// A client playing random inputs and reporting like Game does: a hash
+// every 30 steps and the board + score after each lock
+void PlayHonestly(InputValidator &validator, int id, Logic &client,
+                  int steps) {
+  std::mt19937 rng(7);
+  for (int i = 0; i < steps && !client.isGameOver; i++) {
+    int spawns = client.spawnCounter;
+    switch (rng() % 5) {
+    case 0:
+      client.Move(-1, 0);
+      validator.Input(id, 'L');
+      break;
+    case 1:
+      client.Move(1, 0);
+      validator.Input(id, 'R');
+      break;
+    case 2:
+      client.Rotate();
+      validator.Input(id, 'U');
+      break;
+    case 3:
+      client.Move(0, 1);
+      validator.Input(id, 'D');
+      break;
+    default:
+      client.Tick();
+      validator.Input(id, 'G');
+      break;
+    }
+    if (client.spawnCounter > spawns)
+      validator.ClaimState(id, -1, client.score, Digits(client));
+    if (client.stepCounter % 30 == 0)
+      validator.ClaimHash(id, client.stepCounter,
+                          client.GetStepHash(client.stepCounter));
+  }
+}
+} // namespace
+
+TEST(InputValidatorTest, HonestClientPasses) {
+  InputValidator validator;
+  Logic client;
+  client.Reset(1234);
+  int id = validator.StartMatch(1234);
+  PlayHonestly(validator, id, client, 2000);
+  validator.WaitIdle();
+  InputValidator::Status status = validator.GetStatus(id);
+  EXPECT_FALSE(status.diverged) << status.reason;
+  EXPECT_FALSE(status.lost);
+  EXPECT_GT(status.checks, 20);
+  EXPECT_EQ(status.step, client.stepCounter);
+  EXPECT_EQ(status.score, client.score);
+}
+
+TEST(InputValidatorTest, InflatedScoreIsFlagged) {
+  InputValidator validator;
+  Logic client;
+  client.Reset(99);
+  int id = validator.StartMatch(99);
+  PlayHonestly(validator, id, client, 300);
+  validator.ClaimState(id, -1, client.score + 5000, Digits(client));
+  validator.WaitIdle();
+  InputValidator::Status status = validator.GetStatus(id);
+  EXPECT_TRUE(status.diverged);
+  EXPECT_EQ(status.divergedStep, client.stepCounter);
+  EXPECT_NE(status.reason.find("score"), std::string::npos);
+}
+
+// Hash claims from a board the inputs did not produce
+TEST(InputValidatorTest, ForgedStateHashIsFlagged) {
+  InputValidator validator;
+  Logic client;
+  client.Reset(5);
+  int id = validator.StartMatch(5);
+  for (int i = 0; i < 10; i++) {
+    client.Move(1, 0);
+    validator.Input(id, 'R');
+  }
+  client.score += 100; // Edited locally, not earned
+  client.RefreshStepHash();
+  validator.ClaimHash(id, client.stepCounter,
+                      client.GetStepHash(client.stepCounter));
+  validator.WaitIdle();
+  InputValidator::Status status = validator.GetStatus(id);
+  EXPECT_TRUE(status.diverged);
+  EXPECT_EQ(status.divergedStep, 10);
+}
+
+TEST(InputValidatorTest, GapMakesMatchUnverifiable) {
+  InputValidator validator;
+  int id = validator.StartMatch(1);
+  validator.Input(id, 'L');
+  validator.Inputs(id, 5, "LRU"); // Steps 2..4 never arrived
+  validator.ClaimHash(id, 7, 0x1234);
+  validator.WaitIdle();
+  InputValidator::Status status = validator.GetStatus(id);
+  EXPECT_TRUE(status.lost);
+  EXPECT_FALSE(status.diverged);
+  EXPECT_EQ(status.step, 1);
+}
+
+TEST(InputValidatorTest, MatchesAreIndependent) {
+  InputValidator validator;
+  int a = validator.StartMatch(10);
+  int b = validator.StartMatch(20);
+  validator.Input(a, 'G');
+  validator.ClaimState(b, -1, 1, std::string(BOARD_HEIGHT * BOARD_WIDTH, '0'));
+  validator.WaitIdle();
+  EXPECT_FALSE(validator.GetStatus(a).diverged);
+  EXPECT_EQ(validator.GetStatus(a).step, 1);
+  EXPECT_TRUE(validator.GetStatus(b).diverged);
+  validator.EndMatch(b);
+  EXPECT_FALSE(validator.GetStatus(b).diverged); // Forgotten
+}
@@ -0,0 +1,106 @@
+#include "../jitter_buffer.h"
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+// Runs 10ms frames from fromMs to toMs, recording when each item plays
+void RunFrames(JitterBuffer<int> &buffer, int64_t fromMs, int64_t toMs,
+               std::vector<int64_t> &playedAt) {
+  for (int64_t now = fromMs; now <= toMs; now += 10)
+    buffer.Release(now, [&](int &) { playedAt.push_back(now); });
+}
+} // namespace
+
+TEST(JitterBufferTest, UnstampedItemsPlayImmediately) {
+  JitterBuffer<int> buffer;
+  buffer.Push(-1, 100, 1);
+  buffer.Push(-1, 100, 2);
+  std::vector<int> played;
+  EXPECT_EQ(buffer.Release(100, [&](int &i) { played.push_back(i); }), 2);
+  EXPECT_EQ(played, (std::vector<int>{1, 2}));
+}
+
+TEST(JitterBufferTest, SteadyCadenceAddsNoDelay) {
+  JitterBuffer<int> buffer;
+  std::vector<int64_t> playedAt;
+  for (int i = 0; i < 40; i++) {
+    int64_t arrival = i * 50 + 30; // Constant 30ms transit
+    buffer.Push(i * 50, arrival, i);
+    RunFrames(buffer, arrival, arrival, playedAt);
+  }
+  EXPECT_EQ(playedAt.size(), 40u);
+  EXPECT_FLOAT_EQ(buffer.GetDelayMs(), 0.0f);
+  EXPECT_EQ(buffer.GetBaselineMs(), 30);
+}
+
+// Inputs made every 50ms arrive in clumps of three every 150ms; playback
+// restores the 50ms spacing once the buffer has seen one clump
+TEST(JitterBufferTest, SmoothsBurstyDelivery) {
+  JitterBuffer<int> buffer;
+  std::vector<int64_t> playedAt;
+  int64_t now = 0;
+  for (int burst = 0; burst < 12; burst++) {
+    int64_t arrival = burst * 150 + 100 + 20;
+    RunFrames(buffer, now, arrival - 10, playedAt);
+    for (int k = 0; k < 3; k++) {
+      int i = burst * 3 + k;
+      buffer.Push(i * 50, arrival, i);
+    }
+    now = arrival;
+  }
+  RunFrames(buffer, now, now + 500, playedAt);
+  ASSERT_EQ(playedAt.size(), 36u);
+  EXPECT_GT(buffer.GetTargetDelayMs(), 90.0f); // Decays slowly between bursts
+  EXPECT_LE(buffer.GetTargetDelayMs(), 100.0f);
+  for (size_t i = 7; i < playedAt.size(); i++)
+    EXPECT_EQ(playedAt[i] - playedAt[i - 1], 50) << "item " << i;
+}
+
+// One late spike raises the delay; afterwards playback runs slightly fast
+// until the extra latency is gone again
+TEST(JitterBufferTest, CatchesUpAfterSpike) {
+  JitterBuffer<int> buffer;
+  std::vector<int64_t> playedAt;
+  int64_t now = 0;
+  for (int i = 0; i < 200; i++) {
+    int64_t arrival = i * 50 + 20 + (i == 10 ? 200 : 0);
+    if (i == 11)
+      arrival = 10 * 50 + 20 + 200; // Held up behind the late one
+    RunFrames(buffer, now, arrival - 10, playedAt);
+    buffer.Push(i * 50, arrival, i);
+    now = arrival;
+  }
+  EXPECT_GT(buffer.GetCatchUpFrames(), 0);
+  EXPECT_LT(buffer.GetDelayMs(), 20.0f);
+}
+
+TEST(JitterBufferTest, NeverHoldsLongerThanMaxDelay) {
+  JitterBuffer<int>::Config config;
+  config.maxDelayMs = 100;
+  JitterBuffer<int> buffer(config);
+  buffer.Push(0, 10, 0);
+  buffer.Push(50, 1000, 1); // 940ms late: target would be huge
+  EXPECT_LE(buffer.GetTargetDelayMs(), 100.0f);
+  buffer.Push(100, 1000, 2);
+  std::vector<int64_t> playedAt;
+  RunFrames(buffer, 1000, 1200, playedAt);
+  ASSERT_EQ(playedAt.size(), 3u);
+  EXPECT_LE(playedAt.back(), 1100);
+}
+
+TEST(JitterBufferTest, FlushKeepsOrderAndReset) {
+  JitterBuffer<int> buffer;
+  buffer.Push(0, 10, 0);
+  buffer.Push(50, 300, 1);
+  buffer.Push(-1, 300, 2);
+  buffer.Push(100, 300, 3);
+  std::vector<int> played;
+  EXPECT_EQ(buffer.Flush([&](int &i) { played.push_back(i); }), 4);
+  EXPECT_EQ(played, (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_EQ(buffer.Size(), 0u);
+
+  buffer.Push(150, 400, 4);
+  buffer.Reset();
+  EXPECT_EQ(buffer.Size(), 0u);
+  EXPECT_FLOAT_EQ(buffer.GetTargetDelayMs(), 0.0f);
+}
@@ -0,0 +1,42 @@
+#include "../latency_histogram.h"
+#include <gtest/gtest.h>
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+  LatencyHistogram h;
+  for (int us = 0; us < 16; us++)
+    h.Record(us);
+  EXPECT_EQ(h.Count(), 16u);
+  EXPECT_EQ(h.Percentile(0.0), 0);
+  EXPECT_EQ(h.Percentile(1.0), 15);
+  EXPECT_EQ(h.Max(), 15);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValueContiguously) {
+  for (int i = 0; i + 1 < LatencyHistogram::BUCKET_COUNT; i++) {
+    EXPECT_EQ(LatencyHistogram::BucketLow(i) + LatencyHistogram::BucketWidth(i),
+              LatencyHistogram::BucketLow(i + 1));
+  }
+  for (int64_t us : {16LL, 17LL, 31LL, 32LL, 1000LL, 123456LL, 987654321LL}) {
+    int index = LatencyHistogram::Index(us);
+    EXPECT_GE(us, LatencyHistogram::BucketLow(index));
+    EXPECT_LT(us, LatencyHistogram::BucketLow(index) +
+                      LatencyHistogram::BucketWidth(index));
+  }
+}
+
+// Uniform 1..10000us: percentiles within the ~6% bucket error
+TEST(LatencyHistogramTest, PercentilesAndMerge) {
+  LatencyHistogram a, b;
+  for (int us = 1; us <= 10000; us++)
+    (us % 2 ? a : b).Record(us);
+  a.Merge(b);
+  EXPECT_EQ(a.Count(), 10000u);
+  EXPECT_NEAR((double)a.Percentile(0.50), 5000.0, 5000.0 * 0.07);
+  EXPECT_NEAR((double)a.Percentile(0.99), 9900.0, 9900.0 * 0.07);
+  EXPECT_EQ(a.Max(), 10000);
+  EXPECT_NEAR(a.Mean(), 5000.5, 0.01);
+
+  a.Clear();
+  EXPECT_EQ(a.Count(), 0u);
+  EXPECT_EQ(a.Percentile(0.5), 0);
+}
@@ -414,3 +414,32 @@ TEST_F(LogicTest, TickLocking) {
   EXPECT_TRUE(boardHasBlocks)
       << "Board should contain locked piece blocks after Tick";
 }
+
+TEST_F(LogicTest, LockEventRecordsBlocksAndClearedRows) {
+  // Rows 17 and 19 full but for column 0; a vertical I fills both
+  for (int c = 1; c < BOARD_WIDTH; c++) {
+    logic.board.SetCell(17, c, (int)PieceType::O);
+    logic.board.SetCell(19, c, (int)PieceType::O);
+  }
+  logic.currentPiece.rotation = 1; // Column x + 2, rows y..y+3
+  logic.currentPiece.x = -2;
+  logic.currentPiece.y = 16;
+  int locks = logic.lockCounter;
+  logic.LockPiece();
+
+  EXPECT_EQ(logic.lockCounter, locks + 1);
+  const Logic::LockEvent &lock = logic.lastLock;
+  EXPECT_EQ(lock.type, PieceType::I);
+  ASSERT_EQ(lock.blockCount, 4);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_EQ(lock.blockCols[i], 0);
+    EXPECT_EQ(lock.blockRows[i], 16 + i);
+  }
+  ASSERT_EQ(lock.linesCleared, 2);
+  EXPECT_EQ(lock.clearedRows[0], 19);
+  EXPECT_EQ(lock.clearedRows[1], 17); // Not 18, where it was re-checked
+
+  logic.Reset(1);
+  EXPECT_EQ(logic.lockCounter, 0);
+  EXPECT_EQ(logic.lastLock.linesCleared, 0);
+}
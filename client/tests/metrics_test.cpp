@@ -0,0 +1,164 @@
+#include "../metrics_server.h"
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// One plain HTTP/1.1 request; returns the whole response
+std::string HttpGet(int port, const std::string &path) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((uint16_t)port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return "";
+  }
+  struct timeval t = {5, 0}; // A stuck server fails the test, not hangs it
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &t, sizeof(t));
+  std::string request = "GET " + path + " HTTP/1.1\r\nHost: x\r\n\r\n";
+  send(fd, request.data(), request.size(), 0);
+  std::string response;
+  char buffer[4096];
+  ssize_t n;
+  while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0)
+    response.append(buffer, (size_t)n);
+  close(fd);
+  return response;
+}
+
+bool Contains(const std::string &text, const std::string &line) {
+  return text.find(line) != std::string::npos;
+}
+
+} // namespace
+
+TEST(MetricsTest, SumsThreadsIncludingExitedOnes) {
+  Metrics metrics;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++)
+    threads.emplace_back([&metrics] {
+      for (int i = 0; i < 1000; i++)
+        metrics.CountMessage(true, NetworkMsgType::MOVE_LR, 14);
+      metrics.Add(Metrics::DESYNCS);
+    });
+  for (std::thread &thread : threads)
+    thread.join();
+  metrics.CountMessage(false, NetworkMsgType::PING, 4);
+
+  // The first scrape folds the exited threads' shards into the retired
+  // total; the counts must not change (or double) on the next one
+  for (int scrape = 0; scrape < 2; scrape++) {
+    Metrics::Snapshot s = metrics.Collect();
+    EXPECT_EQ(s.counters[Metrics::MESSAGES_IN][(int)NetworkMsgType::MOVE_LR],
+              4000u);
+    EXPECT_EQ(s.counters[Metrics::BYTES_IN][(int)NetworkMsgType::MOVE_LR],
+              56000u);
+    EXPECT_EQ(s.counters[Metrics::MESSAGES_OUT][(int)NetworkMsgType::PING],
+              1u);
+    EXPECT_EQ(s.Total(Metrics::DESYNCS), 4u);
+  }
+}
+
+TEST(MetricsTest, RegistriesAreIndependent) {
+  Metrics a, b;
+  a.Add(Metrics::DROPPED_FRAMES, 3);
+  b.Add(Metrics::DROPPED_FRAMES);
+  EXPECT_EQ(a.Collect().Total(Metrics::DROPPED_FRAMES), 3u);
+  EXPECT_EQ(b.Collect().Total(Metrics::DROPPED_FRAMES), 1u);
+}
+
+TEST(MetricsTest, RendersPrometheusText) {
+  Metrics metrics;
+  metrics.CountMessage(true, NetworkMsgType::STATE_HASH, 40);
+  metrics.Observe(Metrics::RTT, 80);      // <= 100us
+  metrics.Observe(Metrics::RTT, 3000);    // <= 5ms
+  metrics.Observe(Metrics::RTT, 5000000); // Beyond the last bound
+  metrics.Set(Metrics::SESSIONS_ACTIVE, 2);
+  metrics.Set(Metrics::JITTER_QUEUE, 7);
+  metrics.CountAllocation();
+  std::string text = metrics.Render();
+
+  EXPECT_TRUE(Contains(text, "# TYPE tetris_messages_total counter\n"));
+  EXPECT_TRUE(Contains(
+      text, "tetris_messages_total{direction=\"in\",type=\"STATE_HASH\"} 1\n"));
+  EXPECT_TRUE(Contains(text, "tetris_message_bytes_total{direction=\"in\","
+                             "type=\"STATE_HASH\"} 40\n"));
+  EXPECT_TRUE(Contains(text, "tetris_sessions_active 2\n"));
+  EXPECT_TRUE(Contains(text, "tetris_queue_depth{queue=\"jitter\"} 7\n"));
+  EXPECT_TRUE(Contains(text, "tetris_allocations_total 1\n"));
+
+  // Buckets are cumulative and end with +Inf == count
+  EXPECT_TRUE(Contains(text, "# TYPE tetris_rtt_seconds histogram\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_bucket{le=\"0.0001\"} 1\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_bucket{le=\"0.0025\"} 1\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_bucket{le=\"0.005\"} 2\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_bucket{le=\"1\"} 2\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_bucket{le=\"+Inf\"} 3\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_sum 5.003080\n"));
+  EXPECT_TRUE(Contains(text, "tetris_rtt_seconds_count 3\n"));
+
+  // Every sample line is "name[{labels}] value"
+  size_t start = 0;
+  while (start < text.size()) {
+    size_t end = text.find('\n', start);
+    ASSERT_NE(end, std::string::npos);
+    std::string line = text.substr(start, end - start);
+    start = end + 1;
+    if (line[0] == '#')
+      continue;
+    EXPECT_EQ(line.compare(0, 7, "tetris_"), 0) << line;
+    size_t space = line.rfind(' ');
+    ASSERT_NE(space, std::string::npos) << line;
+    EXPECT_NE(line.find_first_of("0123456789", space), std::string::npos);
+  }
+}
+
+TEST(MetricsTest, ServesScrapesOnLoopback) {
+  Metrics metrics;
+  metrics.Add(Metrics::DESYNCS, 5);
+  MetricsServer server(metrics);
+  ASSERT_TRUE(server.Start(0)); // Any free port
+  ASSERT_GT(server.GetPort(), 0);
+
+  std::string response = HttpGet(server.GetPort(), "/metrics");
+  EXPECT_EQ(response.compare(0, 15, "HTTP/1.1 200 OK"), 0) << response;
+  EXPECT_TRUE(Contains(response, "text/plain; version=0.0.4"));
+  EXPECT_TRUE(Contains(response, "\r\n\r\n# HELP"));
+  EXPECT_TRUE(Contains(response, "tetris_desyncs_total 5\n"));
+
+  metrics.Add(Metrics::DESYNCS); // Every scrape sees current values
+  EXPECT_TRUE(Contains(HttpGet(server.GetPort(), "/metrics"),
+                       "tetris_desyncs_total 6\n"));
+  EXPECT_EQ(HttpGet(server.GetPort(), "/").compare(0, 12, "HTTP/1.1 404"),
+            0);
+
+  int port = server.GetPort();
+  server.Stop();
+  EXPECT_EQ(HttpGet(port, "/metrics"), "");
+}
+
+TEST(MetricsTest, SilentConnectionTimesOut) {
+  Metrics metrics;
+  MetricsServer server(metrics);
+  ASSERT_TRUE(server.Start(0));
+  int silent = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons((uint16_t)server.GetPort());
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  ASSERT_EQ(connect(silent, (struct sockaddr *)&addr, sizeof(addr)), 0);
+
+  // Served once the silent connection's request timeout runs out
+  std::string response = HttpGet(server.GetPort(), "/metrics");
+  EXPECT_EQ(response.compare(0, 15, "HTTP/1.1 200 OK"), 0) << response;
+  close(silent);
+  server.Stop();
+}
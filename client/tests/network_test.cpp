@@ -31,3 +31,53 @@ TEST(NetworkProtocolTest, SerializeGameStart) {
   std::string msg = NetworkProtocol::SerializeGameStart(999, "Player");
   EXPECT_EQ(msg, "GAME_START_HOST;SEED:999;P1_NAME:Player");
 }
+
+TEST(NetworkProtocolTest, InputStamp) {
+  std::string msg = NetworkProtocol::WithStamp("MOVE_LR;DIR:-1", 123456);
+  EXPECT_EQ(msg, "MOVE_LR;DIR:-1;T:123456");
+  NetworkMessage out = NetworkProtocol::Parse(msg);
+  EXPECT_EQ(out.type, NetworkMsgType::MOVE_LR);
+  EXPECT_EQ(out.intParam1, -1);
+  EXPECT_EQ(out.stampMs, 123456);
+
+  // Older peers send no stamp
+  EXPECT_EQ(NetworkProtocol::Parse("ROTATE").stampMs, -1);
+  // A stamp that is not a number is not a message
+  EXPECT_EQ(NetworkProtocol::Parse("ROTATE;T:x").type,
+            NetworkMsgType::UNKNOWN);
+  EXPECT_EQ(NetworkProtocol::Parse("MOVE_LR;DIR:1;T:").type,
+            NetworkMsgType::UNKNOWN);
+  EXPECT_EQ(NetworkProtocol::Parse("PING;T:x").type, NetworkMsgType::UNKNOWN);
+}
+
+TEST(NetworkProtocolTest, SoftDropIsNotAGravityTick) {
+  NetworkMessage soft =
+      NetworkProtocol::Parse(NetworkProtocol::WithStamp(
+          NetworkProtocol::SerializeSoftDrop(), 42));
+  EXPECT_EQ(soft.type, NetworkMsgType::MOVE_DOWN);
+  EXPECT_EQ(soft.intParam1, 1);
+  EXPECT_EQ(soft.stampMs, 42);
+  EXPECT_EQ(NetworkProtocol::Parse("MOVE_DOWN").intParam1, 0);
+}
+
+TEST(NetworkProtocolTest, PingStampIsEchoed) {
+  NetworkMessage ping =
+      NetworkProtocol::Parse(NetworkProtocol::SerializePing(987654321));
+  EXPECT_EQ(ping.type, NetworkMsgType::PING);
+  EXPECT_EQ(ping.intParam1, 0);
+  EXPECT_EQ(ping.stampMs, 987654321);
+
+  NetworkMessage echo =
+      NetworkProtocol::Parse(NetworkProtocol::SerializePingEcho(ping.stampMs));
+  EXPECT_EQ(echo.type, NetworkMsgType::PING);
+  EXPECT_EQ(echo.intParam1, 1);
+  EXPECT_EQ(echo.stampMs, 987654321);
+
+  EXPECT_EQ(NetworkProtocol::Parse("PING;ECHO:abc").type,
+            NetworkMsgType::UNKNOWN);
+
+  // Older peers send a bare PING, which must not be answered
+  NetworkMessage bare = NetworkProtocol::Parse("PING");
+  EXPECT_EQ(bare.type, NetworkMsgType::PING);
+  EXPECT_EQ(bare.stampMs, -1);
+}
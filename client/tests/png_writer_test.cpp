@@ -0,0 +1,185 @@
+#include "../png_writer.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+uint32_t Get32(const std::string &s, size_t at) {
+  return (uint32_t)(uint8_t)s[at] << 24 | (uint32_t)(uint8_t)s[at + 1] << 16 |
+         (uint32_t)(uint8_t)s[at + 2] << 8 | (uint8_t)s[at + 3];
+}
+
+// Just enough inflate for what PngWriter writes: fixed-Huffman blocks
+class Inflater {
+public:
+  explicit Inflater(const std::string &data) : in(data) {}
+
+  bool Run(std::vector<uint8_t> &out) {
+    for (;;) {
+      int final = Bits(1);
+      if (Bits(2) != 1)
+        return false;
+      for (;;) {
+        int symbol = Symbol();
+        if (symbol < 0)
+          return false;
+        if (symbol < 256) {
+          out.push_back((uint8_t)symbol);
+          continue;
+        }
+        if (symbol == 256)
+          break;
+        static const int LENGTH_BASE[29] = {
+            3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+            31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        int l = symbol - 257;
+        int extra = l < 8 || l == 28 ? 0 : (l - 4) / 4;
+        int length = LENGTH_BASE[l] + Bits(extra);
+        int code = 0;
+        for (int i = 0; i < 5; i++)
+          code = code << 1 | Bits(1);
+        int distance = 1;
+        if (code < 4) {
+          distance += code;
+        } else {
+          int dExtra = code / 2 - 1;
+          distance += ((2 | (code & 1)) << dExtra) + Bits(dExtra);
+        }
+        if (distance > (int)out.size())
+          return false;
+        for (int i = 0; i < length; i++)
+          out.push_back(out[out.size() - distance]);
+      }
+      if (final)
+        return true;
+    }
+  }
+
+private:
+  int Bits(int count) {
+    int value = 0;
+    for (int i = 0; i < count; i++, bit++) {
+      uint8_t byte = (uint8_t)in[bit / 8];
+      value |= (byte >> (bit % 8) & 1) << i;
+    }
+    return value;
+  }
+
+  int Symbol() {
+    int code = 0;
+    for (int length = 1; length <= 9; length++) {
+      code = code << 1 | Bits(1);
+      if (length == 7 && code <= 23)
+        return 256 + code;
+      if (length == 8 && code >= 0x30 && code <= 0xbf)
+        return code - 0x30;
+      if (length == 8 && code >= 0xc0 && code <= 0xc7)
+        return 280 + code - 0xc0;
+      if (length == 9 && code >= 0x190)
+        return 144 + code - 0x190;
+    }
+    return -1;
+  }
+
+  const std::string &in;
+  size_t bit = 0;
+};
+
+// The filtered scanlines inside a PNG written by PngWriter
+bool Decode(const std::string &png, int &width, int &height,
+            std::vector<uint8_t> &rgba) {
+  size_t at = 8;
+  std::string idat;
+  while (at + 12 <= png.size()) {
+    uint32_t size = Get32(png, at);
+    std::string type = png.substr(at + 4, 4);
+    std::string body = png.substr(at + 8, size);
+    uint32_t crc = PngWriter::Crc32((const uint8_t *)type.data(), 4);
+    crc = PngWriter::Crc32((const uint8_t *)body.data(), size, crc);
+    if (crc != Get32(png, at + 8 + size))
+      return false;
+    if (type == "IHDR") {
+      width = (int)Get32(body, 0);
+      height = (int)Get32(body, 4);
+    } else if (type == "IDAT") {
+      idat += body;
+    }
+    at += 12 + size;
+  }
+  std::vector<uint8_t> raw;
+  if (!Inflater(idat.substr(2)).Run(raw))
+    return false;
+  size_t stride = (size_t)width * 4;
+  if (raw.size() != (stride + 1) * height ||
+      PngWriter::Adler32(raw.data(), raw.size()) !=
+          Get32(idat, idat.size() - 4))
+    return false;
+  rgba.assign(stride * height, 0);
+  for (int y = 0; y < height; y++) {
+    const uint8_t *line = &raw[(stride + 1) * y];
+    if (line[0] != 2)
+      return false;
+    for (size_t i = 0; i < stride; i++)
+      rgba[stride * y + i] =
+          (uint8_t)(line[1 + i] + (y ? rgba[stride * (y - 1) + i] : 0));
+  }
+  return true;
+}
+
+} // namespace
+
+TEST(PngWriterTest, ChecksumsMatchReferenceValues) {
+  const uint8_t *digits = (const uint8_t *)"123456789";
+  EXPECT_EQ(PngWriter::Crc32(digits, 9), 0xCBF43926u);
+  EXPECT_EQ(PngWriter::Adler32((const uint8_t *)"Wikipedia", 9),
+            0x11E60398u);
+  std::vector<uint8_t> bytes(100000, 0xff); // Several Adler32 rounds
+  uint32_t a = 1, b = 0;
+  for (uint8_t byte : bytes) {
+    a = (a + byte) % 65521;
+    b = (b + a) % 65521;
+  }
+  EXPECT_EQ(PngWriter::Adler32(bytes.data(), bytes.size()), b << 16 | a);
+}
+
+TEST(PngWriterTest, HeaderAndChunks) {
+  uint8_t pixels[2 * 3 * 4] = {};
+  PngWriter writer;
+  std::string png = "prefix";
+  ASSERT_TRUE(writer.Encode(pixels, 2, 3, png));
+  png = png.substr(6); // Appended, not replaced
+  EXPECT_EQ(png.substr(0, 8), std::string("\x89PNG\r\n\x1a\n", 8));
+  EXPECT_EQ(Get32(png, 8), 13u);
+  EXPECT_EQ(png.substr(12, 4), "IHDR");
+  EXPECT_EQ(Get32(png, 16), 2u);
+  EXPECT_EQ(Get32(png, 20), 3u);
+  EXPECT_EQ(png[24], 8); // Bits per channel
+  EXPECT_EQ(png[25], 6); // RGBA
+  EXPECT_EQ(png.substr(png.size() - 12),
+            std::string("\0\0\0\0IEND\xae\x42\x60\x82", 12));
+  EXPECT_FALSE(writer.Encode(pixels, 0, 3, png));
+}
+
+TEST(PngWriterTest, RoundTripsNoiseAndFlatImages) {
+  const int w = 37, h = 29;
+  std::vector<uint8_t> noise(w * h * 4), flat(w * h * 4);
+  uint32_t x = 12345;
+  for (size_t i = 0; i < noise.size(); i++) {
+    x ^= x << 13, x ^= x >> 17, x ^= x << 5;
+    noise[i] = (uint8_t)x;
+    flat[i] = (uint8_t)(i % 4 == 3 ? 255 : (i / 4 % w < 20 ? 40 : 200));
+  }
+  PngWriter writer; // Reused: nothing carries over between images
+  for (const std::vector<uint8_t> *image : {&noise, &flat, &noise}) {
+    std::string png;
+    ASSERT_TRUE(writer.Encode(image->data(), w, h, png));
+    int dw = 0, dh = 0;
+    std::vector<uint8_t> decoded;
+    ASSERT_TRUE(Decode(png, dw, dh, decoded));
+    EXPECT_EQ(dw, w);
+    EXPECT_EQ(dh, h);
+    EXPECT_EQ(decoded, *image);
+    if (image == &flat) {
+      EXPECT_LT(png.size(), flat.size() / 20);
+    }
+  }
+}
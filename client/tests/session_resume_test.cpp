@@ -0,0 +1,142 @@
+#include "../logic.h"
+#include "../network_protocol.h"
+#include "../session_resume.h"
+#include <gtest/gtest.h>
+
+namespace {
+// Deterministic mix of every action type
+void PlayActions(Logic &logic, int count) {
+  for (int i = 0; i < count; i++) {
+    switch (i % 5) {
+    case 0:
+      logic.Move(-1, 0);
+      break;
+    case 1:
+      logic.Rotate();
+      break;
+    case 2:
+      logic.Move(1, 0);
+      break;
+    case 3:
+      logic.Move(0, 1);
+      break;
+    default:
+      logic.Tick();
+    }
+  }
+}
+} // namespace
+
+// The mirror stopped at step 40 when the link dropped; the peer kept
+// playing. Replaying the missed inputs must land on the same state.
+TEST(SessionResumeTest, CatchUpInputsRestoreMirror) {
+  Logic local;
+  Logic mirror;
+  local.Reset(777);
+  mirror.Reset(777);
+  PlayActions(local, 40);
+  PlayActions(mirror, 40);
+  PlayActions(local, 120); // Played during the gap
+
+  std::string inputs;
+  ASSERT_TRUE(SessionResume::CollectInputs(local, mirror.stepCounter, inputs));
+  EXPECT_EQ(inputs.size(), 120u);
+  EXPECT_EQ(SessionResume::ApplyInputs(mirror, 41, inputs), 120);
+  EXPECT_EQ(mirror.stepCounter, local.stepCounter);
+  EXPECT_EQ(mirror.StateHash(), local.StateHash());
+}
+
+TEST(SessionResumeTest, ApplySkipsKnownStepsAndRejectsGaps) {
+  Logic local;
+  Logic mirror;
+  local.Reset(5);
+  mirror.Reset(5);
+  PlayActions(local, 30);
+  PlayActions(mirror, 20);
+
+  std::string inputs;
+  ASSERT_TRUE(SessionResume::CollectInputs(local, 10, inputs));
+  // Steps 11..20 are already applied; only 21..30 are new
+  EXPECT_EQ(SessionResume::ApplyInputs(mirror, 11, inputs), 10);
+  EXPECT_EQ(mirror.StateHash(), local.StateHash());
+
+  Logic behind;
+  behind.Reset(5);
+  EXPECT_EQ(SessionResume::ApplyInputs(behind, 11, inputs), -1);
+}
+
+TEST(SessionResumeTest, LongGapNeedsSnapshot) {
+  Logic local;
+  local.Reset(9);
+  PlayActions(local, Logic::STEP_HISTORY + 50);
+  std::string inputs;
+  EXPECT_FALSE(SessionResume::CollectInputs(local, 10, inputs));
+  EXPECT_FALSE(SessionResume::CollectInputs(local, local.stepCounter + 1,
+                                            inputs));
+  EXPECT_TRUE(SessionResume::CollectInputs(local, local.stepCounter, inputs));
+  EXPECT_TRUE(inputs.empty());
+}
+
+TEST(SessionResumeTest, GraceWindow) {
+  SessionResume session(2.0f);
+  EXPECT_FALSE(session.HasSession());
+  uint64_t token = SessionResume::NewToken();
+  session.Begin(token);
+  EXPECT_TRUE(session.Matches(token));
+  EXPECT_FALSE(session.Matches(token ^ 1));
+
+  session.OnDisconnected();
+  EXPECT_TRUE(session.Update(0.5f));
+  session.OnResumed();
+  EXPECT_EQ(session.GetResumeCount(), 1);
+  EXPECT_FLOAT_EQ(session.GetLastResumeSeconds(), 0.5f);
+
+  session.OnDisconnected();
+  EXPECT_TRUE(session.Update(1.5f));
+  EXPECT_FALSE(session.Update(0.6f));
+
+  session.End();
+  EXPECT_FALSE(session.Matches(token));
+}
+
+TEST(SessionResumeTest, ProtocolRoundTrip) {
+  uint64_t token = 0x0123456789abcdefULL;
+  NetworkMessage start = NetworkProtocol::Parse(
+      NetworkProtocol::SerializeGameStart(99, token, "Host"));
+  EXPECT_EQ(start.type, NetworkMsgType::GAME_START);
+  EXPECT_EQ(start.intParam1, 99);
+  EXPECT_EQ(start.hashParam, token);
+  EXPECT_EQ(start.payload.substr(start.payload.find("P1_NAME:") + 8), "Host");
+
+  NetworkMessage resume =
+      NetworkProtocol::Parse(NetworkProtocol::SerializeResume(token, 321));
+  EXPECT_EQ(resume.type, NetworkMsgType::RESUME);
+  EXPECT_EQ(resume.hashParam, token);
+  EXPECT_EQ(resume.intParam1, 321);
+
+  NetworkMessage ok =
+      NetworkProtocol::Parse(NetworkProtocol::SerializeResumeOk(12));
+  EXPECT_EQ(ok.type, NetworkMsgType::RESUME_OK);
+  EXPECT_EQ(ok.intParam1, 12);
+
+  NetworkMessage inputs =
+      NetworkProtocol::Parse(NetworkProtocol::SerializeInputs(41, "LURDG"));
+  EXPECT_EQ(inputs.type, NetworkMsgType::INPUTS);
+  EXPECT_EQ(inputs.intParam1, 41);
+  EXPECT_EQ(inputs.strParam1, "LURDG");
+
+  EXPECT_EQ(NetworkProtocol::Parse("RESUME_REJECT").type,
+            NetworkMsgType::RESUME_REJECT);
+  EXPECT_EQ(NetworkProtocol::Parse("PING").type, NetworkMsgType::PING);
+}
+
+TEST(SessionResumeTest, MalformedSessionIsUnknown) {
+  EXPECT_EQ(NetworkProtocol::Parse("RESUME;SESSION:xyz;STEP:3").type,
+            NetworkMsgType::UNKNOWN);
+  EXPECT_EQ(NetworkProtocol::Parse("RESUME;SESSION:-1;STEP:3").type,
+            NetworkMsgType::UNKNOWN);
+  EXPECT_EQ(NetworkProtocol::Parse("RESUME;SESSION:1ffffffffffffffff").type,
+            NetworkMsgType::UNKNOWN);
+  EXPECT_EQ(NetworkProtocol::Parse("RESUME;SESSION:;STEP:3").type,
+            NetworkMsgType::UNKNOWN);
+}
@@ -0,0 +1,137 @@
+#include "../thumbnail_batch.h"
+#include <gtest/gtest.h>
+
+TEST(SoftRasterTest, SpansOfEveryLengthStayInPlace) {
+  const uint32_t fence = 0xdeadbeef, pixel = SoftRaster::Pack(0x11223344);
+  for (int offset = 0; offset < 4; offset++) {
+    for (int count = 0; count <= 40; count++) {
+      std::vector<uint32_t> buffer(48, fence);
+      SoftRaster::FillSpan(buffer.data() + offset, count, pixel);
+      for (int i = 0; i < 48; i++) {
+        bool inside = i >= offset && i < offset + count;
+        ASSERT_EQ(buffer[i], inside ? pixel : fence) << offset << " " << count;
+      }
+    }
+  }
+  uint8_t bytes[4];
+  memcpy(bytes, &pixel, 4);
+  EXPECT_EQ(bytes[0], 0x11); // R first in memory
+  EXPECT_EQ(bytes[3], 0x44);
+  EXPECT_EQ(SoftRaster::Unpack(pixel), 0x11223344u);
+}
+
+TEST(SoftRasterTest, RectanglesAreClipped) {
+  SoftRaster raster;
+  raster.Resize(8, 6);
+  raster.Clear(1);
+  raster.FillRect(-3, 4, 5, 10, 2); // Off the left and bottom edges
+  raster.StrokeRect(5, 0, 3, 3, 3);
+  EXPECT_EQ(raster.At(0, 4), 2u);
+  EXPECT_EQ(raster.At(1, 5), 2u);
+  EXPECT_EQ(raster.At(2, 4), 1u);
+  EXPECT_EQ(raster.At(0, 3), 1u);
+  EXPECT_EQ(raster.At(5, 0), 3u);
+  EXPECT_EQ(raster.At(7, 2), 3u);
+  EXPECT_EQ(raster.At(6, 1), 1u); // Outline only
+  raster.FillRect(100, 100, 5, 5, 4);
+  raster.FillRect(2, 2, 0, 3, 4);
+}
+
+TEST(SoftRasterTest, BoardLooksLikeTheRendererFallback) {
+  SoftPalette palette = SoftPalette::Classic();
+  EXPECT_EQ(SoftRaster::Unpack(palette.cells[(int)PieceType::I]),
+            0x66bfffffu);
+  EXPECT_EQ(SoftRaster::Unpack(palette.grid), 0x5c5c5cffu);
+
+  Logic logic;
+  logic.Reset(1);
+  logic.board.SetCell(19, 0, (int)PieceType::Z);
+  logic.board.SetCell(19, 1, 42); // Garbage from a peer
+  SoftRaster raster;
+  const int cell = 8;
+  raster.RenderLogic(logic, cell, true, palette);
+  ASSERT_EQ(raster.Width(), 80);
+  ASSERT_EQ(raster.Height(), 160);
+  int y = 19 * cell;
+  EXPECT_EQ(raster.At(0, y + 3), palette.border);
+  EXPECT_EQ(raster.At(cell - 1, y + 3), palette.background); // Inset
+  EXPECT_EQ(raster.At(3, y + 3), palette.cells[(int)PieceType::Z]);
+  EXPECT_EQ(raster.At(cell + 3, y + 3), palette.cells[BoardCells::OTHER]);
+  EXPECT_EQ(raster.At(2 * cell, y + 3), palette.grid);
+  EXPECT_EQ(raster.At(2 * cell + 3, y + 3), palette.background);
+
+  // The active piece and its ghost, as BoardCells lays them out
+  uint8_t codes[BoardCells::CELL_COUNT];
+  BoardCells::Build(logic, true, codes);
+  bool ghost = false;
+  for (int i = 0; i < BoardCells::CELL_COUNT; i++) {
+    if (codes[i] / BoardCells::LAYER_STRIDE != BoardCells::GHOST)
+      continue;
+    int slot = codes[i] % BoardCells::LAYER_STRIDE;
+    int x = i % BOARD_WIDTH * cell + 3, y = i / BOARD_WIDTH * cell + 3;
+    EXPECT_EQ(raster.At(x, y), palette.ghosts[slot]);
+    ghost = true;
+  }
+  EXPECT_TRUE(ghost);
+
+  raster.RenderBoard(logic.board, 3, palette); // No inset, no grid
+  EXPECT_EQ(raster.At(1, 19 * 3 + 1), palette.cells[(int)PieceType::Z]);
+  EXPECT_EQ(raster.At(9, 3), palette.background);
+}
+
+TEST(SoftRasterTest, ReplayFramesEndOnTheFinalBoard) {
+  std::string inputs;
+  for (int i = 0; i < 60; i++)
+    inputs += "LUGRG"[i % 5];
+  Logic final;
+  final.Reset(7);
+  ASSERT_EQ(SessionResume::ApplyInputs(final, 1, inputs), 60);
+
+  SoftPalette palette = SoftPalette::Classic();
+  SoftRaster raster, expected;
+  ASSERT_TRUE(raster.RenderReplay(7, inputs, 3, 4, palette));
+  expected.RenderLogic(final, 4, false, palette);
+  int w = SoftRaster::BoardWidth(4);
+  ASSERT_EQ(raster.Width(), 3 * w + 2 * SoftRaster::STRIP_GAP);
+  int last = 2 * (w + SoftRaster::STRIP_GAP);
+  for (int y = 0; y < raster.Height(); y++)
+    for (int x = 0; x < w; x++)
+      ASSERT_EQ(raster.At(last + x, y), expected.At(x, y));
+  EXPECT_EQ(raster.At(w, 0), 0u); // Gap
+
+  EXPECT_FALSE(raster.RenderReplay(7, "LLX", 2, 4, palette));
+}
+
+TEST(ThumbnailBatchTest, EveryItemIsRenderedOnce) {
+  std::vector<Logic> games(100);
+  for (int i = 0; i < (int)games.size(); i++) {
+    games[i].Reset(i + 1);
+    for (int t = 0; t < i; t++)
+      games[i].Tick();
+  }
+  SoftPalette palette = SoftPalette::Classic();
+  ThumbnailBatch batch(4);
+  std::vector<std::string> pngs;
+  int rendered = batch.Render(
+      (int)games.size(),
+      [&](int i, SoftRaster &raster) {
+        if (i == 13)
+          return false; // Left empty
+        raster.RenderLogic(games[i], 5, false, palette);
+        return true;
+      },
+      pngs);
+  EXPECT_EQ(rendered, 99);
+  ASSERT_EQ(pngs.size(), games.size());
+  EXPECT_TRUE(pngs[13].empty());
+
+  // Same bytes as a single-threaded render
+  SoftRaster raster;
+  PngWriter writer;
+  for (int i : {0, 50, 99}) {
+    std::string png;
+    raster.RenderLogic(games[i], 5, false, palette);
+    writer.Encode(raster.Data(), raster.Width(), raster.Height(), png);
+    EXPECT_EQ(pngs[i], png);
+  }
+}
@@ -0,0 +1,160 @@
+#include "../loopback_transport.h"
+#include "../shm_transport.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+std::atomic<bool> running(true);
+
+// Shared memory names are machine-wide: keep parallel test runs apart
+int UniquePort(int offset) { return 20000 + (int)(getpid() % 20000) + offset; }
+
+std::string RecvExactly(TransportStream &stream, size_t len) {
+  std::string out;
+  char buf[4096];
+  while (out.size() < len) {
+    int n = stream.Recv(buf, std::min(sizeof(buf), len - out.size()));
+    if (n <= 0)
+      break;
+    out.append(buf, (size_t)n);
+  }
+  return out;
+}
+
+// Connect + accept, then bytes both ways, Peek, and an orderly close
+void CheckRoundTrip(Transport &transport, int port) {
+  const char *error = "";
+  std::unique_ptr<TransportListener> listener = transport.Listen(port, error);
+  ASSERT_TRUE(listener) << error;
+  std::unique_ptr<TransportStream> client =
+      transport.Connect("127.0.0.1", port, 1000, running, error);
+  ASSERT_TRUE(client) << error;
+  std::unique_ptr<TransportStream> host = listener->Accept();
+  ASSERT_TRUE(host);
+
+  EXPECT_EQ(client->Send("GAME_START\n", 11), 11);
+  char peek[4];
+  EXPECT_EQ(host->Peek(peek, sizeof(peek), 100), 4);
+  EXPECT_EQ(std::string(peek, 4), "GAME");
+  EXPECT_EQ(RecvExactly(*host, 11), "GAME_START\n");
+
+  EXPECT_EQ(host->Send("PING\n", 5), 5);
+  EXPECT_EQ(RecvExactly(*client, 5), "PING\n");
+
+  // Nothing queued: Peek times out instead of blocking
+  EXPECT_EQ(client->Peek(peek, sizeof(peek), 10), 0);
+
+  // Bytes sent before the close still arrive, then Recv reports 0
+  host->Send("BYE\n", 4);
+  host->Shutdown();
+  EXPECT_EQ(RecvExactly(*client, 4), "BYE\n");
+  char buf[8];
+  EXPECT_EQ(client->Recv(buf, sizeof(buf)), 0);
+  EXPECT_EQ(client->Send("x", 1), -1);
+}
+
+// More than the ring capacity through a concurrent reader
+void CheckBulkTransfer(Transport &transport, int port) {
+  const char *error = "";
+  std::unique_ptr<TransportListener> listener = transport.Listen(port, error);
+  ASSERT_TRUE(listener) << error;
+  std::unique_ptr<TransportStream> client =
+      transport.Connect("", port, 1000, running, error);
+  std::unique_ptr<TransportStream> host = listener->Accept();
+  ASSERT_TRUE(client && host);
+
+  std::string payload(3 * 1024 * 1024, '\0');
+  for (size_t i = 0; i < payload.size(); i++)
+    payload[i] = (char)(i * 131 + (i >> 12));
+  std::thread writer([&]() {
+    EXPECT_EQ(client->Send(payload.data(), payload.size()),
+              (int)payload.size());
+  });
+  std::string received = RecvExactly(*host, payload.size());
+  writer.join();
+  EXPECT_TRUE(received == payload);
+}
+} // namespace
+
+TEST(TransportTest, LoopbackRoundTrip) {
+  LoopbackTransport transport;
+  CheckRoundTrip(transport, 1);
+}
+
+TEST(TransportTest, LoopbackBulkTransfer) {
+  LoopbackTransport transport;
+  CheckBulkTransfer(transport, 2);
+}
+
+TEST(TransportTest, LoopbackRefusedAndPortInUse) {
+  LoopbackTransport transport;
+  const char *error = "";
+  EXPECT_FALSE(transport.Connect("", 3, 100, running, error));
+  EXPECT_STREQ(error, "Connection refused");
+
+  std::unique_ptr<TransportListener> listener = transport.Listen(3, error);
+  ASSERT_TRUE(listener);
+  EXPECT_FALSE(transport.Listen(3, error));
+  EXPECT_STREQ(error, "Port already in use");
+
+  listener.reset(); // Closing frees the port
+  EXPECT_TRUE(transport.Listen(3, error));
+}
+
+// Stop() relies on this to join the network thread
+TEST(TransportTest, CloseAndShutdownWakeBlockedThreads) {
+  LoopbackTransport transport;
+  const char *error = "";
+  std::unique_ptr<TransportListener> listener = transport.Listen(4, error);
+  std::thread acceptor([&]() { EXPECT_FALSE(listener->Accept()); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  listener->Close();
+  acceptor.join();
+
+  listener = transport.Listen(5, error);
+  std::unique_ptr<TransportStream> client =
+      transport.Connect("", 5, 100, running, error);
+  std::unique_ptr<TransportStream> host = listener->Accept();
+  ASSERT_TRUE(client && host);
+  std::thread reader([&]() {
+    char buf[8];
+    EXPECT_EQ(host->Recv(buf, sizeof(buf)), -1);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  host->Shutdown();
+  reader.join();
+}
+
+TEST(TransportTest, SharedMemoryRoundTrip) {
+  ShmTransport transport;
+  CheckRoundTrip(transport, UniquePort(0));
+}
+
+TEST(TransportTest, SharedMemoryBulkTransfer) {
+  ShmTransport transport;
+  CheckBulkTransfer(transport, UniquePort(1));
+}
+
+// One segment carries one connection; accepting frees the name again
+TEST(TransportTest, SharedMemoryOneClientPerListen) {
+  ShmTransport transport;
+  int port = UniquePort(2);
+  const char *error = "";
+  EXPECT_FALSE(transport.Connect("", port, 100, running, error));
+  EXPECT_STREQ(error, "Connection refused");
+
+  std::unique_ptr<TransportListener> listener = transport.Listen(port, error);
+  ASSERT_TRUE(listener) << error;
+  EXPECT_FALSE(transport.Listen(port, error)); // We are alive and listening
+  std::unique_ptr<TransportStream> first =
+      transport.Connect("", port, 100, running, error);
+  ASSERT_TRUE(first);
+  EXPECT_FALSE(transport.Connect("", port, 100, running, error));
+  std::unique_ptr<TransportStream> host = listener->Accept();
+  ASSERT_TRUE(host);
+
+  std::unique_ptr<TransportListener> next = transport.Listen(port, error);
+  EXPECT_TRUE(next) << error;
+}
@@ -0,0 +1,156 @@
+#include "../wire_gen.h"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+std::string Hex(const std::string &bytes) {
+  static const char digits[] = "0123456789abcdef";
+  std::string out;
+  for (unsigned char c : bytes) {
+    out += digits[c >> 4];
+    out += digits[c & 15];
+  }
+  return out;
+}
+
+std::string FromHex(const std::string &hex) {
+  std::string out;
+  for (size_t i = 0; i + 1 < hex.size(); i += 2)
+    out += (char)std::stoi(hex.substr(i, 2), nullptr, 16);
+  return out;
+}
+
+Wire::JoinGame GoldenJoinGame() {
+  Wire::JoinGame join;
+  join.name = "Ann";
+  join.settings.emplace();
+  join.settings->attackMode = "lines";
+  join.settings->showGhostPiece = true;
+  join.settings->allowHoldPiece = false;
+  return join;
+}
+
+Wire::SyncState GoldenSyncState() {
+  Wire::SyncState sync;
+  sync.score = 1200;
+  sync.nextType = 3;
+  sync.board = std::string("\x00\x01\x02", 3);
+  sync.step = 77;
+  sync.current = Wire::PieceState{2, -1, 5, 3};
+  return sync;
+}
+
+} // namespace
+
+// The same frames are checked by wire/wire_test.go and
+// client-nuxt/app/services/wire.test.ts
+const char *const GOLDEN_JOIN_GAME =
+    "010a03416e6e120b0a056c696e657310012800";
+const char *const GOLDEN_SYNC_STATE =
+    "2408e01210061a03000102209a012a0808041001180a2006";
+const char *const GOLDEN_STATE_HASH = "2508d8041090e4d0b287d3aeeefe01";
+
+TEST(WireTest, GoldenFramesMatchTheOtherLanguages) {
+  EXPECT_EQ(Hex(Wire::Encode(GoldenJoinGame())), GOLDEN_JOIN_GAME);
+  EXPECT_EQ(Hex(Wire::Encode(GoldenSyncState())), GOLDEN_SYNC_STATE);
+  Wire::StateHash hash;
+  hash.step = 300;
+  hash.hash = 0xfedcba9876543210ull;
+  EXPECT_EQ(Hex(Wire::Encode(hash)), GOLDEN_STATE_HASH);
+
+  Wire::SyncState sync;
+  ASSERT_TRUE(Wire::Decode(FromHex(GOLDEN_SYNC_STATE), sync));
+  EXPECT_EQ(sync.score, 1200);
+  EXPECT_EQ(sync.board, std::string("\x00\x01\x02", 3));
+  ASSERT_TRUE(sync.current.has_value());
+  EXPECT_EQ(sync.current->x, -1);
+  EXPECT_EQ(sync.current->rotation, 3);
+}
+
+TEST(WireTest, RoundTripsEveryFieldType) {
+  Wire::HashHistory history;
+  history.fromStep = -5;
+  history.hashes = {0, 1, 0x80, UINT64_MAX};
+  history.inputs = std::string("LR\0G", 4);
+  Wire::HashHistory back;
+  ASSERT_TRUE(Wire::Decode(Wire::Encode(history), back));
+  EXPECT_EQ(back.fromStep, -5);
+  EXPECT_EQ(back.hashes, history.hashes);
+  EXPECT_EQ(back.inputs, history.inputs);
+
+  Wire::GameStartHost start;
+  start.seed = INT32_MIN;
+  start.session = 0x0123456789abcdefull;
+  start.hostName = "\xe0\xb8\xad\xe0\xb9\x8b"; // UTF-8
+  Wire::GameStartHost startBack;
+  ASSERT_TRUE(Wire::Decode(Wire::Encode(start), startBack));
+  EXPECT_EQ(startBack.seed, INT32_MIN);
+  EXPECT_EQ(startBack.session, start.session);
+  EXPECT_EQ(startBack.hostName, start.hostName);
+
+  Wire::Ping ping;
+  EXPECT_EQ(Wire::Encode(ping), std::string(1, (char)Wire::MsgId::PING));
+  EXPECT_TRUE(Wire::Decode(Wire::Encode(ping), ping));
+}
+
+// Defaults cost nothing on the wire and come back when decoding
+TEST(WireTest, DefaultsAreLeftOutAndRestored) {
+  Wire::MoveLR move;
+  move.dir = 1;
+  EXPECT_EQ(Hex(Wire::Encode(move)), "200802"); // No stampMs
+  Wire::MoveLR moveBack;
+  moveBack.stampMs = 99;
+  ASSERT_TRUE(Wire::Decode(Wire::Encode(move), moveBack));
+  EXPECT_EQ(moveBack.stampMs, -1);
+
+  Wire::JoinGame join;
+  join.settings.emplace(); // All defaults: an empty nested struct
+  Wire::JoinGame joinBack;
+  ASSERT_TRUE(Wire::Decode(Wire::Encode(join), joinBack));
+  ASSERT_TRUE(joinBack.settings.has_value());
+  EXPECT_TRUE(joinBack.settings->allowHoldPiece);
+  EXPECT_TRUE(joinBack.settings->increaseGravity);
+  EXPECT_FALSE(joinBack.settings->showGhostPiece);
+}
+
+// A newer peer's extra fields are skipped; an older peer's missing ones
+// take their defaults
+TEST(WireTest, SkipsFieldsFromNewerPeers) {
+  std::string frame = Wire::Encode(GoldenJoinGame());
+  frame += FromHex("7801");           // tag 15, varint 1
+  frame += FromHex("820103616263");   // tag 16, bytes "abc"
+  frame += FromHex("f8ffffff0fff01"); // tag 2^28 - 1, varint 255
+  Wire::JoinGame join;
+  ASSERT_TRUE(Wire::Decode(frame, join));
+  EXPECT_EQ(join.name, "Ann");
+  EXPECT_EQ(join.settings->attackMode, "lines");
+
+  // A known tag with another wire type is skipped too
+  Wire::Attack attack;
+  ASSERT_TRUE(Wire::Decode(FromHex("060a0178"), attack));
+  EXPECT_EQ(attack.lines, 0);
+}
+
+TEST(WireTest, RejectsMalformedAndForeignFrames) {
+  // Cut inside a field: rejected. Cut between fields: a valid frame with
+  // fewer fields, as the transport (WebSocket, length prefix) delimits
+  // frames.
+  std::string frame = Wire::Encode(GoldenSyncState());
+  Wire::SyncState sync;
+  for (size_t len = 0; len < frame.size(); len++) {
+    bool boundary = len == 1 || len == 4 || len == 6 || len == 11 || len == 14;
+    EXPECT_EQ(Wire::Decode(frame.data(), len, sync), boundary) << len;
+  }
+
+  Wire::StateHash hash;
+  EXPECT_FALSE(Wire::Decode(frame, hash)); // Another message's frame
+  EXPECT_FALSE(Wire::Decode(FromHex("250b"), hash)); // Wire type 3
+  EXPECT_FALSE(Wire::Decode(FromHex("2500"), hash)); // Tag 0
+
+  EXPECT_EQ(Wire::PeekId(frame.data(), frame.size()),
+            Wire::MsgId::SYNC_STATE);
+  EXPECT_EQ(Wire::PeekId("", 0), Wire::MsgId::UNKNOWN);
+  EXPECT_EQ((uint32_t)Wire::PeekId("\x7f", 1), 127u); // Newer message
+  EXPECT_STREQ(Wire::MsgName(Wire::MsgId::JOIN_GAME), "join_game");
+}
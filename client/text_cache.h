@@ -0,0 +1,244 @@
+#ifndef TEXT_CACHE_H
+#define TEXT_CACHE_H
+
+#include "raylib.h"
+#include "rlgl.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// DrawText()/MeasureText() for strings drawn every frame (scores, names,
+// input fields). Each (text, font, size) is laid out once into glyph quads;
+// later frames only append those quads to rlgl's batch. Numbers use a
+// per-size digit table, so "SCORE: 1200" re-lays out nothing when the
+// score changes. All quads use the font texture, so consecutive strings
+// (and shapes, which share the default font's texture) go out in one draw
+// call. Output matches DrawText() with the default font.
+class TextCache {
+public:
+  static constexpr size_t MAX_ENTRIES = 64; // Least recently used go first
+
+  // Returns the x offset where following text would start
+  float Draw(const char *text, float x, float y, int fontSize, Color color) {
+    const Entry &entry = Lookup(text, fontSize);
+    Emit(entry.quads.data(), entry.quads.size(), x, y, color);
+    return entry.advance;
+  }
+  float Draw(const std::string &text, float x, float y, int fontSize,
+             Color color) {
+    return Draw(text.c_str(), x, y, fontSize, color);
+  }
+
+  int Measure(const char *text, int fontSize) {
+    return (int)Lookup(text, fontSize).width;
+  }
+  int Measure(const std::string &text, int fontSize) {
+    return Measure(text.c_str(), fontSize);
+  }
+
+  // prefix followed by the decimal value, e.g. ("SCORE: ", 1200)
+  void DrawNumber(const char *prefix, long long value, float x, float y,
+                  int fontSize, Color color) {
+    const Entry &entry = Lookup(prefix, fontSize);
+    Emit(entry.quads.data(), entry.quads.size(), x, y, color);
+    const Digits &digits = LookupDigits(fontSize);
+    char buffer[24];
+    int count = Format(value, buffer);
+    Quad quads[24];
+    float offset = entry.advance;
+    for (int i = 0; i < count; i++) {
+      const Glyph &glyph = digits.glyphs[DigitIndex(buffer[i])];
+      quads[i] = glyph.quad;
+      quads[i].x0 += offset;
+      quads[i].x1 += offset;
+      offset += glyph.advance;
+    }
+    Emit(quads, count, x, y, color);
+  }
+
+  int MeasureNumber(const char *prefix, long long value, int fontSize) {
+    const Entry &entry = Lookup(prefix, fontSize);
+    const Digits &digits = LookupDigits(fontSize);
+    char buffer[24];
+    int count = Format(value, buffer);
+    if (count == 0)
+      return (int)entry.width;
+    float width = entry.advance;
+    for (int i = 0; i < count; i++)
+      width += digits.glyphs[DigitIndex(buffer[i])].advance;
+    return (int)(width - Spacing(fontSize)); // No spacing after the last
+  }
+
+  size_t Size() const { return entries.size(); }
+  void Clear() {
+    entries.clear();
+    digitTables.clear();
+  }
+
+private:
+  struct Quad {
+    float x0, y0, x1, y1; // Relative to the text position
+    float u0, v0, u1, v1;
+  };
+
+  struct Entry {
+    std::string text;
+    int fontSize = 0;
+    std::vector<Quad> quads;
+    float width = 0;   // As MeasureText()
+    float advance = 0; // Where the next character would start
+    uint64_t lastUse = 0;
+  };
+
+  struct Glyph {
+    Quad quad = {};
+    float advance = 0;
+  };
+
+  struct Digits {
+    int fontSize = 0;
+    Glyph glyphs[11]; // '0'-'9', '-'
+  };
+
+  // DrawText() scales the 10 px default font and spaces by whole pixels
+  static int PixelSize(int fontSize) {
+    return fontSize < 10 ? 10 : fontSize;
+  }
+  static float Spacing(int fontSize) {
+    return (float)(PixelSize(fontSize) / 10);
+  }
+
+  static int DigitIndex(char c) { return c == '-' ? 10 : c - '0'; }
+
+  static int Format(long long value, char *out) {
+    char reversed[24];
+    int count = 0;
+    unsigned long long magnitude =
+        value < 0 ? 0ull - (unsigned long long)value : value;
+    do {
+      reversed[count++] = (char)('0' + magnitude % 10);
+      magnitude /= 10;
+    } while (magnitude > 0);
+    int length = 0;
+    if (value < 0)
+      out[length++] = '-';
+    while (count > 0)
+      out[length++] = reversed[--count];
+    return length;
+  }
+
+  const Entry &Lookup(const char *text, int fontSize) {
+    useCounter++;
+    for (Entry &entry : entries) {
+      if (entry.fontSize == fontSize && entry.text == text) {
+        entry.lastUse = useCounter;
+        return entry;
+      }
+    }
+    if (entries.size() >= MAX_ENTRIES) {
+      size_t oldest = 0;
+      for (size_t i = 1; i < entries.size(); i++)
+        if (entries[i].lastUse < entries[oldest].lastUse)
+          oldest = i;
+      entries[oldest] = entries.back();
+      entries.pop_back();
+    }
+    entries.emplace_back();
+    Entry &entry = entries.back();
+    entry.text = text;
+    entry.fontSize = fontSize;
+    entry.lastUse = useCounter;
+    Layout(text, fontSize, entry.quads, entry.advance, entry.width);
+    return entry;
+  }
+
+  const Digits &LookupDigits(int fontSize) {
+    for (const Digits &digits : digitTables)
+      if (digits.fontSize == fontSize)
+        return digits;
+    digitTables.emplace_back();
+    Digits &digits = digitTables.back();
+    digits.fontSize = fontSize;
+    const char *chars = "0123456789-";
+    std::vector<Quad> quads;
+    for (int i = 0; i < 11; i++) {
+      char text[2] = {chars[i], '\0'};
+      float width;
+      Layout(text, fontSize, quads, digits.glyphs[i].advance, width);
+      digits.glyphs[i].quad = quads[0];
+    }
+    return digits;
+  }
+
+  // The layout of DrawTextEx()/DrawTextCodepoint(), single line
+  static void Layout(const char *text, int fontSize, std::vector<Quad> &quads,
+                     float &advance, float &width) {
+    Font font = GetFontDefault();
+    float size = (float)PixelSize(fontSize);
+    float spacing = Spacing(fontSize);
+    float scale = size / font.baseSize;
+    float padding = (float)font.glyphPadding;
+    float texWidth = (float)font.texture.width;
+    float texHeight = (float)font.texture.height;
+
+    quads.clear();
+    float x = 0;
+    float measured = 0;
+    int count = 0;
+    for (int i = 0; text[i] != '\0';) {
+      int bytes = 0;
+      int codepoint = GetCodepointNext(&text[i], &bytes);
+      i += bytes;
+      int index = GetGlyphIndex(font, codepoint);
+      const Rectangle &rec = font.recs[index];
+      const GlyphInfo &glyph = font.glyphs[index];
+      if (codepoint != ' ' && codepoint != '\t') {
+        Quad q;
+        q.x0 = x + (glyph.offsetX - padding) * scale;
+        q.y0 = (glyph.offsetY - padding) * scale;
+        q.x1 = q.x0 + (rec.width + 2 * padding) * scale;
+        q.y1 = q.y0 + (rec.height + 2 * padding) * scale;
+        q.u0 = (rec.x - padding) / texWidth;
+        q.v0 = (rec.y - padding) / texHeight;
+        q.u1 = (rec.x + rec.width + padding) / texWidth;
+        q.v1 = (rec.y + rec.height + padding) / texHeight;
+        quads.push_back(q);
+      }
+      x += (glyph.advanceX ? glyph.advanceX : rec.width) * scale + spacing;
+      measured += glyph.advanceX ? glyph.advanceX : rec.width + glyph.offsetX;
+      count++;
+    }
+    advance = x;
+    width = count ? measured * scale + (count - 1) * spacing : 0;
+  }
+
+  static void Emit(const Quad *quads, size_t count, float x, float y,
+                   Color color) {
+    if (count == 0)
+      return;
+    rlCheckRenderBatchLimit(4 * (int)count);
+    rlSetTexture(GetFontDefault().texture.id);
+    rlBegin(RL_QUADS);
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlNormal3f(0.0f, 0.0f, 1.0f);
+    for (size_t i = 0; i < count; i++) {
+      const Quad &q = quads[i];
+      rlTexCoord2f(q.u0, q.v0);
+      rlVertex2f(x + q.x0, y + q.y0);
+      rlTexCoord2f(q.u0, q.v1);
+      rlVertex2f(x + q.x0, y + q.y1);
+      rlTexCoord2f(q.u1, q.v1);
+      rlVertex2f(x + q.x1, y + q.y1);
+      rlTexCoord2f(q.u1, q.v0);
+      rlVertex2f(x + q.x1, y + q.y0);
+    }
+    rlEnd();
+    rlSetTexture(0);
+  }
+
+  std::vector<Entry> entries;
+  std::vector<Digits> digitTables;
+  uint64_t useCounter = 0;
+};
+
+#endif
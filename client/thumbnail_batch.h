@@ -0,0 +1,66 @@
+#ifndef THUMBNAIL_BATCH_H
+#define THUMBNAIL_BATCH_H
+
+#include "png_writer.h"
+#include "soft_raster.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Draws and PNG-encodes many thumbnails across cores. Each worker owns a
+// SoftRaster and a PngWriter, so after its first image it no longer
+// allocates except to grow the output, and it takes items in small chunks
+// from a shared counter, so slow items (long replays) even out.
+class ThumbnailBatch {
+public:
+  // Draws item index into the raster; false leaves its PNG empty
+  typedef std::function<bool(int index, SoftRaster &raster)> DrawFn;
+
+  static constexpr int CHUNK = 16; // Items taken at a time
+
+  explicit ThumbnailBatch(int threads = 0) {
+    if (threads <= 0)
+      threads = (int)std::thread::hardware_concurrency();
+    this->threads = std::max(threads, 1);
+  }
+
+  int Threads() const { return threads; }
+
+  // out[i] is item i's PNG file; returns how many were rendered
+  int Render(int count, const DrawFn &draw, std::vector<std::string> &out) {
+    out.assign(count > 0 ? count : 0, std::string());
+    std::atomic<int> next(0), rendered(0);
+    auto work = [&]() {
+      SoftRaster raster;
+      PngWriter png;
+      for (;;) {
+        int first = next.fetch_add(CHUNK);
+        if (first >= count)
+          break;
+        int last = std::min(first + CHUNK, count);
+        for (int i = first; i < last; i++) {
+          if (draw(i, raster) &&
+              png.Encode(raster.Data(), raster.Width(), raster.Height(),
+                         out[i]))
+            rendered++;
+        }
+      }
+    };
+    int workers = std::min(threads, (count + CHUNK - 1) / CHUNK);
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; t++)
+      pool.emplace_back(work);
+    work(); // The caller is a worker too
+    for (std::thread &thread : pool)
+      thread.join();
+    return rendered;
+  }
+
+private:
+  int threads;
+};
+
+#endif
@@ -0,0 +1,246 @@
+// Offline viewer for flight recorder files (flight_recorder.h): the last
+// few thousand messages a game sent and received, written on a
+// disconnect, a desync or F9.
+//
+//   tetris_flightview flight-desync-1700000000.tbfr
+//   tetris_flightview host.tbfr client.tbfr
+//
+// With one file it prints the timeline. With two (one per peer) it pairs
+// each message one side sent with its arrival on the other, estimates the
+// clock offset between the machines from the fastest trips in each
+// direction, and prints both recordings on one clock with per-message
+// one-way latency. It also lists the longest silences, which is usually
+// where "the board jumped".
+
+#include "../flight_recorder.h"
+#include "../network_protocol.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+typedef FlightRecorder::Entry Entry;
+
+struct Recording {
+  const char *path;
+  FlightRecorder::FileHeader header;
+  std::vector<Entry> entries;
+  std::vector<int> peerIndex; // Matching entry in the other recording, -1
+};
+
+const char *TypeName(const Entry &e) {
+  if (e.direction == FlightRecorder::MARK)
+    return "MARK";
+  return NetworkProtocol::TypeName((NetworkMsgType)e.type);
+}
+
+std::string Preview(const Entry &e) {
+  std::string out;
+  for (int i = 0; i < e.previewLen; i++) {
+    char c = e.preview[i];
+    out += (c >= 32 && c < 127) ? c : '.';
+  }
+  if (e.size > e.previewLen)
+    out += "...";
+  return out;
+}
+
+bool SameMessage(const Entry &a, const Entry &b) {
+  return a.size == b.size && a.previewLen == b.previewLen &&
+         memcmp(a.preview, b.preview, a.previewLen) == 0;
+}
+
+// TCP keeps order, so walk both lists forward. The window skips messages
+// that fell out of one ring or were lost with a dropped connection.
+void Match(Recording &from, Recording &to) {
+  const size_t WINDOW = 256;
+  size_t next = 0;
+  for (size_t i = 0; i < from.entries.size(); i++) {
+    if (from.entries[i].direction != FlightRecorder::OUT)
+      continue;
+    for (size_t j = next; j < to.entries.size() && j < next + WINDOW; j++) {
+      if (to.entries[j].direction == FlightRecorder::IN &&
+          to.peerIndex[j] < 0 && SameMessage(from.entries[i], to.entries[j])) {
+        from.peerIndex[i] = (int)j;
+        to.peerIndex[j] = (int)i;
+        next = j + 1;
+        break;
+      }
+    }
+  }
+}
+
+// Smallest (arrival - send) over all messages from -> to, in raw clocks
+bool MinTrip(const Recording &from, const Recording &to, int64_t &minTrip) {
+  bool found = false;
+  for (size_t i = 0; i < from.entries.size(); i++) {
+    int j = from.peerIndex[i];
+    if (from.entries[i].direction != FlightRecorder::OUT || j < 0)
+      continue;
+    int64_t trip = to.entries[j].timeUs - from.entries[i].timeUs;
+    if (!found || trip < minTrip)
+      minTrip = trip;
+    found = true;
+  }
+  return found;
+}
+
+void PrintHeader(const char *name, const Recording &r) {
+  printf("%s: %s  [%s] reason %s, %zu entries\n", name, r.path,
+         r.header.label, r.header.reason, r.entries.size());
+}
+
+void PrintEntry(double ms, const char *who, const Entry &e,
+                const char *latency) {
+  const char *arrow = e.direction == FlightRecorder::OUT
+                          ? "->"
+                          : (e.direction == FlightRecorder::IN ? "<-" : "**");
+  printf("%12.3f  %s%s %-16s %6u  %9s  %s\n", ms, who, arrow, TypeName(e),
+         e.size, latency, Preview(e).c_str());
+}
+
+// Longest stretches without inbound traffic
+void PrintSilences(const char *name, const Recording &r, int64_t offsetUs,
+                   int64_t baseUs) {
+  struct Gap {
+    int64_t startUs, lengthUs;
+  };
+  std::vector<Gap> gaps;
+  int64_t last = -1;
+  for (const Entry &e : r.entries) {
+    if (e.direction != FlightRecorder::IN)
+      continue;
+    if (last >= 0)
+      gaps.push_back(Gap{last, e.timeUs - last});
+    last = e.timeUs;
+  }
+  std::sort(gaps.begin(), gaps.end(),
+            [](const Gap &a, const Gap &b) { return a.lengthUs > b.lengthUs; });
+  printf("longest inbound silences on %s:\n", name);
+  for (size_t i = 0; i < gaps.size() && i < 3; i++)
+    printf("  %9.1f ms starting at %.3f\n", gaps[i].lengthUs / 1000.0,
+           (gaps[i].startUs + offsetUs - baseUs) / 1000.0);
+}
+
+int ShowOne(Recording &a) {
+  PrintHeader("A", a);
+  if (a.entries.empty())
+    return 0;
+  int64_t base = a.entries.front().timeUs;
+  for (const Entry &e : a.entries)
+    PrintEntry((e.timeUs - base) / 1000.0, "", e, "");
+  PrintSilences("A", a, 0, base);
+  return 0;
+}
+
+int ShowTwo(Recording &a, Recording &b) {
+  PrintHeader("A", a);
+  PrintHeader("B", b);
+  Match(a, b);
+  Match(b, a);
+
+  // tA = tB + offset. With symmetric fastest trips L:
+  //   min(tB_in - tA_out) = L - offset,  min(tA_in - tB_out) = L + offset
+  int64_t ab = 0, ba = 0;
+  bool haveAB = MinTrip(a, b, ab), haveBA = MinTrip(b, a, ba);
+  int64_t offset;
+  const char *method;
+  if (haveAB && haveBA) {
+    offset = (ba - ab) / 2;
+    method = "matched messages, both directions";
+  } else if (haveAB || haveBA) {
+    offset = haveAB ? -ab : ba; // Assumes the fastest trip took ~0
+    method = "matched messages, one direction only";
+  } else {
+    offset = (b.header.wallUs - b.header.monoUs) -
+             (a.header.wallUs - a.header.monoUs);
+    method = "wall clocks (no message matched)";
+  }
+  printf("clock offset B->A %+.3f ms (%s)", offset / 1000.0, method);
+  if (haveAB && haveBA)
+    printf(", fastest one-way trip %.3f ms", (ab + ba) / 2 / 1000.0);
+  printf("\n\n");
+
+  struct Row {
+    int64_t timeUs; // A's clock
+    bool fromA;
+    size_t index;
+  };
+  std::vector<Row> rows;
+  for (size_t i = 0; i < a.entries.size(); i++)
+    rows.push_back(Row{a.entries[i].timeUs, true, i});
+  for (size_t i = 0; i < b.entries.size(); i++)
+    rows.push_back(Row{b.entries[i].timeUs + offset, false, i});
+  std::stable_sort(rows.begin(), rows.end(), [](const Row &x, const Row &y) {
+    return x.timeUs < y.timeUs;
+  });
+  if (rows.empty())
+    return 0;
+
+  int64_t base = rows.front().timeUs;
+  std::vector<int64_t> trips[2];
+  int unmatched[2] = {0, 0};
+  for (const Row &row : rows) {
+    const Recording &self = row.fromA ? a : b;
+    const Recording &other = row.fromA ? b : a;
+    const Entry &e = self.entries[row.index];
+    int peer = self.peerIndex[row.index];
+    char latency[32] = "";
+    if (e.direction == FlightRecorder::IN && peer >= 0) {
+      int64_t sent = other.entries[peer].timeUs + (row.fromA ? offset : 0);
+      int64_t trip = row.timeUs - sent;
+      trips[row.fromA ? 1 : 0].push_back(trip); // [0]: A->B, [1]: B->A
+      snprintf(latency, sizeof(latency), "%.3fms", trip / 1000.0);
+    } else if (e.direction == FlightRecorder::OUT && peer < 0) {
+      unmatched[row.fromA ? 0 : 1]++;
+      snprintf(latency, sizeof(latency), "unmatched");
+    }
+    PrintEntry((row.timeUs - base) / 1000.0, row.fromA ? "A" : "B", e,
+               latency);
+  }
+
+  printf("\n");
+  const char *names[2] = {"A->B", "B->A"};
+  for (int d = 0; d < 2; d++) {
+    std::vector<int64_t> &t = trips[d];
+    std::sort(t.begin(), t.end());
+    if (t.empty()) {
+      printf("%s: no matched messages, %d unmatched\n", names[d],
+             unmatched[d]);
+      continue;
+    }
+    printf("%s: %zu matched, %d unmatched; one-way p50 %.3f ms, p99 %.3f ms, "
+           "max %.3f ms\n",
+           names[d], t.size(), unmatched[d], t[t.size() / 2] / 1000.0,
+           t[t.size() * 99 / 100] / 1000.0, t.back() / 1000.0);
+  }
+  PrintSilences("A", a, 0, base);
+  PrintSilences("B", b, offset, base);
+  return 0;
+}
+
+bool Load(const char *path, Recording &r) {
+  r.path = path;
+  if (!FlightRecorder::ReadFile(path, r.header, r.entries)) {
+    fprintf(stderr, "%s: not a readable flight record\n", path);
+    return false;
+  }
+  r.peerIndex.assign(r.entries.size(), -1);
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 3 || strcmp(argv[1], "--help") == 0) {
+    fprintf(stderr, "usage: tetris_flightview FILE [PEER_FILE]\n");
+    return 1;
+  }
+  Recording a, b;
+  if (!Load(argv[1], a) || (argc == 3 && !Load(argv[2], b)))
+    return 1;
+  return argc == 3 ? ShowTwo(a, b) : ShowOne(a);
+}
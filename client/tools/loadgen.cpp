@@ -0,0 +1,1181 @@
+// Headless load generator: thousands of scripted bots playing full matches,
+// multiplexed over a few poll() event loops. Reuses Logic, NetworkProtocol
+// and the hub codec, and does not link raylib.
+//
+//   tetris_loadgen --mode p2p  --clients 2000 --threads 4 --duration 60
+//   tetris_loadgen --mode hub  --addr 127.0.0.1 --port 8080 --clients 1000
+//   tetris_loadgen --mode host --addr 192.168.1.10 --port 12345 --clients 1
+//
+// p2p  : bots pair up in-process over loopback TCP, half acting as host and
+//        half as client, speaking the game's text protocol end to end.
+// host : bots join running C++ hosts as clients (one client per host).
+// hub  : bots join the Go hub (server.go) over WebSocket and get matched.
+//
+// Reports per-message latency histograms, throughput and error rates. In
+// p2p mode the host bots also validate their clients' reports the way a
+// C++ host does (InputValidator) and report the worker's CPU cost.
+// --metrics-port N serves the same counters as a game host (metrics.h) on
+// http://127.0.0.1:N/metrics while the run lasts.
+
+#include "../desync_detector.h"
+#include "../hub_codec.h"
+#include "../input_validator.h"
+#include "../latency_histogram.h"
+#include "../logic.h"
+#include "../metrics_server.h"
+#include "../network_protocol.h"
+#include "../websocket_frame.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <memory>
+#include <mutex>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <random>
+#include <string>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+enum class Mode { P2P, HOST, HUB };
+
+struct Options {
+  Mode mode = Mode::P2P;
+  std::string addr = "127.0.0.1";
+  int port = 0; // 0: mode default (12345 host, 8080 hub)
+  int clients = 1000;
+  int threads = 4;
+  int durationSeconds = 30;
+  int apm = 150;           // Moves/rotations per minute per bot
+  int gravityMs = 500;     // Matches the game's default gravity interval
+  int matchSeconds = 60;   // Bots give up (as if dead) after this long
+  int rampPerSecond = 500; // New connections per second across all bots
+  int metricsPort = 0;     // 0: no metrics endpoint
+};
+
+// ------------------------------------------------------------ statistics --
+
+enum Category {
+  CAT_INPUT,      // MOVE_LR / ROTATE / MOVE_DOWN
+  CAT_SYNC,       // SYNC_STATE
+  CAT_HASH,       // STATE_HASH
+  CAT_PING,       // PING keepalive
+  CAT_CONTROL,    // CLIENT_READY, GAME_START, PLAYER_DEAD, GAME_OVER
+  CAT_HUB_STATE,  // Hub game_state relayed between two bots
+  CAT_CONNECT,    // TCP connect (+ WebSocket upgrade in hub mode)
+  CAT_MATCH_WAIT, // Ready/join -> GAME_START
+  CAT_COUNT
+};
+
+const char *const CATEGORY_NAMES[CAT_COUNT] = {
+    "input", "sync_state", "state_hash", "ping",
+    "control", "hub_state", "connect", "match_wait"};
+
+struct Stats {
+  LatencyHistogram latency[CAT_COUNT];
+  uint64_t msgsSent = 0, msgsRecv = 0, bytesSent = 0, bytesRecv = 0;
+  uint64_t connectAttempts = 0, connectErrors = 0, disconnects = 0;
+  uint64_t protocolErrors = 0, desyncs = 0, timeouts = 0, peerLeft = 0;
+  uint64_t matchesStarted = 0, matchesCompleted = 0;
+  uint64_t matchesValidated = 0, validationFailures = 0, claimsChecked = 0;
+  double validatorSeconds = 0.0; // Worker CPU time
+  int connected = 0, playing = 0; // Gauges at snapshot time
+
+  void Merge(const Stats &o) {
+    for (int i = 0; i < CAT_COUNT; i++)
+      latency[i].Merge(o.latency[i]);
+    msgsSent += o.msgsSent;
+    msgsRecv += o.msgsRecv;
+    bytesSent += o.bytesSent;
+    bytesRecv += o.bytesRecv;
+    connectAttempts += o.connectAttempts;
+    connectErrors += o.connectErrors;
+    disconnects += o.disconnects;
+    protocolErrors += o.protocolErrors;
+    desyncs += o.desyncs;
+    timeouts += o.timeouts;
+    peerLeft += o.peerLeft;
+    matchesStarted += o.matchesStarted;
+    matchesCompleted += o.matchesCompleted;
+    matchesValidated += o.matchesValidated;
+    validationFailures += o.validationFailures;
+    claimsChecked += o.claimsChecked;
+    validatorSeconds += o.validatorSeconds;
+    connected += o.connected;
+    playing += o.playing;
+  }
+};
+
+int64_t NowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+std::string BoardToString(const Logic &logic) {
+  std::string out;
+  out.reserve(BOARD_WIDTH * BOARD_HEIGHT);
+  for (int r = 0; r < BOARD_HEIGHT; r++)
+    for (int c = 0; c < BOARD_WIDTH; c++)
+      out += (char)('0' + logic.board.GetCell(r, c));
+  return out;
+}
+
+// Same derivation as Game::ProcessHubMessage so bots and natives agree
+int SeedFromMatchId(std::string_view matchId) {
+  uint32_t seed = 2166136261u; // FNV-1a
+  for (char ch : matchId)
+    seed = (seed ^ (uint8_t)ch) * 16777619u;
+  return (int)(seed & 0x7FFFFFFF);
+}
+
+Category CategoryOf(NetworkMsgType type) {
+  switch (type) {
+  case NetworkMsgType::MOVE_LR:
+  case NetworkMsgType::ROTATE:
+  case NetworkMsgType::MOVE_DOWN:
+    return CAT_INPUT;
+  case NetworkMsgType::SYNC_STATE:
+    return CAT_SYNC;
+  case NetworkMsgType::STATE_HASH:
+    return CAT_HASH;
+  case NetworkMsgType::PING:
+    return CAT_PING;
+  default:
+    return CAT_CONTROL;
+  }
+}
+
+// ------------------------------------------------------------------- bot --
+
+enum class BotState {
+  IDLE,       // Waiting for reconnectAt
+  CONNECTING, // Non-blocking connect in flight
+  HANDSHAKE,  // Hub: WebSocket upgrade sent
+  LOBBY,      // Connected, waiting for the match to start
+  PLAYING,
+};
+
+struct Bot {
+  int id = 0;
+  bool isHost = false; // p2p: accepts instead of connecting
+  BotState state = BotState::IDLE;
+  int fd = -1;
+  uint16_t localPort = 0;
+
+  std::string in;  // Partial input (text protocol)
+  std::string out; // Pending output
+  WebSocket::FrameDecoder ws;
+  std::string wsKey;
+
+  Logic self;   // Our board
+  Logic mirror; // Opponent's board rebuilt from its events (text modes)
+  DesyncDetector desync;
+  int validation = 0; // p2p host: validator match checking the client
+  bool selfDead = false, peerDead = false;
+
+  int64_t reconnectAt = 0, connectStartUs = 0, lobbySinceUs = 0;
+  int64_t nextActionUs = 0, nextGravityUs = 0, nextPingUs = 0, matchEndUs = 0;
+
+  // p2p: the bot on the other end of the connection (same event loop), and
+  // the send times of the messages it has in flight towards us, in order.
+  Bot *peer = nullptr;
+  std::deque<int64_t> inflight;
+
+  std::mt19937 rng;
+};
+
+// ------------------------------------------------------------ event loop --
+
+class EventLoop {
+public:
+  EventLoop(const Options &options, int firstBotId, int botCount)
+      : opt(options) {
+    for (int i = 0; i < botCount; i++) {
+      std::unique_ptr<Bot> bot(new Bot());
+      bot->id = firstBotId + i;
+      bot->isHost = opt.mode == Mode::P2P && (i % 2 == 0);
+      bot->rng.seed(0x9E3779B9u * (uint32_t)(bot->id + 1));
+      // Spread connection attempts over the ramp
+      bot->reconnectAt =
+          NowUs() + (int64_t)bot->id * 1000000 / opt.rampPerSecond;
+      bots.push_back(std::move(bot));
+    }
+  }
+
+  bool Start(std::atomic<bool> &stopFlag) {
+    if (opt.mode == Mode::P2P && !OpenListener())
+      return false;
+    for (auto &bot : bots) {
+      if (bot->isHost)
+        waitingHosts.push_back(bot.get());
+    }
+    thread = std::thread(&EventLoop::Run, this, std::ref(stopFlag));
+    return true;
+  }
+
+  void Join() {
+    if (thread.joinable())
+      thread.join();
+  }
+
+  Stats Snapshot() {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    return published;
+  }
+
+private:
+  const Options &opt;
+  std::vector<std::unique_ptr<Bot>> bots;
+  std::thread thread;
+  Stats stats;
+  Stats published;
+  std::mutex publishMutex;
+
+  // p2p hosts: one worker checks every match of this loop. Finished
+  // matches are tallied on a later publish, once the worker caught up.
+  InputValidator validator;
+  std::vector<int> finishedValidations;
+
+  // p2p plumbing
+  int listenFd = -1;
+  uint16_t listenPort = 0;
+  std::deque<Bot *> waitingHosts;
+  std::unordered_map<uint16_t, Bot *> clientsByPort;
+
+  void Run(std::atomic<bool> &stopFlag) {
+    std::vector<pollfd> pfds;
+    std::vector<Bot *> owners;
+    int64_t nextPublish = 0;
+    while (!stopFlag) {
+      int64_t now = NowUs();
+      for (auto &bot : bots)
+        Timers(*bot, now);
+
+      pfds.clear();
+      owners.clear();
+      if (listenFd >= 0) {
+        pfds.push_back({listenFd, POLLIN, 0});
+        owners.push_back(nullptr);
+      }
+      for (auto &bot : bots) {
+        if (bot->fd < 0)
+          continue;
+        short events = POLLIN;
+        if (!bot->out.empty() || bot->state == BotState::CONNECTING)
+          events |= POLLOUT;
+        pfds.push_back({bot->fd, events, 0});
+        owners.push_back(bot.get());
+      }
+
+      // 5ms timer granularity is plenty for human-rate inputs
+      int ready = poll(pfds.data(), pfds.size(), 5);
+      now = NowUs();
+      MetricsTimer tickTimer(Metrics::Get(), Metrics::TICK_DURATION);
+      for (size_t i = 0; ready > 0 && i < pfds.size(); i++) {
+        if (pfds[i].revents == 0)
+          continue;
+        ready--;
+        Bot *bot = owners[i];
+        if (!bot) {
+          AcceptClients(now);
+          continue;
+        }
+        if (bot->fd != pfds[i].fd)
+          continue; // Closed earlier in this pass
+        if (bot->state == BotState::CONNECTING) {
+          if (pfds[i].revents & (POLLOUT | POLLERR | POLLHUP))
+            FinishConnect(*bot, now);
+          continue;
+        }
+        if (pfds[i].revents & (POLLIN | POLLERR | POLLHUP))
+          Receive(*bot, now);
+        if (bot->fd >= 0 && (pfds[i].revents & POLLOUT))
+          Flush(*bot, now);
+      }
+
+      if (now >= nextPublish) {
+        Publish();
+        nextPublish = now + 200000;
+      }
+    }
+    for (auto &bot : bots) {
+      if (bot->fd >= 0)
+        close(bot->fd);
+    }
+    if (listenFd >= 0)
+      close(listenFd);
+    validator.WaitIdle();
+    Publish();
+  }
+
+  void Publish() {
+    for (int id : finishedValidations) {
+      InputValidator::Status status = validator.GetStatus(id);
+      stats.matchesValidated++;
+      stats.claimsChecked += (uint64_t)status.checks;
+      if (status.diverged)
+        stats.validationFailures++;
+      validator.EndMatch(id);
+    }
+    finishedValidations.clear();
+    stats.validatorSeconds = validator.GetBusySeconds();
+    stats.connected = 0;
+    stats.playing = 0;
+    for (auto &bot : bots) {
+      if (bot->fd >= 0 && bot->state != BotState::CONNECTING)
+        stats.connected++;
+      if (bot->state == BotState::PLAYING)
+        stats.playing++;
+    }
+    std::lock_guard<std::mutex> lock(publishMutex);
+    published = stats;
+  }
+
+  // ------------------------------------------------------------- sockets --
+
+  bool OpenListener() {
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0)
+      return false;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0 ||
+        listen(listenFd, SOMAXCONN) < 0 ||
+        getsockname(listenFd, (sockaddr *)&addr, &len) < 0) {
+      close(listenFd);
+      listenFd = -1;
+      return false;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL, 0) | O_NONBLOCK);
+    listenPort = ntohs(addr.sin_port);
+    return true;
+  }
+
+  static void TuneSocket(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int flag = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (char *)&flag, sizeof(int));
+  }
+
+  void StartConnect(Bot &bot, int64_t now) {
+    stats.connectAttempts++;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+      stats.connectErrors++;
+      bot.reconnectAt = now + 1000000;
+      return;
+    }
+    TuneSocket(fd);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    if (opt.mode == Mode::P2P) {
+      addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+      addr.sin_port = htons(listenPort);
+    } else {
+      inet_pton(AF_INET, opt.addr.c_str(), &addr.sin_addr);
+      addr.sin_port = htons(opt.port);
+    }
+    int res = connect(fd, (sockaddr *)&addr, sizeof(addr));
+    if (res < 0 && errno != EINPROGRESS) {
+      close(fd);
+      stats.connectErrors++;
+      bot.reconnectAt = now + 1000000;
+      return;
+    }
+    bot.fd = fd;
+    bot.state = BotState::CONNECTING;
+    bot.connectStartUs = now;
+    if (opt.mode == Mode::P2P) {
+      sockaddr_in local = {};
+      socklen_t len = sizeof(local);
+      getsockname(fd, (sockaddr *)&local, &len);
+      bot.localPort = ntohs(local.sin_port);
+      clientsByPort[bot.localPort] = &bot;
+    }
+  }
+
+  void FinishConnect(Bot &bot, int64_t now) {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(bot.fd, SOL_SOCKET, SO_ERROR, &error, &len) < 0 ||
+        error != 0) {
+      stats.connectErrors++;
+      Close(bot, now, false);
+      return;
+    }
+    if (opt.mode == Mode::HUB) {
+      uint8_t nonce[16];
+      for (uint8_t &b : nonce)
+        b = (uint8_t)bot.rng();
+      bot.wsKey = WebSocket::Base64(nonce, sizeof(nonce));
+      bot.out += WebSocket::BuildClientHandshake(opt.addr, opt.port, "/ws",
+                                                 bot.wsKey);
+      bot.state = BotState::HANDSHAKE;
+      Flush(bot, now);
+      return;
+    }
+    stats.latency[CAT_CONNECT].Record(now - bot.connectStartUs);
+    EnterLobby(bot, now);
+    SendText(bot, "CLIENT_READY;P2_NAME:bot" + std::to_string(bot.id), now);
+  }
+
+  void AcceptClients(int64_t now) {
+    while (true) {
+      sockaddr_in peerAddr = {};
+      socklen_t len = sizeof(peerAddr);
+      int fd = accept(listenFd, (sockaddr *)&peerAddr, &len);
+      if (fd < 0)
+        return;
+      TuneSocket(fd);
+      auto it = clientsByPort.find(ntohs(peerAddr.sin_port));
+      if (it == clientsByPort.end() || waitingHosts.empty()) {
+        stats.protocolErrors++;
+        close(fd);
+        continue;
+      }
+      Bot *host = waitingHosts.front();
+      waitingHosts.pop_front();
+      Bot *client = it->second;
+      host->fd = fd;
+      host->peer = client;
+      client->peer = host;
+      EnterLobby(*host, now);
+    }
+  }
+
+  void EnterLobby(Bot &bot, int64_t now) {
+    bot.state = BotState::LOBBY;
+    bot.lobbySinceUs = now;
+  }
+
+  // error: the connection broke rather than ending with the match
+  void Close(Bot &bot, int64_t now, bool error) {
+    if (error)
+      stats.disconnects++;
+    if (bot.fd >= 0)
+      close(bot.fd);
+    bot.fd = -1;
+    if (bot.localPort) {
+      clientsByPort.erase(bot.localPort);
+      bot.localPort = 0;
+    }
+    if (bot.peer) {
+      if (bot.peer->peer == &bot)
+        bot.peer->peer = nullptr;
+      bot.peer->inflight.clear();
+      bot.peer = nullptr;
+    }
+    bot.inflight.clear();
+    bot.in.clear();
+    bot.out.clear();
+    bot.ws.Clear();
+    bot.state = BotState::IDLE;
+    if (bot.validation) {
+      validator.EndMatch(bot.validation); // Aborted: nothing to tally
+      bot.validation = 0;
+    }
+    // Short think time before queueing for the next match
+    bot.reconnectAt = now + 200000 + (int64_t)(bot.rng() % 800000);
+    if (bot.isHost)
+      waitingHosts.push_back(&bot);
+  }
+
+  void Flush(Bot &bot, int64_t now) {
+    while (!bot.out.empty()) {
+      ssize_t n = send(bot.fd, bot.out.data(), bot.out.size(), 0);
+      if (n < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+          return;
+        Close(bot, now, true);
+        return;
+      }
+      stats.bytesSent += (uint64_t)n;
+      bot.out.erase(0, (size_t)n);
+    }
+  }
+
+  void Receive(Bot &bot, int64_t now) {
+    char buffer[16384];
+    while (bot.fd >= 0) {
+      ssize_t n = recv(bot.fd, buffer, sizeof(buffer), 0);
+      if (n == 0) {
+        // Orderly close after the match is expected; anything else is not
+        Close(bot, now, bot.state == BotState::PLAYING);
+        return;
+      }
+      if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+          Close(bot, now, true);
+        return;
+      }
+      stats.bytesRecv += (uint64_t)n;
+      if (opt.mode == Mode::HUB) {
+        if (!ReceiveHub(bot, buffer, (size_t)n, now))
+          return;
+        continue;
+      }
+      bot.in.append(buffer, (size_t)n);
+      size_t start = 0, pos;
+      while (bot.fd >= 0 &&
+             (pos = bot.in.find('\n', start)) != std::string::npos) {
+        if (pos > start)
+          HandleLine(bot, bot.in.substr(start, pos - start), now);
+        start = pos + 1;
+      }
+      if (bot.fd >= 0)
+        bot.in.erase(0, start);
+    }
+  }
+
+  // ------------------------------------------------------ text protocol --
+
+  void SendText(Bot &bot, const std::string &msg, int64_t now) {
+    if (bot.fd < 0)
+      return;
+    bot.out += msg;
+    bot.out += '\n';
+    stats.msgsSent++;
+    Metrics::Get().CountMessage(
+        false, NetworkProtocol::PeekType(msg.data(), msg.size()), msg.size());
+    if (bot.peer)
+      bot.peer->inflight.push_back(now);
+    Flush(bot, now);
+  }
+
+  void HandleLine(Bot &bot, const std::string &line, int64_t now) {
+    stats.msgsRecv++;
+    NetworkMessage msg;
+    try {
+      msg = NetworkProtocol::Parse(line);
+    } catch (...) {
+      stats.protocolErrors++;
+      return;
+    }
+    Metrics::Get().CountMessage(true, msg.type, line.size());
+    if (!bot.inflight.empty()) {
+      Category cat = CategoryOf(msg.type);
+      if (line.compare(0, 12, "CLIENT_READY") == 0 ||
+          line.compare(0, 11, "PLAYER_DEAD") == 0 ||
+          line.compare(0, 9, "GAME_OVER") == 0)
+        cat = CAT_CONTROL;
+      stats.latency[cat].Record(now - bot.inflight.front());
+      bot.inflight.pop_front();
+    }
+    if (bot.validation)
+      Validate(bot, msg);
+
+    switch (msg.type) {
+    case NetworkMsgType::GAME_START:
+      if (!bot.isHost) {
+        stats.latency[CAT_MATCH_WAIT].Record(now - bot.lobbySinceUs);
+        StartMatch(bot, msg.intParam1, now);
+      }
+      return;
+    case NetworkMsgType::MOVE_LR:
+      bot.mirror.Move(msg.intParam1, 0);
+      return;
+    case NetworkMsgType::ROTATE:
+      bot.mirror.Rotate();
+      return;
+    case NetworkMsgType::MOVE_DOWN:
+      if (msg.intParam1)
+        bot.mirror.Move(0, 1); // Soft drop
+      else
+        bot.mirror.Tick();
+      return;
+    case NetworkMsgType::STATE_HASH: {
+      bool pending = bot.desync.IsResyncPending();
+      if (bot.desync.CheckRemote(bot.mirror, msg.intParam1, msg.hashParam) ==
+              DesyncDetector::Result::MISMATCH &&
+          !pending) {
+        stats.desyncs++;
+        Metrics::Get().Add(Metrics::DESYNCS);
+      }
+      return;
+    }
+    case NetworkMsgType::PING: // Same echo as Game::ApplyNetworkMessage
+      if (msg.intParam1)
+        Metrics::Get().Observe(Metrics::RTT, now - msg.stampMs);
+      else if (msg.stampMs >= 0)
+        SendText(bot, NetworkProtocol::SerializePingEcho(msg.stampMs), now);
+      return;
+    case NetworkMsgType::SYNC_STATE:
+    case NetworkMsgType::HASH_HISTORY_REQ:
+      return; // Counted above; the mirror is driven by inputs only
+    default:
+      break;
+    }
+
+    if (line.compare(0, 12, "CLIENT_READY") == 0) {
+      if (bot.isHost && bot.state == BotState::LOBBY) {
+        int seed = (int)(bot.rng() & 0x7FFFFFFF);
+        uint64_t session = ((uint64_t)bot.rng() << 32) | bot.rng() | 1;
+        SendText(bot,
+                 NetworkProtocol::SerializeGameStart(
+                     seed, session, "bot" + std::to_string(bot.id)),
+                 now);
+        stats.latency[CAT_MATCH_WAIT].Record(now - bot.lobbySinceUs);
+        StartMatch(bot, seed, now);
+      }
+    } else if (line.compare(0, 11, "PLAYER_DEAD") == 0) {
+      bot.peerDead = true;
+      if (bot.isHost)
+        MaybeFinishP2P(bot, now);
+    } else if (line.compare(0, 9, "GAME_OVER") == 0) {
+      if (bot.state == BotState::PLAYING)
+        stats.matchesCompleted++;
+      Close(bot, now, false);
+    }
+  }
+
+  // Same feed as Game::ValidateClientMessage
+  void Validate(Bot &bot, const NetworkMessage &msg) {
+    switch (msg.type) {
+    case NetworkMsgType::MOVE_LR:
+      validator.Input(bot.validation, msg.intParam1 < 0 ? 'L' : 'R');
+      break;
+    case NetworkMsgType::ROTATE:
+      validator.Input(bot.validation, 'U');
+      break;
+    case NetworkMsgType::MOVE_DOWN:
+      validator.Input(bot.validation, msg.intParam1 ? 'D' : 'G');
+      break;
+    case NetworkMsgType::STATE_HASH:
+      validator.ClaimHash(bot.validation, msg.intParam1, msg.hashParam);
+      break;
+    case NetworkMsgType::SYNC_STATE: {
+      int score = 0;
+      size_t boardPos = msg.payload.find("BOARD:");
+      size_t scorePos = msg.payload.find("SCORE:");
+      if (boardPos != std::string::npos && scorePos != std::string::npos &&
+          sscanf(msg.payload.c_str() + scorePos, "SCORE:%d", &score) == 1)
+        validator.ClaimState(bot.validation, -1, score,
+                             msg.payload.substr(boardPos + 6));
+      break;
+    }
+    default:
+      break;
+    }
+  }
+
+  // p2p host ends the match once both boards are done
+  void MaybeFinishP2P(Bot &bot, int64_t now) {
+    if (!bot.selfDead || !bot.peerDead)
+      return;
+    if (bot.validation) {
+      finishedValidations.push_back(bot.validation);
+      bot.validation = 0;
+    }
+    SendText(bot,
+             "GAME_OVER;P1_SCORE:" + std::to_string(bot.self.score) +
+                 ";P2_SCORE:" + std::to_string(bot.mirror.score),
+             now);
+    stats.matchesCompleted++;
+    // The client closes on GAME_OVER; we close when we see its FIN
+    bot.state = BotState::LOBBY;
+  }
+
+  // ---------------------------------------------------------------- hub --
+
+  bool ReceiveHub(Bot &bot, const char *data, size_t len, int64_t now) {
+    if (bot.state == BotState::HANDSHAKE) {
+      bot.in.append(data, len);
+      size_t headerEnd = bot.in.find("\r\n\r\n");
+      if (headerEnd == std::string::npos)
+        return true;
+      std::string head = bot.in.substr(0, headerEnd + 4);
+      if (head.find(" 101 ") == std::string::npos ||
+          WebSocket::FindHeader(head, "Sec-WebSocket-Accept") !=
+              WebSocket::ComputeAcceptKey(bot.wsKey)) {
+        stats.connectErrors++;
+        Close(bot, now, false);
+        return false;
+      }
+      stats.latency[CAT_CONNECT].Record(now - bot.connectStartUs);
+      bot.ws.Feed(bot.in.data() + headerEnd + 4, bot.in.size() - headerEnd - 4);
+      bot.in.clear();
+      EnterLobby(bot, now);
+      char buf[128];
+      HubJson::Writer writer(buf, sizeof(buf));
+      std::string name = "bot" + std::to_string(bot.id);
+      writer.BeginMessage("join_game")
+          .BeginObject()
+          .Key("name")
+          .String(name)
+          .Key("attackMode")
+          .String("garbage")
+          .EndObject()
+          .EndMessage();
+      SendHub(bot, writer, now);
+    } else {
+      bot.ws.Feed(data, len);
+    }
+
+    uint8_t opcode;
+    std::string payload;
+    while (bot.fd >= 0) {
+      WebSocket::FrameDecoder::Status status = bot.ws.Next(opcode, payload);
+      if (status == WebSocket::FrameDecoder::Status::NEED_MORE)
+        return true;
+      if (status == WebSocket::FrameDecoder::Status::ERROR) {
+        stats.protocolErrors++;
+        Close(bot, now, true);
+        return false;
+      }
+      if (opcode == WebSocket::OP_PING) {
+        SendFrame(bot, WebSocket::OP_PONG, payload, now);
+      } else if (opcode == WebSocket::OP_CLOSE) {
+        Close(bot, now, bot.state == BotState::PLAYING);
+        return false;
+      } else if (opcode == WebSocket::OP_TEXT ||
+                 opcode == WebSocket::OP_BINARY) {
+        HandleHub(bot, payload, now);
+      }
+    }
+    return false;
+  }
+
+  void HandleHub(Bot &bot, const std::string &json, int64_t now) {
+    stats.msgsRecv++;
+    Metrics::Get().CountMessage(true, NetworkMsgType::UNKNOWN, json.size());
+    HubJson::MessageView msg;
+    if (!HubJson::ParseMessage(json, msg)) {
+      stats.protocolErrors++;
+      return;
+    }
+    std::string_view raw, value;
+    switch (msg.type) {
+    case HubJson::MsgType::GAME_START:
+      stats.latency[CAT_MATCH_WAIT].Record(now - bot.lobbySinceUs);
+      if (HubJson::FindMember(msg.payload, "matchId", raw) &&
+          HubJson::AsString(raw, value))
+        StartMatch(bot, SeedFromMatchId(value), now);
+      else
+        StartMatch(bot, 0, now);
+      break;
+    case HubJson::MsgType::GAME_STATE: {
+      long long ts = 0;
+      if (HubJson::FindMember(msg.payload, "ts", raw) &&
+          HubJson::AsInt(raw, ts))
+        stats.latency[CAT_HUB_STATE].Record(now - ts);
+      break;
+    }
+    case HubJson::MsgType::GAME_OVER:
+      bot.peerDead = true;
+      MaybeFinishHub(bot, now);
+      break;
+    case HubJson::MsgType::PLAYER_LEFT:
+      stats.peerLeft++;
+      Close(bot, now, false);
+      break;
+    default:
+      break; // waiting_for_opponent, room_status, ...
+    }
+  }
+
+  void SendFrame(Bot &bot, uint8_t opcode, const std::string &payload,
+                 int64_t now) {
+    bot.out += WebSocket::EncodeFrame(opcode, payload.data(), payload.size(),
+                                      (uint32_t)bot.rng() | 1);
+    Flush(bot, now);
+  }
+
+  void SendHub(Bot &bot, const HubJson::Writer &writer, int64_t now) {
+    if (!writer.Ok() || bot.fd < 0)
+      return;
+    stats.msgsSent++;
+    Metrics::Get().CountMessage(false, NetworkMsgType::UNKNOWN,
+                                writer.Size());
+    bot.out += WebSocket::EncodeFrame(WebSocket::OP_TEXT, writer.Data(),
+                                      writer.Size(), (uint32_t)bot.rng() | 1);
+    Flush(bot, now);
+  }
+
+  // Same shape as Game::SendHubGameState plus a send timestamp (bots share
+  // one clock, so the receiving bot can measure hub relay latency)
+  void SendHubGameState(Bot &bot, int64_t now) {
+    char buf[1024];
+    HubJson::Writer writer(buf, sizeof(buf));
+    writer.BeginMessage("game_state").BeginObject().Key("grid").BeginArray();
+    for (int r = 0; r < BOARD_HEIGHT; r++) {
+      writer.BeginArray();
+      for (int c = 0; c < BOARD_WIDTH; c++)
+        writer.Int(bot.self.board.GetCell(r, c));
+      writer.EndArray();
+    }
+    writer.EndArray()
+        .Key("score")
+        .Int(bot.self.score)
+        .Key("ts")
+        .Int(now)
+        .EndObject()
+        .EndMessage();
+    SendHub(bot, writer, now);
+  }
+
+  void MaybeFinishHub(Bot &bot, int64_t now) {
+    if (bot.state != BotState::PLAYING || !bot.selfDead || !bot.peerDead)
+      return;
+    stats.matchesCompleted++;
+    Close(bot, now, false);
+  }
+
+  // ------------------------------------------------------------- playing --
+
+  void StartMatch(Bot &bot, int seed, int64_t now) {
+    if (bot.isHost && opt.mode == Mode::P2P) {
+      if (bot.validation)
+        validator.EndMatch(bot.validation);
+      bot.validation = validator.StartMatch(seed);
+    }
+    bot.self.Reset(seed);
+    bot.mirror.Reset(seed);
+    bot.desync.Reset();
+    bot.selfDead = false;
+    bot.peerDead = false;
+    bot.state = BotState::PLAYING;
+    bot.nextActionUs = now + ActionDelay(bot);
+    bot.nextGravityUs = now + (int64_t)opt.gravityMs * 1000;
+    bot.nextPingUs = now + 1000000;
+    bot.matchEndUs = now + (int64_t)opt.matchSeconds * 1000000;
+    stats.matchesStarted++;
+  }
+
+  // Exponential-ish spacing around the configured APM
+  int64_t ActionDelay(Bot &bot) {
+    int64_t mean = 60000000LL / (opt.apm > 0 ? opt.apm : 1);
+    return mean / 2 + (int64_t)(bot.rng() % (uint32_t)mean);
+  }
+
+  void Timers(Bot &bot, int64_t now) {
+    switch (bot.state) {
+    case BotState::IDLE:
+      if (!bot.isHost && now >= bot.reconnectAt)
+        StartConnect(bot, now);
+      return;
+    case BotState::CONNECTING:
+    case BotState::HANDSHAKE:
+      if (now - bot.connectStartUs > 10000000) {
+        stats.timeouts++;
+        Close(bot, now, false);
+      }
+      return;
+    case BotState::LOBBY:
+      if (bot.fd >= 0 && now - bot.lobbySinceUs > 60000000) {
+        stats.timeouts++; // Nobody started a match with us
+        Close(bot, now, false);
+      }
+      return;
+    case BotState::PLAYING:
+      Play(bot, now);
+      return;
+    }
+  }
+
+  void Play(Bot &bot, int64_t now) {
+    bool hub = opt.mode == Mode::HUB;
+    if (!bot.selfDead) {
+      if (now >= bot.nextActionUs) {
+        uint32_t r = bot.rng() % 20;
+        if (r < 7) {
+          bot.self.Move(-1, 0);
+          if (!hub)
+            SendText(bot, NetworkProtocol::SerializeMoveLR(-1), now);
+        } else if (r < 14) {
+          bot.self.Move(1, 0);
+          if (!hub)
+            SendText(bot, NetworkProtocol::SerializeMoveLR(1), now);
+        } else {
+          bot.self.Rotate();
+          if (!hub)
+            SendText(bot, "ROTATE", now);
+        }
+        bot.nextActionUs = now + ActionDelay(bot);
+      }
+      if (bot.fd >= 0 && now >= bot.nextGravityUs) {
+        int spawns = bot.self.spawnCounter;
+        bot.self.Tick();
+        if (!hub)
+          SendText(bot, "MOVE_DOWN", now);
+        if (bot.self.spawnCounter > spawns) {
+          if (hub)
+            SendHubGameState(bot, now);
+          else
+            SendText(bot,
+                     NetworkProtocol::SerializeSyncState(
+                         bot.self.score, (int)bot.self.nextPiece.type,
+                         BoardToString(bot.self)),
+                     now);
+        }
+        bot.nextGravityUs = now + (int64_t)opt.gravityMs * 1000;
+      }
+      if (bot.fd >= 0 && !hub && bot.desync.ShouldReport(bot.self))
+        SendText(bot,
+                 NetworkProtocol::SerializeStateHash(
+                     bot.self.stepCounter,
+                     bot.self.GetStepHash(bot.self.stepCounter)),
+                 now);
+      if (bot.fd >= 0 && (bot.self.isGameOver || now >= bot.matchEndUs)) {
+        bot.selfDead = true;
+        if (hub) {
+          char buf[64];
+          HubJson::Writer writer(buf, sizeof(buf));
+          writer.BeginObject().Key("type").String("game_over").EndObject();
+          SendHub(bot, writer, now);
+          MaybeFinishHub(bot, now);
+        } else {
+          SendText(bot, "PLAYER_DEAD;ID:1", now);
+          if (bot.isHost)
+            MaybeFinishP2P(bot, now);
+        }
+      }
+    }
+    if (bot.fd < 0 || bot.state != BotState::PLAYING)
+      return;
+    if (!hub && now >= bot.nextPingUs) {
+      SendText(bot, NetworkProtocol::SerializePing(now), now);
+      bot.nextPingUs = now + 1000000;
+    }
+    if (now > bot.matchEndUs + 30000000) {
+      stats.timeouts++; // Opponent never finished
+      Close(bot, now, false);
+    }
+  }
+};
+
+// ------------------------------------------------------------------ main --
+
+std::atomic<bool> stopRequested(false);
+
+void OnSignal(int) { stopRequested = true; }
+
+void PrintUsage() {
+  printf("Usage: tetris_loadgen [options]\n"
+         "  --mode p2p|host|hub   Target (default p2p)\n"
+         "  --addr IP             Host/hub address (default 127.0.0.1)\n"
+         "  --port N              Default 12345 (host), 8080 (hub)\n"
+         "  --clients N           Number of bots (default 1000)\n"
+         "  --threads N           Event-loop threads (default 4)\n"
+         "  --duration S          Run time in seconds (default 30)\n"
+         "  --apm N               Moves per minute per bot (default 150)\n"
+         "  --gravity-ms N        Gravity tick interval (default 500)\n"
+         "  --match-seconds S     Max match length (default 60)\n"
+         "  --ramp N              New connections per second (default 500)\n"
+         "  --metrics-port N      Serve Prometheus metrics on 127.0.0.1:N\n");
+}
+
+bool ParseArgs(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    auto needValue = [&]() {
+      if (!value) {
+        fprintf(stderr, "Missing value for %s\n", arg.c_str());
+        return false;
+      }
+      i++;
+      return true;
+    };
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      exit(0);
+    } else if (arg == "--mode") {
+      if (!needValue())
+        return false;
+      std::string mode = value;
+      if (mode == "p2p")
+        opt.mode = Mode::P2P;
+      else if (mode == "host")
+        opt.mode = Mode::HOST;
+      else if (mode == "hub")
+        opt.mode = Mode::HUB;
+      else
+        return false;
+    } else if (arg == "--addr") {
+      if (!needValue())
+        return false;
+      opt.addr = value;
+    } else if (arg == "--port" || arg == "--clients" || arg == "--threads" ||
+               arg == "--duration" || arg == "--apm" ||
+               arg == "--gravity-ms" || arg == "--match-seconds" ||
+               arg == "--ramp" || arg == "--metrics-port") {
+      if (!needValue())
+        return false;
+      int n = atoi(value);
+      if (n <= 0)
+        return false;
+      if (arg == "--port")
+        opt.port = n;
+      else if (arg == "--clients")
+        opt.clients = n;
+      else if (arg == "--threads")
+        opt.threads = n;
+      else if (arg == "--duration")
+        opt.durationSeconds = n;
+      else if (arg == "--apm")
+        opt.apm = n;
+      else if (arg == "--gravity-ms")
+        opt.gravityMs = n;
+      else if (arg == "--match-seconds")
+        opt.matchSeconds = n;
+      else if (arg == "--metrics-port")
+        opt.metricsPort = n;
+      else
+        opt.rampPerSecond = n;
+    } else {
+      fprintf(stderr, "Unknown option %s\n", arg.c_str());
+      return false;
+    }
+  }
+  if (opt.port == 0)
+    opt.port = opt.mode == Mode::HUB ? 8080 : 12345;
+  if (opt.mode == Mode::P2P && opt.clients % 2)
+    opt.clients++; // Host/client pairs
+  return true;
+}
+
+void RaiseFdLimit() {
+  rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+void PrintReport(const Stats &s, double seconds) {
+  printf("\n=== Load report (%.1fs) ===\n", seconds);
+  printf("matches: started %llu (bot-side), completed %llu\n",
+         (unsigned long long)s.matchesStarted,
+         (unsigned long long)s.matchesCompleted);
+  printf("messages: sent %llu (%.0f/s), received %llu (%.0f/s)\n",
+         (unsigned long long)s.msgsSent, s.msgsSent / seconds,
+         (unsigned long long)s.msgsRecv, s.msgsRecv / seconds);
+  printf("bytes: sent %llu (%.1f KB/s), received %llu (%.1f KB/s)\n",
+         (unsigned long long)s.bytesSent, s.bytesSent / seconds / 1024.0,
+         (unsigned long long)s.bytesRecv, s.bytesRecv / seconds / 1024.0);
+  printf("latency:\n");
+  for (int i = 0; i < CAT_COUNT; i++) {
+    if (s.latency[i].Count() == 0)
+      continue;
+    char line[192];
+    s.latency[i].Format(line, sizeof(line));
+    printf("  %-11s %s\n", CATEGORY_NAMES[i], line);
+  }
+  double attempts = s.connectAttempts ? (double)s.connectAttempts : 1.0;
+  double messages = s.msgsRecv ? (double)s.msgsRecv : 1.0;
+  printf("errors:\n");
+  printf("  connect failures %llu (%.2f%% of %llu attempts)\n",
+         (unsigned long long)s.connectErrors, 100.0 * s.connectErrors / attempts,
+         (unsigned long long)s.connectAttempts);
+  printf("  disconnects mid-match %llu, timeouts %llu, peer left %llu\n",
+         (unsigned long long)s.disconnects, (unsigned long long)s.timeouts,
+         (unsigned long long)s.peerLeft);
+  printf("  protocol errors %llu, desyncs %llu (%.3f per 1k messages)\n",
+         (unsigned long long)s.protocolErrors, (unsigned long long)s.desyncs,
+         1000.0 * (s.protocolErrors + s.desyncs) / messages);
+  if (s.matchesValidated > 0)
+    printf("validation: %llu matches, %llu claims checked, %llu flagged; "
+           "worker CPU %.3f%% of a core (%.0fus per match)\n",
+           (unsigned long long)s.matchesValidated,
+           (unsigned long long)s.claimsChecked,
+           (unsigned long long)s.validationFailures,
+           100.0 * s.validatorSeconds / seconds,
+           1e6 * s.validatorSeconds / (double)s.matchesValidated);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!ParseArgs(argc, argv, opt)) {
+    PrintUsage();
+    return 1;
+  }
+  signal(SIGPIPE, SIG_IGN);
+  signal(SIGINT, OnSignal);
+  RaiseFdLimit();
+  MetricsServer metricsServer;
+  if (opt.metricsPort > 0 && !metricsServer.Start(opt.metricsPort))
+    fprintf(stderr, "Cannot serve metrics on port %d\n", opt.metricsPort);
+
+  int threads = opt.threads < opt.clients ? opt.threads : opt.clients;
+  std::vector<std::unique_ptr<EventLoop>> loops;
+  int assigned = 0;
+  for (int t = 0; t < threads; t++) {
+    int count = (opt.clients - assigned) / (threads - t);
+    if (opt.mode == Mode::P2P)
+      count += count % 2; // Keep each pair on one loop
+    if (count > opt.clients - assigned)
+      count = opt.clients - assigned;
+    loops.emplace_back(new EventLoop(opt, assigned, count));
+    assigned += count;
+  }
+
+  const char *modeName =
+      opt.mode == Mode::P2P ? "p2p" : (opt.mode == Mode::HUB ? "hub" : "host");
+  printf("tetris_loadgen: %d bots, %d threads, mode %s", opt.clients, threads,
+         modeName);
+  if (opt.mode != Mode::P2P)
+    printf(" -> %s:%d", opt.addr.c_str(), opt.port);
+  printf(", %ds\n", opt.durationSeconds);
+
+  std::atomic<bool> stopLoops(false);
+  for (auto &loop : loops) {
+    if (!loop->Start(stopLoops)) {
+      fprintf(stderr, "Failed to start event loop\n");
+      stopLoops = true;
+      for (auto &started : loops)
+        started->Join();
+      return 1;
+    }
+  }
+
+  int64_t start = NowUs();
+  int64_t end = start + (int64_t)opt.durationSeconds * 1000000;
+  uint64_t lastSent = 0;
+  while (!stopRequested && NowUs() < end) {
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    Stats total;
+    for (auto &loop : loops)
+      total.Merge(loop->Snapshot());
+    Metrics::Get().Set(Metrics::SESSIONS_ACTIVE, opt.mode == Mode::P2P
+                                                     ? total.playing / 2
+                                                     : total.playing);
+    printf("[%5.1fs] connected %d playing %d matches %llu msgs/s %llu "
+           "errors %llu\n",
+           (NowUs() - start) / 1e6, total.connected, total.playing,
+           (unsigned long long)total.matchesCompleted,
+           (unsigned long long)(total.msgsSent - lastSent),
+           (unsigned long long)(total.connectErrors + total.disconnects +
+                                total.protocolErrors + total.timeouts));
+    fflush(stdout);
+    lastSent = total.msgsSent;
+  }
+
+  stopLoops = true;
+  Stats total;
+  for (auto &loop : loops) {
+    loop->Join();
+    total.Merge(loop->Snapshot());
+  }
+  PrintReport(total, (NowUs() - start) / 1e6);
+  return 0;
+}
@@ -0,0 +1,280 @@
+// NetworkManager microbenchmark: a host/client pair over loopback TCP (or
+// another backend, --transport).
+// Measures what the game actually pays per message: SendMessageStr framing,
+// the reader thread's pendingData split, the queueMutex handoff and the
+// PollMessages copy.
+//
+//   tetris_netbench                       # full matrix, defaults
+//   tetris_netbench --sizes 32,512 --count 50000 --poll-us 16000
+//
+// Each message carries its send time, so the receiver records
+// enqueue-to-poll latency. Global operator new is counted to report heap
+// allocations per message (both threads, sender and reader).
+
+#include "../latency_histogram.h"
+#include "../network_manager.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+std::atomic<uint64_t> allocationCount(0);
+} // namespace
+
+void *operator new(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+enum class Pattern {
+  PING_PONG, // One in flight: pure latency
+  BURST,     // `burst` back to back, then wait for all of them
+  FLOOD,     // Send as fast as possible: throughput
+};
+
+const char *PatternName(Pattern p) {
+  switch (p) {
+  case Pattern::PING_PONG:
+    return "pingpong";
+  case Pattern::BURST:
+    return "burst";
+  default:
+    return "flood";
+  }
+}
+
+struct Options {
+  TransportKind transport = TransportKind::TCP;
+  int port = 23456;
+  int count = 100000;         // Messages per run
+  std::vector<int> sizes = {24, 64, 256, 1024};
+  int burst = 64;
+  int pollIntervalUs = 0;     // 0: spin; 16000 ~ polling once per frame
+};
+
+struct Result {
+  LatencyHistogram latency;
+  double seconds = 0;
+  uint64_t bytes = 0;
+  uint64_t allocations = 0;
+};
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// "<sendNs>;xxxx..." padded to `size` bytes (never contains '\n')
+std::string MakePayload(int64_t sendNs, int size) {
+  char head[32];
+  int n = snprintf(head, sizeof(head), "%lld;", (long long)sendNs);
+  std::string msg(head, (size_t)n);
+  if ((int)msg.size() < size)
+    msg.append((size_t)(size - (int)msg.size()), 'x');
+  return msg;
+}
+
+class Bench {
+public:
+  explicit Bench(const Options &options) : opt(options) {}
+
+  bool Connect() {
+    host.SetTransport(opt.transport);
+    client.SetTransport(opt.transport);
+    if (!host.StartHost(opt.port)) {
+      fprintf(stderr, "netbench: cannot listen on port %d\n", opt.port);
+      return false;
+    }
+    client.SetConnectOptions(2000, 1, 0);
+    client.ConnectClient("127.0.0.1", opt.port);
+    // The host waits briefly for a WebSocket upgrade before going live
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!(client.IsConnected() && host.IsConnected())) {
+      if (std::chrono::steady_clock::now() > deadline ||
+          client.GetConnectStatus() == NetworkManager::ConnectStatus::FAILED) {
+        fprintf(stderr, "netbench: connect failed: %s\n",
+                client.GetConnectError());
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return true;
+  }
+
+  // False if the run stalled (messages lost or the link dropped)
+  bool Run(Pattern pattern, int size, Result &result) {
+    received = 0;
+    done = false;
+    uint64_t allocationsBefore = allocationCount.load();
+    int64_t start = NowNs();
+
+    std::thread sender([&]() {
+      for (int sent = 0; sent < opt.count;) {
+        int batch = pattern == Pattern::PING_PONG ? 1
+                    : pattern == Pattern::BURST   ? opt.burst
+                                                  : opt.count;
+        if (batch > opt.count - sent)
+          batch = opt.count - sent;
+        for (int i = 0; i < batch; i++)
+          client.SendMessageStr(MakePayload(NowNs(), size));
+        sent += batch;
+        if (pattern != Pattern::FLOOD) {
+          // Block rather than spin so the reader thread gets the CPU
+          std::unique_lock<std::mutex> lock(progressMutex);
+          progress.wait(lock, [&]() { return received >= sent || done; });
+        }
+        if (done)
+          return;
+      }
+    });
+
+    // The game thread's role: poll, parse, record
+    bool ok = true;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (received < opt.count) {
+      std::vector<std::string> messages = host.PollMessages();
+      int64_t now = NowNs();
+      for (const std::string &msg : messages) {
+        result.latency.Record((now - strtoll(msg.c_str(), nullptr, 10)) /
+                              1000);
+        result.bytes += msg.size() + 1; // '\n' framing on the wire
+      }
+      if (!messages.empty()) {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        received += (int)messages.size();
+        progress.notify_one();
+      }
+      if (!host.IsConnected() || std::chrono::steady_clock::now() > deadline) {
+        fprintf(stderr, "netbench: run stalled at %d/%d messages\n",
+                received.load(), opt.count);
+        ok = false;
+        break;
+      }
+      if (opt.pollIntervalUs > 0)
+        std::this_thread::sleep_for(
+            std::chrono::microseconds(opt.pollIntervalUs));
+      else if (messages.empty())
+        std::this_thread::yield();
+    }
+    {
+      std::lock_guard<std::mutex> lock(progressMutex);
+      done = true;
+      progress.notify_one();
+    }
+    sender.join();
+
+    result.seconds = (NowNs() - start) / 1e9;
+    result.allocations = allocationCount.load() - allocationsBefore;
+    return ok;
+  }
+
+private:
+  const Options &opt;
+  NetworkManager host;
+  NetworkManager client;
+  std::mutex progressMutex; // Wakes the sender in PING_PONG/BURST
+  std::condition_variable progress;
+  std::atomic<int> received{0};
+  bool done = false;
+};
+
+bool ParseSizes(const char *arg, std::vector<int> &out) {
+  out.clear();
+  for (const char *p = arg; *p;) {
+    char *end;
+    long size = strtol(p, &end, 10);
+    if (end == p || size < 24 || size > 65536)
+      return false; // Room for the timestamp header
+    out.push_back((int)size);
+    p = *end == ',' ? end + 1 : end;
+  }
+  return !out.empty();
+}
+
+void PrintUsage() {
+  printf("Usage: tetris_netbench [options]\n"
+         "  --transport T   tcp, loopback or shm (default tcp)\n"
+         "  --port N        Loopback port (default 23456)\n"
+         "  --count N       Messages per run (default 100000)\n"
+         "  --sizes A,B,..  Message sizes in bytes, >= 24 (default "
+         "24,64,256,1024)\n"
+         "  --burst N       Messages per burst (default 64)\n"
+         "  --poll-us N     Sleep between polls; 0 spins (default 0)\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    bool ok = value != nullptr;
+    if (arg == "--transport" && ok)
+      ok = ParseTransportKind(argv[++i], opt.transport);
+    else if (arg == "--port" && ok)
+      opt.port = atoi(argv[++i]);
+    else if (arg == "--count" && ok)
+      opt.count = atoi(argv[++i]);
+    else if (arg == "--sizes" && ok)
+      ok = ParseSizes(argv[++i], opt.sizes);
+    else if (arg == "--burst" && ok)
+      opt.burst = atoi(argv[++i]);
+    else if (arg == "--poll-us" && ok)
+      opt.pollIntervalUs = atoi(argv[++i]);
+    else
+      ok = false;
+    if (!ok || opt.count <= 0 || opt.burst <= 0 || opt.port <= 0) {
+      PrintUsage();
+      return arg == "--help" || arg == "-h" ? 0 : 1;
+    }
+  }
+
+  SetTraceLogLevel(LOG_WARNING);
+  Bench bench(opt);
+  if (!bench.Connect())
+    return 1;
+
+  printf("NetworkManager over %s: %d msgs/run, burst %d, poll %s\n",
+         TransportKindName(opt.transport), opt.count, opt.burst,
+         opt.pollIntervalUs ? "sleeping" : "spinning");
+  printf("%-9s %6s %10s %9s %9s %9s %9s %9s %10s\n", "pattern", "size",
+         "msgs/s", "MB/s", "p50", "p99", "p99.9", "max", "allocs/msg");
+  const Pattern patterns[] = {Pattern::PING_PONG, Pattern::BURST,
+                              Pattern::FLOOD};
+  for (Pattern pattern : patterns) {
+    for (int size : opt.sizes) {
+      Result r;
+      if (!bench.Run(pattern, size, r))
+        return 1; // Leftover messages would skew every later run
+      char p50[24], p99[24], p999[24], max[24];
+      LatencyHistogram::FormatUs(r.latency.Percentile(0.50), p50, sizeof(p50));
+      LatencyHistogram::FormatUs(r.latency.Percentile(0.99), p99, sizeof(p99));
+      LatencyHistogram::FormatUs(r.latency.Percentile(0.999), p999,
+                                 sizeof(p999));
+      LatencyHistogram::FormatUs(r.latency.Max(), max, sizeof(max));
+      double messages = (double)r.latency.Count();
+      printf("%-9s %6d %10.0f %9.1f %9s %9s %9s %9s %10.2f\n",
+             PatternName(pattern), size, messages / r.seconds,
+             r.bytes / r.seconds / (1024.0 * 1024.0), p50, p99, p999, max,
+             messages > 0 ? r.allocations / messages : 0.0);
+      fflush(stdout);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,187 @@
+// Headless thumbnail renderer and benchmark: plays seeded bot games, then
+// renders their final boards (and optionally replay previews) to PNG on
+// the CPU (soft_raster.h, png_writer.h) across all cores. No raylib, no
+// window and no GPU.
+//
+//   tetris_thumbnails --games 10000 --threads 8 --cell 6
+//   tetris_thumbnails --games 20 --replay-frames 8 --out thumbs
+//
+// Reports thumbnails per second and the average file size; with --out the
+// files are written as board-N.png and replay-N.png.
+
+#include "../logic.h"
+#include "../thumbnail_batch.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  int games = 1000;
+  int threads = 0;      // 0: one per core
+  int cellSize = 6;     // Pixels
+  int maxSteps = 3000;  // Bots stop (as if topped out) after this many
+  int replayFrames = 0; // 0: final boards only
+  std::string outDir;   // Empty: nothing written
+};
+
+struct Game {
+  int seed = 0;
+  Logic logic;
+  std::string inputs; // Step codes, as Logic::GetStepInput returns them
+};
+
+double Seconds(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       since)
+      .count();
+}
+
+// The load generator's bot: random shifts and rotations, a gravity tick
+// every few actions
+void PlayBot(Game &game, int maxSteps) {
+  std::mt19937 rng(0x9E3779B9u * (uint32_t)(game.seed + 1));
+  game.logic.Reset(game.seed);
+  game.inputs.clear();
+  while (!game.logic.isGameOver && game.logic.stepCounter < maxSteps) {
+    uint32_t r = rng() % 20;
+    if (r < 5)
+      game.logic.Move(-1, 0);
+    else if (r < 10)
+      game.logic.Move(1, 0);
+    else if (r < 13)
+      game.logic.Rotate();
+    else
+      game.logic.Tick();
+    game.inputs += game.logic.GetStepInput(game.logic.stepCounter);
+  }
+}
+
+bool WriteFile(const std::string &path, const std::string &data) {
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f)
+    return false;
+  bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+  return fclose(f) == 0 && ok;
+}
+
+void Report(const char *what, const std::vector<std::string> &pngs,
+            int rendered, double seconds) {
+  size_t bytes = 0;
+  for (const std::string &png : pngs)
+    bytes += png.size();
+  printf("%-7s %d in %.3fs: %.0f/s, %.0f bytes each\n", what, rendered,
+         seconds, rendered / seconds,
+         rendered ? (double)bytes / rendered : 0.0);
+}
+
+int WriteAll(const Options &opt, const char *prefix,
+             const std::vector<std::string> &pngs) {
+  int failed = 0;
+  for (size_t i = 0; i < pngs.size(); i++) {
+    std::string path = opt.outDir + "/" + prefix + "-" + std::to_string(i) +
+                       ".png";
+    if (!pngs[i].empty() && !WriteFile(path, pngs[i])) {
+      fprintf(stderr, "Cannot write %s\n", path.c_str());
+      failed++;
+    }
+  }
+  return failed;
+}
+
+void PrintUsage() {
+  printf("Usage: tetris_thumbnails [options]\n"
+         "  --games N            Bot games to play and render (default "
+         "1000)\n"
+         "  --threads N          Render threads (default: one per core)\n"
+         "  --cell N             Cell size in pixels (default 6)\n"
+         "  --max-steps N        Steps before a bot stops (default 3000)\n"
+         "  --replay-frames N    Also render N-frame replay previews\n"
+         "  --out DIR            Write the PNG files to DIR\n");
+}
+
+bool ParseArgs(int argc, char **argv, Options &opt) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (arg == "--help" || arg == "-h") {
+      PrintUsage();
+      exit(0);
+    }
+    if (!value) {
+      fprintf(stderr, "Missing value for %s\n", arg.c_str());
+      return false;
+    }
+    i++;
+    if (arg == "--games")
+      opt.games = atoi(value);
+    else if (arg == "--threads")
+      opt.threads = atoi(value);
+    else if (arg == "--cell")
+      opt.cellSize = atoi(value);
+    else if (arg == "--max-steps")
+      opt.maxSteps = atoi(value);
+    else if (arg == "--replay-frames")
+      opt.replayFrames = atoi(value);
+    else if (arg == "--out")
+      opt.outDir = value;
+    else {
+      fprintf(stderr, "Unknown option %s\n", arg.c_str());
+      return false;
+    }
+  }
+  return opt.games > 0 && opt.cellSize > 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opt;
+  if (!ParseArgs(argc, argv, opt)) {
+    PrintUsage();
+    return 1;
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<Game> games(opt.games);
+  for (int i = 0; i < opt.games; i++) {
+    games[i].seed = i + 1;
+    PlayBot(games[i], opt.maxSteps);
+  }
+  printf("played  %d bot games in %.3fs\n", opt.games, Seconds(start));
+
+  ThumbnailBatch batch(opt.threads);
+  SoftPalette palette = SoftPalette::Classic();
+  std::vector<std::string> boards;
+  start = std::chrono::steady_clock::now();
+  int rendered = batch.Render(
+      opt.games,
+      [&](int i, SoftRaster &raster) {
+        raster.RenderLogic(games[i].logic, opt.cellSize, false, palette);
+        return true;
+      },
+      boards);
+  Report("boards", boards, rendered, Seconds(start));
+  int failed = opt.outDir.empty() ? 0 : WriteAll(opt, "board", boards);
+
+  if (opt.replayFrames > 0) {
+    std::vector<std::string> replays;
+    start = std::chrono::steady_clock::now();
+    rendered = batch.Render(
+        opt.games,
+        [&](int i, SoftRaster &raster) {
+          return raster.RenderReplay(games[i].seed, games[i].inputs,
+                                     opt.replayFrames, opt.cellSize, palette);
+        },
+        replays);
+    Report("replays", replays, rendered, Seconds(start));
+    if (!opt.outDir.empty())
+      failed += WriteAll(opt, "replay", replays);
+  }
+  printf("threads %d\n", batch.Threads());
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,97 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Byte-stream transports under NetworkManager. Everything above this layer
+// (line framing, WebSocket frames, connect retries) is shared; a backend
+// only moves bytes between two endpoints:
+//
+//   TCP           - sockets, the only one that reaches other machines,
+//                   browsers or the Go hub
+//   LOOPBACK      - in-process pipe pair keyed by "port" (tests, benches)
+//   SHARED_MEMORY - POSIX shm ring buffers between two local processes
+//
+// Desktop only; the web build talks to the browser's WebSocket directly.
+enum class TransportKind { TCP, LOOPBACK, SHARED_MEMORY };
+
+inline const char *TransportKindName(TransportKind kind) {
+  switch (kind) {
+  case TransportKind::LOOPBACK:
+    return "loopback";
+  case TransportKind::SHARED_MEMORY:
+    return "shm";
+  default:
+    return "tcp";
+  }
+}
+
+// Accepts "tcp", "loopback" and "shm"; false leaves `out` untouched
+inline bool ParseTransportKind(const std::string &name, TransportKind &out) {
+  if (name == "tcp")
+    out = TransportKind::TCP;
+  else if (name == "loopback")
+    out = TransportKind::LOOPBACK;
+  else if (name == "shm")
+    out = TransportKind::SHARED_MEMORY;
+  else
+    return false;
+  return true;
+}
+
+// A connected, bidirectional byte stream. Send/Recv may be called from
+// different threads; Shutdown() may be called from any thread and wakes a
+// blocked Recv/Send.
+class TransportStream {
+public:
+  virtual ~TransportStream() = default;
+
+  // Blocks until all of `len` is queued. Returns len, or -1 once closed.
+  virtual int Send(const char *data, size_t len) = 0;
+
+  // Blocks for at least one byte. Returns the byte count, 0 when the peer
+  // closed, -1 on error, shutdown or an expired receive timeout.
+  virtual int Recv(char *buf, size_t cap) = 0;
+
+  // Like Recv but leaves the bytes queued and waits at most timeoutMs;
+  // 0 when nothing arrived in time.
+  virtual int Peek(char *buf, size_t cap, int timeoutMs) = 0;
+
+  // Bound for subsequent Recv calls; 0 waits forever
+  virtual void SetRecvTimeout(int timeoutMs) = 0;
+
+  virtual void Shutdown() = 0;
+};
+
+class TransportListener {
+public:
+  virtual ~TransportListener() = default;
+
+  // Blocks for the next peer; null once Close() was called
+  virtual std::unique_ptr<TransportStream> Accept() = 0;
+
+  // Wakes a blocked Accept(); safe from any thread
+  virtual void Close() = 0;
+};
+
+class Transport {
+public:
+  virtual ~Transport() = default;
+
+  virtual TransportKind Kind() const = 0;
+
+  // Null with `error` set (static string) if the port cannot be claimed
+  virtual std::unique_ptr<TransportListener> Listen(int port,
+                                                    const char *&error) = 0;
+
+  // Bounded by timeoutMs and gives up early once `running` turns false.
+  // Null with `error` set (static string) on failure.
+  virtual std::unique_ptr<TransportStream>
+  Connect(const std::string &address, int port, int timeoutMs,
+          const std::atomic<bool> &running, const char *&error) = 0;
+};
+
+#endif
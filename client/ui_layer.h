@@ -0,0 +1,109 @@
+#ifndef UI_LAYER_H
+#define UI_LAYER_H
+
+#include "raylib.h"
+#include "rlgl.h"
+#include <cstdint>
+#include <string>
+
+// Identifies everything a cached layer's drawing depends on (FNV-1a over
+// the added values): equal keys mean the cached pixels are still right.
+class UiLayerKey {
+public:
+  UiLayerKey &Add(uint64_t value) {
+    for (int i = 0; i < 8; i++)
+      Byte((uint8_t)(value >> (i * 8)));
+    return *this;
+  }
+  UiLayerKey &Add(const std::string &text) {
+    Add((uint64_t)text.size());
+    for (char c : text)
+      Byte((uint8_t)c);
+    return *this;
+  }
+  uint64_t Get() const { return hash; }
+
+private:
+  void Byte(uint8_t b) {
+    hash ^= b;
+    hash *= 0x100000001b3ull;
+  }
+  uint64_t hash = 0xcbf29ce484222325ull;
+};
+
+// Static UI (backgrounds, frames, buttons, menus, the on-screen keyboard)
+// rendered into a RenderTexture2D and composited as one textured quad.
+// The layer is redrawn only when its key changes or after Invalidate().
+// Without render texture support it draws straight to the screen.
+//
+// Owns GPU resources: create and destroy it while the window is open.
+class UiLayer {
+public:
+  UiLayer(int width, int height) : width(width), height(height) {}
+  UiLayer(const UiLayer &) = delete;
+  UiLayer &operator=(const UiLayer &) = delete;
+  ~UiLayer() { Unload(); }
+
+  void Invalidate() { valid = false; }
+  int GetRedrawCount() const { return redraws; }
+
+  template <typename DrawFn> void Draw(uint64_t key, DrawFn draw) {
+    if (!Load()) {
+      draw();
+      return;
+    }
+    if (!valid || key != cachedKey) {
+      BeginTextureMode(target);
+      ClearBackground(BLANK);
+      // Alpha accumulates like "over" instead of being squared, so the
+      // texture holds premultiplied colors with the right coverage
+      rlSetBlendFactorsSeparate(RL_SRC_ALPHA, RL_ONE_MINUS_SRC_ALPHA, RL_ONE,
+                                RL_ONE_MINUS_SRC_ALPHA, RL_FUNC_ADD,
+                                RL_FUNC_ADD);
+      BeginBlendMode(BLEND_CUSTOM_SEPARATE);
+      draw();
+      EndBlendMode();
+      EndTextureMode();
+      cachedKey = key;
+      valid = true;
+      redraws++;
+    }
+    // Render textures are stored bottom-up
+    Rectangle source = {0, 0, (float)width, -(float)height};
+    BeginBlendMode(BLEND_ALPHA_PREMULTIPLY);
+    DrawTextureRec(target.texture, source, {0, 0}, WHITE);
+    EndBlendMode();
+  }
+
+  void Unload() {
+    if (loaded && target.id > 0)
+      UnloadRenderTexture(target);
+    target = {};
+    loaded = failed = valid = false;
+  }
+
+private:
+  bool Load() {
+    if (loaded || failed)
+      return loaded;
+    target = LoadRenderTexture(width, height);
+    loaded = IsRenderTextureReady(target);
+    if (!loaded) {
+      failed = true;
+      TraceLog(LOG_WARNING, "UI: render texture unavailable, drawing "
+                            "static layers every frame");
+    }
+    return loaded;
+  }
+
+  const int width;
+  const int height;
+  RenderTexture2D target = {};
+  bool loaded = false;
+  bool failed = false;
+  bool valid = false;
+  uint64_t cachedKey = 0;
+  int redraws = 0;
+};
+
+#endif
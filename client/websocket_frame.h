@@ -0,0 +1,307 @@
+#ifndef WEBSOCKET_FRAME_H
+#define WEBSOCKET_FRAME_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Minimal RFC 6455 building blocks shared by the native hub client and the
+// host's WebSocket accept path: opening handshake (SHA-1 + Base64 accept key)
+// and frame encoding/decoding. No sockets in here so it can be unit tested.
+namespace WebSocket {
+
+enum Opcode : uint8_t {
+  OP_CONTINUATION = 0x0,
+  OP_TEXT = 0x1,
+  OP_BINARY = 0x2,
+  OP_CLOSE = 0x8,
+  OP_PING = 0x9,
+  OP_PONG = 0xA,
+};
+
+// Largest header: 2 bytes + 8 byte extended length + 4 byte mask
+const size_t MAX_HEADER_SIZE = 14;
+
+inline void Sha1(const uint8_t *data, size_t len, uint8_t out[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                   0xC3D2E1F0};
+  auto rol = [](uint32_t v, int n) { return (v << n) | (v >> (32 - n)); };
+
+  uint64_t bitLen = (uint64_t)len * 8;
+  size_t total = ((len + 8) / 64 + 1) * 64;
+  uint8_t block[64];
+  for (size_t offset = 0; offset < total; offset += 64) {
+    for (size_t i = 0; i < 64; i++) {
+      size_t idx = offset + i;
+      if (idx < len)
+        block[i] = data[idx];
+      else if (idx == len)
+        block[i] = 0x80;
+      else if (idx >= total - 8)
+        block[i] = (uint8_t)(bitLen >> ((total - 1 - idx) * 8));
+      else
+        block[i] = 0;
+    }
+
+    uint32_t w[80];
+    for (int i = 0; i < 16; i++) {
+      w[i] = ((uint32_t)block[i * 4] << 24) |
+             ((uint32_t)block[i * 4 + 1] << 16) |
+             ((uint32_t)block[i * 4 + 2] << 8) | (uint32_t)block[i * 4 + 3];
+    }
+    for (int i = 16; i < 80; i++)
+      w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+    uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+    for (int i = 0; i < 80; i++) {
+      uint32_t f, k;
+      if (i < 20) {
+        f = (b & c) | (~b & d);
+        k = 0x5A827999;
+      } else if (i < 40) {
+        f = b ^ c ^ d;
+        k = 0x6ED9EBA1;
+      } else if (i < 60) {
+        f = (b & c) | (b & d) | (c & d);
+        k = 0x8F1BBCDC;
+      } else {
+        f = b ^ c ^ d;
+        k = 0xCA62C1D6;
+      }
+      uint32_t temp = rol(a, 5) + f + e + k + w[i];
+      e = d;
+      d = c;
+      c = rol(b, 30);
+      b = a;
+      a = temp;
+    }
+    h[0] += a;
+    h[1] += b;
+    h[2] += c;
+    h[3] += d;
+    h[4] += e;
+  }
+
+  for (int i = 0; i < 5; i++) {
+    out[i * 4] = (uint8_t)(h[i] >> 24);
+    out[i * 4 + 1] = (uint8_t)(h[i] >> 16);
+    out[i * 4 + 2] = (uint8_t)(h[i] >> 8);
+    out[i * 4 + 3] = (uint8_t)h[i];
+  }
+}
+
+inline std::string Base64(const uint8_t *data, size_t len) {
+  static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((len + 2) / 3 * 4);
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t n = (uint32_t)data[i] << 16;
+    if (i + 1 < len)
+      n |= (uint32_t)data[i + 1] << 8;
+    if (i + 2 < len)
+      n |= data[i + 2];
+    out += table[(n >> 18) & 63];
+    out += table[(n >> 12) & 63];
+    out += i + 1 < len ? table[(n >> 6) & 63] : '=';
+    out += i + 2 < len ? table[n & 63] : '=';
+  }
+  return out;
+}
+
+// Sec-WebSocket-Accept value for a given Sec-WebSocket-Key
+inline std::string ComputeAcceptKey(const std::string &key) {
+  std::string src = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+  uint8_t digest[20];
+  Sha1((const uint8_t *)src.data(), src.size(), digest);
+  return Base64(digest, sizeof(digest));
+}
+
+inline std::string BuildClientHandshake(const std::string &host, int port,
+                                        const std::string &path,
+                                        const std::string &key) {
+  return "GET " + path + " HTTP/1.1\r\nHost: " + host + ":" +
+         std::to_string(port) +
+         "\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+         "Sec-WebSocket-Key: " +
+         key + "\r\nSec-WebSocket-Version: 13\r\n\r\n";
+}
+
+inline std::string BuildServerHandshake(const std::string &clientKey) {
+  return "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+         "Connection: Upgrade\r\nSec-WebSocket-Accept: " +
+         ComputeAcceptKey(clientKey) + "\r\n\r\n";
+}
+
+// Case-insensitive lookup of an HTTP header value in a raw request/response
+inline std::string FindHeader(const std::string &head, const char *name) {
+  size_t nameLen = strlen(name);
+  size_t lineStart = 0;
+  while (lineStart < head.size()) {
+    size_t lineEnd = head.find("\r\n", lineStart);
+    if (lineEnd == std::string::npos)
+      lineEnd = head.size();
+    if (lineEnd - lineStart > nameLen && head[lineStart + nameLen] == ':') {
+      bool match = true;
+      for (size_t i = 0; i < nameLen && match; i++) {
+        char a = head[lineStart + i], b = name[i];
+        if (a >= 'A' && a <= 'Z')
+          a += 32;
+        if (b >= 'A' && b <= 'Z')
+          b += 32;
+        match = a == b;
+      }
+      if (match) {
+        size_t v = lineStart + nameLen + 1;
+        while (v < lineEnd && head[v] == ' ')
+          v++;
+        return head.substr(v, lineEnd - v);
+      }
+    }
+    lineStart = lineEnd + 2;
+  }
+  return "";
+}
+
+// Writes a single unfragmented frame header into `out` (at least
+// MAX_HEADER_SIZE bytes) and masks `payload` in place when maskKey != 0.
+// Clients must mask (RFC 6455 5.3), servers must not. Returns header size.
+inline size_t EncodeHeader(uint8_t opcode, size_t payloadLen, uint32_t maskKey,
+                           uint8_t *out) {
+  size_t n = 0;
+  out[n++] = 0x80 | (opcode & 0x0F); // FIN + opcode
+  uint8_t maskBit = maskKey ? 0x80 : 0;
+  if (payloadLen < 126) {
+    out[n++] = maskBit | (uint8_t)payloadLen;
+  } else if (payloadLen <= 0xFFFF) {
+    out[n++] = maskBit | 126;
+    out[n++] = (uint8_t)(payloadLen >> 8);
+    out[n++] = (uint8_t)payloadLen;
+  } else {
+    out[n++] = maskBit | 127;
+    for (int i = 7; i >= 0; i--)
+      out[n++] = (uint8_t)((uint64_t)payloadLen >> (i * 8));
+  }
+  if (maskKey) {
+    out[n++] = (uint8_t)(maskKey >> 24);
+    out[n++] = (uint8_t)(maskKey >> 16);
+    out[n++] = (uint8_t)(maskKey >> 8);
+    out[n++] = (uint8_t)maskKey;
+  }
+  return n;
+}
+
+inline void ApplyMask(uint8_t *data, size_t len, const uint8_t mask[4]) {
+  for (size_t i = 0; i < len; i++)
+    data[i] ^= mask[i & 3];
+}
+
+// Convenience: header + (masked) payload as one contiguous buffer
+inline std::string EncodeFrame(uint8_t opcode, const char *payload, size_t len,
+                               uint32_t maskKey) {
+  uint8_t header[MAX_HEADER_SIZE];
+  size_t headerLen = EncodeHeader(opcode, len, maskKey, header);
+  std::string out((const char *)header, headerLen);
+  out.append(payload, len);
+  if (maskKey) {
+    ApplyMask((uint8_t *)&out[headerLen], len, header + headerLen - 4);
+  }
+  return out;
+}
+
+// Incremental frame decoder. Feed raw bytes; complete messages (fragments
+// reassembled, payload unmasked) are handed out one at a time. The internal
+// buffers are reused across messages so steady state does not allocate.
+class FrameDecoder {
+public:
+  enum class Status { NEED_MORE, MESSAGE, ERROR };
+
+  void Feed(const char *data, size_t len) { buffer.append(data, len); }
+
+  // Pops the next complete message. `outOpcode` is the opcode of the first
+  // fragment (TEXT/BINARY) or the control opcode.
+  Status Next(uint8_t &outOpcode, std::string &outPayload) {
+    while (true) {
+      size_t avail = buffer.size() - readPos;
+      if (avail < 2)
+        return Compact(Status::NEED_MORE);
+      const uint8_t *p = (const uint8_t *)buffer.data() + readPos;
+      bool fin = (p[0] & 0x80) != 0;
+      uint8_t opcode = p[0] & 0x0F;
+      bool masked = (p[1] & 0x80) != 0;
+      uint64_t len = p[1] & 0x7F;
+      size_t headerLen = 2;
+      if (len == 126) {
+        if (avail < 4)
+          return Compact(Status::NEED_MORE);
+        len = ((uint64_t)p[2] << 8) | p[3];
+        headerLen = 4;
+      } else if (len == 127) {
+        if (avail < 10)
+          return Compact(Status::NEED_MORE);
+        len = 0;
+        for (int i = 0; i < 8; i++)
+          len = (len << 8) | p[2 + i];
+        headerLen = 10;
+      }
+      // The limit is per message: endless fragments must not add up past it
+      if (len > MAX_MESSAGE_SIZE ||
+          (opcode == OP_CONTINUATION &&
+           message.size() + len > MAX_MESSAGE_SIZE))
+        return Status::ERROR;
+      size_t maskOffset = headerLen;
+      if (masked)
+        headerLen += 4;
+      if (avail < headerLen + len)
+        return Compact(Status::NEED_MORE);
+
+      uint8_t *payload = (uint8_t *)&buffer[readPos + headerLen];
+      if (masked)
+        ApplyMask(payload, (size_t)len, p + maskOffset);
+      readPos += headerLen + (size_t)len;
+
+      if (opcode >= OP_CLOSE) { // Control frames are never fragmented
+        outOpcode = opcode;
+        outPayload.assign((const char *)payload, (size_t)len);
+        return Status::MESSAGE;
+      }
+      if (opcode != OP_CONTINUATION) {
+        messageOpcode = opcode;
+        message.clear();
+      }
+      message.append((const char *)payload, (size_t)len);
+      if (fin) {
+        outOpcode = messageOpcode;
+        outPayload.swap(message);
+        message.clear();
+        return Status::MESSAGE;
+      }
+    }
+  }
+
+  void Clear() {
+    buffer.clear();
+    message.clear();
+    readPos = 0;
+  }
+
+private:
+  static const uint64_t MAX_MESSAGE_SIZE = 1 << 20;
+
+  Status Compact(Status s) {
+    if (readPos > 0) {
+      buffer.erase(0, readPos);
+      readPos = 0;
+    }
+    return s;
+  }
+
+  std::string buffer;
+  std::string message;
+  size_t readPos = 0;
+  uint8_t messageOpcode = OP_TEXT;
+};
+
+} // namespace WebSocket
+
+#endif
@@ -0,0 +1,1036 @@
+// Generated by cmd/wiregen from schema/wire.schema. DO NOT EDIT.
+//
+// Binary encoders and decoders for the wire messages shared with the Go
+// hub and the web client. The schema describes the encoding and how to
+// evolve it.
+#ifndef WIRE_GEN_H
+#define WIRE_GEN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Wire {
+
+enum class MsgId : uint32_t {
+  UNKNOWN = 0,
+  JOIN_GAME = 1,
+  ROOM_STATUS = 2,
+  WAITING_FOR_OPPONENT = 3,
+  GAME_START = 4,
+  GAME_STATE = 5,
+  ATTACK = 6,
+  GAME_OVER = 7,
+  PAUSE = 8,
+  RESUME = 9,
+  PLAYER_LEFT = 10,
+  MOVE_LR = 32,
+  ROTATE = 33,
+  MOVE_DOWN = 34,
+  GAME_START_HOST = 35,
+  SYNC_STATE = 36,
+  STATE_HASH = 37,
+  HASH_HISTORY_REQ = 38,
+  HASH_HISTORY = 39,
+  RESUME_SESSION = 40,
+  RESUME_OK = 41,
+  RESUME_REJECT = 42,
+  INPUTS = 43,
+  PING = 44,
+};
+
+// Snake-case name; for hub messages also the JSON "type"
+inline const char *MsgName(MsgId id) {
+  switch (id) {
+  case MsgId::JOIN_GAME:
+    return "join_game";
+  case MsgId::ROOM_STATUS:
+    return "room_status";
+  case MsgId::WAITING_FOR_OPPONENT:
+    return "waiting_for_opponent";
+  case MsgId::GAME_START:
+    return "game_start";
+  case MsgId::GAME_STATE:
+    return "game_state";
+  case MsgId::ATTACK:
+    return "attack";
+  case MsgId::GAME_OVER:
+    return "game_over";
+  case MsgId::PAUSE:
+    return "pause";
+  case MsgId::RESUME:
+    return "resume";
+  case MsgId::PLAYER_LEFT:
+    return "player_left";
+  case MsgId::MOVE_LR:
+    return "move_lr";
+  case MsgId::ROTATE:
+    return "rotate";
+  case MsgId::MOVE_DOWN:
+    return "move_down";
+  case MsgId::GAME_START_HOST:
+    return "game_start_host";
+  case MsgId::SYNC_STATE:
+    return "sync_state";
+  case MsgId::STATE_HASH:
+    return "state_hash";
+  case MsgId::HASH_HISTORY_REQ:
+    return "hash_history_req";
+  case MsgId::HASH_HISTORY:
+    return "hash_history";
+  case MsgId::RESUME_SESSION:
+    return "resume_session";
+  case MsgId::RESUME_OK:
+    return "resume_ok";
+  case MsgId::RESUME_REJECT:
+    return "resume_reject";
+  case MsgId::INPUTS:
+    return "inputs";
+  case MsgId::PING:
+    return "ping";
+  default:
+    return "unknown";
+  }
+}
+
+class Writer {
+public:
+  explicit Writer(std::string &out) : out(out) {}
+
+  void Varint(uint64_t value) {
+    while (value >= 0x80) {
+      out += (char)(value | 0x80);
+      value >>= 7;
+    }
+    out += (char)value;
+  }
+
+  void Key(uint32_t tag, int wireType) {
+    Varint((uint64_t)tag << 3 | (uint64_t)wireType);
+  }
+
+  void Bool(uint32_t tag, bool value) {
+    Key(tag, 0);
+    Varint(value ? 1 : 0);
+  }
+
+  // Zigzag: small negative numbers stay short
+  void Int(uint32_t tag, int32_t value) {
+    Key(tag, 0);
+    Varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+  }
+
+  void Uint64(uint32_t tag, uint64_t value) {
+    Key(tag, 0);
+    Varint(value);
+  }
+
+  void Bytes(uint32_t tag, const std::string &value) {
+    Key(tag, 2);
+    Varint(value.size());
+    out += value;
+  }
+
+  void Packed(uint32_t tag, const std::vector<uint64_t> &values) {
+    size_t size = 0;
+    for (uint64_t value : values)
+      size += VarintSize(value);
+    Key(tag, 2);
+    Varint(size);
+    for (uint64_t value : values)
+      Varint(value);
+  }
+
+  static size_t VarintSize(uint64_t value) {
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7)
+      size++;
+    return size;
+  }
+
+private:
+  std::string &out;
+};
+
+class Reader {
+public:
+  Reader() {}
+  Reader(const void *data, size_t len)
+      : pos((const uint8_t *)data), end((const uint8_t *)data + len) {}
+
+  bool Varint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+      uint8_t byte = *pos++;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return Fail();
+  }
+
+  // Next field key. False at the end, or on an error (see Ok()).
+  bool Next(uint32_t &tag, int &wireType) {
+    uint64_t key;
+    if (failed || pos == end || !Varint(key))
+      return false;
+    tag = (uint32_t)(key >> 3);
+    wireType = (int)(key & 7);
+    return tag != 0 || Fail();
+  }
+
+  bool Bool(bool &value) {
+    uint64_t raw;
+    if (!Varint(raw))
+      return false;
+    value = raw != 0;
+    return true;
+  }
+
+  bool Int(int32_t &value) {
+    uint64_t raw;
+    if (!Varint(raw))
+      return false;
+    uint32_t zigzag = (uint32_t)raw;
+    value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+    return true;
+  }
+
+  bool Uint64(uint64_t &value) { return Varint(value); }
+
+  bool Bytes(std::string &value) {
+    Reader sub;
+    if (!Sub(sub))
+      return false;
+    value.assign((const char *)sub.pos, sub.end - sub.pos);
+    return true;
+  }
+
+  bool Packed(std::vector<uint64_t> &values) {
+    Reader sub;
+    if (!Sub(sub))
+      return false;
+    values.clear();
+    uint64_t value;
+    while (sub.pos < sub.end) {
+      if (!sub.Varint(value))
+        return Fail();
+      values.push_back(value);
+    }
+    return true;
+  }
+
+  // A length-delimited value as a reader of its own
+  bool Sub(Reader &sub) {
+    uint64_t len;
+    if (!Varint(len))
+      return false;
+    if (len > (uint64_t)(end - pos))
+      return Fail();
+    sub = Reader(pos, (size_t)len);
+    pos += len;
+    return true;
+  }
+
+  // Fields this build does not know: a newer peer sent them
+  bool Skip(int wireType) {
+    uint64_t value;
+    Reader sub;
+    if (wireType == 0)
+      return Varint(value);
+    if (wireType == 2)
+      return Sub(sub);
+    return Fail();
+  }
+
+  bool Ok() const { return !failed; }
+
+private:
+  bool Fail() {
+    failed = true;
+    return false;
+  }
+
+  const uint8_t *pos = nullptr;
+  const uint8_t *end = nullptr;
+  bool failed = false;
+};
+
+struct HostSettings {
+  std::string attackMode;
+  bool showGhostPiece = false;
+  std::string effectType;
+  bool useCascadeGravity = false;
+  bool allowHoldPiece = true;
+  bool increaseGravity = true;
+};
+
+inline void EncodeFields(Writer &w, const HostSettings &m) {
+  if (!m.attackMode.empty())
+    w.Bytes(1, m.attackMode);
+  if (m.showGhostPiece)
+    w.Bool(2, m.showGhostPiece);
+  if (!m.effectType.empty())
+    w.Bytes(3, m.effectType);
+  if (m.useCascadeGravity)
+    w.Bool(4, m.useCascadeGravity);
+  if (!m.allowHoldPiece)
+    w.Bool(5, m.allowHoldPiece);
+  if (!m.increaseGravity)
+    w.Bool(6, m.increaseGravity);
+}
+
+inline bool DecodeFields(Reader &r, HostSettings &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 2) {
+      ok = r.Bytes(m.attackMode);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Bool(m.showGhostPiece);
+    } else if (tag == 3 && wireType == 2) {
+      ok = r.Bytes(m.effectType);
+    } else if (tag == 4 && wireType == 0) {
+      ok = r.Bool(m.useCascadeGravity);
+    } else if (tag == 5 && wireType == 0) {
+      ok = r.Bool(m.allowHoldPiece);
+    } else if (tag == 6 && wireType == 0) {
+      ok = r.Bool(m.increaseGravity);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct JoinGame {
+  static constexpr MsgId ID = MsgId::JOIN_GAME;
+  std::string name;
+  std::optional<HostSettings> settings;
+};
+
+inline void EncodeFields(Writer &w, const JoinGame &m) {
+  if (!m.name.empty())
+    w.Bytes(1, m.name);
+  if (m.settings) {
+    std::string inner;
+    Writer nested(inner);
+    EncodeFields(nested, *m.settings);
+    w.Bytes(2, inner);
+  }
+}
+
+inline bool DecodeFields(Reader &r, JoinGame &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 2) {
+      ok = r.Bytes(m.name);
+    } else if (tag == 2 && wireType == 2) {
+      Reader sub;
+      m.settings.emplace();
+      ok = r.Sub(sub) && DecodeFields(sub, *m.settings);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct RoomStatus {
+  static constexpr MsgId ID = MsgId::ROOM_STATUS;
+  bool hasHost = false;
+  std::optional<HostSettings> hostSettings;
+};
+
+inline void EncodeFields(Writer &w, const RoomStatus &m) {
+  if (m.hasHost)
+    w.Bool(1, m.hasHost);
+  if (m.hostSettings) {
+    std::string inner;
+    Writer nested(inner);
+    EncodeFields(nested, *m.hostSettings);
+    w.Bytes(2, inner);
+  }
+}
+
+inline bool DecodeFields(Reader &r, RoomStatus &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Bool(m.hasHost);
+    } else if (tag == 2 && wireType == 2) {
+      Reader sub;
+      m.hostSettings.emplace();
+      ok = r.Sub(sub) && DecodeFields(sub, *m.hostSettings);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct WaitingForOpponent {
+  static constexpr MsgId ID = MsgId::WAITING_FOR_OPPONENT;
+};
+
+inline void EncodeFields(Writer &, const WaitingForOpponent &) {}
+
+inline bool DecodeFields(Reader &r, WaitingForOpponent &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+struct GameStart {
+  static constexpr MsgId ID = MsgId::GAME_START;
+  std::string opponentId;
+  std::string opponentName;
+  std::string matchId;
+  std::string attackMode;
+};
+
+inline void EncodeFields(Writer &w, const GameStart &m) {
+  if (!m.opponentId.empty())
+    w.Bytes(1, m.opponentId);
+  if (!m.opponentName.empty())
+    w.Bytes(2, m.opponentName);
+  if (!m.matchId.empty())
+    w.Bytes(3, m.matchId);
+  if (!m.attackMode.empty())
+    w.Bytes(4, m.attackMode);
+}
+
+inline bool DecodeFields(Reader &r, GameStart &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 2) {
+      ok = r.Bytes(m.opponentId);
+    } else if (tag == 2 && wireType == 2) {
+      ok = r.Bytes(m.opponentName);
+    } else if (tag == 3 && wireType == 2) {
+      ok = r.Bytes(m.matchId);
+    } else if (tag == 4 && wireType == 2) {
+      ok = r.Bytes(m.attackMode);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+// cells: one byte per cell, row-major, 10 per row
+struct GameState {
+  static constexpr MsgId ID = MsgId::GAME_STATE;
+  std::string cells;
+  int32_t score = 0;
+  int32_t lines = 0;
+};
+
+inline void EncodeFields(Writer &w, const GameState &m) {
+  if (!m.cells.empty())
+    w.Bytes(1, m.cells);
+  if (m.score != 0)
+    w.Int(2, m.score);
+  if (m.lines != 0)
+    w.Int(3, m.lines);
+}
+
+inline bool DecodeFields(Reader &r, GameState &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 2) {
+      ok = r.Bytes(m.cells);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.score);
+    } else if (tag == 3 && wireType == 0) {
+      ok = r.Int(m.lines);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct Attack {
+  static constexpr MsgId ID = MsgId::ATTACK;
+  int32_t lines = 0;
+};
+
+inline void EncodeFields(Writer &w, const Attack &m) {
+  if (m.lines != 0)
+    w.Int(1, m.lines);
+}
+
+inline bool DecodeFields(Reader &r, Attack &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.lines);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct GameOver {
+  static constexpr MsgId ID = MsgId::GAME_OVER;
+};
+
+inline void EncodeFields(Writer &, const GameOver &) {}
+
+inline bool DecodeFields(Reader &r, GameOver &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+struct Pause {
+  static constexpr MsgId ID = MsgId::PAUSE;
+};
+
+inline void EncodeFields(Writer &, const Pause &) {}
+
+inline bool DecodeFields(Reader &r, Pause &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+struct Resume {
+  static constexpr MsgId ID = MsgId::RESUME;
+};
+
+inline void EncodeFields(Writer &, const Resume &) {}
+
+inline bool DecodeFields(Reader &r, Resume &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+struct PlayerLeft {
+  static constexpr MsgId ID = MsgId::PLAYER_LEFT;
+};
+
+inline void EncodeFields(Writer &, const PlayerLeft &) {}
+
+inline bool DecodeFields(Reader &r, PlayerLeft &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+struct PieceState {
+  int32_t type = 0;
+  int32_t x = 0;
+  int32_t y = 0;
+  int32_t rotation = 0;
+};
+
+inline void EncodeFields(Writer &w, const PieceState &m) {
+  if (m.type != 0)
+    w.Int(1, m.type);
+  if (m.x != 0)
+    w.Int(2, m.x);
+  if (m.y != 0)
+    w.Int(3, m.y);
+  if (m.rotation != 0)
+    w.Int(4, m.rotation);
+}
+
+inline bool DecodeFields(Reader &r, PieceState &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.type);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.x);
+    } else if (tag == 3 && wireType == 0) {
+      ok = r.Int(m.y);
+    } else if (tag == 4 && wireType == 0) {
+      ok = r.Int(m.rotation);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+// stampMs: sender's clock for the jitter buffer, -1 if unknown
+struct MoveLR {
+  static constexpr MsgId ID = MsgId::MOVE_LR;
+  int32_t dir = 0;
+  int32_t stampMs = -1;
+};
+
+inline void EncodeFields(Writer &w, const MoveLR &m) {
+  if (m.dir != 0)
+    w.Int(1, m.dir);
+  if (m.stampMs != -1)
+    w.Int(2, m.stampMs);
+}
+
+inline bool DecodeFields(Reader &r, MoveLR &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.dir);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.stampMs);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct Rotate {
+  static constexpr MsgId ID = MsgId::ROTATE;
+  int32_t stampMs = -1;
+};
+
+inline void EncodeFields(Writer &w, const Rotate &m) {
+  if (m.stampMs != -1)
+    w.Int(1, m.stampMs);
+}
+
+inline bool DecodeFields(Reader &r, Rotate &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.stampMs);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+// soft: Logic::Move(0, 1) rather than a gravity tick
+struct MoveDown {
+  static constexpr MsgId ID = MsgId::MOVE_DOWN;
+  bool soft = false;
+  int32_t stampMs = -1;
+};
+
+inline void EncodeFields(Writer &w, const MoveDown &m) {
+  if (m.soft)
+    w.Bool(1, m.soft);
+  if (m.stampMs != -1)
+    w.Int(2, m.stampMs);
+}
+
+inline bool DecodeFields(Reader &r, MoveDown &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Bool(m.soft);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.stampMs);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct GameStartHost {
+  static constexpr MsgId ID = MsgId::GAME_START_HOST;
+  int32_t seed = 0;
+  uint64_t session = 0;
+  std::string hostName;
+};
+
+inline void EncodeFields(Writer &w, const GameStartHost &m) {
+  if (m.seed != 0)
+    w.Int(1, m.seed);
+  if (m.session != 0)
+    w.Uint64(2, m.session);
+  if (!m.hostName.empty())
+    w.Bytes(3, m.hostName);
+}
+
+inline bool DecodeFields(Reader &r, GameStartHost &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.seed);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Uint64(m.session);
+    } else if (tag == 3 && wireType == 2) {
+      ok = r.Bytes(m.hostName);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+// step and current are only set by a full resync
+struct SyncState {
+  static constexpr MsgId ID = MsgId::SYNC_STATE;
+  int32_t score = 0;
+  int32_t nextType = 0;
+  std::string board;
+  int32_t step = -1;
+  std::optional<PieceState> current;
+};
+
+inline void EncodeFields(Writer &w, const SyncState &m) {
+  if (m.score != 0)
+    w.Int(1, m.score);
+  if (m.nextType != 0)
+    w.Int(2, m.nextType);
+  if (!m.board.empty())
+    w.Bytes(3, m.board);
+  if (m.step != -1)
+    w.Int(4, m.step);
+  if (m.current) {
+    std::string inner;
+    Writer nested(inner);
+    EncodeFields(nested, *m.current);
+    w.Bytes(5, inner);
+  }
+}
+
+inline bool DecodeFields(Reader &r, SyncState &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.score);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.nextType);
+    } else if (tag == 3 && wireType == 2) {
+      ok = r.Bytes(m.board);
+    } else if (tag == 4 && wireType == 0) {
+      ok = r.Int(m.step);
+    } else if (tag == 5 && wireType == 2) {
+      Reader sub;
+      m.current.emplace();
+      ok = r.Sub(sub) && DecodeFields(sub, *m.current);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct StateHash {
+  static constexpr MsgId ID = MsgId::STATE_HASH;
+  int32_t step = 0;
+  uint64_t hash = 0;
+};
+
+inline void EncodeFields(Writer &w, const StateHash &m) {
+  if (m.step != 0)
+    w.Int(1, m.step);
+  if (m.hash != 0)
+    w.Uint64(2, m.hash);
+}
+
+inline bool DecodeFields(Reader &r, StateHash &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.step);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Uint64(m.hash);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct HashHistoryReq {
+  static constexpr MsgId ID = MsgId::HASH_HISTORY_REQ;
+  int32_t fromStep = 0;
+  int32_t toStep = 0;
+};
+
+inline void EncodeFields(Writer &w, const HashHistoryReq &m) {
+  if (m.fromStep != 0)
+    w.Int(1, m.fromStep);
+  if (m.toStep != 0)
+    w.Int(2, m.toStep);
+}
+
+inline bool DecodeFields(Reader &r, HashHistoryReq &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.fromStep);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.toStep);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+// hashes[i] and inputs[i] belong to step fromStep + i
+struct HashHistory {
+  static constexpr MsgId ID = MsgId::HASH_HISTORY;
+  int32_t fromStep = 0;
+  std::vector<uint64_t> hashes;
+  std::string inputs;
+};
+
+inline void EncodeFields(Writer &w, const HashHistory &m) {
+  if (m.fromStep != 0)
+    w.Int(1, m.fromStep);
+  if (!m.hashes.empty())
+    w.Packed(2, m.hashes);
+  if (!m.inputs.empty())
+    w.Bytes(3, m.inputs);
+}
+
+inline bool DecodeFields(Reader &r, HashHistory &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.fromStep);
+    } else if (tag == 2 && wireType == 2) {
+      ok = r.Packed(m.hashes);
+    } else if (tag == 3 && wireType == 2) {
+      ok = r.Bytes(m.inputs);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct ResumeSession {
+  static constexpr MsgId ID = MsgId::RESUME_SESSION;
+  uint64_t session = 0;
+  int32_t ackStep = 0;
+};
+
+inline void EncodeFields(Writer &w, const ResumeSession &m) {
+  if (m.session != 0)
+    w.Uint64(1, m.session);
+  if (m.ackStep != 0)
+    w.Int(2, m.ackStep);
+}
+
+inline bool DecodeFields(Reader &r, ResumeSession &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Uint64(m.session);
+    } else if (tag == 2 && wireType == 0) {
+      ok = r.Int(m.ackStep);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct ResumeOk {
+  static constexpr MsgId ID = MsgId::RESUME_OK;
+  int32_t ackStep = 0;
+};
+
+inline void EncodeFields(Writer &w, const ResumeOk &m) {
+  if (m.ackStep != 0)
+    w.Int(1, m.ackStep);
+}
+
+inline bool DecodeFields(Reader &r, ResumeOk &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.ackStep);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct ResumeReject {
+  static constexpr MsgId ID = MsgId::RESUME_REJECT;
+};
+
+inline void EncodeFields(Writer &, const ResumeReject &) {}
+
+inline bool DecodeFields(Reader &r, ResumeReject &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+// codes[i] is the Logic step code of step fromStep + i
+struct Inputs {
+  static constexpr MsgId ID = MsgId::INPUTS;
+  int32_t fromStep = 0;
+  std::string codes;
+};
+
+inline void EncodeFields(Writer &w, const Inputs &m) {
+  if (m.fromStep != 0)
+    w.Int(1, m.fromStep);
+  if (!m.codes.empty())
+    w.Bytes(2, m.codes);
+}
+
+inline bool DecodeFields(Reader &r, Inputs &m) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType)) {
+    bool ok;
+    if (tag == 1 && wireType == 0) {
+      ok = r.Int(m.fromStep);
+    } else if (tag == 2 && wireType == 2) {
+      ok = r.Bytes(m.codes);
+    } else {
+      ok = r.Skip(wireType);
+    }
+    if (!ok)
+      return false;
+  }
+  return r.Ok();
+}
+
+struct Ping {
+  static constexpr MsgId ID = MsgId::PING;
+};
+
+inline void EncodeFields(Writer &, const Ping &) {}
+
+inline bool DecodeFields(Reader &r, Ping &) {
+  uint32_t tag;
+  int wireType;
+  while (r.Next(tag, wireType))
+    if (!r.Skip(wireType))
+      return false;
+  return r.Ok();
+}
+
+// A whole frame: the message id, then the fields
+template <typename T> std::string Encode(const T &message) {
+  std::string out;
+  Writer writer(out);
+  writer.Varint((uint64_t)T::ID);
+  EncodeFields(writer, message);
+  return out;
+}
+
+// Id of a frame, UNKNOWN if it cannot be read. Ids of messages newer than
+// this build are returned as they are.
+inline MsgId PeekId(const void *data, size_t len) {
+  Reader reader(data, len);
+  uint64_t id;
+  if (!reader.Varint(id) || id > UINT32_MAX)
+    return MsgId::UNKNOWN;
+  return (MsgId)id;
+}
+
+// False for a malformed frame or one that carries another message
+template <typename T> bool Decode(const void *data, size_t len, T &out) {
+  Reader reader(data, len);
+  uint64_t id;
+  if (!reader.Varint(id) || id != (uint64_t)T::ID)
+    return false;
+  out = T();
+  return DecodeFields(reader, out);
+}
+
+template <typename T> bool Decode(const std::string &frame, T &out) {
+  return Decode(frame.data(), frame.size(), out);
+}
+
+} // namespace Wire
+
+#endif
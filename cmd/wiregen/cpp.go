@@ -0,0 +1,413 @@
+package main
+
+import (
+	"fmt"
+	"strings"
+)
+
+// client/wire_gen.h: header-only, namespace Wire, C++17
+
+const cppRuntime = `class Writer {
+public:
+  explicit Writer(std::string &out) : out(out) {}
+
+  void Varint(uint64_t value) {
+    while (value >= 0x80) {
+      out += (char)(value | 0x80);
+      value >>= 7;
+    }
+    out += (char)value;
+  }
+
+  void Key(uint32_t tag, int wireType) {
+    Varint((uint64_t)tag << 3 | (uint64_t)wireType);
+  }
+
+  void Bool(uint32_t tag, bool value) {
+    Key(tag, 0);
+    Varint(value ? 1 : 0);
+  }
+
+  // Zigzag: small negative numbers stay short
+  void Int(uint32_t tag, int32_t value) {
+    Key(tag, 0);
+    Varint(((uint32_t)value << 1) ^ (uint32_t)(value >> 31));
+  }
+
+  void Uint64(uint32_t tag, uint64_t value) {
+    Key(tag, 0);
+    Varint(value);
+  }
+
+  void Bytes(uint32_t tag, const std::string &value) {
+    Key(tag, 2);
+    Varint(value.size());
+    out += value;
+  }
+
+  void Packed(uint32_t tag, const std::vector<uint64_t> &values) {
+    size_t size = 0;
+    for (uint64_t value : values)
+      size += VarintSize(value);
+    Key(tag, 2);
+    Varint(size);
+    for (uint64_t value : values)
+      Varint(value);
+  }
+
+  static size_t VarintSize(uint64_t value) {
+    size_t size = 1;
+    for (; value >= 0x80; value >>= 7)
+      size++;
+    return size;
+  }
+
+private:
+  std::string &out;
+};
+
+class Reader {
+public:
+  Reader() {}
+  Reader(const void *data, size_t len)
+      : pos((const uint8_t *)data), end((const uint8_t *)data + len) {}
+
+  bool Varint(uint64_t &value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < end; shift += 7) {
+      uint8_t byte = *pos++;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return Fail();
+  }
+
+  // Next field key. False at the end, or on an error (see Ok()).
+  bool Next(uint32_t &tag, int &wireType) {
+    uint64_t key;
+    if (failed || pos == end || !Varint(key))
+      return false;
+    tag = (uint32_t)(key >> 3);
+    wireType = (int)(key & 7);
+    return tag != 0 || Fail();
+  }
+
+  bool Bool(bool &value) {
+    uint64_t raw;
+    if (!Varint(raw))
+      return false;
+    value = raw != 0;
+    return true;
+  }
+
+  bool Int(int32_t &value) {
+    uint64_t raw;
+    if (!Varint(raw))
+      return false;
+    uint32_t zigzag = (uint32_t)raw;
+    value = (int32_t)(zigzag >> 1) ^ -(int32_t)(zigzag & 1);
+    return true;
+  }
+
+  bool Uint64(uint64_t &value) { return Varint(value); }
+
+  bool Bytes(std::string &value) {
+    Reader sub;
+    if (!Sub(sub))
+      return false;
+    value.assign((const char *)sub.pos, sub.end - sub.pos);
+    return true;
+  }
+
+  bool Packed(std::vector<uint64_t> &values) {
+    Reader sub;
+    if (!Sub(sub))
+      return false;
+    values.clear();
+    uint64_t value;
+    while (sub.pos < sub.end) {
+      if (!sub.Varint(value))
+        return Fail();
+      values.push_back(value);
+    }
+    return true;
+  }
+
+  // A length-delimited value as a reader of its own
+  bool Sub(Reader &sub) {
+    uint64_t len;
+    if (!Varint(len))
+      return false;
+    if (len > (uint64_t)(end - pos))
+      return Fail();
+    sub = Reader(pos, (size_t)len);
+    pos += len;
+    return true;
+  }
+
+  // Fields this build does not know: a newer peer sent them
+  bool Skip(int wireType) {
+    uint64_t value;
+    Reader sub;
+    if (wireType == 0)
+      return Varint(value);
+    if (wireType == 2)
+      return Sub(sub);
+    return Fail();
+  }
+
+  bool Ok() const { return !failed; }
+
+private:
+  bool Fail() {
+    failed = true;
+    return false;
+  }
+
+  const uint8_t *pos = nullptr;
+  const uint8_t *end = nullptr;
+  bool failed = false;
+};
+`
+
+const cppTail = `// A whole frame: the message id, then the fields
+template <typename T> std::string Encode(const T &message) {
+  std::string out;
+  Writer writer(out);
+  writer.Varint((uint64_t)T::ID);
+  EncodeFields(writer, message);
+  return out;
+}
+
+// Id of a frame, UNKNOWN if it cannot be read. Ids of messages newer than
+// this build are returned as they are.
+inline MsgId PeekId(const void *data, size_t len) {
+  Reader reader(data, len);
+  uint64_t id;
+  if (!reader.Varint(id) || id > UINT32_MAX)
+    return MsgId::UNKNOWN;
+  return (MsgId)id;
+}
+
+// False for a malformed frame or one that carries another message
+template <typename T> bool Decode(const void *data, size_t len, T &out) {
+  Reader reader(data, len);
+  uint64_t id;
+  if (!reader.Varint(id) || id != (uint64_t)T::ID)
+    return false;
+  out = T();
+  return DecodeFields(reader, out);
+}
+
+template <typename T> bool Decode(const std::string &frame, T &out) {
+  return Decode(frame.data(), frame.size(), out);
+}
+`
+
+func upperSnake(name string) string { return strings.ToUpper(SnakeCase(name)) }
+
+func cppType(f *Field) string {
+	switch f.Type {
+	case typeBool:
+		return "bool"
+	case typeInt:
+		return "int32_t"
+	case typeUint64:
+		return "uint64_t"
+	case typeString, typeBytes:
+		return "std::string"
+	case typeUint64s:
+		return "std::vector<uint64_t>"
+	}
+	return "std::optional<" + f.Type + ">"
+}
+
+func cppDefault(f *Field) string {
+	switch f.Type {
+	case typeBool:
+		if f.HasDefault {
+			return f.Default
+		}
+		return "false"
+	case typeInt:
+		if f.HasDefault {
+			return f.Default
+		}
+		return "0"
+	case typeUint64:
+		return "0"
+	}
+	return ""
+}
+
+// Writer and Reader method of a scalar field
+func cppMethod(f *Field) string {
+	switch f.Type {
+	case typeBool:
+		return "Bool"
+	case typeInt:
+		return "Int"
+	case typeUint64:
+		return "Uint64"
+	case typeUint64s:
+		return "Packed"
+	}
+	return "Bytes"
+}
+
+// Condition under which a field is written: anything but its default
+func cppPresent(f *Field) string {
+	name := "m." + f.Name
+	switch f.Type {
+	case typeBool:
+		if f.Default == "true" {
+			return "!" + name
+		}
+		return name
+	case typeInt, typeUint64:
+		return fmt.Sprintf("%s != %s", name, cppDefault(f))
+	case typeString, typeBytes, typeUint64s:
+		return "!" + name + ".empty()"
+	}
+	return name
+}
+
+func GenerateCpp(s *Schema) ([]byte, error) {
+	var e emitter
+	e.line("// Generated by cmd/wiregen from schema/wire.schema. DO NOT EDIT.")
+	e.line("//")
+	e.line("// Binary encoders and decoders for the wire messages shared with " +
+		"the Go")
+	e.line("// hub and the web client. The schema describes the encoding and " +
+		"how to")
+	e.line("// evolve it.")
+	e.line("#ifndef WIRE_GEN_H")
+	e.line("#define WIRE_GEN_H")
+	e.line("")
+	for _, include := range []string{"cstddef", "cstdint", "optional",
+		"string", "vector"} {
+		e.line("#include <%s>", include)
+	}
+	e.line("")
+	e.line("namespace Wire {")
+	e.line("")
+
+	e.line("enum class MsgId : uint32_t {")
+	e.line("  UNKNOWN = 0,")
+	for _, m := range s.TopLevel() {
+		e.line("  %s = %d,", upperSnake(m.Name), m.ID)
+	}
+	e.line("};")
+	e.line("")
+	e.line("// Snake-case name; for hub messages also the JSON \"type\"")
+	e.line("inline const char *MsgName(MsgId id) {")
+	e.line("  switch (id) {")
+	for _, m := range s.TopLevel() {
+		e.line("  case MsgId::%s:", upperSnake(m.Name))
+		e.line("    return \"%s\";", SnakeCase(m.Name))
+	}
+	e.line("  default:")
+	e.line("    return \"unknown\";")
+	e.line("  }")
+	e.line("}")
+	e.line("")
+	e.buf.WriteString(cppRuntime)
+
+	for _, m := range s.Messages {
+		e.line("")
+		cppMessage(&e, m)
+	}
+	e.line("")
+	e.buf.WriteString(cppTail)
+	e.line("")
+	e.line("} // namespace Wire")
+	e.line("")
+	e.line("#endif")
+	return e.buf.Bytes(), nil
+}
+
+func cppMessage(e *emitter, m *Message) {
+	e.comment("", m.Comment)
+	if len(m.Fields) == 0 {
+		e.line("struct %s {", m.Name)
+		if !m.IsStruct {
+			e.line("  static constexpr MsgId ID = MsgId::%s;",
+				upperSnake(m.Name))
+		}
+		e.line("};")
+		e.line("")
+		e.line("inline void EncodeFields(Writer &, const %s &) {}", m.Name)
+		e.line("")
+		e.line("inline bool DecodeFields(Reader &r, %s &) {", m.Name)
+		e.line("  uint32_t tag;")
+		e.line("  int wireType;")
+		e.line("  while (r.Next(tag, wireType))")
+		e.line("    if (!r.Skip(wireType))")
+		e.line("      return false;")
+		e.line("  return r.Ok();")
+		e.line("}")
+		return
+	}
+
+	e.line("struct %s {", m.Name)
+	if !m.IsStruct {
+		e.line("  static constexpr MsgId ID = MsgId::%s;", upperSnake(m.Name))
+	}
+	for _, f := range m.Fields {
+		e.comment("  ", f.Comment)
+		if def := cppDefault(f); def != "" {
+			e.line("  %s %s = %s;", cppType(f), f.Name, def)
+		} else {
+			e.line("  %s %s;", cppType(f), f.Name)
+		}
+	}
+	e.line("};")
+	e.line("")
+
+	e.line("inline void EncodeFields(Writer &w, const %s &m) {", m.Name)
+	for _, f := range m.Fields {
+		if f.IsStruct() {
+			e.line("  if (m.%s) {", f.Name)
+			e.line("    std::string inner;")
+			e.line("    Writer nested(inner);")
+			e.line("    EncodeFields(nested, *m.%s);", f.Name)
+			e.line("    w.Bytes(%d, inner);", f.Tag)
+			e.line("  }")
+			continue
+		}
+		e.line("  if (%s)", cppPresent(f))
+		e.line("    w.%s(%d, m.%s);", cppMethod(f), f.Tag, f.Name)
+	}
+	e.line("}")
+	e.line("")
+
+	e.line("inline bool DecodeFields(Reader &r, %s &m) {", m.Name)
+	e.line("  uint32_t tag;")
+	e.line("  int wireType;")
+	e.line("  while (r.Next(tag, wireType)) {")
+	e.line("    bool ok;")
+	for i, f := range m.Fields {
+		keyword := "} else if"
+		if i == 0 {
+			keyword = "if"
+		}
+		e.line("    %s (tag == %d && wireType == %d) {", keyword, f.Tag,
+			f.WireType())
+		if f.IsStruct() {
+			e.line("      Reader sub;")
+			e.line("      m.%s.emplace();", f.Name)
+			e.line("      ok = r.Sub(sub) && DecodeFields(sub, *m.%s);", f.Name)
+		} else {
+			e.line("      ok = r.%s(m.%s);", cppMethod(f), f.Name)
+		}
+	}
+	e.line("    } else {")
+	e.line("      ok = r.Skip(wireType);")
+	e.line("    }")
+	e.line("    if (!ok)")
+	e.line("      return false;")
+	e.line("  }")
+	e.line("  return r.Ok();")
+	e.line("}")
+}
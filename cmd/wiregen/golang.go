@@ -0,0 +1,403 @@
+package main
+
+import (
+	"fmt"
+	"go/format"
+)
+
+// wire/wire_gen.go: package wire, formatted with gofmt
+
+const goRuntime = `// ErrMalformed is returned for frames that end early or break the encoding.
+var ErrMalformed = errors.New("wire: malformed frame")
+
+// Message is implemented by every top-level message.
+type Message interface {
+	ID() MsgID
+	Encode() []byte
+	Decode(frame []byte) error
+}
+
+// PeekID returns the id of a frame, MsgUnknown if it cannot be read. Ids of
+// messages newer than this build are returned as they are.
+func PeekID(frame []byte) MsgID {
+	r := reader{buf: frame}
+	id := r.varint()
+	if r.err != nil || id > math.MaxUint32 {
+		return MsgUnknown
+	}
+	return MsgID(id)
+}
+
+type writer struct {
+	buf []byte
+}
+
+func (w *writer) varint(v uint64) {
+	w.buf = binary.AppendUvarint(w.buf, v)
+}
+
+func (w *writer) key(tag int, wireType int) {
+	w.varint(uint64(tag)<<3 | uint64(wireType))
+}
+
+func (w *writer) bool(tag int, v bool) {
+	w.key(tag, 0)
+	if v {
+		w.varint(1)
+	} else {
+		w.varint(0)
+	}
+}
+
+// Zigzag: small negative numbers stay short
+func (w *writer) int(tag int, v int32) {
+	w.key(tag, 0)
+	w.varint(uint64(uint32(v<<1) ^ uint32(v>>31)))
+}
+
+func (w *writer) uint64(tag int, v uint64) {
+	w.key(tag, 0)
+	w.varint(v)
+}
+
+func (w *writer) bytes(tag int, v []byte) {
+	w.key(tag, 2)
+	w.varint(uint64(len(v)))
+	w.buf = append(w.buf, v...)
+}
+
+func (w *writer) string(tag int, v string) {
+	w.key(tag, 2)
+	w.varint(uint64(len(v)))
+	w.buf = append(w.buf, v...)
+}
+
+func (w *writer) packed(tag int, values []uint64) {
+	var inner writer
+	for _, v := range values {
+		inner.varint(v)
+	}
+	w.bytes(tag, inner.buf)
+}
+
+func (w *writer) nested(tag int, encode func(*writer)) {
+	var inner writer
+	encode(&inner)
+	w.bytes(tag, inner.buf)
+}
+
+// reader keeps the first error; later reads return zero values.
+type reader struct {
+	buf []byte
+	pos int
+	err error
+}
+
+func (r *reader) more() bool {
+	return r.err == nil && r.pos < len(r.buf)
+}
+
+func (r *reader) varint() uint64 {
+	if r.err != nil {
+		return 0
+	}
+	v, n := binary.Uvarint(r.buf[r.pos:])
+	if n <= 0 {
+		r.err = ErrMalformed
+		return 0
+	}
+	r.pos += n
+	return v
+}
+
+func (r *reader) key() (int, int) {
+	key := r.varint()
+	if r.err == nil && key>>3 == 0 {
+		r.err = ErrMalformed
+	}
+	return int(key >> 3), int(key & 7)
+}
+
+func (r *reader) bool() bool {
+	return r.varint() != 0
+}
+
+func (r *reader) int() int32 {
+	v := uint32(r.varint())
+	return int32(v>>1) ^ -int32(v&1)
+}
+
+func (r *reader) uint64() uint64 {
+	return r.varint()
+}
+
+// The next length-delimited value, still pointing into the frame
+func (r *reader) view() []byte {
+	n := r.varint()
+	if r.err != nil {
+		return nil
+	}
+	if n > uint64(len(r.buf)-r.pos) {
+		r.err = ErrMalformed
+		return nil
+	}
+	v := r.buf[r.pos : r.pos+int(n)]
+	r.pos += int(n)
+	return v
+}
+
+func (r *reader) bytes() []byte {
+	return append([]byte(nil), r.view()...)
+}
+
+func (r *reader) string() string {
+	return string(r.view())
+}
+
+func (r *reader) packed() []uint64 {
+	inner := reader{buf: r.view()}
+	values := []uint64{}
+	for inner.more() {
+		values = append(values, inner.varint())
+	}
+	if inner.err != nil && r.err == nil {
+		r.err = inner.err
+	}
+	return values
+}
+
+// Nested struct: decode runs on a reader of its own
+func (r *reader) nested(decode func(*reader) error) {
+	inner := reader{buf: r.view()}
+	if err := decode(&inner); err != nil && r.err == nil {
+		r.err = err
+	}
+}
+
+// Fields this build does not know: a newer peer sent them
+func (r *reader) skip(wireType int) {
+	switch wireType {
+	case 0:
+		r.varint()
+	case 2:
+		r.view()
+	default:
+		r.err = ErrMalformed
+	}
+}
+
+func (r *reader) expect(id MsgID) {
+	if got := MsgID(r.varint()); r.err == nil && got != id {
+		r.err = fmt.Errorf("wire: %v frame, want %v", got, id)
+	}
+}
+`
+
+func goType(f *Field) string {
+	switch f.Type {
+	case typeBool:
+		return "bool"
+	case typeInt:
+		return "int32"
+	case typeUint64:
+		return "uint64"
+	case typeString:
+		return "string"
+	case typeBytes:
+		return "[]byte"
+	case typeUint64s:
+		return "[]uint64"
+	}
+	return "*" + f.Type
+}
+
+func goMethod(f *Field) string {
+	switch f.Type {
+	case typeUint64s:
+		return "packed"
+	case typeInt:
+		return "int"
+	}
+	return f.Type // bool, uint64, string, bytes
+}
+
+func goPresent(f *Field) string {
+	name := "m." + Exported(f.Name)
+	switch f.Type {
+	case typeBool:
+		if f.Default == "true" {
+			return "!" + name
+		}
+		return name
+	case typeInt:
+		if f.HasDefault {
+			return fmt.Sprintf("%s != %s", name, f.Default)
+		}
+		return name + " != 0"
+	case typeUint64:
+		return name + " != 0"
+	case typeString:
+		return name + ` != ""`
+	case typeBytes, typeUint64s:
+		return "len(" + name + ") > 0"
+	}
+	return name + " != nil"
+}
+
+func GenerateGo(s *Schema) ([]byte, error) {
+	var e emitter
+	e.line("// Code generated by cmd/wiregen from schema/wire.schema. DO NOT EDIT.")
+	e.line("")
+	e.line("package wire")
+	e.line("")
+	e.line("import (")
+	e.line("\"encoding/binary\"")
+	e.line("\"errors\"")
+	e.line("\"fmt\"")
+	e.line("\"math\"")
+	e.line(")")
+	e.line("")
+	e.line("// MsgID is the first varint of every frame.")
+	e.line("type MsgID uint32")
+	e.line("")
+	e.line("const (")
+	e.line("MsgUnknown MsgID = 0")
+	for _, m := range s.TopLevel() {
+		e.line("Msg%s MsgID = %d", m.Name, m.ID)
+	}
+	e.line(")")
+	e.line("")
+	e.line("// String returns the snake-case name; for hub messages also the " +
+		"JSON \"type\".")
+	e.line("func (id MsgID) String() string {")
+	e.line("switch id {")
+	for _, m := range s.TopLevel() {
+		e.line("case Msg%s:", m.Name)
+		e.line("return \"%s\"", SnakeCase(m.Name))
+	}
+	e.line("}")
+	e.line("return \"unknown\"")
+	e.line("}")
+	e.line("")
+	e.line("// DecodeAny decodes a frame into the message its id names.")
+	e.line("func DecodeAny(frame []byte) (Message, error) {")
+	e.line("var m Message")
+	e.line("switch PeekID(frame) {")
+	for _, m := range s.TopLevel() {
+		e.line("case Msg%s:", m.Name)
+		e.line("m = &%s{}", m.Name)
+	}
+	e.line("default:")
+	e.line("return nil, fmt.Errorf(\"wire: unknown message id %%d\", " +
+		"PeekID(frame))")
+	e.line("}")
+	e.line("return m, m.Decode(frame)")
+	e.line("}")
+	e.line("")
+	e.buf.WriteString(goRuntime)
+
+	for _, m := range s.Messages {
+		e.line("")
+		goMessage(&e, m)
+	}
+
+	out, err := format.Source(e.buf.Bytes())
+	if err != nil {
+		return nil, fmt.Errorf("gofmt: %v", err)
+	}
+	return out, nil
+}
+
+func goMessage(e *emitter, m *Message) {
+	e.comment("", m.Comment)
+	e.line("type %s struct {", m.Name)
+	for _, f := range m.Fields {
+		e.comment("", f.Comment)
+		e.line("%s %s", Exported(f.Name), goType(f))
+	}
+	e.line("}")
+	e.line("")
+
+	var defaults []string
+	for _, f := range m.Fields {
+		if f.HasDefault && f.Default != "false" && f.Default != "0" {
+			defaults = append(defaults, fmt.Sprintf("%s: %s", Exported(f.Name),
+				f.Default))
+		}
+	}
+	e.line("// New%s returns a %s holding the schema defaults.", m.Name,
+		m.Name)
+	e.line("func New%s() *%s {", m.Name, m.Name)
+	if len(defaults) == 0 {
+		e.line("return &%s{}", m.Name)
+	} else {
+		e.line("return &%s{", m.Name)
+		for _, d := range defaults {
+			e.line("%s,", d)
+		}
+		e.line("}")
+	}
+	e.line("}")
+	e.line("")
+
+	if !m.IsStruct {
+		e.line("func (m *%s) ID() MsgID { return Msg%s }", m.Name, m.Name)
+		e.line("")
+		e.line("func (m *%s) Encode() []byte {", m.Name)
+		e.line("w := &writer{}")
+		e.line("w.varint(uint64(Msg%s))", m.Name)
+		e.line("m.encodeFields(w)")
+		e.line("return w.buf")
+		e.line("}")
+		e.line("")
+		e.line("func (m *%s) Decode(frame []byte) error {", m.Name)
+		e.line("r := &reader{buf: frame}")
+		e.line("r.expect(Msg%s)", m.Name)
+		e.line("return m.decodeFields(r)")
+		e.line("}")
+		e.line("")
+	}
+
+	receiver := "m"
+	if len(m.Fields) == 0 {
+		receiver = ""
+	}
+	e.line("func (%s *%s) encodeFields(w *writer) {", receiver, m.Name)
+	for _, f := range m.Fields {
+		e.line("if %s {", goPresent(f))
+		if f.IsStruct() {
+			e.line("w.nested(%d, m.%s.encodeFields)", f.Tag, Exported(f.Name))
+		} else {
+			e.line("w.%s(%d, m.%s)", goMethod(f), f.Tag, Exported(f.Name))
+		}
+		e.line("}")
+	}
+	e.line("}")
+	e.line("")
+
+	e.line("func (m *%s) decodeFields(r *reader) error {", m.Name)
+	e.line("*m = *New%s()", m.Name)
+	e.line("for r.more() {")
+	if len(m.Fields) == 0 {
+		e.line("_, wireType := r.key()")
+		e.line("r.skip(wireType)")
+	} else {
+		e.line("tag, wireType := r.key()")
+		e.line("switch {")
+		for _, f := range m.Fields {
+			e.line("case tag == %d && wireType == %d:", f.Tag, f.WireType())
+			if f.IsStruct() {
+				e.line("m.%s = New%s()", Exported(f.Name), f.Type)
+				e.line("r.nested(m.%s.decodeFields)", Exported(f.Name))
+			} else {
+				e.line("m.%s = r.%s()", Exported(f.Name), goMethod(f))
+			}
+		}
+		e.line("default:")
+		e.line("r.skip(wireType)")
+		e.line("}")
+	}
+	e.line("}")
+	e.line("return r.err")
+	e.line("}")
+}
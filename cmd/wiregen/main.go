@@ -0,0 +1,127 @@
+// Command wiregen generates the binary message encoders and decoders of
+// the C++ client, the Go hub and the web client from schema/wire.schema.
+//
+//	go run ./cmd/wiregen          # from the repository root
+//	go run ./cmd/wiregen -check   # exit 1 if a generated file is stale
+//
+// The generated files are committed. main_test.go fails while any of them
+// differs from what the schema produces, so the three languages cannot
+// drift apart.
+package main
+
+import (
+	"bytes"
+	"flag"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+)
+
+const schemaPath = "schema/wire.schema"
+
+type output struct {
+	path     string // Relative to the repository root
+	generate func(*Schema) ([]byte, error)
+}
+
+var outputs = []output{
+	{"client/wire_gen.h", GenerateCpp},
+	{"wire/wire_gen.go", GenerateGo},
+	{"client-nuxt/app/services/wire.gen.ts", GenerateTS},
+}
+
+// Generate returns the contents of every output, keyed by path
+func Generate(root string) (map[string][]byte, error) {
+	file, err := os.Open(filepath.Join(root, schemaPath))
+	if err != nil {
+		return nil, err
+	}
+	defer file.Close()
+	schema, err := ParseSchema(file)
+	if err != nil {
+		return nil, fmt.Errorf("%s: %v", schemaPath, err)
+	}
+	files := map[string][]byte{}
+	for _, out := range outputs {
+		data, err := out.generate(schema)
+		if err != nil {
+			return nil, fmt.Errorf("%s: %v", out.path, err)
+		}
+		files[out.path] = data
+	}
+	return files, nil
+}
+
+// Stale lists the outputs whose files differ from the schema's
+func Stale(root string) ([]string, error) {
+	files, err := Generate(root)
+	if err != nil {
+		return nil, err
+	}
+	var stale []string
+	for _, out := range outputs {
+		current, err := os.ReadFile(filepath.Join(root, out.path))
+		if err != nil || !bytes.Equal(current, files[out.path]) {
+			stale = append(stale, out.path)
+		}
+	}
+	return stale, nil
+}
+
+func main() {
+	root := flag.String("root", ".", "repository root")
+	check := flag.Bool("check", false, "only report stale files")
+	flag.Parse()
+
+	if *check {
+		stale, err := Stale(*root)
+		if err != nil {
+			fmt.Fprintln(os.Stderr, "wiregen:", err)
+			os.Exit(1)
+		}
+		if len(stale) > 0 {
+			fmt.Fprintf(os.Stderr, "wiregen: out of date: %s\n",
+				strings.Join(stale, ", "))
+			os.Exit(1)
+		}
+		return
+	}
+
+	files, err := Generate(*root)
+	if err != nil {
+		fmt.Fprintln(os.Stderr, "wiregen:", err)
+		os.Exit(1)
+	}
+	for _, out := range outputs {
+		path := filepath.Join(*root, out.path)
+		if err := os.MkdirAll(filepath.Dir(path), 0o755); err != nil {
+			fmt.Fprintln(os.Stderr, "wiregen:", err)
+			os.Exit(1)
+		}
+		if err := os.WriteFile(path, files[out.path], 0o644); err != nil {
+			fmt.Fprintln(os.Stderr, "wiregen:", err)
+			os.Exit(1)
+		}
+		fmt.Println("wrote", out.path)
+	}
+}
+
+// Line-oriented text builder for the generators
+type emitter struct {
+	buf bytes.Buffer
+}
+
+func (e *emitter) line(format string, args ...interface{}) {
+	if format != "" {
+		fmt.Fprintf(&e.buf, format, args...)
+	}
+	e.buf.WriteByte('\n')
+}
+
+// Schema comment lines as // comments
+func (e *emitter) comment(indent string, lines []string) {
+	for _, text := range lines {
+		e.line("%s// %s", indent, text)
+	}
+}
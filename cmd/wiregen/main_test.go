@@ -0,0 +1,53 @@
+package main
+
+import (
+	"strings"
+	"testing"
+)
+
+// Fails until `go run ./cmd/wiregen` is run after a schema change
+func TestGeneratedFilesAreCurrent(t *testing.T) {
+	stale, err := Stale("../..")
+	if err != nil {
+		t.Fatal(err)
+	}
+	if len(stale) > 0 {
+		t.Errorf("out of date, run `go run ./cmd/wiregen`: %s",
+			strings.Join(stale, ", "))
+	}
+}
+
+func TestSchemaErrors(t *testing.T) {
+	for _, c := range []struct {
+		schema string
+		want   string
+	}{
+		{"message A 1 {\n1 x int\n1 y int\n}", "tag 1 already used"},
+		{"message A 1 {\n}\nmessage B 1 {\n}", "id 1 already used"},
+		{"message A 1 {\nreserved 2\n2 x int\n}", "reserved tag 2"},
+		{"message A 1 {\n1 x float\n}", "unknown type"},
+		{"message A 1 {\n}\nmessage B 2 {\n1 a A\n}", "unknown type"},
+		{"message A 1 {\n1 x string = hi\n}", "take no default"},
+		{"message A 1 {\n1 x bool = yes\n}", "bad bool default"},
+		{"message A 1 {\n1 x int", "not closed"},
+	} {
+		_, err := ParseSchema(strings.NewReader(c.schema))
+		if err == nil || !strings.Contains(err.Error(), c.want) {
+			t.Errorf("%q: got %v, want %q", c.schema, err, c.want)
+		}
+	}
+}
+
+func TestSnakeCase(t *testing.T) {
+	for name, want := range map[string]string{
+		"JoinGame":       "join_game",
+		"MoveLR":         "move_lr",
+		"HashHistoryReq": "hash_history_req",
+		"ResumeOk":       "resume_ok",
+		"Ping":           "ping",
+	} {
+		if got := SnakeCase(name); got != want {
+			t.Errorf("%s: got %s, want %s", name, got, want)
+		}
+	}
+}
@@ -0,0 +1,276 @@
+package main
+
+import (
+	"bufio"
+	"fmt"
+	"io"
+	"regexp"
+	"strconv"
+	"strings"
+)
+
+// Field types of the schema language
+const (
+	typeBool    = "bool"
+	typeInt     = "int"
+	typeUint64  = "uint64"
+	typeString  = "string"
+	typeBytes   = "bytes"
+	typeUint64s = "[]uint64"
+)
+
+// maxTag keeps tag << 3 inside 32 bits
+const maxTag = 1<<28 - 1
+
+type Field struct {
+	Tag        int
+	Name       string
+	Type       string // One of the type constants, or a struct name
+	Default    string // As written; "" when the type's zero value applies
+	HasDefault bool
+	Comment    []string
+}
+
+type Message struct {
+	Name     string
+	ID       int // 0 for structs
+	IsStruct bool
+	Fields   []*Field
+	Reserved []int
+	Comment  []string
+}
+
+type Schema struct {
+	Messages []*Message // In file order
+	byName   map[string]*Message
+}
+
+func (s *Schema) Struct(name string) *Message {
+	m := s.byName[name]
+	if m == nil || !m.IsStruct {
+		return nil
+	}
+	return m
+}
+
+// Top-level messages, in file order
+func (s *Schema) TopLevel() []*Message {
+	var out []*Message
+	for _, m := range s.Messages {
+		if !m.IsStruct {
+			out = append(out, m)
+		}
+	}
+	return out
+}
+
+var (
+	identRe    = regexp.MustCompile(`^[A-Za-z][A-Za-z0-9]*$`)
+	messageRe  = regexp.MustCompile(`^message\s+(\S+)\s+(\d+)\s*\{$`)
+	structRe   = regexp.MustCompile(`^struct\s+(\S+)\s*\{$`)
+	fieldRe    = regexp.MustCompile(`^(\d+)\s+(\S+)\s+(\S+)(?:\s*=\s*(\S+))?$`)
+	reservedRe = regexp.MustCompile(`^reserved\s+(.+)$`)
+)
+
+// ParseSchema reads and validates a schema. Errors carry the line number.
+func ParseSchema(r io.Reader) (*Schema, error) {
+	s := &Schema{byName: map[string]*Message{}}
+	var current *Message
+	var comment []string
+	scanner := bufio.NewScanner(r)
+	line := 0
+	fail := func(format string, args ...interface{}) error {
+		return fmt.Errorf("line %d: %s", line, fmt.Sprintf(format, args...))
+	}
+
+	for scanner.Scan() {
+		line++
+		text := strings.TrimSpace(scanner.Text())
+		if text == "" {
+			comment = nil
+			continue
+		}
+		if strings.HasPrefix(text, "#") {
+			comment = append(comment, strings.TrimSpace(text[1:]))
+			continue
+		}
+
+		if current == nil {
+			m := &Message{Comment: comment}
+			if sub := messageRe.FindStringSubmatch(text); sub != nil {
+				m.Name = sub[1]
+				m.ID, _ = strconv.Atoi(sub[2])
+				if m.ID <= 0 || m.ID > maxTag {
+					return nil, fail("message id %d out of range", m.ID)
+				}
+				for _, other := range s.TopLevel() {
+					if other.ID == m.ID {
+						return nil, fail("message id %d already used by %s",
+							m.ID, other.Name)
+					}
+				}
+			} else if sub := structRe.FindStringSubmatch(text); sub != nil {
+				m.Name = sub[1]
+				m.IsStruct = true
+			} else {
+				return nil, fail("expected `message Name id {` or `struct Name {`")
+			}
+			if !identRe.MatchString(m.Name) {
+				return nil, fail("bad name %q", m.Name)
+			}
+			if s.byName[m.Name] != nil {
+				return nil, fail("%s defined twice", m.Name)
+			}
+			s.byName[m.Name] = m
+			s.Messages = append(s.Messages, m)
+			current = m
+			comment = nil
+			continue
+		}
+
+		if text == "}" {
+			current = nil
+			comment = nil
+			continue
+		}
+		if sub := reservedRe.FindStringSubmatch(text); sub != nil {
+			for _, item := range strings.Split(sub[1], ",") {
+				tag, err := strconv.Atoi(strings.TrimSpace(item))
+				if err != nil || tag <= 0 || tag > maxTag {
+					return nil, fail("bad reserved tag %q", item)
+				}
+				current.Reserved = append(current.Reserved, tag)
+			}
+			comment = nil
+			continue
+		}
+		sub := fieldRe.FindStringSubmatch(text)
+		if sub == nil {
+			return nil, fail("expected `tag name type [= default]`")
+		}
+		f := &Field{Name: sub[2], Type: sub[3], Comment: comment}
+		f.Tag, _ = strconv.Atoi(sub[1])
+		if f.Tag <= 0 || f.Tag > maxTag {
+			return nil, fail("tag %d out of range", f.Tag)
+		}
+		if !identRe.MatchString(f.Name) {
+			return nil, fail("bad field name %q", f.Name)
+		}
+		for _, other := range current.Fields {
+			if other.Tag == f.Tag {
+				return nil, fail("tag %d already used by %s", f.Tag, other.Name)
+			}
+			if other.Name == f.Name {
+				return nil, fail("field %s defined twice", f.Name)
+			}
+		}
+		if sub[4] != "" {
+			f.Default = sub[4]
+			f.HasDefault = true
+		}
+		current.Fields = append(current.Fields, f)
+		comment = nil
+	}
+	if err := scanner.Err(); err != nil {
+		return nil, err
+	}
+	if current != nil {
+		return nil, fmt.Errorf("line %d: %s is not closed", line, current.Name)
+	}
+	return s, s.check()
+}
+
+// Checks that need the whole file: types, defaults, reserved tags
+func (s *Schema) check() error {
+	for _, m := range s.Messages {
+		for _, tag := range m.Reserved {
+			for _, f := range m.Fields {
+				if f.Tag == tag {
+					return fmt.Errorf("%s.%s uses reserved tag %d", m.Name,
+						f.Name, tag)
+				}
+			}
+		}
+		for _, f := range m.Fields {
+			switch f.Type {
+			case typeBool:
+				if f.HasDefault && f.Default != "true" && f.Default != "false" {
+					return fmt.Errorf("%s.%s: bad bool default %q", m.Name,
+						f.Name, f.Default)
+				}
+			case typeInt:
+				if f.HasDefault {
+					if _, err := strconv.ParseInt(f.Default, 10, 32); err != nil {
+						return fmt.Errorf("%s.%s: bad int default %q", m.Name,
+							f.Name, f.Default)
+					}
+				}
+			case typeUint64, typeString, typeBytes, typeUint64s:
+				if f.HasDefault {
+					return fmt.Errorf("%s.%s: %s fields take no default",
+						m.Name, f.Name, f.Type)
+				}
+			default:
+				nested := s.Struct(f.Type)
+				if nested == nil {
+					return fmt.Errorf("%s.%s: unknown type %q (messages "+
+						"cannot be nested, only structs)", m.Name, f.Name,
+						f.Type)
+				}
+				if m.IsStruct {
+					return fmt.Errorf("%s.%s: structs hold scalar fields only",
+						m.Name, f.Name)
+				}
+				if f.HasDefault {
+					return fmt.Errorf("%s.%s: struct fields take no default",
+						m.Name, f.Name)
+				}
+			}
+		}
+	}
+	return nil
+}
+
+// Wire type of a field: 0 varint, 2 length-delimited
+func (f *Field) WireType() int {
+	switch f.Type {
+	case typeBool, typeInt, typeUint64:
+		return 0
+	default:
+		return 2
+	}
+}
+
+func (f *Field) IsStruct() bool {
+	switch f.Type {
+	case typeBool, typeInt, typeUint64, typeString, typeBytes, typeUint64s:
+		return false
+	}
+	return true
+}
+
+// JoinGame -> join_game, MoveLR -> move_lr, HashHistoryReq -> hash_history_req
+func SnakeCase(name string) string {
+	var b strings.Builder
+	for i, r := range name {
+		upper := r >= 'A' && r <= 'Z'
+		if upper && i > 0 {
+			prev := rune(name[i-1])
+			nextLower := i+1 < len(name) && name[i+1] >= 'a' && name[i+1] <= 'z'
+			if (prev >= 'a' && prev <= 'z') || (prev >= '0' && prev <= '9') ||
+				(prev >= 'A' && prev <= 'Z' && nextLower) {
+				b.WriteByte('_')
+			}
+		}
+		if upper {
+			r += 'a' - 'A'
+		}
+		b.WriteRune(r)
+	}
+	return b.String()
+}
+
+// attackMode -> AttackMode
+func Exported(name string) string {
+	return strings.ToUpper(name[:1]) + name[1:]
+}
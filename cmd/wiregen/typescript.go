@@ -0,0 +1,402 @@
+package main
+
+import "fmt"
+
+// client-nuxt/app/services/wire.gen.ts: ES module in the web client's
+// style (4 spaces, no semicolons). 64-bit fields are bigint.
+
+const tsRuntime = `export class WireError extends Error {}
+
+const textEncoder = new TextEncoder()
+const textDecoder = new TextDecoder()
+
+class Writer {
+    private buf = new Uint8Array(64)
+    private len = 0
+
+    // Non-negative, below 2^53
+    varint(value: number) {
+        while (value >= 0x80) {
+            this.byte((value % 0x80) | 0x80)
+            value = Math.floor(value / 0x80)
+        }
+        this.byte(value)
+    }
+
+    varintBig(value: bigint) {
+        value = BigInt.asUintN(64, value)
+        while (value >= 0x80n) {
+            this.byte(Number(value & 0x7fn) | 0x80)
+            value >>= 7n
+        }
+        this.byte(Number(value))
+    }
+
+    key(tag: number, wireType: number) {
+        this.varint(tag * 8 + wireType)
+    }
+
+    bool(tag: number, value: boolean) {
+        this.key(tag, 0)
+        this.byte(value ? 1 : 0)
+    }
+
+    // Zigzag: small negative numbers stay short
+    int(tag: number, value: number) {
+        this.key(tag, 0)
+        this.varint(value >= 0 ? value * 2 : -value * 2 - 1)
+    }
+
+    uint64(tag: number, value: bigint) {
+        this.key(tag, 0)
+        this.varintBig(value)
+    }
+
+    bytes(tag: number, value: Uint8Array) {
+        this.key(tag, 2)
+        this.varint(value.length)
+        this.reserve(value.length)
+        this.buf.set(value, this.len)
+        this.len += value.length
+    }
+
+    string(tag: number, value: string) {
+        this.bytes(tag, textEncoder.encode(value))
+    }
+
+    packed(tag: number, values: bigint[]) {
+        const inner = new Writer()
+        values.forEach(v => inner.varintBig(v))
+        this.bytes(tag, inner.finish())
+    }
+
+    nested(tag: number, encode: (w: Writer) => void) {
+        const inner = new Writer()
+        encode(inner)
+        this.bytes(tag, inner.finish())
+    }
+
+    finish(): Uint8Array {
+        return this.buf.subarray(0, this.len)
+    }
+
+    private byte(value: number) {
+        this.reserve(1)
+        this.buf[this.len++] = value
+    }
+
+    private reserve(size: number) {
+        if (this.len + size <= this.buf.length) return
+        const grown = new Uint8Array(Math.max(this.buf.length * 2, this.len + size))
+        grown.set(this.buf.subarray(0, this.len))
+        this.buf = grown
+    }
+}
+
+class Reader {
+    private buf: Uint8Array
+    private pos = 0
+
+    constructor(buf: Uint8Array) {
+        this.buf = buf
+    }
+
+    more(): boolean {
+        return this.pos < this.buf.length
+    }
+
+    varint(): number {
+        let value = 0
+        let scale = 1
+        for (let i = 0; i < 10; i++) {
+            if (this.pos >= this.buf.length) throw new WireError('truncated frame')
+            const b = this.buf[this.pos++]!
+            value += (b & 0x7f) * scale
+            if (b < 0x80) return value
+            scale *= 0x80
+        }
+        throw new WireError('varint too long')
+    }
+
+    varintBig(): bigint {
+        let value = 0n
+        let shift = 0n
+        for (let i = 0; i < 10; i++) {
+            if (this.pos >= this.buf.length) throw new WireError('truncated frame')
+            const b = this.buf[this.pos++]!
+            value |= BigInt(b & 0x7f) << shift
+            if (b < 0x80) return BigInt.asUintN(64, value)
+            shift += 7n
+        }
+        throw new WireError('varint too long')
+    }
+
+    key(): [number, number] {
+        const key = this.varint()
+        const tag = Math.floor(key / 8)
+        if (tag === 0) throw new WireError('field tag 0')
+        return [tag, key % 8]
+    }
+
+    bool(): boolean {
+        return this.varint() !== 0
+    }
+
+    int(): number {
+        const v = this.varint()
+        return v % 2 === 1 ? -(v + 1) / 2 : v / 2
+    }
+
+    uint64(): bigint {
+        return this.varintBig()
+    }
+
+    // The next length-delimited value, still pointing into the frame
+    view(): Uint8Array {
+        const len = this.varint()
+        if (len > this.buf.length - this.pos) throw new WireError('truncated frame')
+        const out = this.buf.subarray(this.pos, this.pos + len)
+        this.pos += len
+        return out
+    }
+
+    bytes(): Uint8Array {
+        return this.view().slice()
+    }
+
+    string(): string {
+        return textDecoder.decode(this.view())
+    }
+
+    packed(): bigint[] {
+        const inner = new Reader(this.view())
+        const values: bigint[] = []
+        while (inner.more()) values.push(inner.varintBig())
+        return values
+    }
+
+    sub(): Reader {
+        return new Reader(this.view())
+    }
+
+    // Fields this build does not know: a newer peer sent them
+    skip(wireType: number) {
+        if (wireType === 0) this.varint()
+        else if (wireType === 2) this.view()
+        else throw new WireError(` + "`unknown wire type ${wireType}`" + `)
+    }
+
+    expect(id: number) {
+        const got = this.varint()
+        if (got !== id) {
+            throw new WireError(` + "`${MSG_NAMES[got] ?? got} frame, want ${MSG_NAMES[id]}`" + `)
+        }
+    }
+}
+
+// Id of a frame, MsgId.Unknown if it cannot be read. Ids of messages newer
+// than this build are returned as they are.
+export function peekId(frame: Uint8Array): number {
+    try {
+        return new Reader(frame).varint()
+    } catch {
+        return MsgId.Unknown
+    }
+}
+`
+
+func tsType(f *Field) string {
+	switch f.Type {
+	case typeBool:
+		return "boolean"
+	case typeInt:
+		return "number"
+	case typeUint64:
+		return "bigint"
+	case typeString:
+		return "string"
+	case typeBytes:
+		return "Uint8Array"
+	case typeUint64s:
+		return "bigint[]"
+	}
+	return f.Type
+}
+
+func tsDefault(f *Field) string {
+	switch f.Type {
+	case typeBool:
+		if f.HasDefault {
+			return f.Default
+		}
+		return "false"
+	case typeInt:
+		if f.HasDefault {
+			return f.Default
+		}
+		return "0"
+	case typeUint64:
+		return "0n"
+	case typeString:
+		return "''"
+	case typeBytes:
+		return "new Uint8Array(0)"
+	case typeUint64s:
+		return "[]"
+	}
+	return ""
+}
+
+func tsPresent(f *Field) string {
+	name := "m." + f.Name
+	switch f.Type {
+	case typeBool:
+		if f.Default == "true" {
+			return "!" + name
+		}
+		return name
+	case typeInt, typeUint64, typeString:
+		return fmt.Sprintf("%s !== %s", name, tsDefault(f))
+	case typeBytes, typeUint64s:
+		return name + ".length > 0"
+	}
+	return name + " !== undefined"
+}
+
+func tsMethod(f *Field) string {
+	if f.Type == typeUint64s {
+		return "packed"
+	}
+	return f.Type
+}
+
+func GenerateTS(s *Schema) ([]byte, error) {
+	var e emitter
+	e.line("// Generated by cmd/wiregen from schema/wire.schema. DO NOT EDIT.")
+	e.line("//")
+	e.line("// Binary encoders and decoders for the wire messages shared with " +
+		"the C++")
+	e.line("// client and the Go hub. The schema describes the encoding and " +
+		"how to")
+	e.line("// evolve it.")
+	e.line("")
+	e.line("export const MsgId = {")
+	e.line("    Unknown: 0,")
+	for _, m := range s.TopLevel() {
+		e.line("    %s: %d,", m.Name, m.ID)
+	}
+	e.line("} as const")
+	e.line("")
+	e.line("// Snake-case names; for hub messages also the JSON \"type\"")
+	e.line("export const MSG_NAMES: Record<number, string> = {")
+	for _, m := range s.TopLevel() {
+		e.line("    %d: '%s',", m.ID, SnakeCase(m.Name))
+	}
+	e.line("}")
+	e.line("")
+	e.buf.WriteString(tsRuntime)
+
+	for _, m := range s.Messages {
+		e.line("")
+		tsMessage(&e, m)
+	}
+	return e.buf.Bytes(), nil
+}
+
+func tsMessage(e *emitter, m *Message) {
+	e.comment("", m.Comment)
+	e.line("export interface %s {", m.Name)
+	for _, f := range m.Fields {
+		e.comment("    ", f.Comment)
+		if f.IsStruct() {
+			e.line("    %s?: %s", f.Name, tsType(f))
+		} else {
+			e.line("    %s: %s", f.Name, tsType(f))
+		}
+	}
+	e.line("}")
+	e.line("")
+
+	e.line("export function new%s(): %s {", m.Name, m.Name)
+	var values []string
+	for _, f := range m.Fields {
+		if !f.IsStruct() {
+			values = append(values, fmt.Sprintf("%s: %s", f.Name, tsDefault(f)))
+		}
+	}
+	if len(values) == 0 {
+		e.line("    return {}")
+	} else {
+		e.line("    return {")
+		for _, v := range values {
+			e.line("        %s,", v)
+		}
+		e.line("    }")
+	}
+	e.line("}")
+	e.line("")
+
+	// Structs get field helpers for the messages that embed them
+	param := "m"
+	if len(m.Fields) == 0 {
+		param = "_m"
+	}
+	if m.IsStruct {
+		e.line("function write%s(w: Writer, %s: %s) {", m.Name, param, m.Name)
+	} else {
+		e.line("export function encode%s(%s: %s): Uint8Array {", m.Name,
+			param, m.Name)
+		e.line("    const w = new Writer()")
+		e.line("    w.varint(MsgId.%s)", m.Name)
+	}
+	for _, f := range m.Fields {
+		if f.IsStruct() {
+			e.line("    const %s = m.%s", f.Name, f.Name)
+			e.line("    if (%s) w.nested(%d, inner => write%s(inner, %s))",
+				f.Name, f.Tag, f.Type, f.Name)
+			continue
+		}
+		e.line("    if (%s) w.%s(%d, m.%s)", tsPresent(f), tsMethod(f), f.Tag,
+			f.Name)
+	}
+	if !m.IsStruct {
+		e.line("    return w.finish()")
+	}
+	e.line("}")
+	e.line("")
+
+	if m.IsStruct {
+		e.line("function read%s(r: Reader): %s {", m.Name, m.Name)
+	} else {
+		e.line("export function decode%s(frame: Uint8Array): %s {", m.Name,
+			m.Name)
+		e.line("    const r = new Reader(frame)")
+		e.line("    r.expect(MsgId.%s)", m.Name)
+	}
+	e.line("    const m = new%s()", m.Name)
+	e.line("    while (r.more()) {")
+	if len(m.Fields) == 0 {
+		e.line("        const [, wireType] = r.key()")
+		e.line("        r.skip(wireType)")
+	} else {
+		e.line("        const [tag, wireType] = r.key()")
+	}
+	for i, f := range m.Fields {
+		keyword := "else if"
+		if i == 0 {
+			keyword = "if"
+		}
+		value := fmt.Sprintf("r.%s()", tsMethod(f))
+		if f.IsStruct() {
+			value = fmt.Sprintf("read%s(r.sub())", f.Type)
+		}
+		e.line("        %s (tag === %d && wireType === %d) m.%s = %s", keyword,
+			f.Tag, f.WireType(), f.Name, value)
+	}
+	if len(m.Fields) > 0 {
+		e.line("        else r.skip(wireType)")
+	}
+	e.line("    }")
+	e.line("    return m")
+	e.line("}")
+}
@@ -0,0 +1,125 @@
+package tetrisserver
+
+import (
+	"fmt"
+	"io"
+	"net"
+	"net/http"
+	"sync/atomic"
+)
+
+// Hub metrics for /metrics in the Prometheus text format. The connection
+// goroutines only do atomic adds; a scrape reads the counters and walks the
+// hub's clients once under its lock.
+
+var hubMessageTypes = []string{
+	"join_game", "room_status", "waiting_for_opponent", "game_start",
+	"game_state", "attack", "game_over", "pause", "resume", "player_left",
+	"other",
+}
+
+var hubMessageIndex = func() map[string]int {
+	index := make(map[string]int, len(hubMessageTypes))
+	for i, name := range hubMessageTypes {
+		index[name] = i
+	}
+	return index
+}()
+
+const (
+	directionIn  = 0
+	directionOut = 1
+)
+
+type hubCounters struct {
+	messages [2][]atomic.Uint64 // By direction, then hubMessageTypes index
+	bytes    [2][]atomic.Uint64
+}
+
+var hubStats = newHubCounters()
+
+func newHubCounters() *hubCounters {
+	c := &hubCounters{}
+	for d := range c.messages {
+		c.messages[d] = make([]atomic.Uint64, len(hubMessageTypes))
+		c.bytes[d] = make([]atomic.Uint64, len(hubMessageTypes))
+	}
+	return c
+}
+
+func (c *hubCounters) count(direction int, msgType string, size int) {
+	i, ok := hubMessageIndex[msgType]
+	if !ok {
+		i = hubMessageIndex["other"]
+	}
+	c.messages[direction][i].Add(1)
+	c.bytes[direction][i].Add(uint64(size))
+}
+
+// hubGauges is what a scrape finds in the hub at that moment
+type hubGauges struct {
+	clients   int
+	rooms     int // Rooms with at least one player left
+	waiting   int // 1 while a host waits for an opponent
+	sendQueue int // Messages queued to all clients' write pumps
+}
+
+func (h *Hub) gauges() hubGauges {
+	h.mu.Lock()
+	defer h.mu.Unlock()
+	g := hubGauges{clients: len(h.clients)}
+	for c := range h.clients {
+		g.sendQueue += len(c.send)
+	}
+	for _, room := range h.rooms {
+		room.mu.Lock()
+		if len(room.clients) > 0 {
+			g.rooms++
+		}
+		room.mu.Unlock()
+	}
+	if h.waitingClient != nil {
+		g.waiting = 1
+	}
+	return g
+}
+
+func writeMetrics(w io.Writer, c *hubCounters, g hubGauges) {
+	directions := [2]string{"in", "out"}
+	fmt.Fprintln(w, "# HELP tetris_hub_messages_total WebSocket messages by direction and type.")
+	fmt.Fprintln(w, "# TYPE tetris_hub_messages_total counter")
+	for d, direction := range directions {
+		for i, name := range hubMessageTypes {
+			fmt.Fprintf(w, "tetris_hub_messages_total{direction=%q,type=%q} %d\n",
+				direction, name, c.messages[d][i].Load())
+		}
+	}
+	fmt.Fprintln(w, "# HELP tetris_hub_message_bytes_total WebSocket payload bytes by direction and type.")
+	fmt.Fprintln(w, "# TYPE tetris_hub_message_bytes_total counter")
+	for d, direction := range directions {
+		for i, name := range hubMessageTypes {
+			fmt.Fprintf(w, "tetris_hub_message_bytes_total{direction=%q,type=%q} %d\n",
+				direction, name, c.bytes[d][i].Load())
+		}
+	}
+	gauge := func(name, help string, value int) {
+		fmt.Fprintf(w, "# HELP %s %s\n# TYPE %s gauge\n%s %d\n", name, help, name, name, value)
+	}
+	gauge("tetris_hub_clients", "Connected WebSocket clients.", g.clients)
+	gauge("tetris_sessions_active", "Matches in progress.", g.rooms)
+	gauge("tetris_hub_waiting_hosts", "Hosts waiting for an opponent.", g.waiting)
+	gauge("tetris_hub_send_queue_depth", "Messages queued to the clients' write pumps.", g.sendQueue)
+}
+
+// metricsHandler serves loopback clients only: a local Prometheus or curl
+func metricsHandler(h *Hub) http.HandlerFunc {
+	return func(w http.ResponseWriter, r *http.Request) {
+		host, _, err := net.SplitHostPort(r.RemoteAddr)
+		if ip := net.ParseIP(host); err != nil || ip == nil || !ip.IsLoopback() {
+			http.Error(w, "metrics are served on localhost only", http.StatusForbidden)
+			return
+		}
+		w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+		writeMetrics(w, hubStats, h.gauges())
+	}
+}
@@ -0,0 +1,56 @@
+package tetrisserver
+
+import (
+	"io"
+	"net/http"
+	"net/http/httptest"
+	"strings"
+	"testing"
+)
+
+func TestMetricsEndpoint(t *testing.T) {
+	ts := httptest.NewServer(NewServerHandler())
+	defer ts.Close()
+
+	toJson(Message{Type: "attack"})
+	toJson(Message{Type: "no_such_type"})
+
+	resp, err := ts.Client().Get(ts.URL + "/metrics")
+	if err != nil {
+		t.Fatalf("Failed to GET /metrics: %v", err)
+	}
+	defer resp.Body.Close()
+	if resp.StatusCode != http.StatusOK {
+		t.Fatalf("Expected 200 OK, got %d", resp.StatusCode)
+	}
+	if ct := resp.Header.Get("Content-Type"); !strings.HasPrefix(ct, "text/plain; version=0.0.4") {
+		t.Errorf("Unexpected Content-Type %q", ct)
+	}
+	body, _ := io.ReadAll(resp.Body)
+	text := string(body)
+	for _, want := range []string{
+		"# TYPE tetris_hub_messages_total counter",
+		`tetris_hub_messages_total{direction="out",type="attack"} `,
+		`tetris_hub_messages_total{direction="out",type="other"} `,
+		"tetris_hub_clients 0\n",
+		"tetris_sessions_active 0\n",
+		"tetris_hub_send_queue_depth 0\n",
+	} {
+		if !strings.Contains(text, want) {
+			t.Errorf("Missing %q in:\n%s", want, text)
+		}
+	}
+	if strings.Contains(text, `{direction="out",type="attack"} 0`) {
+		t.Errorf("attack was not counted:\n%s", text)
+	}
+}
+
+func TestMetricsRejectRemoteClients(t *testing.T) {
+	req := httptest.NewRequest("GET", "/metrics", nil)
+	req.RemoteAddr = "192.0.2.1:4000"
+	rec := httptest.NewRecorder()
+	metricsHandler(NewHub())(rec, req)
+	if rec.Code != http.StatusForbidden {
+		t.Errorf("Expected 403 for a remote client, got %d", rec.Code)
+	}
+}
@@ -133,6 +133,9 @@ func (r *Room) broadcast(sender *Client, msg Message) {
 
 func toJson(v interface{}) []byte {
 	b, _ := json.Marshal(v)
+	if msg, ok := v.(Message); ok {
+		hubStats.count(directionOut, msg.Type, len(b))
+	}
 	return b
 }
 
@@ -207,9 +210,11 @@ func (c *Client) readPump() {
 
 		var msg Message
 		if err := json.Unmarshal(message, &msg); err != nil {
+			hubStats.count(directionIn, "other", len(message))
 			log.Printf("Error unmarshaling: %v", err)
 			continue
 		}
+		hubStats.count(directionIn, msg.Type, len(message))
 
 		c.handleMessage(msg)
 	}
@@ -513,6 +518,9 @@ func NewServerHandler() http.Handler {
 		}
 	})
 
+	// Prometheus metrics (metrics.go), localhost only
+	mux.HandleFunc("/metrics", metricsHandler(hub))
+
 	// Version Endpoint
 	mux.HandleFunc("/debug/version", func(w http.ResponseWriter, r *http.Request) {
 		w.Header().Set("Content-Type", "text/plain")
@@ -0,0 +1,7 @@
+// Package wire holds the binary messages shared by the Go hub, the C++
+// client and the web client. wire_gen.go is generated from
+// schema/wire.schema, which also describes the encoding and how to evolve
+// it.
+package wire
+
+//go:generate go run ../cmd/wiregen -root ..
@@ -0,0 +1,1535 @@
+// Code generated by cmd/wiregen from schema/wire.schema. DO NOT EDIT.
+
+package wire
+
+import (
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"math"
+)
+
+// MsgID is the first varint of every frame.
+type MsgID uint32
+
+const (
+	MsgUnknown            MsgID = 0
+	MsgJoinGame           MsgID = 1
+	MsgRoomStatus         MsgID = 2
+	MsgWaitingForOpponent MsgID = 3
+	MsgGameStart          MsgID = 4
+	MsgGameState          MsgID = 5
+	MsgAttack             MsgID = 6
+	MsgGameOver           MsgID = 7
+	MsgPause              MsgID = 8
+	MsgResume             MsgID = 9
+	MsgPlayerLeft         MsgID = 10
+	MsgMoveLR             MsgID = 32
+	MsgRotate             MsgID = 33
+	MsgMoveDown           MsgID = 34
+	MsgGameStartHost      MsgID = 35
+	MsgSyncState          MsgID = 36
+	MsgStateHash          MsgID = 37
+	MsgHashHistoryReq     MsgID = 38
+	MsgHashHistory        MsgID = 39
+	MsgResumeSession      MsgID = 40
+	MsgResumeOk           MsgID = 41
+	MsgResumeReject       MsgID = 42
+	MsgInputs             MsgID = 43
+	MsgPing               MsgID = 44
+)
+
+// String returns the snake-case name; for hub messages also the JSON "type".
+func (id MsgID) String() string {
+	switch id {
+	case MsgJoinGame:
+		return "join_game"
+	case MsgRoomStatus:
+		return "room_status"
+	case MsgWaitingForOpponent:
+		return "waiting_for_opponent"
+	case MsgGameStart:
+		return "game_start"
+	case MsgGameState:
+		return "game_state"
+	case MsgAttack:
+		return "attack"
+	case MsgGameOver:
+		return "game_over"
+	case MsgPause:
+		return "pause"
+	case MsgResume:
+		return "resume"
+	case MsgPlayerLeft:
+		return "player_left"
+	case MsgMoveLR:
+		return "move_lr"
+	case MsgRotate:
+		return "rotate"
+	case MsgMoveDown:
+		return "move_down"
+	case MsgGameStartHost:
+		return "game_start_host"
+	case MsgSyncState:
+		return "sync_state"
+	case MsgStateHash:
+		return "state_hash"
+	case MsgHashHistoryReq:
+		return "hash_history_req"
+	case MsgHashHistory:
+		return "hash_history"
+	case MsgResumeSession:
+		return "resume_session"
+	case MsgResumeOk:
+		return "resume_ok"
+	case MsgResumeReject:
+		return "resume_reject"
+	case MsgInputs:
+		return "inputs"
+	case MsgPing:
+		return "ping"
+	}
+	return "unknown"
+}
+
+// DecodeAny decodes a frame into the message its id names.
+func DecodeAny(frame []byte) (Message, error) {
+	var m Message
+	switch PeekID(frame) {
+	case MsgJoinGame:
+		m = &JoinGame{}
+	case MsgRoomStatus:
+		m = &RoomStatus{}
+	case MsgWaitingForOpponent:
+		m = &WaitingForOpponent{}
+	case MsgGameStart:
+		m = &GameStart{}
+	case MsgGameState:
+		m = &GameState{}
+	case MsgAttack:
+		m = &Attack{}
+	case MsgGameOver:
+		m = &GameOver{}
+	case MsgPause:
+		m = &Pause{}
+	case MsgResume:
+		m = &Resume{}
+	case MsgPlayerLeft:
+		m = &PlayerLeft{}
+	case MsgMoveLR:
+		m = &MoveLR{}
+	case MsgRotate:
+		m = &Rotate{}
+	case MsgMoveDown:
+		m = &MoveDown{}
+	case MsgGameStartHost:
+		m = &GameStartHost{}
+	case MsgSyncState:
+		m = &SyncState{}
+	case MsgStateHash:
+		m = &StateHash{}
+	case MsgHashHistoryReq:
+		m = &HashHistoryReq{}
+	case MsgHashHistory:
+		m = &HashHistory{}
+	case MsgResumeSession:
+		m = &ResumeSession{}
+	case MsgResumeOk:
+		m = &ResumeOk{}
+	case MsgResumeReject:
+		m = &ResumeReject{}
+	case MsgInputs:
+		m = &Inputs{}
+	case MsgPing:
+		m = &Ping{}
+	default:
+		return nil, fmt.Errorf("wire: unknown message id %d", PeekID(frame))
+	}
+	return m, m.Decode(frame)
+}
+
+// ErrMalformed is returned for frames that end early or break the encoding.
+var ErrMalformed = errors.New("wire: malformed frame")
+
+// Message is implemented by every top-level message.
+type Message interface {
+	ID() MsgID
+	Encode() []byte
+	Decode(frame []byte) error
+}
+
+// PeekID returns the id of a frame, MsgUnknown if it cannot be read. Ids of
+// messages newer than this build are returned as they are.
+func PeekID(frame []byte) MsgID {
+	r := reader{buf: frame}
+	id := r.varint()
+	if r.err != nil || id > math.MaxUint32 {
+		return MsgUnknown
+	}
+	return MsgID(id)
+}
+
+type writer struct {
+	buf []byte
+}
+
+func (w *writer) varint(v uint64) {
+	w.buf = binary.AppendUvarint(w.buf, v)
+}
+
+func (w *writer) key(tag int, wireType int) {
+	w.varint(uint64(tag)<<3 | uint64(wireType))
+}
+
+func (w *writer) bool(tag int, v bool) {
+	w.key(tag, 0)
+	if v {
+		w.varint(1)
+	} else {
+		w.varint(0)
+	}
+}
+
+// Zigzag: small negative numbers stay short
+func (w *writer) int(tag int, v int32) {
+	w.key(tag, 0)
+	w.varint(uint64(uint32(v<<1) ^ uint32(v>>31)))
+}
+
+func (w *writer) uint64(tag int, v uint64) {
+	w.key(tag, 0)
+	w.varint(v)
+}
+
+func (w *writer) bytes(tag int, v []byte) {
+	w.key(tag, 2)
+	w.varint(uint64(len(v)))
+	w.buf = append(w.buf, v...)
+}
+
+func (w *writer) string(tag int, v string) {
+	w.key(tag, 2)
+	w.varint(uint64(len(v)))
+	w.buf = append(w.buf, v...)
+}
+
+func (w *writer) packed(tag int, values []uint64) {
+	var inner writer
+	for _, v := range values {
+		inner.varint(v)
+	}
+	w.bytes(tag, inner.buf)
+}
+
+func (w *writer) nested(tag int, encode func(*writer)) {
+	var inner writer
+	encode(&inner)
+	w.bytes(tag, inner.buf)
+}
+
+// reader keeps the first error; later reads return zero values.
+type reader struct {
+	buf []byte
+	pos int
+	err error
+}
+
+func (r *reader) more() bool {
+	return r.err == nil && r.pos < len(r.buf)
+}
+
+func (r *reader) varint() uint64 {
+	if r.err != nil {
+		return 0
+	}
+	v, n := binary.Uvarint(r.buf[r.pos:])
+	if n <= 0 {
+		r.err = ErrMalformed
+		return 0
+	}
+	r.pos += n
+	return v
+}
+
+func (r *reader) key() (int, int) {
+	key := r.varint()
+	if r.err == nil && key>>3 == 0 {
+		r.err = ErrMalformed
+	}
+	return int(key >> 3), int(key & 7)
+}
+
+func (r *reader) bool() bool {
+	return r.varint() != 0
+}
+
+func (r *reader) int() int32 {
+	v := uint32(r.varint())
+	return int32(v>>1) ^ -int32(v&1)
+}
+
+func (r *reader) uint64() uint64 {
+	return r.varint()
+}
+
+// The next length-delimited value, still pointing into the frame
+func (r *reader) view() []byte {
+	n := r.varint()
+	if r.err != nil {
+		return nil
+	}
+	if n > uint64(len(r.buf)-r.pos) {
+		r.err = ErrMalformed
+		return nil
+	}
+	v := r.buf[r.pos : r.pos+int(n)]
+	r.pos += int(n)
+	return v
+}
+
+func (r *reader) bytes() []byte {
+	return append([]byte(nil), r.view()...)
+}
+
+func (r *reader) string() string {
+	return string(r.view())
+}
+
+func (r *reader) packed() []uint64 {
+	inner := reader{buf: r.view()}
+	values := []uint64{}
+	for inner.more() {
+		values = append(values, inner.varint())
+	}
+	if inner.err != nil && r.err == nil {
+		r.err = inner.err
+	}
+	return values
+}
+
+// Nested struct: decode runs on a reader of its own
+func (r *reader) nested(decode func(*reader) error) {
+	inner := reader{buf: r.view()}
+	if err := decode(&inner); err != nil && r.err == nil {
+		r.err = err
+	}
+}
+
+// Fields this build does not know: a newer peer sent them
+func (r *reader) skip(wireType int) {
+	switch wireType {
+	case 0:
+		r.varint()
+	case 2:
+		r.view()
+	default:
+		r.err = ErrMalformed
+	}
+}
+
+func (r *reader) expect(id MsgID) {
+	if got := MsgID(r.varint()); r.err == nil && got != id {
+		r.err = fmt.Errorf("wire: %v frame, want %v", got, id)
+	}
+}
+
+type HostSettings struct {
+	AttackMode        string
+	ShowGhostPiece    bool
+	EffectType        string
+	UseCascadeGravity bool
+	AllowHoldPiece    bool
+	IncreaseGravity   bool
+}
+
+// NewHostSettings returns a HostSettings holding the schema defaults.
+func NewHostSettings() *HostSettings {
+	return &HostSettings{
+		AllowHoldPiece:  true,
+		IncreaseGravity: true,
+	}
+}
+
+func (m *HostSettings) encodeFields(w *writer) {
+	if m.AttackMode != "" {
+		w.string(1, m.AttackMode)
+	}
+	if m.ShowGhostPiece {
+		w.bool(2, m.ShowGhostPiece)
+	}
+	if m.EffectType != "" {
+		w.string(3, m.EffectType)
+	}
+	if m.UseCascadeGravity {
+		w.bool(4, m.UseCascadeGravity)
+	}
+	if !m.AllowHoldPiece {
+		w.bool(5, m.AllowHoldPiece)
+	}
+	if !m.IncreaseGravity {
+		w.bool(6, m.IncreaseGravity)
+	}
+}
+
+func (m *HostSettings) decodeFields(r *reader) error {
+	*m = *NewHostSettings()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 2:
+			m.AttackMode = r.string()
+		case tag == 2 && wireType == 0:
+			m.ShowGhostPiece = r.bool()
+		case tag == 3 && wireType == 2:
+			m.EffectType = r.string()
+		case tag == 4 && wireType == 0:
+			m.UseCascadeGravity = r.bool()
+		case tag == 5 && wireType == 0:
+			m.AllowHoldPiece = r.bool()
+		case tag == 6 && wireType == 0:
+			m.IncreaseGravity = r.bool()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type JoinGame struct {
+	Name     string
+	Settings *HostSettings
+}
+
+// NewJoinGame returns a JoinGame holding the schema defaults.
+func NewJoinGame() *JoinGame {
+	return &JoinGame{}
+}
+
+func (m *JoinGame) ID() MsgID { return MsgJoinGame }
+
+func (m *JoinGame) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgJoinGame))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *JoinGame) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgJoinGame)
+	return m.decodeFields(r)
+}
+
+func (m *JoinGame) encodeFields(w *writer) {
+	if m.Name != "" {
+		w.string(1, m.Name)
+	}
+	if m.Settings != nil {
+		w.nested(2, m.Settings.encodeFields)
+	}
+}
+
+func (m *JoinGame) decodeFields(r *reader) error {
+	*m = *NewJoinGame()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 2:
+			m.Name = r.string()
+		case tag == 2 && wireType == 2:
+			m.Settings = NewHostSettings()
+			r.nested(m.Settings.decodeFields)
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type RoomStatus struct {
+	HasHost      bool
+	HostSettings *HostSettings
+}
+
+// NewRoomStatus returns a RoomStatus holding the schema defaults.
+func NewRoomStatus() *RoomStatus {
+	return &RoomStatus{}
+}
+
+func (m *RoomStatus) ID() MsgID { return MsgRoomStatus }
+
+func (m *RoomStatus) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgRoomStatus))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *RoomStatus) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgRoomStatus)
+	return m.decodeFields(r)
+}
+
+func (m *RoomStatus) encodeFields(w *writer) {
+	if m.HasHost {
+		w.bool(1, m.HasHost)
+	}
+	if m.HostSettings != nil {
+		w.nested(2, m.HostSettings.encodeFields)
+	}
+}
+
+func (m *RoomStatus) decodeFields(r *reader) error {
+	*m = *NewRoomStatus()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.HasHost = r.bool()
+		case tag == 2 && wireType == 2:
+			m.HostSettings = NewHostSettings()
+			r.nested(m.HostSettings.decodeFields)
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type WaitingForOpponent struct {
+}
+
+// NewWaitingForOpponent returns a WaitingForOpponent holding the schema defaults.
+func NewWaitingForOpponent() *WaitingForOpponent {
+	return &WaitingForOpponent{}
+}
+
+func (m *WaitingForOpponent) ID() MsgID { return MsgWaitingForOpponent }
+
+func (m *WaitingForOpponent) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgWaitingForOpponent))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *WaitingForOpponent) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgWaitingForOpponent)
+	return m.decodeFields(r)
+}
+
+func (*WaitingForOpponent) encodeFields(w *writer) {
+}
+
+func (m *WaitingForOpponent) decodeFields(r *reader) error {
+	*m = *NewWaitingForOpponent()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
+
+type GameStart struct {
+	OpponentId   string
+	OpponentName string
+	MatchId      string
+	AttackMode   string
+}
+
+// NewGameStart returns a GameStart holding the schema defaults.
+func NewGameStart() *GameStart {
+	return &GameStart{}
+}
+
+func (m *GameStart) ID() MsgID { return MsgGameStart }
+
+func (m *GameStart) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgGameStart))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *GameStart) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgGameStart)
+	return m.decodeFields(r)
+}
+
+func (m *GameStart) encodeFields(w *writer) {
+	if m.OpponentId != "" {
+		w.string(1, m.OpponentId)
+	}
+	if m.OpponentName != "" {
+		w.string(2, m.OpponentName)
+	}
+	if m.MatchId != "" {
+		w.string(3, m.MatchId)
+	}
+	if m.AttackMode != "" {
+		w.string(4, m.AttackMode)
+	}
+}
+
+func (m *GameStart) decodeFields(r *reader) error {
+	*m = *NewGameStart()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 2:
+			m.OpponentId = r.string()
+		case tag == 2 && wireType == 2:
+			m.OpponentName = r.string()
+		case tag == 3 && wireType == 2:
+			m.MatchId = r.string()
+		case tag == 4 && wireType == 2:
+			m.AttackMode = r.string()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+// cells: one byte per cell, row-major, 10 per row
+type GameState struct {
+	Cells []byte
+	Score int32
+	Lines int32
+}
+
+// NewGameState returns a GameState holding the schema defaults.
+func NewGameState() *GameState {
+	return &GameState{}
+}
+
+func (m *GameState) ID() MsgID { return MsgGameState }
+
+func (m *GameState) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgGameState))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *GameState) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgGameState)
+	return m.decodeFields(r)
+}
+
+func (m *GameState) encodeFields(w *writer) {
+	if len(m.Cells) > 0 {
+		w.bytes(1, m.Cells)
+	}
+	if m.Score != 0 {
+		w.int(2, m.Score)
+	}
+	if m.Lines != 0 {
+		w.int(3, m.Lines)
+	}
+}
+
+func (m *GameState) decodeFields(r *reader) error {
+	*m = *NewGameState()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 2:
+			m.Cells = r.bytes()
+		case tag == 2 && wireType == 0:
+			m.Score = r.int()
+		case tag == 3 && wireType == 0:
+			m.Lines = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type Attack struct {
+	Lines int32
+}
+
+// NewAttack returns a Attack holding the schema defaults.
+func NewAttack() *Attack {
+	return &Attack{}
+}
+
+func (m *Attack) ID() MsgID { return MsgAttack }
+
+func (m *Attack) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgAttack))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *Attack) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgAttack)
+	return m.decodeFields(r)
+}
+
+func (m *Attack) encodeFields(w *writer) {
+	if m.Lines != 0 {
+		w.int(1, m.Lines)
+	}
+}
+
+func (m *Attack) decodeFields(r *reader) error {
+	*m = *NewAttack()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Lines = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type GameOver struct {
+}
+
+// NewGameOver returns a GameOver holding the schema defaults.
+func NewGameOver() *GameOver {
+	return &GameOver{}
+}
+
+func (m *GameOver) ID() MsgID { return MsgGameOver }
+
+func (m *GameOver) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgGameOver))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *GameOver) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgGameOver)
+	return m.decodeFields(r)
+}
+
+func (*GameOver) encodeFields(w *writer) {
+}
+
+func (m *GameOver) decodeFields(r *reader) error {
+	*m = *NewGameOver()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
+
+type Pause struct {
+}
+
+// NewPause returns a Pause holding the schema defaults.
+func NewPause() *Pause {
+	return &Pause{}
+}
+
+func (m *Pause) ID() MsgID { return MsgPause }
+
+func (m *Pause) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgPause))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *Pause) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgPause)
+	return m.decodeFields(r)
+}
+
+func (*Pause) encodeFields(w *writer) {
+}
+
+func (m *Pause) decodeFields(r *reader) error {
+	*m = *NewPause()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
+
+type Resume struct {
+}
+
+// NewResume returns a Resume holding the schema defaults.
+func NewResume() *Resume {
+	return &Resume{}
+}
+
+func (m *Resume) ID() MsgID { return MsgResume }
+
+func (m *Resume) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgResume))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *Resume) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgResume)
+	return m.decodeFields(r)
+}
+
+func (*Resume) encodeFields(w *writer) {
+}
+
+func (m *Resume) decodeFields(r *reader) error {
+	*m = *NewResume()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
+
+type PlayerLeft struct {
+}
+
+// NewPlayerLeft returns a PlayerLeft holding the schema defaults.
+func NewPlayerLeft() *PlayerLeft {
+	return &PlayerLeft{}
+}
+
+func (m *PlayerLeft) ID() MsgID { return MsgPlayerLeft }
+
+func (m *PlayerLeft) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgPlayerLeft))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *PlayerLeft) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgPlayerLeft)
+	return m.decodeFields(r)
+}
+
+func (*PlayerLeft) encodeFields(w *writer) {
+}
+
+func (m *PlayerLeft) decodeFields(r *reader) error {
+	*m = *NewPlayerLeft()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
+
+type PieceState struct {
+	Type     int32
+	X        int32
+	Y        int32
+	Rotation int32
+}
+
+// NewPieceState returns a PieceState holding the schema defaults.
+func NewPieceState() *PieceState {
+	return &PieceState{}
+}
+
+func (m *PieceState) encodeFields(w *writer) {
+	if m.Type != 0 {
+		w.int(1, m.Type)
+	}
+	if m.X != 0 {
+		w.int(2, m.X)
+	}
+	if m.Y != 0 {
+		w.int(3, m.Y)
+	}
+	if m.Rotation != 0 {
+		w.int(4, m.Rotation)
+	}
+}
+
+func (m *PieceState) decodeFields(r *reader) error {
+	*m = *NewPieceState()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Type = r.int()
+		case tag == 2 && wireType == 0:
+			m.X = r.int()
+		case tag == 3 && wireType == 0:
+			m.Y = r.int()
+		case tag == 4 && wireType == 0:
+			m.Rotation = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+// stampMs: sender's clock for the jitter buffer, -1 if unknown
+type MoveLR struct {
+	Dir     int32
+	StampMs int32
+}
+
+// NewMoveLR returns a MoveLR holding the schema defaults.
+func NewMoveLR() *MoveLR {
+	return &MoveLR{
+		StampMs: -1,
+	}
+}
+
+func (m *MoveLR) ID() MsgID { return MsgMoveLR }
+
+func (m *MoveLR) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgMoveLR))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *MoveLR) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgMoveLR)
+	return m.decodeFields(r)
+}
+
+func (m *MoveLR) encodeFields(w *writer) {
+	if m.Dir != 0 {
+		w.int(1, m.Dir)
+	}
+	if m.StampMs != -1 {
+		w.int(2, m.StampMs)
+	}
+}
+
+func (m *MoveLR) decodeFields(r *reader) error {
+	*m = *NewMoveLR()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Dir = r.int()
+		case tag == 2 && wireType == 0:
+			m.StampMs = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type Rotate struct {
+	StampMs int32
+}
+
+// NewRotate returns a Rotate holding the schema defaults.
+func NewRotate() *Rotate {
+	return &Rotate{
+		StampMs: -1,
+	}
+}
+
+func (m *Rotate) ID() MsgID { return MsgRotate }
+
+func (m *Rotate) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgRotate))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *Rotate) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgRotate)
+	return m.decodeFields(r)
+}
+
+func (m *Rotate) encodeFields(w *writer) {
+	if m.StampMs != -1 {
+		w.int(1, m.StampMs)
+	}
+}
+
+func (m *Rotate) decodeFields(r *reader) error {
+	*m = *NewRotate()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.StampMs = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+// soft: Logic::Move(0, 1) rather than a gravity tick
+type MoveDown struct {
+	Soft    bool
+	StampMs int32
+}
+
+// NewMoveDown returns a MoveDown holding the schema defaults.
+func NewMoveDown() *MoveDown {
+	return &MoveDown{
+		StampMs: -1,
+	}
+}
+
+func (m *MoveDown) ID() MsgID { return MsgMoveDown }
+
+func (m *MoveDown) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgMoveDown))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *MoveDown) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgMoveDown)
+	return m.decodeFields(r)
+}
+
+func (m *MoveDown) encodeFields(w *writer) {
+	if m.Soft {
+		w.bool(1, m.Soft)
+	}
+	if m.StampMs != -1 {
+		w.int(2, m.StampMs)
+	}
+}
+
+func (m *MoveDown) decodeFields(r *reader) error {
+	*m = *NewMoveDown()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Soft = r.bool()
+		case tag == 2 && wireType == 0:
+			m.StampMs = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type GameStartHost struct {
+	Seed     int32
+	Session  uint64
+	HostName string
+}
+
+// NewGameStartHost returns a GameStartHost holding the schema defaults.
+func NewGameStartHost() *GameStartHost {
+	return &GameStartHost{}
+}
+
+func (m *GameStartHost) ID() MsgID { return MsgGameStartHost }
+
+func (m *GameStartHost) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgGameStartHost))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *GameStartHost) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgGameStartHost)
+	return m.decodeFields(r)
+}
+
+func (m *GameStartHost) encodeFields(w *writer) {
+	if m.Seed != 0 {
+		w.int(1, m.Seed)
+	}
+	if m.Session != 0 {
+		w.uint64(2, m.Session)
+	}
+	if m.HostName != "" {
+		w.string(3, m.HostName)
+	}
+}
+
+func (m *GameStartHost) decodeFields(r *reader) error {
+	*m = *NewGameStartHost()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Seed = r.int()
+		case tag == 2 && wireType == 0:
+			m.Session = r.uint64()
+		case tag == 3 && wireType == 2:
+			m.HostName = r.string()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+// step and current are only set by a full resync
+type SyncState struct {
+	Score    int32
+	NextType int32
+	Board    []byte
+	Step     int32
+	Current  *PieceState
+}
+
+// NewSyncState returns a SyncState holding the schema defaults.
+func NewSyncState() *SyncState {
+	return &SyncState{
+		Step: -1,
+	}
+}
+
+func (m *SyncState) ID() MsgID { return MsgSyncState }
+
+func (m *SyncState) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgSyncState))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *SyncState) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgSyncState)
+	return m.decodeFields(r)
+}
+
+func (m *SyncState) encodeFields(w *writer) {
+	if m.Score != 0 {
+		w.int(1, m.Score)
+	}
+	if m.NextType != 0 {
+		w.int(2, m.NextType)
+	}
+	if len(m.Board) > 0 {
+		w.bytes(3, m.Board)
+	}
+	if m.Step != -1 {
+		w.int(4, m.Step)
+	}
+	if m.Current != nil {
+		w.nested(5, m.Current.encodeFields)
+	}
+}
+
+func (m *SyncState) decodeFields(r *reader) error {
+	*m = *NewSyncState()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Score = r.int()
+		case tag == 2 && wireType == 0:
+			m.NextType = r.int()
+		case tag == 3 && wireType == 2:
+			m.Board = r.bytes()
+		case tag == 4 && wireType == 0:
+			m.Step = r.int()
+		case tag == 5 && wireType == 2:
+			m.Current = NewPieceState()
+			r.nested(m.Current.decodeFields)
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type StateHash struct {
+	Step int32
+	Hash uint64
+}
+
+// NewStateHash returns a StateHash holding the schema defaults.
+func NewStateHash() *StateHash {
+	return &StateHash{}
+}
+
+func (m *StateHash) ID() MsgID { return MsgStateHash }
+
+func (m *StateHash) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgStateHash))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *StateHash) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgStateHash)
+	return m.decodeFields(r)
+}
+
+func (m *StateHash) encodeFields(w *writer) {
+	if m.Step != 0 {
+		w.int(1, m.Step)
+	}
+	if m.Hash != 0 {
+		w.uint64(2, m.Hash)
+	}
+}
+
+func (m *StateHash) decodeFields(r *reader) error {
+	*m = *NewStateHash()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Step = r.int()
+		case tag == 2 && wireType == 0:
+			m.Hash = r.uint64()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type HashHistoryReq struct {
+	FromStep int32
+	ToStep   int32
+}
+
+// NewHashHistoryReq returns a HashHistoryReq holding the schema defaults.
+func NewHashHistoryReq() *HashHistoryReq {
+	return &HashHistoryReq{}
+}
+
+func (m *HashHistoryReq) ID() MsgID { return MsgHashHistoryReq }
+
+func (m *HashHistoryReq) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgHashHistoryReq))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *HashHistoryReq) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgHashHistoryReq)
+	return m.decodeFields(r)
+}
+
+func (m *HashHistoryReq) encodeFields(w *writer) {
+	if m.FromStep != 0 {
+		w.int(1, m.FromStep)
+	}
+	if m.ToStep != 0 {
+		w.int(2, m.ToStep)
+	}
+}
+
+func (m *HashHistoryReq) decodeFields(r *reader) error {
+	*m = *NewHashHistoryReq()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.FromStep = r.int()
+		case tag == 2 && wireType == 0:
+			m.ToStep = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+// hashes[i] and inputs[i] belong to step fromStep + i
+type HashHistory struct {
+	FromStep int32
+	Hashes   []uint64
+	Inputs   string
+}
+
+// NewHashHistory returns a HashHistory holding the schema defaults.
+func NewHashHistory() *HashHistory {
+	return &HashHistory{}
+}
+
+func (m *HashHistory) ID() MsgID { return MsgHashHistory }
+
+func (m *HashHistory) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgHashHistory))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *HashHistory) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgHashHistory)
+	return m.decodeFields(r)
+}
+
+func (m *HashHistory) encodeFields(w *writer) {
+	if m.FromStep != 0 {
+		w.int(1, m.FromStep)
+	}
+	if len(m.Hashes) > 0 {
+		w.packed(2, m.Hashes)
+	}
+	if m.Inputs != "" {
+		w.string(3, m.Inputs)
+	}
+}
+
+func (m *HashHistory) decodeFields(r *reader) error {
+	*m = *NewHashHistory()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.FromStep = r.int()
+		case tag == 2 && wireType == 2:
+			m.Hashes = r.packed()
+		case tag == 3 && wireType == 2:
+			m.Inputs = r.string()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type ResumeSession struct {
+	Session uint64
+	AckStep int32
+}
+
+// NewResumeSession returns a ResumeSession holding the schema defaults.
+func NewResumeSession() *ResumeSession {
+	return &ResumeSession{}
+}
+
+func (m *ResumeSession) ID() MsgID { return MsgResumeSession }
+
+func (m *ResumeSession) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgResumeSession))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *ResumeSession) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgResumeSession)
+	return m.decodeFields(r)
+}
+
+func (m *ResumeSession) encodeFields(w *writer) {
+	if m.Session != 0 {
+		w.uint64(1, m.Session)
+	}
+	if m.AckStep != 0 {
+		w.int(2, m.AckStep)
+	}
+}
+
+func (m *ResumeSession) decodeFields(r *reader) error {
+	*m = *NewResumeSession()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.Session = r.uint64()
+		case tag == 2 && wireType == 0:
+			m.AckStep = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type ResumeOk struct {
+	AckStep int32
+}
+
+// NewResumeOk returns a ResumeOk holding the schema defaults.
+func NewResumeOk() *ResumeOk {
+	return &ResumeOk{}
+}
+
+func (m *ResumeOk) ID() MsgID { return MsgResumeOk }
+
+func (m *ResumeOk) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgResumeOk))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *ResumeOk) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgResumeOk)
+	return m.decodeFields(r)
+}
+
+func (m *ResumeOk) encodeFields(w *writer) {
+	if m.AckStep != 0 {
+		w.int(1, m.AckStep)
+	}
+}
+
+func (m *ResumeOk) decodeFields(r *reader) error {
+	*m = *NewResumeOk()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.AckStep = r.int()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type ResumeReject struct {
+}
+
+// NewResumeReject returns a ResumeReject holding the schema defaults.
+func NewResumeReject() *ResumeReject {
+	return &ResumeReject{}
+}
+
+func (m *ResumeReject) ID() MsgID { return MsgResumeReject }
+
+func (m *ResumeReject) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgResumeReject))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *ResumeReject) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgResumeReject)
+	return m.decodeFields(r)
+}
+
+func (*ResumeReject) encodeFields(w *writer) {
+}
+
+func (m *ResumeReject) decodeFields(r *reader) error {
+	*m = *NewResumeReject()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
+
+// codes[i] is the Logic step code of step fromStep + i
+type Inputs struct {
+	FromStep int32
+	Codes    string
+}
+
+// NewInputs returns a Inputs holding the schema defaults.
+func NewInputs() *Inputs {
+	return &Inputs{}
+}
+
+func (m *Inputs) ID() MsgID { return MsgInputs }
+
+func (m *Inputs) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgInputs))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *Inputs) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgInputs)
+	return m.decodeFields(r)
+}
+
+func (m *Inputs) encodeFields(w *writer) {
+	if m.FromStep != 0 {
+		w.int(1, m.FromStep)
+	}
+	if m.Codes != "" {
+		w.string(2, m.Codes)
+	}
+}
+
+func (m *Inputs) decodeFields(r *reader) error {
+	*m = *NewInputs()
+	for r.more() {
+		tag, wireType := r.key()
+		switch {
+		case tag == 1 && wireType == 0:
+			m.FromStep = r.int()
+		case tag == 2 && wireType == 2:
+			m.Codes = r.string()
+		default:
+			r.skip(wireType)
+		}
+	}
+	return r.err
+}
+
+type Ping struct {
+}
+
+// NewPing returns a Ping holding the schema defaults.
+func NewPing() *Ping {
+	return &Ping{}
+}
+
+func (m *Ping) ID() MsgID { return MsgPing }
+
+func (m *Ping) Encode() []byte {
+	w := &writer{}
+	w.varint(uint64(MsgPing))
+	m.encodeFields(w)
+	return w.buf
+}
+
+func (m *Ping) Decode(frame []byte) error {
+	r := &reader{buf: frame}
+	r.expect(MsgPing)
+	return m.decodeFields(r)
+}
+
+func (*Ping) encodeFields(w *writer) {
+}
+
+func (m *Ping) decodeFields(r *reader) error {
+	*m = *NewPing()
+	for r.more() {
+		_, wireType := r.key()
+		r.skip(wireType)
+	}
+	return r.err
+}
@@ -0,0 +1,183 @@
+package wire
+
+import (
+	"bytes"
+	"encoding/hex"
+	"errors"
+	"math"
+	"testing"
+)
+
+// The same frames are checked by client/tests/wire_test.cpp and
+// client-nuxt/app/services/wire.test.ts
+const (
+	goldenJoinGame  = "010a03416e6e120b0a056c696e657310012800"
+	goldenSyncState = "2408e01210061a03000102209a012a0808041001180a2006"
+	goldenStateHash = "2508d8041090e4d0b287d3aeeefe01"
+)
+
+func goldenJoin() *JoinGame {
+	join := NewJoinGame()
+	join.Name = "Ann"
+	join.Settings = NewHostSettings()
+	join.Settings.AttackMode = "lines"
+	join.Settings.ShowGhostPiece = true
+	join.Settings.AllowHoldPiece = false
+	return join
+}
+
+func goldenSync() *SyncState {
+	sync := NewSyncState()
+	sync.Score = 1200
+	sync.NextType = 3
+	sync.Board = []byte{0, 1, 2}
+	sync.Step = 77
+	sync.Current = &PieceState{Type: 2, X: -1, Y: 5, Rotation: 3}
+	return sync
+}
+
+func mustHex(t *testing.T, s string) []byte {
+	t.Helper()
+	b, err := hex.DecodeString(s)
+	if err != nil {
+		t.Fatal(err)
+	}
+	return b
+}
+
+func TestGoldenFramesMatchTheOtherLanguages(t *testing.T) {
+	hash := &StateHash{Step: 300, Hash: 0xfedcba9876543210}
+	for _, c := range []struct {
+		msg  Message
+		want string
+	}{
+		{goldenJoin(), goldenJoinGame},
+		{goldenSync(), goldenSyncState},
+		{hash, goldenStateHash},
+	} {
+		if got := hex.EncodeToString(c.msg.Encode()); got != c.want {
+			t.Errorf("%v: got %s, want %s", c.msg.ID(), got, c.want)
+		}
+	}
+
+	msg, err := DecodeAny(mustHex(t, goldenSyncState))
+	if err != nil {
+		t.Fatal(err)
+	}
+	sync := msg.(*SyncState)
+	if sync.Score != 1200 || !bytes.Equal(sync.Board, []byte{0, 1, 2}) ||
+		sync.Current == nil || sync.Current.X != -1 ||
+		sync.Current.Rotation != 3 {
+		t.Errorf("decoded %+v, current %+v", sync, sync.Current)
+	}
+}
+
+func TestRoundTripsEveryFieldType(t *testing.T) {
+	history := &HashHistory{FromStep: -5,
+		Hashes: []uint64{0, 1, 0x80, math.MaxUint64}, Inputs: "LR\x00G"}
+	var back HashHistory
+	if err := back.Decode(history.Encode()); err != nil {
+		t.Fatal(err)
+	}
+	if back.FromStep != -5 || back.Inputs != history.Inputs ||
+		len(back.Hashes) != 4 || back.Hashes[3] != math.MaxUint64 {
+		t.Errorf("got %+v", back)
+	}
+
+	start := &GameStartHost{Seed: math.MinInt32, Session: 0x0123456789abcdef,
+		HostName: "อ๋"}
+	var startBack GameStartHost
+	if err := startBack.Decode(start.Encode()); err != nil {
+		t.Fatal(err)
+	}
+	if startBack != *start {
+		t.Errorf("got %+v, want %+v", startBack, *start)
+	}
+
+	ping := &Ping{}
+	if got := ping.Encode(); !bytes.Equal(got, []byte{byte(MsgPing)}) {
+		t.Errorf("ping frame %x", got)
+	}
+}
+
+// Defaults cost nothing on the wire and come back when decoding
+func TestDefaultsAreLeftOutAndRestored(t *testing.T) {
+	move := NewMoveLR()
+	move.Dir = 1
+	if got := hex.EncodeToString(move.Encode()); got != "200802" {
+		t.Errorf("got %s, want no stampMs", got)
+	}
+	back := MoveLR{StampMs: 99}
+	if err := back.Decode(move.Encode()); err != nil || back.StampMs != -1 {
+		t.Errorf("stampMs %d, err %v", back.StampMs, err)
+	}
+
+	join := &JoinGame{Settings: NewHostSettings()}
+	var joinBack JoinGame
+	if err := joinBack.Decode(join.Encode()); err != nil {
+		t.Fatal(err)
+	}
+	s := joinBack.Settings
+	if s == nil || !s.AllowHoldPiece || !s.IncreaseGravity || s.ShowGhostPiece {
+		t.Errorf("settings %+v", s)
+	}
+}
+
+// A newer peer's extra fields are skipped; an older peer's missing ones
+// take their defaults
+func TestSkipsFieldsFromNewerPeers(t *testing.T) {
+	frame := goldenJoin().Encode()
+	frame = append(frame, mustHex(t, "7801")...)           // tag 15, varint
+	frame = append(frame, mustHex(t, "820103616263")...)   // tag 16, bytes
+	frame = append(frame, mustHex(t, "f8ffffff0fff01")...) // tag 2^28 - 1
+	var join JoinGame
+	if err := join.Decode(frame); err != nil {
+		t.Fatal(err)
+	}
+	if join.Name != "Ann" || join.Settings.AttackMode != "lines" {
+		t.Errorf("got %+v", join)
+	}
+
+	// A known tag with another wire type is skipped too
+	var attack Attack
+	if err := attack.Decode(mustHex(t, "060a0178")); err != nil ||
+		attack.Lines != 0 {
+		t.Errorf("lines %d, err %v", attack.Lines, err)
+	}
+}
+
+func TestRejectsMalformedAndForeignFrames(t *testing.T) {
+	// Cut inside a field: rejected. Cut between fields: a valid frame with
+	// fewer fields, as the transport delimits frames.
+	frame := goldenSync().Encode()
+	boundaries := map[int]bool{1: true, 4: true, 6: true, 11: true, 14: true}
+	for n := 0; n < len(frame); n++ {
+		var sync SyncState
+		if err := sync.Decode(frame[:n]); (err == nil) != boundaries[n] {
+			t.Errorf("length %d: err %v", n, err)
+		}
+	}
+
+	var hash StateHash
+	if err := hash.Decode(frame); err == nil {
+		t.Error("decoded another message's frame")
+	}
+	for _, bad := range []string{"250b", "2500"} { // Wire type 3, tag 0
+		if err := hash.Decode(mustHex(t, bad)); !errors.Is(err, ErrMalformed) {
+			t.Errorf("%s: err %v", bad, err)
+		}
+	}
+
+	if id := PeekID(frame); id != MsgSyncState {
+		t.Errorf("PeekID %v", id)
+	}
+	if id := PeekID(nil); id != MsgUnknown {
+		t.Errorf("PeekID(nil) %v", id)
+	}
+	if _, err := DecodeAny([]byte{0x7f}); err == nil {
+		t.Error("DecodeAny accepted an unknown id")
+	}
+	if MsgJoinGame.String() != "join_game" {
+		t.Errorf("name %q", MsgJoinGame.String())
+	}
+}